@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.atomic.AtomicReference;
+
+// The atomic classes update their value with the Unsafe.getAndAdd*() and
+// Unsafe.getAndSet*() intrinsics.
+public class AtomicUpdateBenchmark {
+    final AtomicInteger atomicInt = new AtomicInteger();
+    final AtomicLong atomicLong = new AtomicLong();
+    final AtomicReference<Object> atomicRef = new AtomicReference<>();
+
+    public void timeAtomicIntegerGetAndAdd(int count) {
+        AtomicInteger a = atomicInt;
+        for (int i = 0; i < count; ++i) {
+            a.getAndAdd(i);
+        }
+    }
+
+    public void timeAtomicIntegerGetAndSet(int count) {
+        AtomicInteger a = atomicInt;
+        for (int i = 0; i < count; ++i) {
+            a.getAndSet(i);
+        }
+    }
+
+    public void timeAtomicLongGetAndAdd(int count) {
+        AtomicLong a = atomicLong;
+        for (int i = 0; i < count; ++i) {
+            a.getAndAdd(i);
+        }
+    }
+
+    public void timeAtomicLongGetAndSet(int count) {
+        AtomicLong a = atomicLong;
+        for (int i = 0; i < count; ++i) {
+            a.getAndSet(i);
+        }
+    }
+
+    public void timeAtomicReferenceGetAndSet(int count) {
+        AtomicReference<Object> a = atomicRef;
+        Object o = new Object();
+        for (int i = 0; i < count; ++i) {
+            a.getAndSet(o);
+        }
+    }
+}
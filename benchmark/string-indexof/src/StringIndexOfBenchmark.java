@@ -113,10 +113,58 @@ public class StringIndexOfBenchmark {
         }
     }
 
+    public static final String string36Utf16 =
+        "0123456789ABCDEFGHIJKLMNOPQRSTUVWXY\u00c9";  // length = 36, not compressible
+
+    public void timeStringIndexOfAtStart(int count) {
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, "012");
+        }
+    }
+
+    public void timeStringIndexOfAtEnd(int count) {
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, "XYZ");
+        }
+    }
+
+    public void timeStringIndexOfNotFound(int count) {
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, "XYA");
+        }
+    }
+
+    public void timeStringIndexOfAfter(int count) {
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, "KLM", 8);
+        }
+    }
+
+    public void timeStringIndexOfUtf16(int count) {
+        String s = string36Utf16;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, "XY\u00c9");
+        }
+    }
+
     static int $noinline$indexOf(String s, char c) {
         if (doThrow) { throw new Error(); }
         return s.indexOf(c);
     }
 
+    static int $noinline$indexOf(String s, String str) {
+        if (doThrow) { throw new Error(); }
+        return s.indexOf(str);
+    }
+
+    static int $noinline$indexOf(String s, String str, int fromIndex) {
+        if (doThrow) { throw new Error(); }
+        return s.indexOf(str, fromIndex);
+    }
+
     public static boolean doThrow = false;
 }
@@ -436,6 +436,8 @@ struct XGcOption {
   // Do no measurements for kUseTableLookupReadBarrier to avoid test timeouts. b/31679493
   bool measure_ = kIsDebugBuild && !kUseTableLookupReadBarrier;
   bool gcstress_ = false;
+  // Use sticky (young-generation) concurrent copying collections in addition to full ones.
+  bool generational_cc_ = false;
 };
 
 template <>
@@ -477,6 +479,10 @@ struct CmdlineType<XGcOption> : CmdlineTypeParser<XGcOption> {
         xgc.gcstress_ = true;
       } else if (gc_option == "nogcstress") {
         xgc.gcstress_ = false;
+      } else if (gc_option == "generational_cc") {
+        xgc.generational_cc_ = true;
+      } else if (gc_option == "nogenerational_cc") {
+        xgc.generational_cc_ = false;
       } else if (gc_option == "measure") {
         xgc.measure_ = true;
       } else if ((gc_option == "precise") ||
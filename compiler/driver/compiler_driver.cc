@@ -68,7 +68,9 @@
 #include "mirror/object_array-inl.h"
 #include "mirror/throwable.h"
 #include "nativehelper/ScopedLocalRef.h"
+#include "method_info.h"
 #include "object_lock.h"
+#include "oat_quick_method_header.h"
 #include "runtime.h"
 #include "runtime_intrinsics.h"
 #include "scoped_thread_state_change-inl.h"
@@ -287,9 +289,12 @@ CompilerDriver::CompilerDriver(
       stats_(new AOTCompilationStats),
       compiler_context_(nullptr),
       support_boot_image_fixup_(true),
+      has_input_oat_file_(false),
+      num_reused_methods_(0u),
       compiled_method_storage_(swap_fd),
       profile_compilation_info_(profile_compilation_info),
       max_arena_alloc_(0),
+      compile_wall_ns_(0u),
       dex_to_dex_compiler_(this) {
   DCHECK(compiler_options_ != nullptr);
 
@@ -375,6 +380,10 @@ void CompilerDriver::CompileAll(jobject class_loader,
   }
   if (GetCompilerOptions().GetDumpStats()) {
     stats_->Dump();
+    if (has_input_oat_file_) {
+      LOG(INFO) << "Reused " << num_reused_methods_.LoadRelaxed()
+                << " compiled methods from the input oat file";
+    }
   }
 
   FreeThreadPools();
@@ -642,6 +651,9 @@ static void CompileMethodQuick(
               driver->ShouldCompileBasedOnProfile(method_ref);
 
       if (compile) {
+        compiled_method = driver->ReuseCompiledMethod(dex_file, class_def_idx, method_idx);
+      }
+      if (compile && compiled_method == nullptr) {
         // NOTE: if compiler declines to compile this method, it will return null.
         compiled_method = driver->GetCompiler()->Compile(code_item,
                                                          access_flags,
@@ -1551,13 +1563,57 @@ class ParallelCompilationManager {
   template <typename Fn>
   void ForAllLambda(size_t begin, size_t end, Fn fn, size_t work_units)
       REQUIRES(!*Locks::mutator_lock_) {
+    RunForAll(begin, end, fn, work_units, /* in_order */ false);
+  }
+
+  // Like ForAllLambda, but hand out the indices strictly in increasing order, also with a
+  // work-stealing thread pool. Used when the caller sorted the work by decreasing cost.
+  template <typename Fn>
+  void ForAllLambdaInOrder(size_t begin, size_t end, Fn fn, size_t work_units)
+      REQUIRES(!*Locks::mutator_lock_) {
+    RunForAll(begin, end, fn, work_units, /* in_order */ true);
+  }
+
+  size_t NextIndex() {
+    return index_.FetchAndAddSequentiallyConsistent(1);
+  }
+
+ private:
+  template <typename Fn>
+  void RunForAll(size_t begin, size_t end, Fn fn, size_t work_units, bool in_order)
+      REQUIRES(!*Locks::mutator_lock_) {
     Thread* self = Thread::Current();
     self->AssertNoPendingException();
     CHECK_GT(work_units, 0U);
 
+    if (work_units == 1u) {
+      // Single threaded work, e.g. class initialization in transactions, must not be split for
+      // the workers to steal. Run it on this thread.
+      for (size_t index = begin; index < end; ++index) {
+        fn(index);
+        self->AssertNoPendingException();
+      }
+      return;
+    }
+
     index_.StoreRelaxed(begin);
-    for (size_t i = 0; i < work_units; ++i) {
-      thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn));
+    if (thread_pool_->IsWorkStealing() && !in_order) {
+      // Give each work unit a slice of the range instead of having all the threads contend on
+      // index_. The workers split their slices further for idle workers to steal.
+      const size_t grain =
+          std::max<size_t>(1u, (end - begin) / (work_units * kForAllTasksPerWorkUnit));
+      for (size_t i = 0; i < work_units; ++i) {
+        const size_t slice_begin = begin + (end - begin) * i / work_units;
+        const size_t slice_end = begin + (end - begin) * (i + 1) / work_units;
+        if (slice_begin != slice_end) {
+          thread_pool_->AddTask(
+              self, new ForAllRangeLambda<Fn>(thread_pool_, slice_begin, slice_end, grain, fn));
+        }
+      }
+    } else {
+      for (size_t i = 0; i < work_units; ++i) {
+        thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn));
+      }
     }
     thread_pool_->StartWorkers(self);
 
@@ -1572,11 +1628,6 @@ class ParallelCompilationManager {
     thread_pool_->StopWorkers(self);
   }
 
-  size_t NextIndex() {
-    return index_.FetchAndAddSequentiallyConsistent(1);
-  }
-
- private:
   template <typename Fn>
   class ForAllClosureLambda : public Task {
    public:
@@ -1606,6 +1657,45 @@ class ParallelCompilationManager {
     Fn fn_;
   };
 
+  // Number of tasks a work unit is split into with a work-stealing thread pool.
+  static constexpr size_t kForAllTasksPerWorkUnit = 16;
+
+  template <typename Fn>
+  class ForAllRangeLambda : public Task {
+   public:
+    ForAllRangeLambda(ThreadPool* thread_pool, size_t begin, size_t end, size_t grain, Fn fn)
+        : thread_pool_(thread_pool),
+          begin_(begin),
+          end_(end),
+          grain_(grain),
+          fn_(fn) {}
+
+    void Run(Thread* self) OVERRIDE {
+      // Push the upper halves onto this worker's deque, where idle workers can steal them.
+      while (end_ - begin_ > grain_) {
+        const size_t middle = begin_ + (end_ - begin_) / 2;
+        thread_pool_->AddTask(
+            self, new ForAllRangeLambda<Fn>(thread_pool_, middle, end_, grain_, fn_));
+        end_ = middle;
+      }
+      for (size_t index = begin_; index != end_; ++index) {
+        fn_(index);
+        self->AssertNoPendingException();
+      }
+    }
+
+    void Finalize() OVERRIDE {
+      delete this;
+    }
+
+   private:
+    ThreadPool* const thread_pool_;
+    const size_t begin_;
+    size_t end_;
+    const size_t grain_;
+    Fn fn_;
+  };
+
   AtomicInteger index_;
   ClassLinker* const class_linker_;
   const jobject class_loader_;
@@ -2683,6 +2773,89 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// Compile the methods of the class at `class_def_index` in `dex_file`.
+template <typename CompileFn>
+static void CompileClass(ParallelCompilationManager* context,
+                         const DexFile& dex_file,
+                         size_t class_def_index,
+                         CompileFn compile_fn) {
+  ScopedTrace trace(__FUNCTION__);
+  const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+  ClassLinker* class_linker = context->GetClassLinker();
+  jobject jclass_loader = context->GetClassLoader();
+  ClassReference ref(&dex_file, class_def_index);
+  // Skip compiling classes with generic verifier failures since they will still fail at runtime
+  if (context->GetCompiler()->GetVerificationResults()->IsClassRejected(ref)) {
+    return;
+  }
+  // Use a scoped object access to perform to the quick SkipClass check.
+  const char* descriptor = dex_file.GetClassDescriptor(class_def);
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<3> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
+  Handle<mirror::Class> klass(
+      hs.NewHandle(class_linker->FindClass(soa.Self(), descriptor, class_loader)));
+  Handle<mirror::DexCache> dex_cache;
+  if (klass == nullptr) {
+    soa.Self()->AssertPendingException();
+    soa.Self()->ClearException();
+    dex_cache = hs.NewHandle(class_linker->FindDexCache(soa.Self(), dex_file));
+  } else if (SkipClass(jclass_loader, dex_file, klass.Get())) {
+    return;
+  } else {
+    dex_cache = hs.NewHandle(klass->GetDexCache());
+  }
+
+  const uint8_t* class_data = dex_file.GetClassData(class_def);
+  if (class_data == nullptr) {
+    // empty class, probably a marker interface
+    return;
+  }
+
+  // Go to native so that we don't block GC during compilation.
+  ScopedThreadSuspension sts(soa.Self(), kNative);
+
+  CompilerDriver* const driver = context->GetCompiler();
+
+  // Can we run DEX-to-DEX compiler on this class ?
+  optimizer::DexToDexCompiler::CompilationLevel dex_to_dex_compilation_level =
+      GetDexToDexCompilationLevel(soa.Self(), *driver, jclass_loader, dex_file, class_def);
+
+  ClassDataItemIterator it(dex_file, class_data);
+  it.SkipAllFields();
+
+  bool compilation_enabled = driver->IsClassToCompile(
+      dex_file.StringByTypeIdx(class_def.class_idx_));
+
+  // Compile direct and virtual methods.
+  int64_t previous_method_idx = -1;
+  while (it.HasNextMethod()) {
+    uint32_t method_idx = it.GetMemberIndex();
+    if (method_idx == previous_method_idx) {
+      // smali can create dex files with two encoded_methods sharing the same method_idx
+      // http://code.google.com/p/smali/issues/detail?id=119
+      it.Next();
+      continue;
+    }
+    previous_method_idx = method_idx;
+    compile_fn(soa.Self(),
+               driver,
+               it.GetMethodCodeItem(),
+               it.GetMethodAccessFlags(),
+               it.GetMethodInvokeType(class_def),
+               class_def_index,
+               method_idx,
+               class_loader,
+               dex_file,
+               dex_to_dex_compilation_level,
+               compilation_enabled,
+               dex_cache);
+    it.Next();
+  }
+  DCHECK(!it.HasNext());
+}
+
 template <typename CompileFn>
 static void CompileDexFile(CompilerDriver* driver,
                            jobject class_loader,
@@ -2701,85 +2874,132 @@ static void CompileDexFile(CompilerDriver* driver,
                                      dex_files,
                                      thread_pool);
 
-  auto compile = [&context, &compile_fn](size_t class_def_index) {
-    ScopedTrace trace(__FUNCTION__);
-    const DexFile& dex_file = *context.GetDexFile();
-    const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
-    ClassLinker* class_linker = context.GetClassLinker();
-    jobject jclass_loader = context.GetClassLoader();
-    ClassReference ref(&dex_file, class_def_index);
-    // Skip compiling classes with generic verifier failures since they will still fail at runtime
-    if (context.GetCompiler()->GetVerificationResults()->IsClassRejected(ref)) {
-      return;
+  auto compile = [&context, &dex_file, &compile_fn](size_t class_def_index) {
+    CompileClass(&context, dex_file, class_def_index, compile_fn);
+  };
+  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+}
+
+size_t CompilerDriver::EstimateClassCompileCost(const DexFile& dex_file,
+                                                const DexFile::ClassDef& class_def) const {
+  const uint8_t* class_data = dex_file.GetClassData(class_def);
+  if (class_data == nullptr) {
+    return 0u;
+  }
+  ClassDataItemIterator it(dex_file, class_data);
+  it.SkipAllFields();
+  size_t cost = 0u;
+  for (; it.HasNextMethod(); it.Next()) {
+    const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
+    if (code_item == nullptr) {
+      continue;
     }
-    // Use a scoped object access to perform to the quick SkipClass check.
-    const char* descriptor = dex_file.GetClassDescriptor(class_def);
-    ScopedObjectAccess soa(Thread::Current());
-    StackHandleScope<3> hs(soa.Self());
-    Handle<mirror::ClassLoader> class_loader(
-        hs.NewHandle(soa.Decode<mirror::ClassLoader>(jclass_loader)));
-    Handle<mirror::Class> klass(
-        hs.NewHandle(class_linker->FindClass(soa.Self(), descriptor, class_loader)));
-    Handle<mirror::DexCache> dex_cache;
-    if (klass == nullptr) {
-      soa.Self()->AssertPendingException();
-      soa.Self()->ClearException();
-      dex_cache = hs.NewHandle(class_linker->FindDexCache(soa.Self(), dex_file));
-    } else if (SkipClass(jclass_loader, dex_file, klass.Get())) {
-      return;
-    } else {
-      dex_cache = hs.NewHandle(klass->GetDexCache());
+    const uint32_t method_idx = it.GetMemberIndex();
+    const size_t code_units =
+        CodeItemInstructionAccessor(dex_file, code_item).InsnsSizeInCodeUnits();
+    if (!ShouldCompileBasedOnProfile(MethodReference(&dex_file, method_idx))) {
+      // The method only gets verified and possibly quickened, which is much cheaper.
+      cost += code_units / kUncompiledMethodCostDivisor;
+      continue;
     }
-
-    const uint8_t* class_data = dex_file.GetClassData(class_def);
-    if (class_data == nullptr) {
-      // empty class, probably a marker interface
-      return;
+    cost += code_units;
+    if (profile_compilation_info_ != nullptr) {
+      // Each profiled call site may get a callee of up to the inlining limit inlined. Use the
+      // hotness lookup, which unlike GetMethod() does not allocate.
+      ProfileCompilationInfo::MethodHotness hotness =
+          profile_compilation_info_->GetMethodHotness(MethodReference(&dex_file, method_idx));
+      cost += hotness.GetInlineCacheCount() * compiler_options_->GetInlineMaxCodeUnits();
     }
+  }
+  return cost;
+}
 
-    // Go to native so that we don't block GC during compilation.
-    ScopedThreadSuspension sts(soa.Self(), kNative);
-
-    CompilerDriver* const driver = context.GetCompiler();
-
-    // Can we run DEX-to-DEX compiler on this class ?
-    optimizer::DexToDexCompiler::CompilationLevel dex_to_dex_compilation_level =
-        GetDexToDexCompilationLevel(soa.Self(), *driver, jclass_loader, dex_file, class_def);
-
-    ClassDataItemIterator it(dex_file, class_data);
-    it.SkipAllFields();
+template <typename CompileFn>
+void CompilerDriver::CompileDexFilesByCost(jobject class_loader,
+                                           const std::vector<const DexFile*>& dex_files,
+                                           TimingLogger* timings,
+                                           const char* timing_name,
+                                           CompileFn compile_fn) {
+  TimingLogger::ScopedTiming t(timing_name, timings);
+  ThreadPool* const thread_pool = parallel_thread_pool_.get();
+
+  // Collect the classes of all the dex files and order them by decreasing estimated cost, so that
+  // the largest classes start first instead of ending up as the last tasks of a dex file, with
+  // a single thread busy while the others wait for the next dex file.
+  struct CostedClass {
+    const DexFile* dex_file;
+    uint16_t class_def_index;
+    size_t cost;
+  };
+  std::vector<CostedClass> classes;
+  {
+    TimingLogger::ScopedTiming t2("Estimate compile cost", timings);
+    for (const DexFile* dex_file : dex_files) {
+      CHECK(dex_file != nullptr);
+      for (uint32_t i = 0; i != dex_file->NumClassDefs(); ++i) {
+        const size_t cost = EstimateClassCompileCost(*dex_file, dex_file->GetClassDef(i));
+        classes.push_back(CostedClass { dex_file, dchecked_integral_cast<uint16_t>(i), cost });
+      }
+    }
+    // Keep the dex file order for classes of equal cost.
+    std::stable_sort(classes.begin(),
+                     classes.end(),
+                     [](const CostedClass& lhs, const CostedClass& rhs) {
+                       return lhs.cost > rhs.cost;
+                     });
+  }
 
-    bool compilation_enabled = driver->IsClassToCompile(
-        dex_file.StringByTypeIdx(class_def.class_idx_));
+  ParallelCompilationManager context(Runtime::Current()->GetClassLinker(),
+                                     class_loader,
+                                     this,
+                                     /* dex_file */ nullptr,
+                                     dex_files,
+                                     thread_pool);
 
-    // Compile direct and virtual methods.
-    int64_t previous_method_idx = -1;
-    while (it.HasNextMethod()) {
-      uint32_t method_idx = it.GetMemberIndex();
-      if (method_idx == previous_method_idx) {
-        // smali can create dex files with two encoded_methods sharing the same method_idx
-        // http://code.google.com/p/smali/issues/detail?id=119
-        it.Next();
-        continue;
+  // The workers and the calling thread, which also runs tasks while waiting.
+  const size_t num_threads = thread_pool->GetThreadCount() + 1u;
+  std::unique_ptr<Atomic<uint64_t>[]> busy_ns(new Atomic<uint64_t>[num_threads]);
+  for (size_t i = 0; i != num_threads; ++i) {
+    busy_ns[i].StoreRelaxed(0u);
+  }
+  auto get_thread_index = [thread_pool, num_threads](Thread* self) {
+    const std::vector<ThreadPoolWorker*>& workers = thread_pool->GetWorkers();
+    for (size_t i = 0; i != workers.size(); ++i) {
+      if (workers[i]->GetThread() == self) {
+        return i;
       }
-      previous_method_idx = method_idx;
-      compile_fn(soa.Self(),
-                 driver,
-                 it.GetMethodCodeItem(),
-                 it.GetMethodAccessFlags(),
-                 it.GetMethodInvokeType(class_def),
-                 class_def_index,
-                 method_idx,
-                 class_loader,
-                 dex_file,
-                 dex_to_dex_compilation_level,
-                 compilation_enabled,
-                 dex_cache);
-      it.Next();
     }
-    DCHECK(!it.HasNext());
+    return num_threads - 1u;
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  auto compile = [&](size_t index) {
+    const uint64_t start_ns = NanoTime();
+    const CostedClass& costed_class = classes[index];
+    CompileClass(&context, *costed_class.dex_file, costed_class.class_def_index, compile_fn);
+    busy_ns[get_thread_index(Thread::Current())].FetchAndAddRelaxed(NanoTime() - start_ns);
+  };
+  const uint64_t start_ns = NanoTime();
+  context.ForAllLambdaInOrder(0, classes.size(), compile, parallel_thread_count_);
+  compile_wall_ns_ += NanoTime() - start_ns;
+
+  if (compile_thread_busy_ns_.size() < num_threads) {
+    compile_thread_busy_ns_.resize(num_threads, 0u);
+  }
+  for (size_t i = 0; i != num_threads; ++i) {
+    compile_thread_busy_ns_[i] += busy_ns[i].LoadRelaxed();
+  }
+}
+
+void CompilerDriver::DumpCompileThreadTimes(std::ostream& os) const {
+  if (compile_thread_busy_ns_.empty()) {
+    return;
+  }
+  os << "Compile thread times (wall " << PrettyDuration(compile_wall_ns_) << "):\n";
+  for (size_t i = 0; i != compile_thread_busy_ns_.size(); ++i) {
+    const uint64_t busy = compile_thread_busy_ns_[i];
+    const uint64_t idle = compile_wall_ns_ > busy ? compile_wall_ns_ - busy : 0u;
+    os << "  thread " << i << ": busy " << PrettyDuration(busy)
+       << " idle " << PrettyDuration(idle) << "\n";
+  }
 }
 
 void CompilerDriver::Compile(jobject class_loader,
@@ -2793,21 +3013,35 @@ void CompilerDriver::Compile(jobject class_loader,
   }
 
   dex_to_dex_compiler_.ClearState();
-  for (const DexFile* dex_file : dex_files) {
-    CHECK(dex_file != nullptr);
-    CompileDexFile(this,
-                   class_loader,
-                   *dex_file,
-                   dex_files,
-                   parallel_thread_pool_.get(),
-                   parallel_thread_count_,
-                   timings,
-                   "Compile Dex File Quick",
-                   CompileMethodQuick);
+  if (parallel_thread_count_ > 1u) {
+    // Schedule the classes of all the dex files together. A single thread compiles in dex file
+    // order to keep its output independent of the cost estimates.
+    CompileDexFilesByCost(class_loader,
+                          dex_files,
+                          timings,
+                          "Compile Dex File Quick",
+                          CompileMethodQuick);
     const ArenaPool* const arena_pool = Runtime::Current()->GetArenaPool();
     const size_t arena_alloc = arena_pool->GetBytesAllocated();
     max_arena_alloc_ = std::max(arena_alloc, max_arena_alloc_);
     Runtime::Current()->ReclaimArenaPoolMemory();
+  } else {
+    for (const DexFile* dex_file : dex_files) {
+      CHECK(dex_file != nullptr);
+      CompileDexFile(this,
+                     class_loader,
+                     *dex_file,
+                     dex_files,
+                     parallel_thread_pool_.get(),
+                     parallel_thread_count_,
+                     timings,
+                     "Compile Dex File Quick",
+                     CompileMethodQuick);
+      const ArenaPool* const arena_pool = Runtime::Current()->GetArenaPool();
+      const size_t arena_alloc = arena_pool->GetBytesAllocated();
+      max_arena_alloc_ = std::max(arena_alloc, max_arena_alloc_);
+      Runtime::Current()->ReclaimArenaPoolMemory();
+    }
   }
 
   if (dex_to_dex_compiler_.NumCodeItemsToQuicken(Thread::Current()) > 0u) {
@@ -2827,6 +3061,10 @@ void CompilerDriver::Compile(jobject class_loader,
     dex_to_dex_compiler_.ClearState();
   }
 
+  if (has_input_oat_file_) {
+    VLOG(compiler) << "Reused " << num_reused_methods_.LoadRelaxed()
+                   << " compiled methods from the input oat file";
+  }
   VLOG(compiler) << "Compile: " << GetMemoryUsageString(false);
 }
 
@@ -3008,8 +3246,14 @@ bool CompilerDriver::MayInlineInternal(const DexFile* inlined_from,
 
 void CompilerDriver::InitializeThreadPools() {
   size_t parallel_count = parallel_thread_count_ > 0 ? parallel_thread_count_ - 1 : 0;
-  parallel_thread_pool_.reset(
-      new ThreadPool("Compiler driver thread pool", parallel_count));
+  // Only use work stealing with several threads. With none, the tasks split by ForAllLambda
+  // would run out of order.
+  if (parallel_count > 0) {
+    parallel_thread_pool_.reset(
+        new WorkStealingThreadPool("Compiler driver thread pool", parallel_count));
+  } else {
+    parallel_thread_pool_.reset(new ThreadPool("Compiler driver thread pool", parallel_count));
+  }
   single_thread_pool_.reset(new ThreadPool("Single-threaded Compiler driver thread pool", 0));
 }
 
@@ -3028,4 +3272,105 @@ void CompilerDriver::SetClasspathDexFiles(const std::vector<const DexFile*>& dex
   classpath_classes_.AddDexFiles(dex_files);
 }
 
+void CompilerDriver::SetInputOatFile(const OatFile* input_oat_file) {
+  DCHECK(input_oat_file != nullptr);
+  DCHECK(!has_input_oat_file_);
+  has_input_oat_file_ = true;
+  const size_t num_dex_files = dex_files_for_oat_file_.size();
+  std::vector<const OatFile::OatDexFile*> oat_dex_files(num_dex_files, nullptr);
+  std::vector<bool> changed(num_dex_files, true);
+  std::unordered_map<std::string, size_t> defining_dex_files;
+  for (size_t i = 0; i != num_dex_files; ++i) {
+    const DexFile* dex_file = dex_files_for_oat_file_[i];
+    oat_dex_files[i] = input_oat_file->GetOatDexFile(dex_file->GetLocation().c_str(),
+                                                     /* dex_location_checksum */ nullptr);
+    changed[i] = oat_dex_files[i] == nullptr ||
+        oat_dex_files[i]->GetDexFileLocationChecksum() != dex_file->GetLocationChecksum();
+    for (uint32_t j = 0; j != dex_file->NumClassDefs(); ++j) {
+      defining_dex_files.emplace(dex_file->GetClassDescriptor(dex_file->GetClassDef(j)), i);
+    }
+  }
+  // Compiled code depends on the layout of the classes it uses, such as field offsets and vtable
+  // indexes, which in turn depends on their superclasses. Consider a dex file changed if it refers
+  // to any class defined in a changed dex file, until no more dex files change.
+  bool updated = true;
+  while (updated) {
+    updated = false;
+    for (size_t i = 0; i != num_dex_files; ++i) {
+      if (changed[i]) {
+        continue;
+      }
+      const DexFile* dex_file = dex_files_for_oat_file_[i];
+      for (uint32_t j = 0; j != dex_file->NumTypeIds(); ++j) {
+        auto it = defining_dex_files.find(dex_file->StringByTypeIdx(dex::TypeIndex(j)));
+        if (it != defining_dex_files.end() && changed[it->second]) {
+          changed[i] = true;
+          updated = true;
+          break;
+        }
+      }
+    }
+  }
+  for (size_t i = 0; i != num_dex_files; ++i) {
+    if (!changed[i]) {
+      reusable_oat_dex_files_.Put(dex_files_for_oat_file_[i], oat_dex_files[i]);
+    }
+  }
+  VLOG(compiler) << "Reusing compiled code of " << reusable_oat_dex_files_.size() << " of "
+                 << num_dex_files << " dex files from " << input_oat_file->GetLocation();
+}
+
+CompiledMethod* CompilerDriver::ReuseCompiledMethod(const DexFile& dex_file,
+                                                    uint16_t class_def_idx,
+                                                    uint32_t method_idx) {
+  auto oat_dex_file_it = reusable_oat_dex_files_.find(&dex_file);
+  if (oat_dex_file_it == reusable_oat_dex_files_.end() ||
+      !oat_dex_file_it->second->IsReusableMethod(method_idx)) {
+    return nullptr;
+  }
+  // Find the index of the method in the class data, as used by the OatClass.
+  const uint8_t* class_data = dex_file.GetClassData(dex_file.GetClassDef(class_def_idx));
+  DCHECK(class_data != nullptr);
+  ClassDataItemIterator it(dex_file, class_data);
+  it.SkipAllFields();
+  uint32_t class_method_index = 0u;
+  for (; it.HasNextMethod() && it.GetMemberIndex() != method_idx; it.Next()) {
+    ++class_method_index;
+  }
+  DCHECK(it.HasNextMethod());
+  const OatFile::OatMethod oat_method =
+      oat_dex_file_it->second->GetOatClass(class_def_idx).GetOatMethod(class_method_index);
+  const OatQuickMethodHeader* method_header = oat_method.GetOatQuickMethodHeader();
+  if (method_header == nullptr || method_header->GetCodeSize() == 0u) {
+    return nullptr;
+  }
+  ArrayRef<const uint8_t> vmap_table;
+  if (method_header->GetVmapTableOffset() != 0u) {
+    const uint8_t* data =
+        reinterpret_cast<const uint8_t*>(method_header->GetOptimizedCodeInfoPtr());
+    CodeInfoEncoding encoding(data);
+    vmap_table = ArrayRef<const uint8_t>(data, encoding.HeaderSize() + encoding.NonHeaderSize());
+  }
+  ArrayRef<const uint8_t> method_info;
+  if (method_header->GetMethodInfoOffset() != 0u) {
+    const uint8_t* data =
+        reinterpret_cast<const uint8_t*>(method_header->GetOptimizedMethodInfoPtr());
+    const size_t size = MethodInfo::ComputeSize(MethodInfo(data).NumMethodIndices());
+    method_info = ArrayRef<const uint8_t>(data, size);
+  }
+  const QuickMethodFrameInfo frame_info = method_header->GetFrameInfo();
+  num_reused_methods_.FetchAndAddRelaxed(1u);
+  return CompiledMethod::SwapAllocCompiledMethod(
+      this,
+      GetInstructionSet(),
+      ArrayRef<const uint8_t>(method_header->GetCode(), method_header->GetCodeSize()),
+      frame_info.FrameSizeInBytes(),
+      frame_info.CoreSpillMask(),
+      frame_info.FpSpillMask(),
+      method_info,
+      vmap_table,
+      /* cfi_info */ ArrayRef<const uint8_t>(),
+      /* patches */ ArrayRef<const linker::LinkerPatch>());
+}
+
 }  // namespace art
@@ -41,6 +41,7 @@
 #include "dex/dex_to_dex_compiler.h"
 #include "dex/method_reference.h"
 #include "driver/compiled_method_storage.h"
+#include "oat_file.h"
 #include "thread_pool.h"
 #include "utils/atomic_dex_ref_map.h"
 #include "utils/dex_cache_arrays_layout.h"
@@ -114,6 +115,17 @@ class CompilerDriver {
   // Set dex files classpath.
   void SetClasspathDexFiles(const std::vector<const DexFile*>& dex_files);
 
+  // Set an oat file previously compiled from the dex files for the oat file, with the same
+  // options, to copy the compiled code of unchanged methods from. Must be called after
+  // SetDexFilesForOatFile(). The oat file must outlive the compilation.
+  void SetInputOatFile(const OatFile* input_oat_file);
+
+  // Return a copy of the compiled code of the method from the input oat file, or null if the
+  // method or any dex file it may depend on changed, or its code is not reusable.
+  CompiledMethod* ReuseCompiledMethod(const DexFile& dex_file,
+                                      uint16_t class_def_idx,
+                                      uint32_t method_idx);
+
   // Get dex files associated with the the oat file being compiled.
   ArrayRef<const DexFile* const> GetDexFilesForOatFile() const {
     return ArrayRef<const DexFile* const>(dex_files_for_oat_file_);
@@ -338,6 +350,9 @@ class CompilerDriver {
   // Get memory usage during compilation.
   std::string GetMemoryUsageString(bool extended) const;
 
+  // Dump the busy and idle time of each thread that compiled methods, for --dump-timings.
+  void DumpCompileThreadTimes(std::ostream& os) const;
+
   void SetHadHardVerifierFailure() {
     had_hard_verifier_failure_ = true;
   }
@@ -457,6 +472,19 @@ class CompilerDriver {
                const std::vector<const DexFile*>& dex_files,
                TimingLogger* timings);
 
+  // Compile the classes of all the dex files with the parallel thread pool, largest estimated
+  // compile cost first.
+  template <typename CompileFn>
+  void CompileDexFilesByCost(jobject class_loader,
+                             const std::vector<const DexFile*>& dex_files,
+                             TimingLogger* timings,
+                             const char* timing_name,
+                             CompileFn compile_fn);
+
+  // Estimate the cost of compiling the methods of a class, in dex code units.
+  size_t EstimateClassCompileCost(const DexFile& dex_file,
+                                  const DexFile::ClassDef& class_def) const;
+
   bool MayInlineInternal(const DexFile* inlined_from, const DexFile* inlined_into) const;
 
   void InitializeThreadPools();
@@ -533,6 +561,15 @@ class CompilerDriver {
   // List of dex files associates with the oat file.
   std::vector<const DexFile*> dex_files_for_oat_file_;
 
+  // Whether an input oat file was set, even if none of its compiled code can be reused.
+  bool has_input_oat_file_;
+
+  // The input oat file entries of the dex files whose compiled code can be reused.
+  SafeMap<const DexFile*, const OatFile::OatDexFile*> reusable_oat_dex_files_;
+
+  // Number of methods copied from the input oat file.
+  Atomic<size_t> num_reused_methods_;
+
   CompiledMethodStorage compiled_method_storage_;
 
   // Info for profile guided compilation.
@@ -540,6 +577,15 @@ class CompilerDriver {
 
   size_t max_arena_alloc_;
 
+  // Time spent compiling classes by each thread of the cost-ordered compilation, and the wall
+  // time of that compilation. The last entry is the thread running the compilation.
+  std::vector<uint64_t> compile_thread_busy_ns_;
+  uint64_t compile_wall_ns_;
+
+  // Methods the profile filter excludes from compilation only get verified and quickened. Their
+  // code units count for this fraction of a compiled method's.
+  static constexpr size_t kUncompiledMethodCostDivisor = 8;
+
   // Compiler for dex to dex (quickening).
   optimizer::DexToDexCompiler dex_to_dex_compiler_;
 
@@ -18,10 +18,13 @@
 
 #include <limits>
 
+#include "art_field-inl.h"
+#include "art_method-inl.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "induction_var_range.h"
 #include "nodes.h"
+#include "scoped_thread_state_change-inl.h"
 #include "side_effects_analysis.h"
 
 namespace art {
@@ -509,7 +512,8 @@ class BCEVisitor : public HGraphVisitor {
 
   BCEVisitor(HGraph* graph,
              const SideEffectsAnalysis& side_effects,
-             HInductionVarAnalysis* induction_analysis)
+             HInductionVarAnalysis* induction_analysis,
+             OptimizingCompilerStats* stats)
       : HGraphVisitor(graph),
         allocator_(graph->GetArenaStack()),
         maps_(graph->GetBlocks().size(),
@@ -524,11 +528,17 @@ class BCEVisitor : public HGraphVisitor {
         taken_test_loop_(std::less<uint32_t>(),
                          allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
         finite_loop_(allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
+        invariant_field_loads_(allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
+        visited_field_loads_(allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
+        visited_array_lengths_(allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
         has_dom_based_dynamic_bce_(false),
         initial_block_size_(graph->GetBlocks().size()),
         side_effects_(side_effects),
         induction_range_(induction_analysis),
-        next_(nullptr) {}
+        stats_(stats),
+        next_(nullptr) {
+    FindInvariantFieldLoads();
+  }
 
   void VisitBasicBlock(HBasicBlock* block) OVERRIDE {
     DCHECK(!IsAddedBlock(block));
@@ -567,6 +577,63 @@ class BCEVisitor : public HGraphVisitor {
   }
 
  private:
+  /**
+   * Collects the loads of final fields whose value cannot change while this graph executes.
+   * The field must not be volatile or stored to anywhere in the graph (which covers inlined
+   * constructors), and its object must not be allocated in the graph, since a constructor
+   * call that has not been inlined may still initialize the field. Final fields of the
+   * receiver may be assigned repeatedly while compiling a constructor, so none is collected
+   * in that case.
+   */
+  void FindInvariantFieldLoads() {
+    ScopedArenaSet<uint32_t> stored_offsets(allocator_.Adapter(kArenaAllocBoundsCheckElimination));
+    ScopedArenaVector<HInstanceFieldGet*> loads(
+        allocator_.Adapter(kArenaAllocBoundsCheckElimination));
+    for (HBasicBlock* block : GetGraph()->GetReversePostOrder()) {
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        HInstruction* instruction = it.Current();
+        if (instruction->IsUnresolvedInstanceFieldSet()) {
+          // Any field may be stored to.
+          return;
+        } else if (instruction->IsInstanceFieldSet()) {
+          stored_offsets.insert(instruction->AsInstanceFieldSet()->GetFieldOffset().Uint32Value());
+        } else if (instruction->IsInstanceFieldGet()) {
+          HInstanceFieldGet* load = instruction->AsInstanceFieldGet();
+          if (load->GetFieldInfo().GetField() != nullptr &&
+              !load->IsVolatile() &&
+              !GetObject(load)->IsNewInstance()) {
+            loads.push_back(load);
+          }
+        }
+      }
+    }
+    if (loads.empty()) {
+      return;
+    }
+    ScopedObjectAccess soa(Thread::Current());
+    ArtMethod* method = GetGraph()->GetArtMethod();
+    if (method != nullptr && method->IsConstructor()) {
+      return;
+    }
+    for (HInstanceFieldGet* load : loads) {
+      if (load->GetFieldInfo().GetField()->IsFinal() &&
+          stored_offsets.find(load->GetFieldOffset().Uint32Value()) == stored_offsets.end()) {
+        invariant_field_loads_.insert(load->GetId());
+      }
+    }
+  }
+
+  /** Returns the object that a field or array length is read from, past its null check. */
+  static HInstruction* GetObject(HInstruction* instruction) {
+    HInstruction* object = instruction->InputAt(0);
+    return object->IsNullCheck() ? object->InputAt(0) : object;
+  }
+
+  bool IsInvariantFieldLoad(HInstruction* instruction) const {
+    return instruction->IsInstanceFieldGet() &&
+           invariant_field_loads_.find(instruction->GetId()) != invariant_field_loads_.end();
+  }
+
   // Return the map of proven value ranges at the beginning of a basic block.
   ScopedArenaSafeMap<int, ValueRange*>* GetValueRangeMap(HBasicBlock* basic_block) {
     if (IsAddedBlock(basic_block)) {
@@ -1225,6 +1292,71 @@ class BCEVisitor : public HGraphVisitor {
     }
   }
 
+  /**
+   * Replaces a load of an invariant final field (see FindInvariantFieldLoads()) by a
+   * dominating load of the same field from the same object. This way, range facts on
+   * the array length of the earlier load also hold for the later one, even across calls
+   * or inlined helpers that global value numbering must assume to clobber the heap. An
+   * invariant load that remains inside a loop whose object is defined outside of it is
+   * hoisted to the preheader, which exposes loops bounded by object fields
+   *
+   * for (int i = 0; i < this.size; i++) {
+   *   this.elements[i] = 0;
+   * }
+   *
+   * to loop-based dynamic bce.
+   */
+  void VisitInstanceFieldGet(HInstanceFieldGet* field_get) OVERRIDE {
+    if (!IsInvariantFieldLoad(field_get)) {
+      return;
+    }
+    HInstruction* object = GetObject(field_get);
+    uint32_t offset = field_get->GetFieldOffset().Uint32Value();
+    for (HInstanceFieldGet* other : visited_field_loads_) {
+      if (other->IsInBlock() &&
+          GetObject(other) == object &&
+          other->GetFieldOffset().Uint32Value() == offset &&
+          other->StrictlyDominates(field_get)) {
+        ReplaceInstruction(field_get, other);
+        return;
+      }
+    }
+    visited_field_loads_.push_back(field_get);
+    if (field_get->IsInLoop()) {
+      // A final field of a non-null object can be loaded speculatively.
+      HLoopInformation* loop = field_get->GetBlock()->GetLoopInformation();
+      if (!loop->ContainsIrreducibleLoop() &&
+          loop->IsDefinedOutOfTheLoop(field_get->InputAt(0))) {
+        HoistToPreHeaderOrDeoptBlock(loop, field_get);
+        if (DataType::IsIntegralType(field_get->GetType())) {
+          // The load may now act as a loop invariant bound.
+          induction_range_.ReVisit(loop);
+        }
+      }
+    }
+  }
+
+  /**
+   * Replaces the length of an array held in an invariant final field by a dominating
+   * length of the same array, so that ranges already proven for the latter apply.
+   */
+  void VisitArrayLength(HArrayLength* array_length) OVERRIDE {
+    HInstruction* array = GetObject(array_length);
+    if (!IsInvariantFieldLoad(array)) {
+      return;
+    }
+    for (HArrayLength* other : visited_array_lengths_) {
+      if (other->IsInBlock() &&
+          GetObject(other) == array &&
+          other->IsStringLength() == array_length->IsStringLength() &&
+          other->StrictlyDominates(array_length)) {
+        ReplaceInstruction(array_length, other);
+        return;
+      }
+    }
+    visited_array_lengths_.push_back(array_length);
+  }
+
   /**
     * After null/bounds checks are eliminated, some invariant array references
     * may be exposed underneath which can be hoisted out of the loop to the
@@ -1373,6 +1505,7 @@ class BCEVisitor : public HGraphVisitor {
           // bounds check twice if it occurred multiple times in the use list.
           if (other_bounds_check->IsInBlock()) {
             ReplaceInstruction(other_bounds_check, other_bounds_check->InputAt(0));
+            MaybeRecordStat(stats_, MethodCompilationStat::kRemovedBoundsCheckWithDeoptimization);
           }
         }
       }
@@ -1496,6 +1629,7 @@ class BCEVisitor : public HGraphVisitor {
                 other_bounds_check, other_index, GetGraph(), block, &min_lower, &min_upper);
           }
           ReplaceInstruction(other_bounds_check, other_index);
+          MaybeRecordStat(stats_, MethodCompilationStat::kRemovedBoundsCheckWithDeoptimization);
         }
       }
       // In code, using unsigned comparisons:
@@ -1920,6 +2054,13 @@ class BCEVisitor : public HGraphVisitor {
   // Finite loop bookkeeping.
   ScopedArenaSet<uint32_t> finite_loop_;
 
+  // Ids of the loads of final fields that are invariant in the graph.
+  ScopedArenaSet<int> invariant_field_loads_;
+
+  // Invariant field loads and the array lengths read from them, in visiting order.
+  ScopedArenaVector<HInstanceFieldGet*> visited_field_loads_;
+  ScopedArenaVector<HArrayLength*> visited_array_lengths_;
+
   // Flag that denotes whether dominator-based dynamic elimination has occurred.
   bool has_dom_based_dynamic_bce_;
 
@@ -1932,12 +2073,27 @@ class BCEVisitor : public HGraphVisitor {
   // Range analysis based on induction variables.
   InductionVarRange induction_range_;
 
+  // Compiler statistics, may be null.
+  OptimizingCompilerStats* const stats_;
+
   // Safe iteration.
   HInstruction* next_;
 
   DISALLOW_COPY_AND_ASSIGN(BCEVisitor);
 };
 
+static size_t CountBoundsChecks(HGraph* graph) {
+  size_t count = 0u;
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (it.Current()->IsBoundsCheck()) {
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
 void BoundsCheckElimination::Run() {
   if (!graph_->HasBoundsChecks()) {
     return;
@@ -1948,7 +2104,9 @@ void BoundsCheckElimination::Run() {
   // be bounded by a range at one instruction, it must be true that all uses of
   // that value dominated by that instruction fits in that range. Range of that
   // value can be narrowed further down in the dominator tree.
-  BCEVisitor visitor(graph_, side_effects_, induction_analysis_);
+  const size_t initial_bounds_checks = (stats_ != nullptr) ? CountBoundsChecks(graph_) : 0u;
+
+  BCEVisitor visitor(graph_, side_effects_, induction_analysis_, stats_);
   for (size_t i = 0, size = graph_->GetReversePostOrder().size(); i != size; ++i) {
     HBasicBlock* current = graph_->GetReversePostOrder()[i];
     if (visitor.IsAddedBlock(current)) {
@@ -1968,6 +2126,15 @@ void BoundsCheckElimination::Run() {
 
   // Perform cleanup.
   visitor.Finish();
+
+  if (stats_ != nullptr) {
+    const size_t remaining_bounds_checks = CountBoundsChecks(graph_);
+    DCHECK_LE(remaining_bounds_checks, initial_bounds_checks);
+    MaybeRecordStat(stats_,
+                    MethodCompilationStat::kRemovedBoundsCheck,
+                    initial_bounds_checks - remaining_bounds_checks);
+    MaybeRecordStat(stats_, MethodCompilationStat::kRemainingBoundsCheck, remaining_bounds_checks);
+  }
 }
 
 }  // namespace art
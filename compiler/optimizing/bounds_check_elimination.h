@@ -29,8 +29,9 @@ class BoundsCheckElimination : public HOptimization {
   BoundsCheckElimination(HGraph* graph,
                          const SideEffectsAnalysis& side_effects,
                          HInductionVarAnalysis* induction_analysis,
+                         OptimizingCompilerStats* stats = nullptr,
                          const char* name = kBoundsCheckEliminationPassName)
-      : HOptimization(graph, name),
+      : HOptimization(graph, name, stats),
         side_effects_(side_effects),
         induction_analysis_(induction_analysis) {}
 
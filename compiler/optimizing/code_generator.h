@@ -374,6 +374,15 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
     return requires_current_method_;
   }
 
+  // Whether the generated code increments the hotness count of the method
+  // on entry and on loop back edges.
+  bool CountsHotness() const {
+    return GetCompilerOptions().CountHotnessInCompiledCode() || GetGraph()->IsCompilingBaseline();
+  }
+
+  // Hotness count at which baseline code asks the JIT for an optimized compilation.
+  static uint16_t GetBaselineHotnessThreshold();
+
   // Clears the spill slots taken by loop phis in the `LocationSummary` of the
   // suspend check. This is called when the code generator generates code
   // for the suspend check at the back edge (instead of where the suspend check
@@ -537,7 +546,8 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
       HInvokeStaticOrDirect* invoke, Location temp, SlowPathCode* slow_path);
   void GenerateInvokeUnresolvedRuntimeCall(HInvokeUnresolved* invoke);
 
-  void GenerateInvokePolymorphicCall(HInvokePolymorphic* invoke);
+  void GenerateInvokePolymorphicCall(HInvokePolymorphic* invoke,
+                                     SlowPathCode* slow_path = nullptr);
 
   void CreateUnresolvedFieldLocationSummary(
       HInstruction* field_access,
@@ -558,6 +568,10 @@ class CodeGenerator : public DeletableArenaObject<kArenaAllocCodeGenerator> {
 
   static void CreateSystemArrayCopyLocationSummary(HInvoke* invoke);
 
+  // Place the arguments of `instruction` in the outgoing arguments area, where the
+  // StringBuilderAppend entrypoint expects them, and the result in `out`.
+  void CreateStringBuilderAppendLocations(HStringBuilderAppend* instruction, Location out);
+
   void SetDisassemblyInformation(DisassemblyInformation* info) { disasm_info_ = info; }
   DisassemblyInformation* GetDisassemblyInformation() const { return disasm_info_; }
 
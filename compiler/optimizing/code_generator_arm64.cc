@@ -775,8 +775,7 @@ class LoadReferenceWithBakerReadBarrierSlowPathARM64 : public ReadBarrierMarkSlo
            instruction_->IsArraySet() ||
            instruction_->IsInstanceOf() ||
            instruction_->IsCheckCast() ||
-           (instruction_->IsInvokeVirtual() && instruction_->GetLocations()->Intrinsified()) ||
-           (instruction_->IsInvokeStaticOrDirect() && instruction_->GetLocations()->Intrinsified()))
+           (instruction_->IsInvoke() && instruction_->GetLocations()->Intrinsified()))
         << "Unexpected instruction in read barrier marking slow path: "
         << instruction_->DebugName();
     // The read barrier instrumentation of object ArrayGet
@@ -931,12 +930,16 @@ class LoadReferenceWithBakerReadBarrierAndUpdateFieldSlowPathARM64
     DCHECK(obj_.IsW());
     DCHECK_NE(ref_.reg(), LocationFrom(temp_).reg());
 
-    // This slow path is only used by the UnsafeCASObject intrinsic at the moment.
-    DCHECK((instruction_->IsInvokeVirtual() && instruction_->GetLocations()->Intrinsified()))
+    // This slow path is only used by the UnsafeCASObject and VarHandleCompareAndSet
+    // intrinsics at the moment.
+    DCHECK(((instruction_->IsInvokeVirtual() || instruction_->IsInvokePolymorphic()) &&
+            instruction_->GetLocations()->Intrinsified()))
         << "Unexpected instruction in read barrier marking and field updating slow path: "
         << instruction_->DebugName();
     DCHECK(instruction_->GetLocations()->Intrinsified());
-    DCHECK_EQ(instruction_->AsInvoke()->GetIntrinsic(), Intrinsics::kUnsafeCASObject);
+    DCHECK(instruction_->AsInvoke()->GetIntrinsic() == Intrinsics::kUnsafeCASObject ||
+           instruction_->AsInvoke()->GetIntrinsic() == Intrinsics::kVarHandleCompareAndSet)
+        << instruction_->AsInvoke()->GetIntrinsic();
     DCHECK_EQ(offset_, 0u);
     DCHECK_EQ(scale_factor_, 0u);
     DCHECK_EQ(use_load_acquire_, false);
@@ -1488,7 +1491,7 @@ void CodeGeneratorARM64::GenerateFrameEntry() {
   MacroAssembler* masm = GetVIXLAssembler();
   __ Bind(&frame_entry_label_);
 
-  if (GetCompilerOptions().CountHotnessInCompiledCode()) {
+  if (CountsHotness()) {
     UseScratchRegisterScope temps(masm);
     Register temp = temps.AcquireX();
     __ Ldrh(temp, MemOperand(kArtMethodRegister, ArtMethod::HotnessCountOffset().Int32Value()));
@@ -1543,6 +1546,27 @@ void CodeGeneratorARM64::GenerateFrameEntry() {
     }
   }
 
+  if (GetGraph()->IsCompilingBaseline()) {
+    // Once hot, ask the JIT for an optimized version of this method. The entrypoint
+    // preserves all registers and finds the current method on the stack; `lr` has
+    // been spilled above as baseline methods are never leaf methods.
+    DCHECK(!HasEmptyFrame());
+    DCHECK(RequiresCurrentMethod());
+    vixl::aarch64::Label done;
+    {
+      UseScratchRegisterScope temps(masm);
+      Register temp = temps.AcquireW();
+      __ Ldrh(temp, MemOperand(kArtMethodRegister, ArtMethod::HotnessCountOffset().Int32Value()));
+      __ Cmp(temp, GetBaselineHotnessThreshold());
+      __ B(lo, &done);
+    }
+    int32_t entry_point_offset =
+        GetThreadOffset<kArm64PointerSize>(kQuickCompileOptimized).Int32Value();
+    __ Ldr(lr, MemOperand(tr, entry_point_offset));
+    __ Blr(lr);
+    __ Bind(&done);
+  }
+
   MaybeGenerateMarkingRegisterCheck(/* code */ __LINE__);
 }
 
@@ -3517,7 +3541,7 @@ void InstructionCodeGeneratorARM64::HandleGoto(HInstruction* got, HBasicBlock* s
   HLoopInformation* info = block->GetLoopInformation();
 
   if (info != nullptr && info->IsBackEdge(*block) && info->HasSuspendCheck()) {
-    if (codegen_->GetCompilerOptions().CountHotnessInCompiledCode()) {
+    if (codegen_->CountsHotness()) {
       UseScratchRegisterScope temps(GetVIXLAssembler());
       Register temp1 = temps.AcquireX();
       Register temp2 = temps.AcquireX();
@@ -4551,10 +4575,20 @@ void CodeGeneratorARM64::GenerateVirtualCall(
 }
 
 void LocationsBuilderARM64::VisitInvokePolymorphic(HInvokePolymorphic* invoke) {
+  IntrinsicLocationsBuilderARM64 intrinsic(GetGraph()->GetAllocator(), codegen_);
+  if (intrinsic.TryDispatch(invoke)) {
+    return;
+  }
+
   HandleInvoke(invoke);
 }
 
 void InstructionCodeGeneratorARM64::VisitInvokePolymorphic(HInvokePolymorphic* invoke) {
+  if (TryGenerateIntrinsicCode(invoke, codegen_)) {
+    codegen_->MaybeGenerateMarkingRegisterCheck(/* code */ __LINE__);
+    return;
+  }
+
   codegen_->GenerateInvokePolymorphicCall(invoke);
   codegen_->MaybeGenerateMarkingRegisterCheck(/* code */ __LINE__);
 }
@@ -5244,6 +5278,18 @@ void InstructionCodeGeneratorARM64::VisitNewArray(HNewArray* instruction) {
   codegen_->MaybeGenerateMarkingRegisterCheck(/* code */ __LINE__);
 }
 
+void LocationsBuilderARM64::VisitStringBuilderAppend(HStringBuilderAppend* instruction) {
+  codegen_->CreateStringBuilderAppendLocations(instruction, LocationFrom(x0));
+}
+
+void InstructionCodeGeneratorARM64::VisitStringBuilderAppend(HStringBuilderAppend* instruction) {
+  InvokeRuntimeCallingConvention calling_convention;
+  __ Mov(calling_convention.GetRegisterAt(0).W(), instruction->GetFormat()->GetValue());
+  codegen_->InvokeRuntime(kQuickStringBuilderAppend, instruction, instruction->GetDexPc());
+  CheckEntrypointTypes<kQuickStringBuilderAppend, void*, uint32_t>();
+  codegen_->MaybeGenerateMarkingRegisterCheck(/* code */ __LINE__);
+}
+
 void LocationsBuilderARM64::VisitNewInstance(HNewInstance* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(
       instruction, LocationSummary::kCallOnMainOnly);
@@ -6327,12 +6373,14 @@ void CodeGeneratorARM64::GenerateRawReferenceLoad(HInstruction* instruction,
     // UnsafeGetObject/UnsafeGetObjectVolatile and UnsafeCASObject
     // intrinsics.
     if (use_load_acquire) {
-      // UnsafeGetObjectVolatile intrinsic case.
+      // UnsafeGetObjectVolatile, VarHandleGetAcquire and VarHandleGetVolatile intrinsics case.
       // Register `index` is not an index in an object array, but an
       // offset to an object reference field within object `obj`.
       DCHECK(instruction->IsInvoke()) << instruction->DebugName();
       DCHECK(instruction->GetLocations()->Intrinsified());
-      DCHECK(instruction->AsInvoke()->GetIntrinsic() == Intrinsics::kUnsafeGetObjectVolatile)
+      DCHECK(instruction->AsInvoke()->GetIntrinsic() == Intrinsics::kUnsafeGetObjectVolatile ||
+             instruction->AsInvoke()->GetIntrinsic() == Intrinsics::kVarHandleGetAcquire ||
+             instruction->AsInvoke()->GetIntrinsic() == Intrinsics::kVarHandleGetVolatile)
           << instruction->AsInvoke()->GetIntrinsic();
       DCHECK_EQ(offset, 0u);
       DCHECK_EQ(scale_factor, 0u);
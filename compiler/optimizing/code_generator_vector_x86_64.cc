@@ -25,6 +25,15 @@ namespace x86_64 {
 // NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
 #define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
 
+// Helper to determine whether a vector operation works on 256-bit ymm registers (AVX2),
+// rather than on 128-bit xmm registers (SSE). The loop optimizer uses one vector size
+// per method, so all vector operations of a graph agree on this.
+static bool IsYmmVector(HVecOperation* instruction) {
+  size_t size = instruction->GetVectorNumberOfBytes();
+  DCHECK(size == 16u || size == 32u) << size;
+  return size == 32u;
+}
+
 void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
   HInstruction* input = instruction->InputAt(0);
@@ -57,10 +66,11 @@ void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instru
 void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
 
-  // Shorthand for any type of zero.
+  // Shorthand for any type of zero. Note that the VEX encoding also clears the upper half.
   if (IsZeroBitPattern(instruction->InputAt(0))) {
-    __ xorps(dst, dst);
+    is_ymm ? __ vxorps(dst, dst, dst, kVexLength128) : __ xorps(dst, dst);
     return;
   }
 
@@ -68,38 +78,40 @@ void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
-      __ punpcklbw(dst, dst);
-      __ punpcklwd(dst, dst);
-      __ pshufd(dst, dst, Immediate(0));
+      if (is_ymm) {
+        __ vpbroadcastb(dst, dst, kVexLength256);
+      } else {
+        __ punpcklbw(dst, dst);
+        __ punpcklwd(dst, dst);
+        __ pshufd(dst, dst, Immediate(0));
+      }
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
-      __ punpcklwd(dst, dst);
-      __ pshufd(dst, dst, Immediate(0));
+      if (is_ymm) {
+        __ vpbroadcastw(dst, dst, kVexLength256);
+      } else {
+        __ punpcklwd(dst, dst);
+        __ pshufd(dst, dst, Immediate(0));
+      }
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
-      __ pshufd(dst, dst, Immediate(0));
+      is_ymm ? __ vpbroadcastd(dst, dst, kVexLength256) : __ pshufd(dst, dst, Immediate(0));
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ true);
-      __ punpcklqdq(dst, dst);
+      is_ymm ? __ vpbroadcastq(dst, dst, kVexLength256) : __ punpcklqdq(dst, dst);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       DCHECK(locations->InAt(0).Equals(locations->Out()));
-      __ shufps(dst, dst, Immediate(0));
+      is_ymm ? __ vbroadcastss(dst, dst, kVexLength256) : __ shufps(dst, dst, Immediate(0));
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
       DCHECK(locations->InAt(0).Equals(locations->Out()));
-      __ shufpd(dst, dst, Immediate(0));
+      is_ymm ? __ vbroadcastsd(dst, dst, kVexLength256) : __ shufpd(dst, dst, Immediate(0));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -134,6 +146,7 @@ void LocationsBuilderX86_64::VisitVecExtractScalar(HVecExtractScalar* instructio
 void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  // Lane 0 is in the low xmm half of both 128-bit and 256-bit vectors.
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -143,17 +156,13 @@ void InstructionCodeGeneratorX86_64::VisitVecExtractScalar(HVecExtractScalar* in
       LOG(FATAL) << "Unsupported SIMD type";
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ false);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
       __ movd(locations->Out().AsRegister<CpuRegister>(), src, /*64-bit*/ true);
       break;
     case DataType::Type::kFloat32:
     case DataType::Type::kFloat64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 4u);
       DCHECK(locations->InAt(0).Equals(locations->Out()));  // no code required
       break;
     default:
@@ -198,9 +207,29 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsYmmVector(instruction)) {
+    // Fold the upper 128-bit half into the lower one, then reduce as a 128-bit vector.
+    __ vextracti128(dst, src, Immediate(1));
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kInt32:
+        switch (instruction->GetKind()) {
+          case HVecReduce::kSum: __ vpaddd(dst, dst, src, kVexLength128); break;
+          case HVecReduce::kMin: __ vpminsd(dst, dst, src, kVexLength128); break;
+          case HVecReduce::kMax: __ vpmaxsd(dst, dst, src, kVexLength128); break;
+        }
+        break;
+      case DataType::Type::kInt64:
+        DCHECK_EQ(instruction->GetKind(), HVecReduce::kSum);
+        __ vpaddq(dst, dst, src, kVexLength128);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type";
+        UNREACHABLE();
+    }
+    src = dst;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       switch (instruction->GetKind()) {
         case HVecReduce::kSum:
           __ movaps(dst, src);
@@ -230,7 +259,6 @@ void InstructionCodeGeneratorX86_64::VisitVecReduce(HVecReduce* instruction) {
       }
       break;
     case DataType::Type::kInt64: {
-      DCHECK_EQ(2u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
       switch (instruction->GetKind()) {
         case HVecReduce::kSum:
@@ -262,8 +290,7 @@ void InstructionCodeGeneratorX86_64::VisitVecCnv(HVecCnv* instruction) {
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
   if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
-    DCHECK_EQ(4u, instruction->GetVectorLength());
-    __ cvtdq2ps(dst, src);
+    IsYmmVector(instruction) ? __ vcvtdq2ps(dst, src, kVexLength256) : __ cvtdq2ps(dst, src);
   } else {
     LOG(FATAL) << "Unsupported SIMD type";
   }
@@ -277,38 +304,63 @@ void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pxor(dst, dst);
-      __ psubb(dst, src);
+      if (is_ymm) {
+        __ vpxor(dst, dst, dst, kVexLength256);
+        __ vpsubb(dst, dst, src, kVexLength256);
+      } else {
+        __ pxor(dst, dst);
+        __ psubb(dst, src);
+      }
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pxor(dst, dst);
-      __ psubw(dst, src);
+      if (is_ymm) {
+        __ vpxor(dst, dst, dst, kVexLength256);
+        __ vpsubw(dst, dst, src, kVexLength256);
+      } else {
+        __ pxor(dst, dst);
+        __ psubw(dst, src);
+      }
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pxor(dst, dst);
-      __ psubd(dst, src);
+      if (is_ymm) {
+        __ vpxor(dst, dst, dst, kVexLength256);
+        __ vpsubd(dst, dst, src, kVexLength256);
+      } else {
+        __ pxor(dst, dst);
+        __ psubd(dst, src);
+      }
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ pxor(dst, dst);
-      __ psubq(dst, src);
+      if (is_ymm) {
+        __ vpxor(dst, dst, dst, kVexLength256);
+        __ vpsubq(dst, dst, src, kVexLength256);
+      } else {
+        __ pxor(dst, dst);
+        __ psubq(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ xorps(dst, dst);
-      __ subps(dst, src);
+      if (is_ymm) {
+        __ vxorps(dst, dst, dst, kVexLength256);
+        __ vsubps(dst, dst, src, kVexLength256);
+      } else {
+        __ xorps(dst, dst);
+        __ subps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ xorpd(dst, dst);
-      __ subpd(dst, src);
+      if (is_ymm) {
+        __ vxorpd(dst, dst, dst, kVexLength256);
+        __ vsubpd(dst, dst, src, kVexLength256);
+      } else {
+        __ xorpd(dst, dst);
+        __ subpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -328,28 +380,45 @@ void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt32: {
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
-      __ movaps(dst, src);
-      __ pxor(tmp, tmp);
-      __ pcmpgtd(tmp, dst);
-      __ pxor(dst, tmp);
-      __ psubd(dst, tmp);
+      if (is_ymm) {
+        __ vpxor(tmp, tmp, tmp, kVexLength256);
+        __ vpcmpgtd(tmp, tmp, src, kVexLength256);
+        __ vpxor(dst, src, tmp, kVexLength256);
+        __ vpsubd(dst, dst, tmp, kVexLength256);
+      } else {
+        __ movaps(dst, src);
+        __ pxor(tmp, tmp);
+        __ pcmpgtd(tmp, dst);
+        __ pxor(dst, tmp);
+        __ psubd(dst, tmp);
+      }
       break;
     }
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pcmpeqb(dst, dst);  // all ones
-      __ psrld(dst, Immediate(1));
-      __ andps(dst, src);
+      if (is_ymm) {
+        __ vpcmpeqb(dst, dst, dst, kVexLength256);  // all ones
+        __ vpsrld(dst, dst, Immediate(1), kVexLength256);
+        __ vandps(dst, dst, src, kVexLength256);
+      } else {
+        __ pcmpeqb(dst, dst);  // all ones
+        __ psrld(dst, Immediate(1));
+        __ andps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ pcmpeqb(dst, dst);  // all ones
-      __ psrlq(dst, Immediate(1));
-      __ andpd(dst, src);
+      if (is_ymm) {
+        __ vpcmpeqb(dst, dst, dst, kVexLength256);  // all ones
+        __ vpsrlq(dst, dst, Immediate(1), kVexLength256);
+        __ vandpd(dst, dst, src, kVexLength256);
+      } else {
+        __ pcmpeqb(dst, dst);  // all ones
+        __ psrlq(dst, Immediate(1));
+        __ andpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -359,7 +428,7 @@ void InstructionCodeGeneratorX86_64::VisitVecAbs(HVecAbs* instruction) {
 
 void LocationsBuilderX86_64::VisitVecNot(HVecNot* instruction) {
   CreateVecUnOpLocations(GetGraph()->GetAllocator(), instruction);
-  // Boolean-not requires a temporary to construct the 16 x one.
+  // Boolean-not requires a temporary to construct the 16 (or 32) x one.
   if (instruction->GetPackedType() == DataType::Type::kBool) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
   }
@@ -369,14 +438,21 @@ void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool: {  // special case boolean-not
-      DCHECK_EQ(16u, instruction->GetVectorLength());
       XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
-      __ pxor(dst, dst);
-      __ pcmpeqb(tmp, tmp);  // all ones
-      __ psubb(dst, tmp);  // 16 x one
-      __ pxor(dst, src);
+      if (is_ymm) {
+        __ vpxor(dst, dst, dst, kVexLength256);
+        __ vpcmpeqb(tmp, tmp, tmp, kVexLength256);  // all ones
+        __ vpsubb(dst, dst, tmp, kVexLength256);  // 32 x one
+        __ vpxor(dst, dst, src, kVexLength256);
+      } else {
+        __ pxor(dst, dst);
+        __ pcmpeqb(tmp, tmp);  // all ones
+        __ psubb(dst, tmp);  // 16 x one
+        __ pxor(dst, src);
+      }
       break;
     }
     case DataType::Type::kUint8:
@@ -385,20 +461,31 @@ void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
     case DataType::Type::kInt16:
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      __ pcmpeqb(dst, dst);  // all ones
-      __ pxor(dst, src);
+      if (is_ymm) {
+        __ vpcmpeqb(dst, dst, dst, kVexLength256);  // all ones
+        __ vpxor(dst, dst, src, kVexLength256);
+      } else {
+        __ pcmpeqb(dst, dst);  // all ones
+        __ pxor(dst, src);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pcmpeqb(dst, dst);  // all ones
-      __ xorps(dst, src);
+      if (is_ymm) {
+        __ vpcmpeqb(dst, dst, dst, kVexLength256);  // all ones
+        __ vxorps(dst, dst, src, kVexLength256);
+      } else {
+        __ pcmpeqb(dst, dst);  // all ones
+        __ xorps(dst, src);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ pcmpeqb(dst, dst);  // all ones
-      __ xorpd(dst, src);
+      if (is_ymm) {
+        __ vpcmpeqb(dst, dst, dst, kVexLength256);  // all ones
+        __ vxorpd(dst, dst, src, kVexLength256);
+      } else {
+        __ pcmpeqb(dst, dst);  // all ones
+        __ xorpd(dst, src);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -438,32 +525,27 @@ void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ paddb(dst, src);
+      is_ymm ? __ vpaddb(dst, dst, src, kVexLength256) : __ paddb(dst, src);
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ paddw(dst, src);
+      is_ymm ? __ vpaddw(dst, dst, src, kVexLength256) : __ paddw(dst, src);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ paddd(dst, src);
+      is_ymm ? __ vpaddd(dst, dst, src, kVexLength256) : __ paddd(dst, src);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ paddq(dst, src);
+      is_ymm ? __ vpaddq(dst, dst, src, kVexLength256) : __ paddq(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ addps(dst, src);
+      is_ymm ? __ vaddps(dst, dst, src, kVexLength256) : __ addps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ addpd(dst, src);
+      is_ymm ? __ vaddpd(dst, dst, src, kVexLength256) : __ addpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -480,17 +562,16 @@ void InstructionCodeGeneratorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instruct
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
 
   DCHECK(instruction->IsRounded());
 
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-     __ pavgb(dst, src);
-     return;
+      is_ymm ? __ vpavgb(dst, dst, src, kVexLength256) : __ pavgb(dst, src);
+      return;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pavgw(dst, src);
+      is_ymm ? __ vpavgw(dst, dst, src, kVexLength256) : __ pavgw(dst, src);
       return;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -507,32 +588,27 @@ void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ psubb(dst, src);
+      is_ymm ? __ vpsubb(dst, dst, src, kVexLength256) : __ psubb(dst, src);
       break;
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psubw(dst, src);
+      is_ymm ? __ vpsubw(dst, dst, src, kVexLength256) : __ psubw(dst, src);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ psubd(dst, src);
+      is_ymm ? __ vpsubd(dst, dst, src, kVexLength256) : __ psubd(dst, src);
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ psubq(dst, src);
+      is_ymm ? __ vpsubq(dst, dst, src, kVexLength256) : __ psubq(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ subps(dst, src);
+      is_ymm ? __ vsubps(dst, dst, src, kVexLength256) : __ subps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ subpd(dst, src);
+      is_ymm ? __ vsubpd(dst, dst, src, kVexLength256) : __ subpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -549,23 +625,20 @@ void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pmullw(dst, src);
+      is_ymm ? __ vpmullw(dst, dst, src, kVexLength256) : __ pmullw(dst, src);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pmulld(dst, src);
+      is_ymm ? __ vpmulld(dst, dst, src, kVexLength256) : __ pmulld(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ mulps(dst, src);
+      is_ymm ? __ vmulps(dst, dst, src, kVexLength256) : __ mulps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ mulpd(dst, src);
+      is_ymm ? __ vmulpd(dst, dst, src, kVexLength256) : __ mulpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -582,14 +655,13 @@ void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ divps(dst, src);
+      is_ymm ? __ vdivps(dst, dst, src, kVexLength256) : __ divps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ divpd(dst, src);
+      is_ymm ? __ vdivpd(dst, dst, src, kVexLength256) : __ divpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -606,39 +678,32 @@ void InstructionCodeGeneratorX86_64::VisitVecMin(HVecMin* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pminub(dst, src);
+      is_ymm ? __ vpminub(dst, dst, src, kVexLength256) : __ pminub(dst, src);
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pminsb(dst, src);
+      is_ymm ? __ vpminsb(dst, dst, src, kVexLength256) : __ pminsb(dst, src);
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pminuw(dst, src);
+      is_ymm ? __ vpminuw(dst, dst, src, kVexLength256) : __ pminuw(dst, src);
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pminsw(dst, src);
+      is_ymm ? __ vpminsw(dst, dst, src, kVexLength256) : __ pminsw(dst, src);
       break;
     case DataType::Type::kUint32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pminud(dst, src);
+      is_ymm ? __ vpminud(dst, dst, src, kVexLength256) : __ pminud(dst, src);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pminsd(dst, src);
+      is_ymm ? __ vpminsd(dst, dst, src, kVexLength256) : __ pminsd(dst, src);
       break;
     // Next cases are sloppy wrt 0.0 vs -0.0.
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ minps(dst, src);
+      is_ymm ? __ vminps(dst, dst, src, kVexLength256) : __ minps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ minpd(dst, src);
+      is_ymm ? __ vminpd(dst, dst, src, kVexLength256) : __ minpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -655,39 +720,32 @@ void InstructionCodeGeneratorX86_64::VisitVecMax(HVecMax* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pmaxub(dst, src);
+      is_ymm ? __ vpmaxub(dst, dst, src, kVexLength256) : __ pmaxub(dst, src);
       break;
     case DataType::Type::kInt8:
-      DCHECK_EQ(16u, instruction->GetVectorLength());
-      __ pmaxsb(dst, src);
+      is_ymm ? __ vpmaxsb(dst, dst, src, kVexLength256) : __ pmaxsb(dst, src);
       break;
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pmaxuw(dst, src);
+      is_ymm ? __ vpmaxuw(dst, dst, src, kVexLength256) : __ pmaxuw(dst, src);
       break;
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ pmaxsw(dst, src);
+      is_ymm ? __ vpmaxsw(dst, dst, src, kVexLength256) : __ pmaxsw(dst, src);
       break;
     case DataType::Type::kUint32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pmaxud(dst, src);
+      is_ymm ? __ vpmaxud(dst, dst, src, kVexLength256) : __ pmaxud(dst, src);
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pmaxsd(dst, src);
+      is_ymm ? __ vpmaxsd(dst, dst, src, kVexLength256) : __ pmaxsd(dst, src);
       break;
     // Next cases are sloppy wrt 0.0 vs -0.0.
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ maxps(dst, src);
+      is_ymm ? __ vmaxps(dst, dst, src, kVexLength256) : __ maxps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ maxpd(dst, src);
+      is_ymm ? __ vmaxpd(dst, dst, src, kVexLength256) : __ maxpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -704,6 +762,7 @@ void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -712,17 +771,13 @@ void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
     case DataType::Type::kInt16:
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      __ pand(dst, src);
+      is_ymm ? __ vpand(dst, dst, src, kVexLength256) : __ pand(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ andps(dst, src);
+      is_ymm ? __ vandps(dst, dst, src, kVexLength256) : __ andps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ andpd(dst, src);
+      is_ymm ? __ vandpd(dst, dst, src, kVexLength256) : __ andpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -739,6 +794,7 @@ void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -747,17 +803,13 @@ void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
     case DataType::Type::kInt16:
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      __ pandn(dst, src);
+      is_ymm ? __ vpandn(dst, dst, src, kVexLength256) : __ pandn(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ andnps(dst, src);
+      is_ymm ? __ vandnps(dst, dst, src, kVexLength256) : __ andnps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ andnpd(dst, src);
+      is_ymm ? __ vandnpd(dst, dst, src, kVexLength256) : __ andnpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -774,6 +826,7 @@ void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -782,17 +835,13 @@ void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
     case DataType::Type::kInt16:
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      __ por(dst, src);
+      is_ymm ? __ vpor(dst, dst, src, kVexLength256) : __ por(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ orps(dst, src);
+      is_ymm ? __ vorps(dst, dst, src, kVexLength256) : __ orps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ orpd(dst, src);
+      is_ymm ? __ vorpd(dst, dst, src, kVexLength256) : __ orpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -809,6 +858,7 @@ void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -817,17 +867,13 @@ void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
     case DataType::Type::kInt16:
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      __ pxor(dst, src);
+      is_ymm ? __ vpxor(dst, dst, src, kVexLength256) : __ pxor(dst, src);
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ xorps(dst, src);
+      is_ymm ? __ vxorps(dst, dst, src, kVexLength256) : __ xorps(dst, src);
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ xorpd(dst, src);
+      is_ymm ? __ vxorpd(dst, dst, src, kVexLength256) : __ xorpd(dst, src);
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -862,19 +908,20 @@ void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psllw(dst, Immediate(static_cast<int8_t>(value)));
+      is_ymm ? __ vpsllw(dst, dst, Immediate(static_cast<int8_t>(value)), kVexLength256)
+             : __ psllw(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ pslld(dst, Immediate(static_cast<int8_t>(value)));
+      is_ymm ? __ vpslld(dst, dst, Immediate(static_cast<int8_t>(value)), kVexLength256)
+             : __ pslld(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ psllq(dst, Immediate(static_cast<int8_t>(value)));
+      is_ymm ? __ vpsllq(dst, dst, Immediate(static_cast<int8_t>(value)), kVexLength256)
+             : __ psllq(dst, Immediate(static_cast<int8_t>(value)));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -891,15 +938,16 @@ void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psraw(dst, Immediate(static_cast<int8_t>(value)));
+      is_ymm ? __ vpsraw(dst, dst, Immediate(static_cast<int8_t>(value)), kVexLength256)
+             : __ psraw(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ psrad(dst, Immediate(static_cast<int8_t>(value)));
+      is_ymm ? __ vpsrad(dst, dst, Immediate(static_cast<int8_t>(value)), kVexLength256)
+             : __ psrad(dst, Immediate(static_cast<int8_t>(value)));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -916,19 +964,20 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  bool is_ymm = IsYmmVector(instruction);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
-      __ psrlw(dst, Immediate(static_cast<int8_t>(value)));
+      is_ymm ? __ vpsrlw(dst, dst, Immediate(static_cast<int8_t>(value)), kVexLength256)
+             : __ psrlw(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      __ psrld(dst, Immediate(static_cast<int8_t>(value)));
+      is_ymm ? __ vpsrld(dst, dst, Immediate(static_cast<int8_t>(value)), kVexLength256)
+             : __ psrld(dst, Immediate(static_cast<int8_t>(value)));
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      __ psrlq(dst, Immediate(static_cast<int8_t>(value)));
+      is_ymm ? __ vpsrlq(dst, dst, Immediate(static_cast<int8_t>(value)), kVexLength256)
+             : __ psrlq(dst, Immediate(static_cast<int8_t>(value)));
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -974,8 +1023,12 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
 
   DCHECK_EQ(1u, instruction->InputCount());  // only one input currently implemented
 
-  // Zero out all other elements first.
-  __ xorps(dst, dst);
+  // Zero out all other elements first. Note that the VEX encoding also clears the upper half.
+  if (IsYmmVector(instruction)) {
+    __ vxorps(dst, dst, dst, kVexLength128);
+  } else {
+    __ xorps(dst, dst);
+  }
 
   // Shorthand for any type of zero.
   if (IsZeroBitPattern(instruction->InputAt(0))) {
@@ -992,19 +1045,15 @@ void InstructionCodeGeneratorX86_64::VisitVecSetScalars(HVecSetScalars* instruct
       LOG(FATAL) << "Unsupported SIMD type";
       UNREACHABLE();
     case DataType::Type::kInt32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());
       break;
     case DataType::Type::kInt64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
       __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>());  // is 64-bit
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
       __ movss(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
       __ movsd(dst, locations->InAt(0).AsFpuRegister<XmmRegister>());
       break;
     default:
@@ -1101,8 +1150,10 @@ static Address VecAddress(LocationSummary* locations, size_t size, bool is_strin
 
 void LocationsBuilderX86_64::VisitVecLoad(HVecLoad* instruction) {
   CreateVecMemLocations(GetGraph()->GetAllocator(), instruction, /*is_load*/ true);
-  // String load requires a temporary for the compressed load.
-  if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
+  // String load requires a temporary for the compressed 128-bit load.
+  if (mirror::kUseStringCompression &&
+      instruction->IsStringCharAt() &&
+      !IsYmmVector(instruction)) {
     instruction->GetLocations()->AddTemp(Location::RequiresFpuRegister());
   }
 }
@@ -1112,28 +1163,38 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, instruction->IsStringCharAt());
   XmmRegister reg = locations->Out().AsFpuRegister<XmmRegister>();
-  bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
+  bool is_ymm = IsYmmVector(instruction);
+  bool is_aligned = instruction->GetAlignment().IsAlignedAt(is_ymm ? 32 : 16);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
-      DCHECK_EQ(8u, instruction->GetVectorLength());
       // Special handling of compressed/uncompressed string load.
       if (mirror::kUseStringCompression && instruction->IsStringCharAt()) {
         NearLabel done, not_compressed;
-        XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
         // Test compression bit.
         static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
                       "Expecting 0=compressed, 1=uncompressed");
         uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
         __ testb(Address(locations->InAt(0).AsRegister<CpuRegister>(), count_offset), Immediate(1));
         __ j(kNotZero, &not_compressed);
-        // Zero extend 8 compressed bytes into 8 chars.
-        __ movsd(reg, VecAddress(locations, 1, instruction->IsStringCharAt()));
-        __ pxor(tmp, tmp);
-        __ punpcklbw(reg, tmp);
-        __ jmp(&done);
-        // Load 8 direct uncompressed chars.
-        __ Bind(&not_compressed);
-        is_aligned16 ?  __ movdqa(reg, address) :  __ movdqu(reg, address);
+        if (is_ymm) {
+          // Zero extend 16 compressed bytes into 16 chars.
+          __ vpmovzxbw(reg, VecAddress(locations, 1, instruction->IsStringCharAt()), kVexLength256);
+          __ jmp(&done);
+          // Load 16 direct uncompressed chars.
+          __ Bind(&not_compressed);
+          is_aligned ? __ vmovdqa(reg, address, kVexLength256)
+                     : __ vmovdqu(reg, address, kVexLength256);
+        } else {
+          XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+          // Zero extend 8 compressed bytes into 8 chars.
+          __ movsd(reg, VecAddress(locations, 1, instruction->IsStringCharAt()));
+          __ pxor(tmp, tmp);
+          __ punpcklbw(reg, tmp);
+          __ jmp(&done);
+          // Load 8 direct uncompressed chars.
+          __ Bind(&not_compressed);
+          is_aligned ?  __ movdqa(reg, address) :  __ movdqu(reg, address);
+        }
         __ Bind(&done);
         return;
       }
@@ -1144,17 +1205,28 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
     case DataType::Type::kInt16:
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      is_aligned16 ? __ movdqa(reg, address) : __ movdqu(reg, address);
+      if (is_ymm) {
+        is_aligned ? __ vmovdqa(reg, address, kVexLength256)
+                   : __ vmovdqu(reg, address, kVexLength256);
+      } else {
+        is_aligned ? __ movdqa(reg, address) : __ movdqu(reg, address);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      is_aligned16 ? __ movaps(reg, address) : __ movups(reg, address);
+      if (is_ymm) {
+        is_aligned ? __ vmovaps(reg, address, kVexLength256)
+                   : __ vmovups(reg, address, kVexLength256);
+      } else {
+        is_aligned ? __ movaps(reg, address) : __ movups(reg, address);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      is_aligned16 ? __ movapd(reg, address) : __ movupd(reg, address);
+      if (is_ymm) {
+        is_aligned ? __ vmovapd(reg, address, kVexLength256)
+                   : __ vmovupd(reg, address, kVexLength256);
+      } else {
+        is_aligned ? __ movapd(reg, address) : __ movupd(reg, address);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -1171,7 +1243,8 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
   size_t size = DataType::Size(instruction->GetPackedType());
   Address address = VecAddress(locations, size, /*is_string_char_at*/ false);
   XmmRegister reg = locations->InAt(2).AsFpuRegister<XmmRegister>();
-  bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
+  bool is_ymm = IsYmmVector(instruction);
+  bool is_aligned = instruction->GetAlignment().IsAlignedAt(is_ymm ? 32 : 16);
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -1180,17 +1253,28 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
     case DataType::Type::kInt16:
     case DataType::Type::kInt32:
     case DataType::Type::kInt64:
-      DCHECK_LE(2u, instruction->GetVectorLength());
-      DCHECK_LE(instruction->GetVectorLength(), 16u);
-      is_aligned16 ? __ movdqa(address, reg) : __ movdqu(address, reg);
+      if (is_ymm) {
+        is_aligned ? __ vmovdqa(address, reg, kVexLength256)
+                   : __ vmovdqu(address, reg, kVexLength256);
+      } else {
+        is_aligned ? __ movdqa(address, reg) : __ movdqu(address, reg);
+      }
       break;
     case DataType::Type::kFloat32:
-      DCHECK_EQ(4u, instruction->GetVectorLength());
-      is_aligned16 ? __ movaps(address, reg) : __ movups(address, reg);
+      if (is_ymm) {
+        is_aligned ? __ vmovaps(address, reg, kVexLength256)
+                   : __ vmovups(address, reg, kVexLength256);
+      } else {
+        is_aligned ? __ movaps(address, reg) : __ movups(address, reg);
+      }
       break;
     case DataType::Type::kFloat64:
-      DCHECK_EQ(2u, instruction->GetVectorLength());
-      is_aligned16 ? __ movapd(address, reg) : __ movupd(address, reg);
+      if (is_ymm) {
+        is_aligned ? __ vmovapd(address, reg, kVexLength256)
+                   : __ vmovupd(address, reg, kVexLength256);
+      } else {
+        is_aligned ? __ movapd(address, reg) : __ movupd(address, reg);
+      }
       break;
     default:
       LOG(FATAL) << "Unsupported SIMD type";
@@ -142,7 +142,7 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg1, CpuRegister reg2);
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
-  void Exchange128(XmmRegister reg, int mem);
+  void ExchangeSIMD(XmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -327,11 +327,23 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   }
 
   size_t GetFloatingPointSpillSlotSize() const OVERRIDE {
-    return GetGraph()->HasSIMD()
-        ? 2 * kX86_64WordSize   // 16 bytes == 2 x86_64 words for each spill
-        : 1 * kX86_64WordSize;  //  8 bytes == 1 x86_64 words for each spill
+    return UsesYmmRegisters()
+        ? 4 * kX86_64WordSize   // 32 bytes == 4 x86_64 words for each spill
+        : GetGraph()->HasSIMD()
+            ? 2 * kX86_64WordSize   // 16 bytes == 2 x86_64 words for each spill
+            : 1 * kX86_64WordSize;  //  8 bytes == 1 x86_64 words for each spill
   }
 
+  // Whether the vector code of this method operates on 256-bit ymm registers, in which
+  // case the full ymm registers need to be preserved by spills and moves.
+  bool UsesYmmRegisters() const {
+    return GetGraph()->HasSIMD() && isa_features_.HasAVX2();
+  }
+
+  // Clear the upper halves of the ymm registers before transferring control to code
+  // that may use legacy SSE encodings, avoiding the AVX-SSE transition penalty.
+  void MaybeGenerateVZeroUpper();
+
   HGraphVisitor* GetLocationBuilder() OVERRIDE {
     return &location_builder_;
   }
@@ -473,6 +473,7 @@ class HGraphVisualizerPrinter : public HGraphDelegateVisitor {
   void VisitInvokePolymorphic(HInvokePolymorphic* invoke) OVERRIDE {
     VisitInvoke(invoke);
     StartAttributeStream("invoke_type") << "InvokePolymorphic";
+    StartAttributeStream("intrinsic") << invoke->GetIntrinsic();
   }
 
   void VisitInstanceFieldGet(HInstanceFieldGet* iget) OVERRIDE {
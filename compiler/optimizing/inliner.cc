@@ -66,6 +66,11 @@ static constexpr size_t kMaximumNumberOfRecursiveCalls = 4;
 // Controls the use of inline caches in AOT mode.
 static constexpr bool kUseAOTInlineCaches = true;
 
+// Megamorphic call sites only get type guards for their most frequent receiver
+// types, each seen at least this percentage of the time.
+static constexpr size_t kMaximumNumberOfMegamorphicTargets = 2;
+static constexpr uint64_t kMinimumMegamorphicTargetPercent = 25;
+
 // We check for line numbers to make sure the DepthString implementation
 // aligns the output nicely.
 #define LOG_INTERNAL(msg) \
@@ -359,6 +364,33 @@ static mirror::Class* GetMonomorphicType(Handle<mirror::ObjectArray<mirror::Clas
   return classes->Get(0);
 }
 
+// Keep in `classes`, sorted by decreasing `counts`, only the receiver types of a
+// megamorphic call site frequent enough to pay for a type guard in front of the
+// dispatch. Returns whether any type is left.
+static bool KeepDominantReceiverTypes(Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                      const uint32_t* counts)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  uint64_t total = 0;
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize && classes->Get(i) != nullptr; ++i) {
+    total += counts[i];
+  }
+  size_t number_of_dominant_types = 0;
+  for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+    if (classes->Get(i) == nullptr) {
+      break;
+    }
+    DCHECK(i == 0 || counts[i] <= counts[i - 1]);
+    if (number_of_dominant_types < kMaximumNumberOfMegamorphicTargets &&
+        total != 0u &&
+        counts[i] * UINT64_C(100) >= total * kMinimumMegamorphicTargetPercent) {
+      ++number_of_dominant_types;
+    } else {
+      classes->Set(i, nullptr);
+    }
+  }
+  return number_of_dominant_types != 0;
+}
+
 ArtMethod* HInliner::TryCHADevirtualization(ArtMethod* resolved_method) {
   if (!resolved_method->HasSingleImplementation()) {
     return nullptr;
@@ -444,6 +476,14 @@ static bool AlwaysThrows(CompilerDriver* const compiler_driver, ArtMethod* metho
   return throw_seen;
 }
 
+static bool IsStringBuilderDefaultConstructor(ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  return method->IsConstructor() &&
+         !method->IsStatic() &&
+         strcmp(method->GetShorty(), "V") == 0 &&
+         method->GetDeclaringClass()->DescriptorEquals("Ljava/lang/StringBuilder;");
+}
+
 bool HInliner::TryInline(HInvoke* invoke_instruction) {
   if (invoke_instruction->IsInvokeUnresolved() ||
       invoke_instruction->IsInvokePolymorphic()) {
@@ -463,6 +503,12 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
     LOG_FAIL_NO_STAT() << "Not inlining a String.<init> method";
     return false;
   }
+  if (IsStringBuilderDefaultConstructor(resolved_method)) {
+    // The instruction simplifier can replace a `new StringBuilder()` append chain with
+    // a single HStringBuilderAppend only if the constructor call is kept.
+    LOG_FAIL_NO_STAT() << "Not inlining a StringBuilder.<init>() method";
+    return false;
+  }
   ArtMethod* actual_method = nullptr;
 
   if (invoke_instruction->IsInvokeStaticOrDirect()) {
@@ -572,9 +618,10 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 
   StackHandleScope<1> hs(Thread::Current());
   Handle<mirror::ObjectArray<mirror::Class>> inline_cache;
+  uint32_t receiver_counts[InlineCache::kIndividualCacheSize] = {};
   InlineCacheType inline_cache_type = Runtime::Current()->IsAotCompiler()
-      ? GetInlineCacheAOT(caller_dex_file, invoke_instruction, &hs, &inline_cache)
-      : GetInlineCacheJIT(invoke_instruction, &hs, &inline_cache);
+      ? GetInlineCacheAOT(caller_dex_file, invoke_instruction, &hs, &inline_cache, receiver_counts)
+      : GetInlineCacheJIT(invoke_instruction, &hs, &inline_cache, receiver_counts);
 
   switch (inline_cache_type) {
     case kInlineCacheNoData: {
@@ -596,7 +643,8 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
     case kInlineCacheMonomorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kMonomorphicCall);
       if (UseOnlyPolymorphicInliningWithNoDeopt()) {
-        return TryInlinePolymorphicCall(invoke_instruction, resolved_method, inline_cache);
+        return TryInlinePolymorphicCall(
+            invoke_instruction, resolved_method, inline_cache, /* is_megamorphic */ false);
       } else {
         return TryInlineMonomorphicCall(invoke_instruction, resolved_method, inline_cache);
       }
@@ -604,16 +652,21 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 
     case kInlineCachePolymorphic: {
       MaybeRecordStat(stats_, MethodCompilationStat::kPolymorphicCall);
-      return TryInlinePolymorphicCall(invoke_instruction, resolved_method, inline_cache);
+      return TryInlinePolymorphicCall(
+          invoke_instruction, resolved_method, inline_cache, /* is_megamorphic */ false);
     }
 
     case kInlineCacheMegamorphic: {
-      LOG_FAIL_NO_STAT()
-          << "Interface or virtual call to "
-          << caller_dex_file.PrettyMethod(invoke_instruction->GetDexMethodIndex())
-          << " is megamorphic and not inlined";
       MaybeRecordStat(stats_, MethodCompilationStat::kMegamorphicCall);
-      return false;
+      if (!KeepDominantReceiverTypes(inline_cache, receiver_counts)) {
+        LOG_FAIL_NO_STAT()
+            << "Interface or virtual call to "
+            << caller_dex_file.PrettyMethod(invoke_instruction->GetDexMethodIndex())
+            << " is megamorphic without dominant types and not inlined";
+        return false;
+      }
+      return TryInlinePolymorphicCall(
+          invoke_instruction, resolved_method, inline_cache, /* is_megamorphic */ true);
     }
 
     case kInlineCacheMissingTypes: {
@@ -630,7 +683,8 @@ bool HInliner::TryInlineFromInlineCache(const DexFile& caller_dex_file,
 HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     HInvoke* invoke_instruction,
     StackHandleScope<1>* hs,
-    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+    /*out*/uint32_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   DCHECK(Runtime::Current()->UseJitCompilation());
 
@@ -651,7 +705,8 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
   } else {
     Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
         *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-        *inline_cache);
+        *inline_cache,
+        receiver_counts);
     return GetInlineCacheType(*inline_cache);
   }
 }
@@ -660,7 +715,8 @@ HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
     const DexFile& caller_dex_file,
     HInvoke* invoke_instruction,
     StackHandleScope<1>* hs,
-    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+    /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+    /*out*/uint32_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   DCHECK(Runtime::Current()->IsAotCompiler());
   const ProfileCompilationInfo* pci = compiler_driver_->GetProfileCompilationInfo();
@@ -683,14 +739,16 @@ HInliner::InlineCacheType HInliner::GetInlineCacheAOT(
   } else {
     return ExtractClassesFromOfflineProfile(invoke_instruction,
                                             *(offline_profile.get()),
-                                            *inline_cache);
+                                            *inline_cache,
+                                            receiver_counts);
   }
 }
 
 HInliner::InlineCacheType HInliner::ExtractClassesFromOfflineProfile(
     const HInvoke* invoke_instruction,
     const ProfileCompilationInfo::OfflineProfileMethodInfo& offline_profile,
-    /*out*/Handle<mirror::ObjectArray<mirror::Class>> inline_cache)
+    /*out*/Handle<mirror::ObjectArray<mirror::Class>> inline_cache,
+    /*out*/uint32_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   const auto it = offline_profile.inline_caches->find(invoke_instruction->GetDexPc());
   if (it == offline_profile.inline_caches->end()) {
@@ -702,11 +760,11 @@ HInliner::InlineCacheType HInliner::ExtractClassesFromOfflineProfile(
   if (dex_pc_data.is_missing_types) {
     return kInlineCacheMissingTypes;
   }
-  if (dex_pc_data.is_megamorphic) {
+  if (dex_pc_data.is_megamorphic && dex_pc_data.class_counts.empty()) {
     return kInlineCacheMegamorphic;
   }
 
-  DCHECK_LE(dex_pc_data.classes.size(), InlineCache::kIndividualCacheSize);
+  DCHECK_LE(dex_pc_data.class_counts.size(), InlineCache::kIndividualCacheSize);
   Thread* self = Thread::Current();
   // We need to resolve the class relative to the containing dex file.
   // So first, build a mapping from the index of dex file in the profile to
@@ -730,10 +788,25 @@ HInliner::InlineCacheType HInliner::ExtractClassesFromOfflineProfile(
     }
   }
 
+  // Sort the classes by decreasing frequency, so that the most frequent types are tested first.
+  // The histogram contains all the classes of non megamorphic receivers.
+  std::vector<std::pair<uint32_t, ProfileCompilationInfo::ClassReference>> sorted_classes;
+  for (const auto& class_count : dex_pc_data.class_counts) {
+    sorted_classes.emplace_back(class_count.second, class_count.first);
+  }
+  std::stable_sort(sorted_classes.begin(),
+                   sorted_classes.end(),
+                   [](const std::pair<uint32_t, ProfileCompilationInfo::ClassReference>& lhs,
+                      const std::pair<uint32_t, ProfileCompilationInfo::ClassReference>& rhs) {
+                     return lhs.first > rhs.first;
+                   });
+
   // Walk over the classes and resolve them. If we cannot find a type we return
-  // kInlineCacheMissingTypes.
+  // kInlineCacheMissingTypes, unless the receiver is megamorphic, in which case we
+  // only use the types we can find.
   int ic_index = 0;
-  for (const ProfileCompilationInfo::ClassReference& class_ref : dex_pc_data.classes) {
+  for (const auto& sorted_class : sorted_classes) {
+    const ProfileCompilationInfo::ClassReference& class_ref = sorted_class.second;
     ObjPtr<mirror::DexCache> dex_cache =
         dex_profile_index_to_dex_cache[class_ref.dex_profile_index];
     DCHECK(dex_cache != nullptr);
@@ -748,7 +821,10 @@ HInliner::InlineCacheType HInliner::ExtractClassesFromOfflineProfile(
           dex_cache,
           caller_compilation_unit_.GetClassLoader().Get());
     if (clazz != nullptr) {
+      receiver_counts[ic_index] = sorted_class.first;
       inline_cache->Set(ic_index++, clazz);
+    } else if (dex_pc_data.is_megamorphic) {
+      continue;
     } else {
       VLOG(compiler) << "Could not resolve class from inline cache in AOT mode "
           << caller_compilation_unit_.GetDexFile()->PrettyMethod(
@@ -758,7 +834,9 @@ HInliner::InlineCacheType HInliner::ExtractClassesFromOfflineProfile(
       return kInlineCacheMissingTypes;
     }
   }
-  return GetInlineCacheType(inline_cache);
+  // The resolved classes of a megamorphic receiver may fit in the cache, but only its dominant
+  // types may be guarded.
+  return dex_pc_data.is_megamorphic ? kInlineCacheMegamorphic : GetInlineCacheType(inline_cache);
 }
 
 HInstanceFieldGet* HInliner::BuildGetReceiverClass(ClassLinker* class_linker,
@@ -970,11 +1048,15 @@ HInstruction* HInliner::AddTypeGuard(HInstruction* receiver,
 
 bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                                         ArtMethod* resolved_method,
-                                        Handle<mirror::ObjectArray<mirror::Class>> classes) {
+                                        Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                        bool is_megamorphic) {
   DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface())
       << invoke_instruction->DebugName();
 
-  if (TryInlinePolymorphicCallToSameTarget(invoke_instruction, resolved_method, classes)) {
+  // The classes of a megamorphic call site are only a subset of its receivers, so
+  // we cannot check that they all share the same target.
+  if (!is_megamorphic &&
+      TryInlinePolymorphicCallToSameTarget(invoke_instruction, resolved_method, classes)) {
     return true;
   }
 
@@ -1007,12 +1089,31 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
     dex::TypeIndex class_index = FindClassIndexIn(handle.Get(), caller_compilation_unit_);
     HInstruction* return_replacement = nullptr;
     LOG_NOTE() << "Try inline polymorphic call to " << method->PrettyMethod();
-    if (!class_index.IsValid() ||
-        !TryBuildAndInline(invoke_instruction,
-                           method,
-                           ReferenceTypeInfo::Create(handle, /* is_exact */ true),
-                           &return_replacement)) {
+    if (!class_index.IsValid()) {
+      all_targets_inlined = false;
+    } else if (!TryBuildAndInline(invoke_instruction,
+                                  method,
+                                  ReferenceTypeInfo::Create(handle, /* is_exact */ true),
+                                  &return_replacement)) {
       all_targets_inlined = false;
+      if (invoke_instruction->IsInvokeInterface()) {
+        // Even if we cannot inline the target, calling it through an invoke-virtual after
+        // the type guard avoids the IMT lookup and a possible conflict trampoline.
+        HInvokeVirtual* new_invoke = BuildInvokeVirtualForInterface(invoke_instruction, method);
+        if (new_invoke != nullptr) {
+          one_target_inlined = true;
+          LOG_NOTE() << "Polymorphic interface call to " << ArtMethod::PrettyMethod(resolved_method)
+                     << " is devirtualized to " << ArtMethod::PrettyMethod(method);
+          HInstruction* compare = AddTypeGuard(receiver,
+                                               cursor,
+                                               bb_cursor,
+                                               class_index,
+                                               handle,
+                                               invoke_instruction,
+                                               /* with_deoptimization */ false);
+          CreateDiamondPatternForPolymorphicInline(compare, new_invoke, invoke_instruction);
+        }
+      }
     } else {
       one_target_inlined = true;
 
@@ -1021,7 +1122,8 @@ bool HInliner::TryInlinePolymorphicCall(HInvoke* invoke_instruction,
 
       // If we have inlined all targets before, and this receiver is the last seen,
       // we deoptimize instead of keeping the original invoke instruction.
-      bool deoptimize = !UseOnlyPolymorphicInliningWithNoDeopt() &&
+      bool deoptimize = !is_megamorphic &&
+          !UseOnlyPolymorphicInliningWithNoDeopt() &&
           all_targets_inlined &&
           (i != InlineCache::kIndividualCacheSize - 1) &&
           (classes->Get(i + 1) == nullptr);
@@ -1267,6 +1369,36 @@ bool HInliner::TryInlinePolymorphicCallToSameTarget(
   return true;
 }
 
+HInvokeVirtual* HInliner::BuildInvokeVirtualForInterface(HInvoke* invoke_instruction,
+                                                         ArtMethod* method) {
+  DCHECK(invoke_instruction->IsInvokeInterface());
+  DCHECK(!method->IsDefault() || method->IsCopied());
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  uint32_t dex_method_index = FindMethodIndexIn(
+      method, caller_dex_file, invoke_instruction->GetDexMethodIndex());
+  if (dex_method_index == dex::kDexNoIndex) {
+    return nullptr;
+  }
+  HInvokeVirtual* new_invoke = new (graph_->GetAllocator()) HInvokeVirtual(
+      graph_->GetAllocator(),
+      invoke_instruction->GetNumberOfArguments(),
+      invoke_instruction->GetType(),
+      invoke_instruction->GetDexPc(),
+      dex_method_index,
+      method,
+      method->GetMethodIndex());
+  HInputsRef inputs = invoke_instruction->GetInputs();
+  for (size_t index = 0; index != inputs.size(); ++index) {
+    new_invoke->SetArgumentAt(index, inputs[index]);
+  }
+  invoke_instruction->GetBlock()->InsertInstructionBefore(new_invoke, invoke_instruction);
+  new_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+  if (invoke_instruction->GetType() == DataType::Type::kReference) {
+    new_invoke->SetReferenceTypeInfo(invoke_instruction->GetReferenceTypeInfo());
+  }
+  return new_invoke;
+}
+
 bool HInliner::TryInlineAndReplace(HInvoke* invoke_instruction,
                                    ArtMethod* method,
                                    ReferenceTypeInfo receiver_type,
@@ -1333,29 +1465,10 @@ bool HInliner::TryInlineAndReplace(HInvoke* invoke_instruction,
         return false;
       }
 
-      const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
-      uint32_t dex_method_index = FindMethodIndexIn(
-          method, caller_dex_file, invoke_instruction->GetDexMethodIndex());
-      if (dex_method_index == dex::kDexNoIndex) {
+      HInvokeVirtual* new_invoke = BuildInvokeVirtualForInterface(invoke_instruction, method);
+      if (new_invoke == nullptr) {
         return false;
       }
-      HInvokeVirtual* new_invoke = new (graph_->GetAllocator()) HInvokeVirtual(
-          graph_->GetAllocator(),
-          invoke_instruction->GetNumberOfArguments(),
-          invoke_instruction->GetType(),
-          invoke_instruction->GetDexPc(),
-          dex_method_index,
-          method,
-          method->GetMethodIndex());
-      HInputsRef inputs = invoke_instruction->GetInputs();
-      for (size_t index = 0; index != inputs.size(); ++index) {
-        new_invoke->SetArgumentAt(index, inputs[index]);
-      }
-      invoke_instruction->GetBlock()->InsertInstructionBefore(new_invoke, invoke_instruction);
-      new_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
-      if (invoke_instruction->GetType() == DataType::Type::kReference) {
-        new_invoke->SetReferenceTypeInfo(invoke_instruction->GetReferenceTypeInfo());
-      }
       return_replacement = new_invoke;
       // invoke_instruction is replaced with new_invoke.
       should_remove_invoke_instruction = true;
@@ -1755,6 +1868,7 @@ bool HInliner::TryBuildAndInlineHelper(HInvoke* invoke_instruction,
       invoke_type,
       graph_->IsDebuggable(),
       /* osr */ false,
+      /* baseline */ false,
       caller_instruction_counter);
   callee_graph->SetArtMethod(resolved_method);
 
@@ -132,28 +132,36 @@ class HInliner : public HOptimization {
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
+  // The classes are sorted by decreasing frequency, and `receiver_counts` receives
+  // the number of times each of them has been seen.
   InlineCacheType GetInlineCacheJIT(
       HInvoke* invoke_instruction,
       StackHandleScope<1>* hs,
-      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+      /*out*/uint32_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Try getting the inline cache from AOT offline profile.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
+  // The classes are sorted by decreasing frequency, and `receiver_counts` receives
+  // the number of times each of them has been seen.
   InlineCacheType GetInlineCacheAOT(const DexFile& caller_dex_file,
       HInvoke* invoke_instruction,
       StackHandleScope<1>* hs,
-      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache)
+      /*out*/Handle<mirror::ObjectArray<mirror::Class>>* inline_cache,
+      /*out*/uint32_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Extract the mirror classes from the offline profile and add them to the `inline_cache`.
   // Note that even if we have profile data for the invoke the inline_cache might contain
-  // only null entries if the types cannot be resolved.
+  // only null entries if the types cannot be resolved. For megamorphic invokes, the
+  // `inline_cache` contains the most frequent types recorded in the profile.
   InlineCacheType ExtractClassesFromOfflineProfile(
       const HInvoke* invoke_instruction,
       const ProfileCompilationInfo::OfflineProfileMethodInfo& offline_profile,
-      /*out*/Handle<mirror::ObjectArray<mirror::Class>> inline_cache)
+      /*out*/Handle<mirror::ObjectArray<mirror::Class>> inline_cache,
+      /*out*/uint32_t* receiver_counts)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Compute the inline cache type.
@@ -170,10 +178,14 @@ class HInliner : public HOptimization {
                                 Handle<mirror::ObjectArray<mirror::Class>> classes)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Try to inline targets of a polymorphic call.
+  // Try to inline targets of a polymorphic call. For a megamorphic call, `classes` only
+  // holds its dominant receiver types, and the original invoke is always kept as fallback.
+  // Targets that cannot be inlined are still called directly after their type guard if
+  // that avoids an interface dispatch.
   bool TryInlinePolymorphicCall(HInvoke* invoke_instruction,
                                 ArtMethod* resolved_method,
-                                Handle<mirror::ObjectArray<mirror::Class>> classes)
+                                Handle<mirror::ObjectArray<mirror::Class>> classes,
+                                bool is_megamorphic)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
   bool TryInlinePolymorphicCallToSameTarget(HInvoke* invoke_instruction,
@@ -184,6 +196,11 @@ class HInliner : public HOptimization {
   // Returns whether or not we should use only polymorphic inlining with no deoptimizations.
   bool UseOnlyPolymorphicInliningWithNoDeopt();
 
+  // Build an invoke-virtual of `method` replacing the invoke-interface `invoke_instruction`,
+  // and insert it before `invoke_instruction`. Returns null if that is not possible.
+  HInvokeVirtual* BuildInvokeVirtualForInterface(HInvoke* invoke_instruction, ArtMethod* method)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Try CHA-based devirtualization to change virtual method calls into
   // direct calls.
   // Returns the actual method that resolved_method can be devirtualized to.
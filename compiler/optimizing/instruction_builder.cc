@@ -28,6 +28,7 @@
 #include "driver/dex_compilation_unit.h"
 #include "driver/compiler_options.h"
 #include "imtable-inl.h"
+#include "intrinsics.h"
 #include "mirror/dex_cache.h"
 #include "oat_file.h"
 #include "optimizing_compiler_stats.h"
@@ -1064,19 +1065,40 @@ bool HInstructionBuilder::BuildInvokePolymorphic(const Instruction& instruction
   DCHECK_EQ(1 + ArtMethod::NumArgRegisters(descriptor), number_of_vreg_arguments);
   DataType::Type return_type = DataType::FromShorty(descriptor[0]);
   size_t number_of_arguments = strlen(descriptor);
+  ArtMethod* resolved_method = ResolveMethod(method_idx, kVirtual);
   HInvoke* invoke = new (allocator_) HInvokePolymorphic(allocator_,
                                                         number_of_arguments,
                                                         return_type,
                                                         dex_pc,
-                                                        method_idx);
-  return HandleInvoke(invoke,
-                      number_of_vreg_arguments,
-                      args,
-                      register_index,
-                      is_range,
-                      descriptor,
-                      nullptr /* clinit_check */,
-                      false /* is_unresolved */);
+                                                        method_idx,
+                                                        resolved_method);
+  if (resolved_method != nullptr) {
+    // Recognize VarHandle accessors right away, they need the type check below.
+    ScopedObjectAccess soa(Thread::Current());
+    bool wrong_invoke_type = false;
+    IntrinsicsRecognizer::Recognize(invoke, resolved_method, &wrong_invoke_type);
+  }
+  if (!HandleInvoke(invoke,
+                    number_of_vreg_arguments,
+                    args,
+                    register_index,
+                    is_range,
+                    descriptor,
+                    nullptr /* clinit_check */,
+                    false /* is_unresolved */)) {
+    return false;
+  }
+
+  // The compiled VarHandle accessors only check that the variable is of a reference type.
+  // The conversion of the value to the call site's return type is a checked cast.
+  if (invoke->GetIntrinsic() != Intrinsics::kNone &&
+      return_type == DataType::Type::kReference) {
+    dex::TypeIndex return_type_index = dex_file_->GetProtoId(proto_idx).return_type_idx_;
+    if (strcmp(dex_file_->StringByTypeIdx(return_type_index), "Ljava/lang/Object;") != 0) {
+      latest_result_ = BuildCheckCast(invoke, return_type_index, dex_pc);
+    }
+  }
+  return true;
 }
 
 HNewInstance* HInstructionBuilder::BuildNewInstance(dex::TypeIndex type_index, uint32_t dex_pc) {
@@ -1918,24 +1940,33 @@ void HInstructionBuilder::BuildTypeCheck(const Instruction& instruction,
                                          dex::TypeIndex type_index,
                                          uint32_t dex_pc) {
   HInstruction* object = LoadLocal(reference, DataType::Type::kReference);
-  HLoadClass* cls = BuildLoadClass(type_index, dex_pc);
-
-  ScopedObjectAccess soa(Thread::Current());
-  TypeCheckKind check_kind = ComputeTypeCheckKind(cls->GetClass());
   if (instruction.Opcode() == Instruction::INSTANCE_OF) {
+    HLoadClass* cls = BuildLoadClass(type_index, dex_pc);
+    ScopedObjectAccess soa(Thread::Current());
+    TypeCheckKind check_kind = ComputeTypeCheckKind(cls->GetClass());
     AppendInstruction(new (allocator_) HInstanceOf(object, cls, check_kind, dex_pc));
     UpdateLocal(destination, current_block_->GetLastInstruction());
   } else {
     DCHECK_EQ(instruction.Opcode(), Instruction::CHECK_CAST);
-    // We emit a CheckCast followed by a BoundType. CheckCast is a statement
-    // which may throw. If it succeeds BoundType sets the new type of `object`
-    // for all subsequent uses.
-    AppendInstruction(new (allocator_) HCheckCast(object, cls, check_kind, dex_pc));
-    AppendInstruction(new (allocator_) HBoundType(object, dex_pc));
-    UpdateLocal(reference, current_block_->GetLastInstruction());
+    UpdateLocal(reference, BuildCheckCast(object, type_index, dex_pc));
   }
 }
 
+HInstruction* HInstructionBuilder::BuildCheckCast(HInstruction* object,
+                                                  dex::TypeIndex type_index,
+                                                  uint32_t dex_pc) {
+  HLoadClass* cls = BuildLoadClass(type_index, dex_pc);
+
+  ScopedObjectAccess soa(Thread::Current());
+  TypeCheckKind check_kind = ComputeTypeCheckKind(cls->GetClass());
+  // We emit a CheckCast followed by a BoundType. CheckCast is a statement
+  // which may throw. If it succeeds BoundType sets the new type of `object`
+  // for all subsequent uses.
+  AppendInstruction(new (allocator_) HCheckCast(object, cls, check_kind, dex_pc));
+  AppendInstruction(new (allocator_) HBoundType(object, dex_pc));
+  return current_block_->GetLastInstruction();
+}
+
 bool HInstructionBuilder::NeedsAccessCheck(dex::TypeIndex type_index, bool* finalizable) const {
   return !compiler_driver_->CanAccessInstantiableTypeWithoutChecks(
       LookupReferrerClass(), LookupResolvedType(type_index, *dex_compilation_unit_), finalizable);
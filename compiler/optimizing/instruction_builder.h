@@ -216,6 +216,10 @@ class HInstructionBuilder : public ValueObject {
                       dex::TypeIndex type_index,
                       uint32_t dex_pc);
 
+  // Builds a `HCheckCast` of `object` to `type_index` and returns the `HBoundType`
+  // carrying the checked type.
+  HInstruction* BuildCheckCast(HInstruction* object, dex::TypeIndex type_index, uint32_t dex_pc);
+
   // Builds an instruction sequence for a switch statement.
   void BuildSwitch(const Instruction& instruction, uint32_t dex_pc);
 
@@ -24,6 +24,7 @@
 #include "mirror/class-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "sharpening.h"
+#include "string_builder_append.h"
 
 namespace art {
 
@@ -2422,6 +2423,144 @@ void InstructionSimplifierVisitor::SimplifyAllocationIntrinsic(HInvoke* invoke)
   }
 }
 
+// Replace code looking like
+//    sb = new StringBuilder();
+//    sb.append(a).append(b)...append(z);
+//    s = sb.toString();
+// where all the instructions are in the same block and `sb` has no other uses,
+// with a single HStringBuilderAppend allocating the result with its exact length.
+static bool TryReplaceStringBuilderAppend(HInvoke* invoke) {
+  DCHECK_EQ(invoke->GetIntrinsic(), Intrinsics::kStringBuilderToString);
+  if (!invoke->HasUses() ||
+      invoke->CanThrowIntoCatchBlock() ||
+      invoke->GetBlock()->GetGraph()->IsDebuggable()) {
+    return false;
+  }
+
+  HBasicBlock* block = invoke->GetBlock();
+  HInstruction* sb = invoke->InputAt(0);
+
+  // We support only a new StringBuilder, otherwise we cannot ensure that
+  // the StringBuilder data does not need to be populated for other users.
+  if (!sb->IsNewInstance() || sb->GetBlock() != block) {
+    return false;
+  }
+
+  // The append pattern uses the StringBuilder only as the first argument.
+  for (const HUseListNode<HInstruction*>& use : sb->GetUses()) {
+    if (use.GetUser()->GetBlock() != block || use.GetIndex() != 0u) {
+      return false;
+    }
+  }
+
+  // Collect args and check for unexpected uses. Going backwards, we expect the call
+  // to StringBuilder.toString(), some number of append calls, one call to the
+  // constructor with no arguments and the constructor fence (unless eliminated).
+  bool seen_constructor = false;
+  bool seen_to_string = false;
+  uint32_t format = 0u;
+  uint32_t num_args = 0u;
+  HInstruction* args[StringBuilderAppend::kMaxArgs];  // Added in reverse order.
+  for (HBackwardInstructionIterator iter(block->GetInstructions()); !iter.Done(); iter.Advance()) {
+    HInstruction* user = iter.Current();
+    // Instructions of interest apply to `sb`, skip those that do not involve `sb`.
+    if (user->InputCount() == 0u || user->InputAt(0u) != sb) {
+      continue;
+    }
+    if (!seen_to_string) {
+      if (user != invoke) {
+        return false;
+      }
+      seen_to_string = true;
+    } else if (user->IsInvokeVirtual() && !seen_constructor) {
+      StringBuilderAppend::Argument arg;
+      switch (user->AsInvokeVirtual()->GetIntrinsic()) {
+        case Intrinsics::kStringBuilderAppend:
+          arg = StringBuilderAppend::Argument::kString;
+          break;
+        case Intrinsics::kStringBuilderAppendBoolean:
+          arg = StringBuilderAppend::Argument::kBoolean;
+          break;
+        case Intrinsics::kStringBuilderAppendChar:
+          arg = StringBuilderAppend::Argument::kChar;
+          break;
+        case Intrinsics::kStringBuilderAppendInt:
+          arg = StringBuilderAppend::Argument::kInt;
+          break;
+        case Intrinsics::kStringBuilderAppendLong:
+          arg = StringBuilderAppend::Argument::kLong;
+          break;
+        default:
+          return false;
+      }
+      // Uses of the append return value should have been replaced with the receiver.
+      if (user->HasUses() || num_args == StringBuilderAppend::kMaxArgs) {
+        return false;
+      }
+      format = (format << StringBuilderAppend::kBitsPerArg) | static_cast<uint32_t>(arg);
+      args[num_args] = user->InputAt(1u);
+      ++num_args;
+    } else if (user->IsInvokeStaticOrDirect() &&
+               !seen_constructor &&
+               user->AsInvokeStaticOrDirect()->GetResolvedMethod() != nullptr &&
+               user->AsInvokeStaticOrDirect()->GetResolvedMethod()->IsConstructor() &&
+               user->AsInvokeStaticOrDirect()->GetNumberOfArguments() == 1u) {
+      // We accept only the constructor with no extra arguments.
+      seen_constructor = true;
+    } else if (user->IsConstructorFence() && seen_constructor) {
+      // The fence guards the allocation and precedes the constructor call.
+    } else {
+      return false;
+    }
+  }
+
+  if (!seen_constructor || num_args == 0u) {
+    return false;
+  }
+
+  // Accept only environment uses by the instructions we are about to remove.
+  for (const HUseListNode<HEnvironment*>& use : sb->GetEnvUses()) {
+    HInstruction* holder = use.GetUser()->GetHolder();
+    if (holder->GetBlock() != block || holder->InputCount() == 0u || holder->InputAt(0) != sb) {
+      return false;
+    }
+  }
+
+  // Create the replacement instruction.
+  HGraph* graph = block->GetGraph();
+  HIntConstant* fmt = graph->GetIntConstant(static_cast<int32_t>(format));
+  ArenaAllocator* allocator = graph->GetAllocator();
+  HStringBuilderAppend* append =
+      new (allocator) HStringBuilderAppend(fmt, num_args, allocator, invoke->GetDexPc());
+  append->SetReferenceTypeInfo(invoke->GetReferenceTypeInfo());
+  for (size_t i = 0; i != num_args; ++i) {
+    append->SetArgumentAt(i, args[num_args - 1u - i]);
+  }
+  block->InsertInstructionBefore(append, invoke);
+  DCHECK(!invoke->CanBeNull());
+  invoke->ReplaceWith(append);
+  // Copy the environment, except for the StringBuilder uses.
+  for (HEnvironment* env = invoke->GetEnvironment(); env != nullptr; env = env->GetParent()) {
+    for (size_t i = 0, size = env->Size(); i != size; ++i) {
+      if (env->GetInstructionAt(i) == sb) {
+        env->RemoveAsUserOfInput(i);
+        env->SetRawEnvAt(i, /* instruction */ nullptr);
+      }
+    }
+  }
+  append->CopyEnvironmentFrom(invoke->GetEnvironment());
+  // Remove the old instruction.
+  block->RemoveInstruction(invoke);
+  // Remove the StringBuilder's uses and the StringBuilder.
+  HConstructorFence::RemoveConstructorFences(sb);
+  while (sb->HasNonEnvironmentUses()) {
+    block->RemoveInstruction(sb->GetUses().front().GetUser());
+  }
+  DCHECK(!sb->HasEnvironmentUses());
+  block->RemoveInstruction(sb);
+  return true;
+}
+
 void InstructionSimplifierVisitor::SimplifyMemBarrier(HInvoke* invoke,
                                                       MemBarrierKind barrier_kind) {
   uint32_t dex_pc = invoke->GetDexPc();
@@ -2483,12 +2622,22 @@ void InstructionSimplifierVisitor::VisitInvoke(HInvoke* instruction) {
       break;
     case Intrinsics::kStringBufferAppend:
     case Intrinsics::kStringBuilderAppend:
+    case Intrinsics::kStringBuilderAppendBoolean:
+    case Intrinsics::kStringBuilderAppendChar:
+    case Intrinsics::kStringBuilderAppendInt:
+    case Intrinsics::kStringBuilderAppendLong:
       SimplifyReturnThis(instruction);
       break;
     case Intrinsics::kStringBufferToString:
-    case Intrinsics::kStringBuilderToString:
       SimplifyAllocationIntrinsic(instruction);
       break;
+    case Intrinsics::kStringBuilderToString:
+      if (TryReplaceStringBuilderAppend(instruction)) {
+        RecordSimplification();
+      } else {
+        SimplifyAllocationIntrinsic(instruction);
+      }
+      break;
     case Intrinsics::kUnsafeLoadFence:
       SimplifyMemBarrier(instruction, MemBarrierKind::kLoadAny);
       break;
@@ -24,6 +24,7 @@
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
 #include "mirror/dex_cache-inl.h"
+#include "mirror/var_handle.h"
 #include "nodes.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -139,9 +140,11 @@ static bool CheckInvokeType(Intrinsics intrinsic, HInvoke* invoke)
       // Call might be devirtualized.
       return (invoke_type == kVirtual || invoke_type == kDirect || invoke_type == kInterface);
 
+    case kPolymorphic:
+      return (invoke_type == kPolymorphic);
+
     case kSuper:
     case kInterface:
-    case kPolymorphic:
       return false;
   }
   LOG(FATAL) << "Unknown intrinsic invoke type: " << intrinsic_type;
@@ -159,9 +162,10 @@ bool IntrinsicsRecognizer::Recognize(HInvoke* invoke,
     return false;
   }
 
-  // TODO: b/65872996 The intent is that polymorphic signature methods should
-  // be compiler intrinsics. At present, they are only interpreter intrinsics.
-  if (art_method->IsPolymorphicSignature()) {
+  // Of the signature polymorphic methods, only the VarHandle accessors are compiler
+  // intrinsics. MethodHandle.invoke() and invokeExact() always go through the runtime.
+  if (art_method->IsPolymorphicSignature() &&
+      art_method->GetDeclaringClass() != mirror::VarHandle::StaticClass()) {
     return false;
   }
 
@@ -325,4 +329,107 @@ IntrinsicVisitor::IntegerValueOfInfo IntrinsicVisitor::ComputeIntegerValueOfInfo
   return info;
 }
 
+static size_t GetExpectedVarHandleValuesCount(Intrinsics intrinsic) {
+  switch (intrinsic) {
+    case Intrinsics::kVarHandleGet:
+    case Intrinsics::kVarHandleGetAcquire:
+    case Intrinsics::kVarHandleGetOpaque:
+    case Intrinsics::kVarHandleGetVolatile:
+      return 0u;
+    case Intrinsics::kVarHandleSet:
+    case Intrinsics::kVarHandleSetOpaque:
+    case Intrinsics::kVarHandleSetRelease:
+    case Intrinsics::kVarHandleSetVolatile:
+    case Intrinsics::kVarHandleGetAndAdd:
+      return 1u;
+    case Intrinsics::kVarHandleCompareAndSet:
+      return 2u;
+    default:
+      LOG(FATAL) << "Unexpected VarHandle intrinsic " << intrinsic;
+      UNREACHABLE();
+  }
+}
+
+bool IntrinsicVisitor::IsVarHandleFastPathCandidate(HInvoke* invoke) {
+  DCHECK(invoke->IsInvokePolymorphic());
+  size_t number_of_arguments = invoke->GetNumberOfArguments();
+  // The arguments are the VarHandle, the coordinates and the values, in that order.
+  size_t expected_values_count = GetExpectedVarHandleValuesCount(invoke->GetIntrinsic());
+  if (number_of_arguments < 2u + expected_values_count) {
+    // Static fields have no coordinate. They need a class initialization check, leave
+    // them to the runtime.
+    return false;
+  }
+  size_t coordinates_count = GetVarHandleCoordinatesCount(invoke);
+  if (coordinates_count > 2u) {
+    return false;
+  }
+  if (invoke->InputAt(1)->GetType() != DataType::Type::kReference) {
+    return false;
+  }
+  if (coordinates_count == 2u && invoke->InputAt(2)->GetType() != DataType::Type::kInt32) {
+    return false;
+  }
+
+  DataType::Type value_type = GetVarHandleValueType(invoke);
+  if (value_type != DataType::Type::kInt32 &&
+      value_type != DataType::Type::kInt64 &&
+      value_type != DataType::Type::kReference) {
+    return false;
+  }
+  for (size_t i = 1u + coordinates_count; i != number_of_arguments; ++i) {
+    if (invoke->InputAt(i)->GetType() != value_type) {
+      return false;
+    }
+  }
+
+  switch (invoke->GetIntrinsic()) {
+    case Intrinsics::kVarHandleGet:
+    case Intrinsics::kVarHandleGetAcquire:
+    case Intrinsics::kVarHandleGetOpaque:
+    case Intrinsics::kVarHandleGetVolatile:
+      return true;
+    case Intrinsics::kVarHandleSet:
+    case Intrinsics::kVarHandleSetOpaque:
+    case Intrinsics::kVarHandleSetRelease:
+    case Intrinsics::kVarHandleSetVolatile:
+      return invoke->GetType() == DataType::Type::kVoid;
+    case Intrinsics::kVarHandleGetAndAdd:
+      return value_type != DataType::Type::kReference && invoke->GetType() == value_type;
+    case Intrinsics::kVarHandleCompareAndSet:
+      return invoke->GetType() == DataType::Type::kBool;
+    default:
+      LOG(FATAL) << "Unexpected VarHandle intrinsic " << invoke->GetIntrinsic();
+      UNREACHABLE();
+  }
+}
+
+size_t IntrinsicVisitor::GetVarHandleCoordinatesCount(HInvoke* invoke) {
+  size_t expected_values_count = GetExpectedVarHandleValuesCount(invoke->GetIntrinsic());
+  DCHECK_GE(invoke->GetNumberOfArguments(), 1u + expected_values_count);
+  return invoke->GetNumberOfArguments() - 1u - expected_values_count;
+}
+
+DataType::Type IntrinsicVisitor::GetVarHandleValueType(HInvoke* invoke) {
+  if (GetExpectedVarHandleValuesCount(invoke->GetIntrinsic()) == 0u) {
+    return invoke->GetType();
+  }
+  return invoke->InputAt(invoke->GetNumberOfArguments() - 1u)->GetType();
+}
+
+Primitive::Type IntrinsicVisitor::GetVarHandleValuePrimitiveType(HInvoke* invoke) {
+  DataType::Type value_type = GetVarHandleValueType(invoke);
+  switch (value_type) {
+    case DataType::Type::kInt32:
+      return Primitive::kPrimInt;
+    case DataType::Type::kInt64:
+      return Primitive::kPrimLong;
+    case DataType::Type::kReference:
+      return Primitive::kPrimNot;
+    default:
+      LOG(FATAL) << "Unexpected VarHandle value type " << value_type;
+      UNREACHABLE();
+  }
+}
+
 }  // namespace art
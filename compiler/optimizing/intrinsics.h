@@ -154,6 +154,23 @@ class IntrinsicVisitor : public ValueObject {
 
   static IntegerValueOfInfo ComputeIntegerValueOfInfo();
 
+  // Returns whether a VarHandle accessor call site has a shape the code generators can
+  // compile inline: an instance field or an array element holding an int, long or reference
+  // variable, accessed with a signature that needs no conversions. Any other call site is
+  // compiled as a call to the runtime.
+  static bool IsVarHandleFastPathCandidate(HInvoke* invoke);
+
+  // Returns the number of coordinates of a VarHandle accessor call site: one for an instance
+  // field (the holder object) and two for an array element (the array and the index).
+  static size_t GetVarHandleCoordinatesCount(HInvoke* invoke);
+
+  // Returns the type of the variable accessed by a VarHandle accessor call site.
+  static DataType::Type GetVarHandleValueType(HInvoke* invoke);
+
+  // Returns the primitive type a VarHandle's variable type must have for the compiled fast
+  // path of a call site accepted by `IsVarHandleFastPathCandidate()`.
+  static Primitive::Type GetVarHandleValuePrimitiveType(HInvoke* invoke);
+
  protected:
   IntrinsicVisitor() {}
 
@@ -290,38 +307,32 @@ UNREACHABLE_INTRINSIC(Arch, VarHandleReleaseFence)              \
 UNREACHABLE_INTRINSIC(Arch, VarHandleLoadLoadFence)             \
 UNREACHABLE_INTRINSIC(Arch, VarHandleStoreStoreFence)           \
 UNREACHABLE_INTRINSIC(Arch, MethodHandleInvokeExact)            \
-UNREACHABLE_INTRINSIC(Arch, MethodHandleInvoke)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleCompareAndExchange)        \
-UNREACHABLE_INTRINSIC(Arch, VarHandleCompareAndExchangeAcquire) \
-UNREACHABLE_INTRINSIC(Arch, VarHandleCompareAndExchangeRelease) \
-UNREACHABLE_INTRINSIC(Arch, VarHandleCompareAndSet)             \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGet)                       \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAcquire)                \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndAdd)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndAddAcquire)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndAddRelease)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseAnd)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseAndAcquire)   \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseAndRelease)   \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseOr)           \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseOrAcquire)    \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseOrRelease)    \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseXor)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseXorAcquire)   \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndBitwiseXorRelease)   \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndSet)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndSetAcquire)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetAndSetRelease)          \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetOpaque)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleGetVolatile)               \
-UNREACHABLE_INTRINSIC(Arch, VarHandleSet)                       \
-UNREACHABLE_INTRINSIC(Arch, VarHandleSetOpaque)                 \
-UNREACHABLE_INTRINSIC(Arch, VarHandleSetRelease)                \
-UNREACHABLE_INTRINSIC(Arch, VarHandleSetVolatile)               \
-UNREACHABLE_INTRINSIC(Arch, VarHandleWeakCompareAndSet)         \
-UNREACHABLE_INTRINSIC(Arch, VarHandleWeakCompareAndSetAcquire)  \
-UNREACHABLE_INTRINSIC(Arch, VarHandleWeakCompareAndSetPlain)    \
-UNREACHABLE_INTRINSIC(Arch, VarHandleWeakCompareAndSetRelease)
+UNREACHABLE_INTRINSIC(Arch, MethodHandleInvoke)
+
+// Defines the VarHandle accessors that are recognized as intrinsics but have no compiled
+// fast path on any architecture. Calls to them always go through the runtime.
+#define UNIMPLEMENTED_VAR_HANDLE_INTRINSICS(Arch)                 \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleCompareAndExchange)        \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleCompareAndExchangeAcquire) \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleCompareAndExchangeRelease) \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndAddAcquire)          \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndAddRelease)          \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseAnd)          \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseAndAcquire)   \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseAndRelease)   \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseOr)           \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseOrAcquire)    \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseOrRelease)    \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseXor)          \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseXorAcquire)   \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndBitwiseXorRelease)   \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndSet)                 \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndSetAcquire)          \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleGetAndSetRelease)          \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleWeakCompareAndSet)         \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleWeakCompareAndSetAcquire)  \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleWeakCompareAndSetPlain)    \
+UNIMPLEMENTED_INTRINSIC(Arch, VarHandleWeakCompareAndSetRelease)
 
 template <typename IntrinsicLocationsBuilder, typename Codegenerator>
 bool IsCallFreeIntrinsic(HInvoke* invoke, Codegenerator* codegen) {
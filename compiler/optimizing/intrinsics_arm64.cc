@@ -17,6 +17,7 @@
 #include "intrinsics_arm64.h"
 
 #include "arch/arm64/instruction_set_features_arm64.h"
+#include "art_field.h"
 #include "art_method.h"
 #include "code_generator_arm64.h"
 #include "common_arm64.h"
@@ -28,6 +29,7 @@
 #include "mirror/object_array-inl.h"
 #include "mirror/reference.h"
 #include "mirror/string-inl.h"
+#include "mirror/var_handle.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "utils/arm64/assembler_arm64.h"
@@ -127,6 +129,8 @@ class IntrinsicSlowPathARM64 : public SlowPathCodeARM64 {
       if (invoke_->IsInvokeStaticOrDirect()) {
         codegen->GenerateStaticOrDirectCall(
             invoke_->AsInvokeStaticOrDirect(), LocationFrom(kArtMethodRegister), this);
+      } else if (invoke_->IsInvokePolymorphic()) {
+        codegen->GenerateInvokePolymorphicCall(invoke_->AsInvokePolymorphic(), this);
       } else {
         codegen->GenerateVirtualCall(
             invoke_->AsInvokeVirtual(), LocationFrom(kArtMethodRegister), this);
@@ -1174,18 +1178,22 @@ static void CreateIntIntIntIntIntToInt(ArenaAllocator* allocator,
   }
 }
 
-static void GenCas(HInvoke* invoke, DataType::Type type, CodeGeneratorARM64* codegen) {
+// Compares and sets the variable at `base` + `offset_loc`. For references with Baker read
+// barriers, `temp_loc` is used by the read barrier.
+static void GenCompareAndSet(HInvoke* invoke,
+                             DataType::Type type,
+                             CodeGeneratorARM64* codegen,
+                             Register base,
+                             Location offset_loc,
+                             Register expected,
+                             Register value,
+                             Location temp_loc) {
   MacroAssembler* masm = codegen->GetVIXLAssembler();
   LocationSummary* locations = invoke->GetLocations();
 
   Location out_loc = locations->Out();
   Register out = WRegisterFrom(out_loc);                           // Boolean result.
-
-  Register base = WRegisterFrom(locations->InAt(1));               // Object pointer.
-  Location offset_loc = locations->InAt(2);
   Register offset = XRegisterFrom(offset_loc);                     // Long offset.
-  Register expected = RegisterFrom(locations->InAt(3), type);      // Expected.
-  Register value = RegisterFrom(locations->InAt(4), type);         // Value.
 
   // This needs to be before the temp registers, as MarkGCCard also uses VIXL temps.
   if (type == DataType::Type::kReference) {
@@ -1198,7 +1206,7 @@ static void GenCas(HInvoke* invoke, DataType::Type type, CodeGeneratorARM64* cod
     DCHECK(!kEmitCompilerReadBarrier || kUseBakerReadBarrier);
 
     if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
-      Register temp = WRegisterFrom(locations->GetTemp(0));
+      Register temp = WRegisterFrom(temp_loc);
       // Need to make sure the reference stored in the field is a to-space
       // one before attempting the CAS or the CAS could fail incorrectly.
       codegen->UpdateReferenceFieldWithBakerReadBarrier(
@@ -1256,6 +1264,20 @@ static void GenCas(HInvoke* invoke, DataType::Type type, CodeGeneratorARM64* cod
   }
 }
 
+static void GenCas(HInvoke* invoke, DataType::Type type, CodeGeneratorARM64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  bool use_temp =
+      type == DataType::Type::kReference && kEmitCompilerReadBarrier && kUseBakerReadBarrier;
+  GenCompareAndSet(invoke,
+                   type,
+                   codegen,
+                   /* base */ WRegisterFrom(locations->InAt(1)),
+                   /* offset_loc */ locations->InAt(2),
+                   /* expected */ RegisterFrom(locations->InAt(3), type),
+                   /* value */ RegisterFrom(locations->InAt(4), type),
+                   use_temp ? locations->GetTemp(0) : Location::NoLocation());
+}
+
 void IntrinsicLocationsBuilderARM64::VisitUnsafeCASInt(HInvoke* invoke) {
   CreateIntIntIntIntIntToInt(allocator_, invoke, DataType::Type::kInt32);
 }
@@ -1286,6 +1308,348 @@ void IntrinsicCodeGeneratorARM64::VisitUnsafeCASObject(HInvoke* invoke) {
   GenCas(invoke, DataType::Type::kReference, codegen_);
 }
 
+// The compiled VarHandle accessors handle instance fields and array elements holding an int,
+// a long or a reference; see the x86-64 implementation for the checks made on the fast path.
+
+static bool IsVarHandleFastPathSupported(HInvoke* invoke) {
+  if (!IntrinsicVisitor::IsVarHandleFastPathCandidate(invoke)) {
+    return false;
+  }
+  // The only read barrier implementation supporting the VarHandle
+  // accessors on references is the Baker-style read barriers.
+  return !kEmitCompilerReadBarrier ||
+         kUseBakerReadBarrier ||
+         IntrinsicVisitor::GetVarHandleValueType(invoke) != DataType::Type::kReference;
+}
+
+static void CreateVarHandleLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  if (!IsVarHandleFastPathSupported(invoke)) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  for (size_t i = 0, e = invoke->GetNumberOfArguments(); i != e; ++i) {
+    locations->SetInAt(i, Location::RequiresRegister());
+  }
+  if (invoke->GetType() != DataType::Type::kVoid) {
+    locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  }
+  // The offset of the variable within its holder.
+  locations->AddTemp(Location::RequiresRegister());
+  Intrinsics intrinsic = invoke->GetIntrinsic();
+  bool reads_reference = intrinsic != Intrinsics::kVarHandleSet &&
+                         intrinsic != Intrinsics::kVarHandleSetOpaque &&
+                         intrinsic != Intrinsics::kVarHandleSetRelease &&
+                         intrinsic != Intrinsics::kVarHandleSetVolatile &&
+                         IntrinsicVisitor::GetVarHandleValueType(invoke) ==
+                             DataType::Type::kReference;
+  if (reads_reference && kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+    // Temporary register for (Baker) read barrier.
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+// Branches to `slow_path` unless the VarHandle supports the access mode of `invoke` and its
+// variable and coordinates match the call site. Otherwise, the offset of the variable within
+// the holder object (input 1) is left in the first temporary register.
+static void GenerateVarHandleChecks(HInvoke* invoke,
+                                    CodeGeneratorARM64* codegen,
+                                    SlowPathCodeARM64* slow_path) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register varhandle = WRegisterFrom(locations->InAt(0));
+  Register object = WRegisterFrom(locations->InAt(1));
+  Register offset = XRegisterFrom(locations->GetTemp(0));
+  const MemberOffset class_offset = mirror::Object::ClassOffset();
+  const MemberOffset var_type_offset = mirror::VarHandle::VarTypeOffset();
+
+  UseScratchRegisterScope temps(masm);
+  Register temp = temps.AcquireW();
+  Register temp2 = temps.AcquireW();
+
+  mirror::VarHandle::AccessMode access_mode =
+      mirror::VarHandle::GetAccessModeByIntrinsic(invoke->GetIntrinsic());
+  __ Ldr(temp, HeapOperand(varhandle, mirror::VarHandle::AccessModesBitMaskOffset()));
+  __ Tbz(temp, static_cast<uint32_t>(access_mode), slow_path->GetEntryLabel());
+
+  // /* HeapReference<Class> */ temp = varhandle->var_type_
+  __ Ldr(temp, HeapOperand(varhandle, var_type_offset));
+  codegen->GetAssembler()->MaybeUnpoisonHeapReference(temp);
+  __ Ldrh(temp, HeapOperand(temp, mirror::Class::PrimitiveTypeOffset()));
+  __ Cmp(temp, static_cast<uint32_t>(IntrinsicVisitor::GetVarHandleValuePrimitiveType(invoke)));
+  __ B(ne, slow_path->GetEntryLabel());
+
+  __ Cbz(object, slow_path->GetEntryLabel());
+
+  // The class of the holder must be exactly the first coordinate type. The (possibly
+  // poisoned) references are compared without read barriers: a false negative only
+  // sends us to the slow path.
+  // /* HeapReference<Class> */ temp = object->klass_
+  __ Ldr(temp, HeapOperand(object, class_offset));
+  __ Ldr(temp2, HeapOperand(varhandle, mirror::VarHandle::CoordinateType0Offset()));
+  __ Cmp(temp, temp2);
+  __ B(ne, slow_path->GetEntryLabel());
+
+  if (IntrinsicVisitor::GetVarHandleCoordinatesCount(invoke) == 1u) {
+    // Only a FieldVarHandle for an instance field has a single coordinate.
+    __ Ldr(temp2, HeapOperand(varhandle, mirror::VarHandle::CoordinateType1Offset()));
+    __ Cbnz(temp2, slow_path->GetEntryLabel());
+    // offset = varhandle->art_field_->offset_
+    __ Ldr(offset,
+           MemOperand(varhandle.X(), mirror::FieldVarHandle::ArtFieldOffset().Int32Value()));
+    __ Ldr(offset.W(), MemOperand(offset, ArtField::OffsetOffset().Int32Value()));
+  } else {
+    // The component type of the array must be the variable type. This rules out the
+    // VarHandles viewing byte arrays and byte buffers as arrays of wider elements.
+    Register index = WRegisterFrom(locations->InAt(2));
+    DataType::Type value_type = IntrinsicVisitor::GetVarHandleValueType(invoke);
+    codegen->GetAssembler()->MaybeUnpoisonHeapReference(temp);
+    // /* HeapReference<Class> */ temp = temp->component_type_
+    __ Ldr(temp, HeapOperand(temp, mirror::Class::ComponentTypeOffset()));
+    __ Ldr(temp2, HeapOperand(varhandle, var_type_offset));
+    __ Cmp(temp, temp2);
+    __ B(ne, slow_path->GetEntryLabel());
+    __ Ldr(temp, HeapOperand(object, mirror::Array::LengthOffset()));
+    __ Cmp(index, temp);
+    __ B(hs, slow_path->GetEntryLabel());
+    // offset = data_offset + (index << shift)
+    __ Mov(offset.W(), mirror::Array::DataOffset(DataType::Size(value_type)).Uint32Value());
+    __ Add(offset.W(), offset.W(), Operand(index, LSL, DataType::SizeShift(value_type)));
+  }
+}
+
+// Branches to `slow_path` unless the reference `value` stored by `invoke` is null or an
+// instance of exactly the variable type of the VarHandle.
+static void GenerateVarHandleReferenceValueCheck(HInvoke* invoke,
+                                                 CodeGeneratorARM64* codegen,
+                                                 Register value,
+                                                 SlowPathCodeARM64* slow_path) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  Register varhandle = WRegisterFrom(invoke->GetLocations()->InAt(0));
+
+  UseScratchRegisterScope temps(masm);
+  Register temp = temps.AcquireW();
+  Register temp2 = temps.AcquireW();
+
+  vixl::aarch64::Label value_ok;
+  __ Cbz(value, &value_ok);
+  // /* HeapReference<Class> */ temp = value->klass_
+  __ Ldr(temp, HeapOperand(value, mirror::Object::ClassOffset()));
+  __ Ldr(temp2, HeapOperand(varhandle, mirror::VarHandle::VarTypeOffset()));
+  __ Cmp(temp, temp2);
+  __ B(ne, slow_path->GetEntryLabel());
+  __ Bind(&value_ok);
+}
+
+static void GenerateVarHandleGet(HInvoke* invoke,
+                                 CodeGeneratorARM64* codegen,
+                                 bool use_load_acquire) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register object = WRegisterFrom(locations->InAt(1));
+  Location offset_loc = locations->GetTemp(0);
+  Location out_loc = locations->Out();
+  DataType::Type type = invoke->GetType();
+  Register out = RegisterFrom(out_loc, type);
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen, slow_path);
+
+  if (type == DataType::Type::kReference && kEmitCompilerReadBarrier) {
+    DCHECK(kUseBakerReadBarrier);
+    Register temp = WRegisterFrom(locations->GetTemp(1));
+    codegen->GenerateReferenceLoadWithBakerReadBarrier(invoke,
+                                                       out_loc,
+                                                       object,
+                                                       /* offset */ 0u,
+                                                       /* index */ offset_loc,
+                                                       /* scale_factor */ 0u,
+                                                       temp,
+                                                       /* needs_null_check */ false,
+                                                       use_load_acquire);
+  } else {
+    MemOperand mem_op(object.X(), XRegisterFrom(offset_loc));
+    if (use_load_acquire) {
+      codegen->LoadAcquire(invoke, out, mem_op, /* needs_null_check */ false);
+    } else {
+      codegen->Load(type, out, mem_op);
+    }
+    if (type == DataType::Type::kReference) {
+      codegen->GetAssembler()->MaybeUnpoisonHeapReference(out);
+    }
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void GenerateVarHandleSet(HInvoke* invoke,
+                                 CodeGeneratorARM64* codegen,
+                                 bool use_store_release) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  DataType::Type type = IntrinsicVisitor::GetVarHandleValueType(invoke);
+  Register object = WRegisterFrom(locations->InAt(1));
+  Register value = RegisterFrom(locations->InAt(invoke->GetNumberOfArguments() - 1u), type);
+  Register offset = XRegisterFrom(locations->GetTemp(0));
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen, slow_path);
+  if (type == DataType::Type::kReference) {
+    GenerateVarHandleReferenceValueCheck(invoke, codegen, value, slow_path);
+  }
+
+  MemOperand mem_op(object.X(), offset);
+  {
+    // We use a block to end the scratch scope before the write barrier, thus
+    // freeing the temporary registers so they can be used in `MarkGCCard`.
+    UseScratchRegisterScope temps(masm);
+    Register source = value;
+    if (kPoisonHeapReferences && type == DataType::Type::kReference) {
+      Register temp = temps.AcquireSameSizeAs(value);
+      __ Mov(temp.W(), value.W());
+      codegen->GetAssembler()->PoisonHeapReference(temp.W());
+      source = temp;
+    }
+    if (use_store_release) {
+      codegen->StoreRelease(invoke, type, source, mem_op, /* needs_null_check */ false);
+    } else {
+      codegen->Store(type, source, mem_op);
+    }
+  }
+
+  if (type == DataType::Type::kReference) {
+    bool value_can_be_null = invoke->InputAt(invoke->GetNumberOfArguments() - 1u)->CanBeNull();
+    codegen->MarkGCCard(object, value, value_can_be_null);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitVarHandleGet(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderARM64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderARM64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderARM64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitVarHandleGet(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, /* use_load_acquire */ false);
+}
+void IntrinsicCodeGeneratorARM64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, /* use_load_acquire */ true);
+}
+void IntrinsicCodeGeneratorARM64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, /* use_load_acquire */ false);
+}
+void IntrinsicCodeGeneratorARM64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_, /* use_load_acquire */ true);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitVarHandleSet(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderARM64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderARM64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderARM64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitVarHandleSet(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* use_store_release */ false);
+}
+void IntrinsicCodeGeneratorARM64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* use_store_release */ false);
+}
+void IntrinsicCodeGeneratorARM64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* use_store_release */ true);
+}
+void IntrinsicCodeGeneratorARM64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* use_store_release */ true);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitVarHandleCompareAndSet(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitVarHandleCompareAndSet(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  size_t number_of_arguments = invoke->GetNumberOfArguments();
+  DataType::Type type = IntrinsicVisitor::GetVarHandleValueType(invoke);
+  Register expected = RegisterFrom(locations->InAt(number_of_arguments - 2u), type);
+  Register value = RegisterFrom(locations->InAt(number_of_arguments - 1u), type);
+  bool use_temp =
+      type == DataType::Type::kReference && kEmitCompilerReadBarrier && kUseBakerReadBarrier;
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen_, slow_path);
+  if (type == DataType::Type::kReference) {
+    GenerateVarHandleReferenceValueCheck(invoke, codegen_, value, slow_path);
+  }
+
+  GenCompareAndSet(invoke,
+                   type,
+                   codegen_,
+                   /* base */ WRegisterFrom(locations->InAt(1)),
+                   /* offset_loc */ locations->GetTemp(0),
+                   expected,
+                   value,
+                   use_temp ? locations->GetTemp(1) : Location::NoLocation());
+  GetVIXLAssembler()->Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitVarHandleGetAndAdd(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitVarHandleGetAndAdd(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  DataType::Type type = invoke->GetType();
+  Register object = WRegisterFrom(locations->InAt(1));
+  Register value = RegisterFrom(locations->InAt(invoke->GetNumberOfArguments() - 1u), type);
+  Register tmp_ptr = XRegisterFrom(locations->GetTemp(0));
+  Register out = RegisterFrom(locations->Out(), type);
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen_, slow_path);
+
+  UseScratchRegisterScope temps(masm);
+  Register tmp_value = temps.AcquireSameSizeAs(value);             // New value.
+  Register tmp_32 = temps.AcquireW();                              // Store status.
+
+  // The offset is no longer needed, turn it into a pointer to the variable.
+  __ Add(tmp_ptr, object.X(), tmp_ptr);
+
+  // do {
+  //   out = [tmp_ptr];
+  // } while (failure([tmp_ptr] <- out + value));
+
+  vixl::aarch64::Label loop_head;
+  __ Bind(&loop_head);
+  __ Ldaxr(out, MemOperand(tmp_ptr));
+  __ Add(tmp_value, out, value);
+  __ Stlxr(tmp_32, tmp_value, MemOperand(tmp_ptr));
+  __ Cbnz(tmp_32, &loop_head);
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void IntrinsicLocationsBuilderARM64::VisitStringCompareTo(HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator_) LocationSummary(invoke,
@@ -3061,6 +3425,10 @@ UNIMPLEMENTED_INTRINSIC(ARM64, StringBufferAppend);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringBufferLength);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringBufferToString);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderAppend);
+UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderAppendBoolean);
+UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderAppendChar);
+UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderAppendInt);
+UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderAppendLong);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderLength);
 UNIMPLEMENTED_INTRINSIC(ARM64, StringBuilderToString);
 
@@ -3071,6 +3439,7 @@ UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(ARM64, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_VAR_HANDLE_INTRINSICS(ARM64)
 UNREACHABLE_INTRINSICS(ARM64)
 
 #undef __
@@ -3266,6 +3266,10 @@ UNIMPLEMENTED_INTRINSIC(MIPS, StringBufferAppend);
 UNIMPLEMENTED_INTRINSIC(MIPS, StringBufferLength);
 UNIMPLEMENTED_INTRINSIC(MIPS, StringBufferToString);
 UNIMPLEMENTED_INTRINSIC(MIPS, StringBuilderAppend);
+UNIMPLEMENTED_INTRINSIC(MIPS, StringBuilderAppendBoolean);
+UNIMPLEMENTED_INTRINSIC(MIPS, StringBuilderAppendChar);
+UNIMPLEMENTED_INTRINSIC(MIPS, StringBuilderAppendInt);
+UNIMPLEMENTED_INTRINSIC(MIPS, StringBuilderAppendLong);
 UNIMPLEMENTED_INTRINSIC(MIPS, StringBuilderLength);
 UNIMPLEMENTED_INTRINSIC(MIPS, StringBuilderToString);
 
@@ -3276,6 +3280,19 @@ UNIMPLEMENTED_INTRINSIC(MIPS, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(MIPS, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(MIPS, UnsafeGetAndSetObject)
 
+// VarHandle accessors.
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGet)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetOpaque)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleGetVolatile)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleSet)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleSetOpaque)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleSetRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS, VarHandleSetVolatile)
+
+UNIMPLEMENTED_VAR_HANDLE_INTRINSICS(MIPS)
 UNREACHABLE_INTRINSICS(MIPS)
 
 #undef __
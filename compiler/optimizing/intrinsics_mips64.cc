@@ -2639,6 +2639,10 @@ UNIMPLEMENTED_INTRINSIC(MIPS64, StringBufferAppend);
 UNIMPLEMENTED_INTRINSIC(MIPS64, StringBufferLength);
 UNIMPLEMENTED_INTRINSIC(MIPS64, StringBufferToString);
 UNIMPLEMENTED_INTRINSIC(MIPS64, StringBuilderAppend);
+UNIMPLEMENTED_INTRINSIC(MIPS64, StringBuilderAppendBoolean);
+UNIMPLEMENTED_INTRINSIC(MIPS64, StringBuilderAppendChar);
+UNIMPLEMENTED_INTRINSIC(MIPS64, StringBuilderAppendInt);
+UNIMPLEMENTED_INTRINSIC(MIPS64, StringBuilderAppendLong);
 UNIMPLEMENTED_INTRINSIC(MIPS64, StringBuilderLength);
 UNIMPLEMENTED_INTRINSIC(MIPS64, StringBuilderToString);
 
@@ -2649,6 +2653,19 @@ UNIMPLEMENTED_INTRINSIC(MIPS64, UnsafeGetAndSetInt)
 UNIMPLEMENTED_INTRINSIC(MIPS64, UnsafeGetAndSetLong)
 UNIMPLEMENTED_INTRINSIC(MIPS64, UnsafeGetAndSetObject)
 
+// VarHandle accessors.
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleCompareAndSet)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGet)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAcquire)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetAndAdd)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetOpaque)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleGetVolatile)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleSet)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleSetOpaque)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleSetRelease)
+UNIMPLEMENTED_INTRINSIC(MIPS64, VarHandleSetVolatile)
+
+UNIMPLEMENTED_VAR_HANDLE_INTRINSICS(MIPS64)
 UNREACHABLE_INTRINSICS(MIPS64)
 
 #undef __
@@ -19,6 +19,7 @@
 #include <limits>
 
 #include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "art_field.h"
 #include "art_method.h"
 #include "base/bit_utils.h"
 #include "code_generator_x86_64.h"
@@ -31,6 +32,7 @@
 #include "mirror/object_array-inl.h"
 #include "mirror/reference.h"
 #include "mirror/string.h"
+#include "mirror/var_handle.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "utils/x86_64/assembler_x86_64.h"
@@ -1826,6 +1828,261 @@ void IntrinsicCodeGeneratorX86_64::VisitStringIndexOfAfter(HInvoke* invoke) {
   GenerateStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ false);
 }
 
+static void CreateStringStringIndexOfLocations(HInvoke* invoke,
+                                               ArenaAllocator* allocator,
+                                               bool start_at_zero) {
+  LocationSummary* locations = new (allocator) LocationSummary(invoke,
+                                                               LocationSummary::kCallOnSlowPath,
+                                                               kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  if (!start_at_zero) {
+    locations->SetInAt(2, Location::RequiresRegister());          // The starting index.
+  }
+  // The inputs must be preserved for the slow path, so the output cannot reuse them.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+
+  // Variable shifts use CL as the count.
+  locations->AddTemp(Location::RegisterLocation(RCX));
+  // The length of the searched string, the current and end addresses of the scan,
+  // the mask of matching characters and a temporary to compare characters.
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  // The first character of the searched string in all lanes, and the block being scanned.
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+// Searches the characters of the string at `arg` in the string at `string_obj`, for all start
+// positions from the address in `cur` up to, but not including, the address in `end`. Both
+// strings use the same encoding, compressed (8-bit characters) or not (16-bit characters).
+//
+// Candidate positions are found by comparing 16 bytes of the string at a time with the first
+// character of `arg`. The loads are aligned to 16 bytes, so they never cross into another page
+// even when they read before the start or past the end of the characters. Matches outside of
+// the scanned range are masked out. Each candidate is then checked by comparing the remaining
+// characters one at a time. Leaves the index of the first match in `out`, or branches to
+// `not_found`.
+static void GenerateStringStringIndexOfLoop(X86_64Assembler* assembler,
+                                            CpuRegister string_obj,
+                                            CpuRegister arg,
+                                            CpuRegister arg_length,
+                                            CpuRegister cur,
+                                            CpuRegister end,
+                                            CpuRegister mask,
+                                            CpuRegister temp,
+                                            CpuRegister out,
+                                            XmmRegister first_char,
+                                            XmmRegister block,
+                                            bool is_compressed,
+                                            Label* not_found) {
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  const ScaleFactor scale = is_compressed ? ScaleFactor::TIMES_1 : ScaleFactor::TIMES_2;
+  CpuRegister rcx(RCX);
+
+  // Copy the first character to scan for to all lanes.
+  if (is_compressed) {
+    __ movzxb(mask, Address(arg, value_offset));
+    __ imull(mask, mask, Immediate(0x01010101));
+  } else {
+    __ movzxw(mask, Address(arg, value_offset));
+    __ imull(mask, mask, Immediate(0x00010001));
+  }
+  __ movd(first_char, mask, /* is64bit */ false);
+  __ pshufd(first_char, first_char, Immediate(0));
+
+  // Scan the aligned block holding the first start position, ignoring matches before it.
+  NearLabel next_block, check_mask, compare, found;
+  __ movl(rcx, cur);
+  __ andl(rcx, Immediate(15));
+  __ andq(cur, Immediate(-16));
+  __ movdqa(block, Address(cur, 0));
+  if (is_compressed) {
+    __ pcmpeqb(block, first_char);
+  } else {
+    __ pcmpeqw(block, first_char);
+  }
+  __ pmovmskb(mask, block);
+  __ shrl(mask, rcx);
+  __ shll(mask, rcx);
+  __ jmp(&check_mask);
+
+  __ Bind(&next_block);
+  __ addq(cur, Immediate(16));
+  __ cmpq(cur, end);
+  __ j(kAboveEqual, not_found);
+  __ movdqa(block, Address(cur, 0));
+  if (is_compressed) {
+    __ pcmpeqb(block, first_char);
+  } else {
+    __ pcmpeqw(block, first_char);
+  }
+  __ pmovmskb(mask, block);
+
+  __ Bind(&check_mask);
+  if (!is_compressed) {
+    // Each matching character sets two bits, only keep the one of its first byte.
+    __ andl(mask, Immediate(0x5555));
+  }
+  __ testl(mask, mask);
+  __ j(kEqual, &next_block);
+
+  // Candidates come in increasing order, so the scan is over once one is past the end.
+  __ bsfl(rcx, mask);
+  __ addq(rcx, cur);
+  __ cmpq(rcx, end);
+  __ j(kAboveEqual, not_found);
+
+  // Compare the remaining characters of the candidate at RCX.
+  __ movl(out, Immediate(1));
+  __ Bind(&compare);
+  __ cmpl(out, arg_length);
+  __ j(kGreaterEqual, &found);
+  if (is_compressed) {
+    __ movzxb(temp, Address(arg, out, scale, value_offset));
+    __ movzxb(CpuRegister(TMP), Address(rcx, out, scale, 0));
+  } else {
+    __ movzxw(temp, Address(arg, out, scale, value_offset));
+    __ movzxw(CpuRegister(TMP), Address(rcx, out, scale, 0));
+  }
+  __ addl(out, Immediate(1));
+  __ cmpl(temp, CpuRegister(TMP));
+  __ j(kEqual, &compare);
+  // Not a match, drop the candidate and look for the next one.
+  __ leal(CpuRegister(TMP), Address(mask, -1));
+  __ andl(mask, CpuRegister(TMP));
+  __ jmp(&check_mask);
+
+  // Compute the index of the match from its address.
+  __ Bind(&found);
+  __ leaq(out, Address(rcx, -value_offset));
+  __ subq(out, string_obj);
+  if (!is_compressed) {
+    __ shrl(out, Immediate(1));
+  }
+}
+
+static void GenerateStringStringIndexOf(HInvoke* invoke,
+                                        X86_64Assembler* assembler,
+                                        CodeGeneratorX86_64* codegen,
+                                        bool start_at_zero) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  CpuRegister string_obj = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister arg = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister rcx = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister arg_length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister cur = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister end = locations->GetTemp(3).AsRegister<CpuRegister>();
+  CpuRegister mask = locations->GetTemp(4).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(5).AsRegister<CpuRegister>();
+  XmmRegister first_char = locations->GetTemp(6).AsFpuRegister<XmmRegister>();
+  XmmRegister block = locations->GetTemp(7).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  // Check our assumptions for registers.
+  DCHECK_EQ(rcx.AsRegister(), RCX);
+
+  // Location of reference to data array within the String object.
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  // Location of count within the String object.
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+
+  // A null argument throws, and strings of different encodings are compared character
+  // by character. Both are left to the slow path.
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  if (invoke->InputAt(1)->CanBeNull()) {
+    __ testl(arg, arg);
+    __ j(kEqual, slow_path->GetEntryLabel());
+  }
+
+  // Load the count fields of both strings, containing the length and compression flag.
+  __ movl(rcx, Address(string_obj, count_offset));
+  __ movl(arg_length, Address(arg, count_offset));
+  if (mirror::kUseStringCompression) {
+    __ movl(CpuRegister(TMP), rcx);
+    __ xorl(CpuRegister(TMP), arg_length);
+    __ testl(CpuRegister(TMP), Immediate(1));
+    __ j(kNotZero, slow_path->GetEntryLabel());
+    // Mask out first bit used as compression flag.
+    __ shrl(rcx, Immediate(1));
+    __ shrl(arg_length, Immediate(1));
+  }
+
+  // Ensure we have a start index >= 0.
+  __ xorl(out, out);
+  if (!start_at_zero) {
+    CpuRegister start_index = locations->InAt(2).AsRegister<CpuRegister>();
+    __ cmpl(start_index, Immediate(0));
+    __ cmov(kGreater, out, start_index, /* is64bit */ false);  // 32-bit copy is enough.
+  }
+
+  // The empty string is found at the start index, clamped to the string length.
+  Label not_found, done;
+  __ testl(arg_length, arg_length);
+  NearLabel non_empty_arg;
+  __ j(kNotEqual, &non_empty_arg);
+  __ cmpl(out, rcx);
+  __ cmov(kGreater, out, rcx, /* is64bit */ false);
+  __ jmp(&done);
+  __ Bind(&non_empty_arg);
+
+  // The last start position is string.length - arg.length.
+  __ subl(rcx, arg_length);
+  __ cmpl(out, rcx);
+  __ j(kGreater, &not_found);
+
+  if (mirror::kUseStringCompression) {
+    NearLabel uncompressed_string_search;
+    __ testl(Address(string_obj, count_offset), Immediate(1));
+    __ j(kNotZero, &uncompressed_string_search);
+    // Scan from string_obj + value_offset + start_index to past the last start position.
+    __ leaq(cur, Address(string_obj, out, ScaleFactor::TIMES_1, value_offset));
+    __ leaq(end, Address(string_obj, rcx, ScaleFactor::TIMES_1, value_offset + 1));
+    GenerateStringStringIndexOfLoop(assembler, string_obj, arg, arg_length, cur, end, mask, temp,
+                                    out, first_char, block, /* is_compressed */ true, &not_found);
+    __ jmp(&done);
+    __ Bind(&uncompressed_string_search);
+  }
+  // Scan from string_obj + value_offset + 2 * start_index to past the last start position.
+  __ leaq(cur, Address(string_obj, out, ScaleFactor::TIMES_2, value_offset));
+  __ leaq(end, Address(string_obj, rcx, ScaleFactor::TIMES_2, value_offset + 2));
+  GenerateStringStringIndexOfLoop(assembler, string_obj, arg, arg_length, cur, end, mask, temp,
+                                  out, first_char, block, /* is_compressed */ false, &not_found);
+  __ jmp(&done);
+
+  // Failed to match; return -1.
+  __ Bind(&not_found);
+  __ movl(out, Immediate(-1));
+
+  // And join up at the end.
+  __ Bind(&done);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringStringIndexOf(HInvoke* invoke) {
+  CreateStringStringIndexOfLocations(invoke, allocator_, /* start_at_zero */ true);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringStringIndexOf(HInvoke* invoke) {
+  GenerateStringStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ true);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringStringIndexOfAfter(HInvoke* invoke) {
+  CreateStringStringIndexOfLocations(invoke, allocator_, /* start_at_zero */ false);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringStringIndexOfAfter(HInvoke* invoke) {
+  GenerateStringStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero */ false);
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitStringNewStringFromBytes(HInvoke* invoke) {
   LocationSummary* locations = new (allocator_) LocationSummary(
       invoke, LocationSummary::kCallOnMainAndSlowPath, kIntrinsified);
@@ -2401,16 +2658,22 @@ void IntrinsicLocationsBuilderX86_64::VisitUnsafeCASObject(HInvoke* invoke) {
   CreateIntIntIntIntIntToInt(allocator_, DataType::Type::kReference, invoke);
 }
 
-static void GenCAS(DataType::Type type, HInvoke* invoke, CodeGeneratorX86_64* codegen) {
+// Compares and sets the variable at `base` + `offset`. For references, `temp1` and `temp2`
+// are used for card marking and the (Baker) read barrier.
+static void GenCompareAndSet(DataType::Type type,
+                             HInvoke* invoke,
+                             CodeGeneratorX86_64* codegen,
+                             CpuRegister base,
+                             CpuRegister offset,
+                             CpuRegister expected,
+                             CpuRegister value,
+                             Location temp1_loc,
+                             Location temp2_loc) {
   X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
   LocationSummary* locations = invoke->GetLocations();
 
-  CpuRegister base = locations->InAt(1).AsRegister<CpuRegister>();
-  CpuRegister offset = locations->InAt(2).AsRegister<CpuRegister>();
-  CpuRegister expected = locations->InAt(3).AsRegister<CpuRegister>();
   // Ensure `expected` is in RAX (required by the CMPXCHG instruction).
   DCHECK_EQ(expected.AsRegister(), RAX);
-  CpuRegister value = locations->InAt(4).AsRegister<CpuRegister>();
   Location out_loc = locations->Out();
   CpuRegister out = out_loc.AsRegister<CpuRegister>();
 
@@ -2419,8 +2682,8 @@ static void GenCAS(DataType::Type type, HInvoke* invoke, CodeGeneratorX86_64* co
     // UnsafeCASObject intrinsic is the Baker-style read barriers.
     DCHECK(!kEmitCompilerReadBarrier || kUseBakerReadBarrier);
 
-    CpuRegister temp1 = locations->GetTemp(0).AsRegister<CpuRegister>();
-    CpuRegister temp2 = locations->GetTemp(1).AsRegister<CpuRegister>();
+    CpuRegister temp1 = temp1_loc.AsRegister<CpuRegister>();
+    CpuRegister temp2 = temp2_loc.AsRegister<CpuRegister>();
 
     // Mark card for object assuming new value is stored.
     bool value_can_be_null = true;  // TODO: Worth finding out this information?
@@ -2513,6 +2776,20 @@ static void GenCAS(DataType::Type type, HInvoke* invoke, CodeGeneratorX86_64* co
   }
 }
 
+static void GenCAS(DataType::Type type, HInvoke* invoke, CodeGeneratorX86_64* codegen) {
+  LocationSummary* locations = invoke->GetLocations();
+  bool is_reference = (type == DataType::Type::kReference);
+  GenCompareAndSet(type,
+                   invoke,
+                   codegen,
+                   /* base */ locations->InAt(1).AsRegister<CpuRegister>(),
+                   /* offset */ locations->InAt(2).AsRegister<CpuRegister>(),
+                   /* expected */ locations->InAt(3).AsRegister<CpuRegister>(),
+                   /* value */ locations->InAt(4).AsRegister<CpuRegister>(),
+                   is_reference ? locations->GetTemp(0) : Location::NoLocation(),
+                   is_reference ? locations->GetTemp(1) : Location::NoLocation());
+}
+
 void IntrinsicCodeGeneratorX86_64::VisitUnsafeCASInt(HInvoke* invoke) {
   GenCAS(DataType::Type::kInt32, invoke, codegen_);
 }
@@ -2529,6 +2806,474 @@ void IntrinsicCodeGeneratorX86_64::VisitUnsafeCASObject(HInvoke* invoke) {
   GenCAS(DataType::Type::kReference, invoke, codegen_);
 }
 
+static void CreateIntIntIntIntToIntPlusTemps(ArenaAllocator* allocator,
+                                             DataType::Type type,
+                                             HInvoke* invoke) {
+  bool can_call = kEmitCompilerReadBarrier &&
+      kUseBakerReadBarrier &&
+      (invoke->GetIntrinsic() == Intrinsics::kUnsafeGetAndSetObject);
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke,
+                                      can_call
+                                          ? LocationSummary::kCallOnSlowPath
+                                          : LocationSummary::kNoCall,
+                                      kIntrinsified);
+  locations->SetInAt(0, Location::NoLocation());        // Unused receiver.
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  // The output is written before the last use of the inputs.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  if (type == DataType::Type::kReference) {
+    // Need temporary registers for card-marking, and possibly for
+    // (Baker) read barrier.
+    locations->AddTemp(Location::RequiresRegister());
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndAddInt(HInvoke* invoke) {
+  CreateIntIntIntIntToIntPlusTemps(allocator_, DataType::Type::kInt32, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndAddLong(HInvoke* invoke) {
+  CreateIntIntIntIntToIntPlusTemps(allocator_, DataType::Type::kInt64, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndSetInt(HInvoke* invoke) {
+  CreateIntIntIntIntToIntPlusTemps(allocator_, DataType::Type::kInt32, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndSetLong(HInvoke* invoke) {
+  CreateIntIntIntIntToIntPlusTemps(allocator_, DataType::Type::kInt64, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitUnsafeGetAndSetObject(HInvoke* invoke) {
+  // The only read barrier implementation supporting the
+  // UnsafeGetAndSetObject intrinsic is the Baker-style read barriers.
+  if (kEmitCompilerReadBarrier && !kUseBakerReadBarrier) {
+    return;
+  }
+
+  CreateIntIntIntIntToIntPlusTemps(allocator_, DataType::Type::kReference, invoke);
+}
+
+static void GenUnsafeGetAndUpdate(DataType::Type type,
+                                  bool is_add,
+                                  HInvoke* invoke,
+                                  CodeGeneratorX86_64* codegen) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister base = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister offset = locations->InAt(2).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(3).AsRegister<CpuRegister>();
+  Location out_loc = locations->Out();
+  CpuRegister out = out_loc.AsRegister<CpuRegister>();
+  Address field_addr(base, offset, ScaleFactor::TIMES_1, 0);
+
+  // LOCK XADD and XCHG (locked implicitly) have full barrier semantics, and
+  // we don't need scheduling barriers at this time. Both leave the old value
+  // of the variable in `out`.
+  if (type == DataType::Type::kReference) {
+    DCHECK(!is_add);
+    // The only read barrier implementation supporting the
+    // UnsafeGetAndSetObject intrinsic is the Baker-style read barriers.
+    DCHECK(!kEmitCompilerReadBarrier || kUseBakerReadBarrier);
+
+    CpuRegister temp1 = locations->GetTemp(0).AsRegister<CpuRegister>();
+    CpuRegister temp2 = locations->GetTemp(1).AsRegister<CpuRegister>();
+
+    // Mark card for object assuming new value is stored.
+    bool value_can_be_null = invoke->InputAt(3)->CanBeNull();
+    codegen->MarkGCCard(temp1, temp2, base, value, value_can_be_null);
+
+    if (kEmitCompilerReadBarrier && kUseBakerReadBarrier) {
+      // Make sure the reference stored in the field is a to-space one before
+      // exchanging it, so that the old value returned is a to-space reference.
+      codegen->GenerateReferenceLoadWithBakerReadBarrier(
+          invoke,
+          out_loc,  // Unused, used only as a "temporary" within the read barrier.
+          base,
+          field_addr,
+          /* needs_null_check */ false,
+          /* always_update_field */ true,
+          &temp1,
+          &temp2);
+    }
+
+    __ movl(out, value);
+    __ MaybePoisonHeapReference(out);
+    __ xchgl(out, field_addr);
+    __ MaybeUnpoisonHeapReference(out);
+  } else if (type == DataType::Type::kInt64) {
+    __ movq(out, value);
+    if (is_add) {
+      __ LockXaddq(field_addr, out);
+    } else {
+      __ xchgq(out, field_addr);
+    }
+  } else {
+    DCHECK_EQ(type, DataType::Type::kInt32);
+    __ movl(out, value);
+    if (is_add) {
+      __ LockXaddl(field_addr, out);
+    } else {
+      __ xchgl(out, field_addr);
+    }
+  }
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndAddInt(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kInt32, /* is_add */ true, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndAddLong(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kInt64, /* is_add */ true, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndSetInt(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kInt32, /* is_add */ false, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndSetLong(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kInt64, /* is_add */ false, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitUnsafeGetAndSetObject(HInvoke* invoke) {
+  GenUnsafeGetAndUpdate(DataType::Type::kReference, /* is_add */ false, invoke, codegen_);
+}
+
+// The compiled VarHandle accessors handle instance fields and array elements holding an int,
+// a long or a reference. Their fast path checks that the VarHandle supports the access mode
+// and that its variable and coordinate types match the call site exactly. Everything else,
+// including throwing any exception, is left to the runtime on the slow path.
+
+static bool IsVarHandleFastPathSupported(HInvoke* invoke) {
+  if (!IntrinsicVisitor::IsVarHandleFastPathCandidate(invoke)) {
+    return false;
+  }
+  // The only read barrier implementation supporting the VarHandle
+  // accessors on references is the Baker-style read barriers.
+  return !kEmitCompilerReadBarrier ||
+         kUseBakerReadBarrier ||
+         IntrinsicVisitor::GetVarHandleValueType(invoke) != DataType::Type::kReference;
+}
+
+static void CreateVarHandleLocations(ArenaAllocator* allocator, HInvoke* invoke) {
+  if (!IsVarHandleFastPathSupported(invoke)) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  size_t number_of_arguments = invoke->GetNumberOfArguments();
+  for (size_t i = 0; i != number_of_arguments; ++i) {
+    locations->SetInAt(i, Location::RequiresRegister());
+  }
+  if (invoke->GetIntrinsic() == Intrinsics::kVarHandleCompareAndSet) {
+    // expected value must be in EAX/RAX.
+    locations->SetInAt(number_of_arguments - 2u, Location::RegisterLocation(RAX));
+  }
+  if (invoke->GetType() != DataType::Type::kVoid) {
+    locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  }
+  // The offset of the variable within its holder.
+  locations->AddTemp(Location::RequiresRegister());
+  // Used by the checks, and possibly for card-marking and reference poisoning.
+  locations->AddTemp(Location::RequiresRegister());
+  if (invoke->GetIntrinsic() == Intrinsics::kVarHandleCompareAndSet &&
+      IntrinsicVisitor::GetVarHandleValueType(invoke) == DataType::Type::kReference) {
+    // Need a second temporary register for card-marking and (Baker) read barrier.
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+// Branches to `slow_path` unless the VarHandle supports the access mode of `invoke` and its
+// variable and coordinates match the call site. Otherwise, the offset of the variable within
+// the holder object (input 1) is left in the first temporary register.
+static void GenerateVarHandleChecks(HInvoke* invoke,
+                                    CodeGeneratorX86_64* codegen,
+                                    SlowPathCode* slow_path) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister varhandle = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister object = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister offset = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(1).AsRegister<CpuRegister>();
+  const uint32_t class_offset = mirror::Object::ClassOffset().Uint32Value();
+  const uint32_t var_type_offset = mirror::VarHandle::VarTypeOffset().Uint32Value();
+
+  mirror::VarHandle::AccessMode access_mode =
+      mirror::VarHandle::GetAccessModeByIntrinsic(invoke->GetIntrinsic());
+  __ testl(Address(varhandle, mirror::VarHandle::AccessModesBitMaskOffset().Uint32Value()),
+           Immediate(1 << static_cast<uint32_t>(access_mode)));
+  __ j(kZero, slow_path->GetEntryLabel());
+
+  // /* HeapReference<Class> */ temp = varhandle->var_type_
+  __ movl(temp, Address(varhandle, var_type_offset));
+  __ MaybeUnpoisonHeapReference(temp);
+  __ cmpw(Address(temp, mirror::Class::PrimitiveTypeOffset().Uint32Value()),
+          Immediate(IntrinsicVisitor::GetVarHandleValuePrimitiveType(invoke)));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+
+  __ testl(object, object);
+  __ j(kZero, slow_path->GetEntryLabel());
+
+  // The class of the holder must be exactly the first coordinate type. The (possibly
+  // poisoned) references are compared without read barriers: a false negative only
+  // sends us to the slow path.
+  // /* HeapReference<Class> */ temp = object->klass_
+  __ movl(temp, Address(object, class_offset));
+  __ cmpl(temp, Address(varhandle, mirror::VarHandle::CoordinateType0Offset().Uint32Value()));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+
+  if (IntrinsicVisitor::GetVarHandleCoordinatesCount(invoke) == 1u) {
+    // Only a FieldVarHandle for an instance field has a single coordinate.
+    __ cmpl(Address(varhandle, mirror::VarHandle::CoordinateType1Offset().Uint32Value()),
+            Immediate(0));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+    // offset = varhandle->art_field_->offset_
+    __ movq(offset, Address(varhandle, mirror::FieldVarHandle::ArtFieldOffset().Uint32Value()));
+    __ movl(offset, Address(offset, ArtField::OffsetOffset().Uint32Value()));
+  } else {
+    // The component type of the array must be the variable type. This rules out the
+    // VarHandles viewing byte arrays and byte buffers as arrays of wider elements.
+    CpuRegister index = locations->InAt(2).AsRegister<CpuRegister>();
+    DataType::Type value_type = IntrinsicVisitor::GetVarHandleValueType(invoke);
+    __ MaybeUnpoisonHeapReference(temp);
+    // /* HeapReference<Class> */ temp = temp->component_type_
+    __ movl(temp, Address(temp, mirror::Class::ComponentTypeOffset().Uint32Value()));
+    __ cmpl(temp, Address(varhandle, var_type_offset));
+    __ j(kNotEqual, slow_path->GetEntryLabel());
+    __ cmpl(index, Address(object, mirror::Array::LengthOffset().Uint32Value()));
+    __ j(kAboveEqual, slow_path->GetEntryLabel());
+    // offset = data_offset + (index << shift)
+    __ movl(offset, index);
+    __ shll(offset, Immediate(DataType::SizeShift(value_type)));
+    __ addl(offset, Immediate(mirror::Array::DataOffset(DataType::Size(value_type)).Int32Value()));
+  }
+}
+
+// Branches to `slow_path` unless the reference `value` stored by `invoke` is null or an
+// instance of exactly the variable type of the VarHandle.
+static void GenerateVarHandleReferenceValueCheck(HInvoke* invoke,
+                                                 CodeGeneratorX86_64* codegen,
+                                                 CpuRegister value,
+                                                 SlowPathCode* slow_path) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister varhandle = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(1).AsRegister<CpuRegister>();
+
+  NearLabel value_ok;
+  __ testl(value, value);
+  __ j(kZero, &value_ok);
+  // /* HeapReference<Class> */ temp = value->klass_
+  __ movl(temp, Address(value, mirror::Object::ClassOffset().Uint32Value()));
+  __ cmpl(temp, Address(varhandle, mirror::VarHandle::VarTypeOffset().Uint32Value()));
+  __ j(kNotEqual, slow_path->GetEntryLabel());
+  __ Bind(&value_ok);
+}
+
+// The x86-64 memory model makes all loads acquire loads, so all the get access modes
+// share the same code.
+static void GenerateVarHandleGet(HInvoke* invoke, CodeGeneratorX86_64* codegen) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister object = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister offset = locations->GetTemp(0).AsRegister<CpuRegister>();
+  Location out_loc = locations->Out();
+  CpuRegister out = out_loc.AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen, slow_path);
+
+  Address address(object, offset, ScaleFactor::TIMES_1, 0);
+  switch (invoke->GetType()) {
+    case DataType::Type::kInt32:
+      __ movl(out, address);
+      break;
+
+    case DataType::Type::kInt64:
+      __ movq(out, address);
+      break;
+
+    case DataType::Type::kReference:
+      if (kEmitCompilerReadBarrier) {
+        DCHECK(kUseBakerReadBarrier);
+        codegen->GenerateReferenceLoadWithBakerReadBarrier(
+            invoke, out_loc, object, address, /* needs_null_check */ false);
+      } else {
+        __ movl(out, address);
+        __ MaybeUnpoisonHeapReference(out);
+      }
+      break;
+
+    default:
+      LOG(FATAL) << "Unexpected type " << invoke->GetType();
+      UNREACHABLE();
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+// We don't care for release: it requires an AnyStore barrier, which is already given by
+// the x86 memory model.
+static void GenerateVarHandleSet(HInvoke* invoke,
+                                 CodeGeneratorX86_64* codegen,
+                                 bool is_volatile) {
+  X86_64Assembler* assembler = down_cast<X86_64Assembler*>(codegen->GetAssembler());
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister object = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister value =
+      locations->InAt(invoke->GetNumberOfArguments() - 1u).AsRegister<CpuRegister>();
+  CpuRegister offset = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(1).AsRegister<CpuRegister>();
+  DataType::Type type = IntrinsicVisitor::GetVarHandleValueType(invoke);
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen, slow_path);
+  if (type == DataType::Type::kReference) {
+    GenerateVarHandleReferenceValueCheck(invoke, codegen, value, slow_path);
+  }
+
+  Address address(object, offset, ScaleFactor::TIMES_1, 0);
+  if (type == DataType::Type::kInt64) {
+    __ movq(address, value);
+  } else if (kPoisonHeapReferences && type == DataType::Type::kReference) {
+    __ movl(temp, value);
+    __ PoisonHeapReference(temp);
+    __ movl(address, temp);
+  } else {
+    __ movl(address, value);
+  }
+
+  if (is_volatile) {
+    codegen->MemoryFence();
+  }
+
+  if (type == DataType::Type::kReference) {
+    // The offset is no longer needed, use its register for card-marking.
+    bool value_can_be_null = invoke->InputAt(invoke->GetNumberOfArguments() - 1u)->CanBeNull();
+    codegen->MarkGCCard(offset, temp, object, value, value_can_be_null);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGet(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGet(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_);
+}
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGetAcquire(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_);
+}
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGetOpaque(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_);
+}
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGetVolatile(HInvoke* invoke) {
+  GenerateVarHandleGet(invoke, codegen_);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleSet(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleSet(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* is_volatile */ false);
+}
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleSetOpaque(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* is_volatile */ false);
+}
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleSetRelease(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* is_volatile */ false);
+}
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleSetVolatile(HInvoke* invoke) {
+  GenerateVarHandleSet(invoke, codegen_, /* is_volatile */ true);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleCompareAndSet(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleCompareAndSet(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  size_t number_of_arguments = invoke->GetNumberOfArguments();
+  CpuRegister expected = locations->InAt(number_of_arguments - 2u).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(number_of_arguments - 1u).AsRegister<CpuRegister>();
+  DataType::Type type = IntrinsicVisitor::GetVarHandleValueType(invoke);
+  bool is_reference = (type == DataType::Type::kReference);
+
+  SlowPathCode* slow_path = new (codegen_->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen_, slow_path);
+  if (is_reference) {
+    GenerateVarHandleReferenceValueCheck(invoke, codegen_, value, slow_path);
+  }
+
+  GenCompareAndSet(type,
+                   invoke,
+                   codegen_,
+                   /* base */ locations->InAt(1).AsRegister<CpuRegister>(),
+                   /* offset */ locations->GetTemp(0).AsRegister<CpuRegister>(),
+                   expected,
+                   value,
+                   is_reference ? locations->GetTemp(1) : Location::NoLocation(),
+                   is_reference ? locations->GetTemp(2) : Location::NoLocation());
+  GetAssembler()->Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitVarHandleGetAndAdd(HInvoke* invoke) {
+  CreateVarHandleLocations(allocator_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitVarHandleGetAndAdd(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister object = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister value =
+      locations->InAt(invoke->GetNumberOfArguments() - 1u).AsRegister<CpuRegister>();
+  CpuRegister offset = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen_->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  GenerateVarHandleChecks(invoke, codegen_, slow_path);
+
+  // LOCK XADD has full barrier semantics, and leaves the old value in `out`.
+  Address address(object, offset, ScaleFactor::TIMES_1, 0);
+  if (invoke->GetType() == DataType::Type::kInt64) {
+    __ movq(out, value);
+    __ LockXaddq(address, out);
+  } else {
+    DCHECK_EQ(invoke->GetType(), DataType::Type::kInt32);
+    __ movl(out, value);
+    __ LockXaddl(address, out);
+  }
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitIntegerReverse(HInvoke* invoke) {
   LocationSummary* locations =
       new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
@@ -3047,22 +3792,20 @@ UNIMPLEMENTED_INTRINSIC(X86_64, ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(X86_64, FloatIsInfinite)
 UNIMPLEMENTED_INTRINSIC(X86_64, DoubleIsInfinite)
 
-UNIMPLEMENTED_INTRINSIC(X86_64, StringStringIndexOf);
-UNIMPLEMENTED_INTRINSIC(X86_64, StringStringIndexOfAfter);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBufferAppend);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBufferLength);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBufferToString);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderAppend);
+UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderAppendBoolean);
+UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderAppendChar);
+UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderAppendInt);
+UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderAppendLong);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderLength);
 UNIMPLEMENTED_INTRINSIC(X86_64, StringBuilderToString);
 
 // 1.8.
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndAddInt)
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndAddLong)
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetInt)
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetLong)
-UNIMPLEMENTED_INTRINSIC(X86_64, UnsafeGetAndSetObject)
 
+UNIMPLEMENTED_VAR_HANDLE_INTRINSICS(X86_64)
 UNREACHABLE_INTRINSICS(X86_64)
 
 #undef __
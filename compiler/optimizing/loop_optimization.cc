@@ -23,19 +23,33 @@
 #include "arch/mips64/instruction_set_features_mips64.h"
 #include "arch/x86/instruction_set_features_x86.h"
 #include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "dead_code_elimination.h"
 #include "driver/compiler_driver.h"
 #include "linear_order.h"
 #include "mirror/array-inl.h"
 #include "mirror/string.h"
+#include "superblock_cloner.h"
 
 namespace art {
 
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Enables unswitching of inner loops on loop-invariant conditions.
+static constexpr bool kEnableLoopUnswitching = true;
+
+// Maximum number of instructions of a loop that is unswitched (limits code growth).
+static constexpr uint32_t kMaxUnswitchedLoopInstructions = 50;
+
+// Maximum number of a != b runtime tests guarding a vector loop.
+static constexpr size_t kMaxNumberOfRuntimeTests = 4;
+
 // No loop unrolling factor (just one copy of the loop-body).
 static constexpr uint32_t kNoUnrollingFactor = 1;
 
+// Largest SIMD vector size in bytes over all supported targets (256-bit AVX2).
+static constexpr uint32_t kMaxVectorSizeInBytes = 32;
+
 //
 // Static helpers.
 //
@@ -73,6 +87,66 @@ static bool IsGotoBlock(HBasicBlock* block, /*out*/ HBasicBlock** succ) {
   return false;
 }
 
+// Detect an inner loop, i.e. a loop without nested loops.
+static bool IsInnerLoop(HLoopInformation* loop_info) {
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    if (block->IsLoopHeader() && block != loop_info->GetHeader()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Creates a phi in the single loop exit for the instruction defined in the loop.
+static HPhi* CreateExitPhi(HInstruction* instruction, HBasicBlock* exit) {
+  DCHECK_EQ(exit->GetPredecessors().size(), 1u);
+  ArenaAllocator* allocator = exit->GetGraph()->GetAllocator();
+  HPhi* phi = new (allocator) HPhi(
+      allocator, kNoRegNumber, 0, HPhi::ToPhiType(instruction->GetType()));
+  if (instruction->GetType() == DataType::Type::kReference) {
+    phi->SetReferenceTypeInfo(instruction->GetReferenceTypeInfo());
+    phi->SetCanBeNull(instruction->CanBeNull());
+  }
+  exit->AddPhi(phi);
+  phi->AddInput(instruction);
+  return phi;
+}
+
+// Replace all uses of the instruction outside its loop with a phi in the single
+// loop exit, which puts the loop in closed SSA form for that instruction.
+static void ReplaceOutsideUsesWithExitPhi(HLoopInformation* loop_info,
+                                          HInstruction* instruction,
+                                          HBasicBlock* exit) {
+  HPhi* phi = nullptr;
+  const HUseList<HInstruction*>& uses = instruction->GetUses();
+  for (auto it = uses.begin(), end = uses.end(); it != end;) {
+    HInstruction* user = it->GetUser();
+    size_t index = it->GetIndex();
+    ++it;  // increment before replacing
+    if (!loop_info->Contains(*user->GetBlock())) {
+      if (phi == nullptr) {
+        phi = CreateExitPhi(instruction, exit);
+      }
+      user->ReplaceInput(phi, index);
+    }
+  }
+  const HUseList<HEnvironment*>& env_uses = instruction->GetEnvUses();
+  for (auto it = env_uses.begin(), end = env_uses.end(); it != end;) {
+    HEnvironment* user = it->GetUser();
+    size_t index = it->GetIndex();
+    ++it;  // increment before replacing
+    if (!loop_info->Contains(*user->GetHolder()->GetBlock())) {
+      if (phi == nullptr) {
+        phi = CreateExitPhi(instruction, exit);
+      }
+      user->RemoveAsUserOfInput(index);
+      user->SetRawEnvAt(index, phi);
+      phi->AddEnvUseAt(user, index);
+    }
+  }
+}
+
 // Detect an early exit loop.
 static bool IsEarlyExit(HLoopInformation* loop_info) {
   HBlocksInLoopReversePostOrderIterator it_loop(*loop_info);
@@ -424,8 +498,7 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_tests_(nullptr),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_mode_(kSequential),
@@ -446,6 +519,18 @@ void HLoopOptimization::Run() {
   ScopedArenaAllocator allocator(graph_->GetArenaStack());
   loop_allocator_ = &allocator;
 
+  // Unswitch loops first, so that the loop versions are seen by all other loop
+  // optimizations. Removing the branches made dead by unswitching rebuilds the
+  // loop information, so the induction information of all loops is recomputed.
+  if (kEnableLoopUnswitching && TryUnswitchLoops()) {
+    HDeadCodeElimination(graph_, stats_, "dead_code_elimination$loop_unswitching").Run();
+    for (HBasicBlock* block : graph_->GetPostOrder()) {
+      if (block->IsLoopHeader()) {
+        induction_range_.ReVisit(block->GetLoopInformation());
+      }
+    }
+  }
+
   // Perform loop optimizations.
   LocalRun();
   if (top_loop_ == nullptr) {
@@ -482,6 +567,8 @@ void HLoopOptimization::LocalRun() {
     ScopedArenaSafeMap<HInstruction*, HInstruction*> reds(
         std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
     ScopedArenaSet<ArrayReference> refs(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+    ScopedArenaVector<std::pair<HInstruction*, HInstruction*>> tests(
+        loop_allocator_->Adapter(kArenaAllocLoopOptimization));
     ScopedArenaSafeMap<HInstruction*, HInstruction*> map(
         std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
     ScopedArenaSafeMap<HInstruction*, HInstruction*> perm(
@@ -490,6 +577,7 @@ void HLoopOptimization::LocalRun() {
     iset_ = &iset;
     reductions_ = &reds;
     vector_refs_ = &refs;
+    vector_runtime_tests_ = &tests;
     vector_map_ = &map;
     vector_permanent_map_ = &perm;
     // Traverse.
@@ -498,6 +586,7 @@ void HLoopOptimization::LocalRun() {
     iset_ = nullptr;
     reductions_ = nullptr;
     vector_refs_ = nullptr;
+    vector_runtime_tests_ = nullptr;
     vector_map_ = nullptr;
     vector_permanent_map_ = nullptr;
   }
@@ -575,6 +664,130 @@ bool HLoopOptimization::TraverseLoopsInnerToOuter(LoopNode* node) {
   return changed;
 }
 
+//
+// Loop unswitching.
+//
+
+bool HLoopOptimization::TryUnswitchLoops() {
+  // Collect the inner loops first, as unswitching adds new loops to the graph.
+  ScopedArenaVector<HBasicBlock*> headers(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+  for (HBasicBlock* block : graph_->GetPostOrder()) {
+    if (block->IsLoopHeader() && IsInnerLoop(block->GetLoopInformation())) {
+      headers.push_back(block);
+    }
+  }
+  // Unswitching keeps the loop information of the existing loop headers.
+  bool unswitched = false;
+  for (HBasicBlock* header : headers) {
+    if (TryUnswitchLoop(header->GetLoopInformation())) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kLoopUnswitched);
+      unswitched = true;
+    }
+  }
+  return unswitched;
+}
+
+bool HLoopOptimization::TryUnswitchLoop(HLoopInformation* loop_info) {
+  HBasicBlock* header = loop_info->GetHeader();
+  HBasicBlock* preheader = loop_info->GetPreHeader();
+  // Find the single exit of the loop and the first branch in the loop-body on a
+  // loop-invariant condition. Ensure the loop is small enough to be copied.
+  HBasicBlock* exit = nullptr;
+  HIf* invariant_if = nullptr;
+  uint32_t number_of_instructions = 0;
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      if (!loop_info->Contains(*successor)) {
+        if (exit != nullptr) {
+          return false;  // more than one exit
+        }
+        exit = successor;
+      }
+    }
+    for (HInstructionIterator i(block->GetInstructions()); !i.Done(); i.Advance()) {
+      if (!i.Current()->IsClonable() ||
+          ++number_of_instructions > kMaxUnswitchedLoopInstructions) {
+        return false;
+      }
+    }
+    HInstruction* last = block->GetLastInstruction();
+    if (invariant_if == nullptr && block != header && last->IsIf()) {
+      HInstruction* condition = last->InputAt(0);
+      if (!condition->IsConstant() && !loop_info->Contains(*condition->GetBlock())) {
+        invariant_if = last->AsIf();
+      }
+    }
+  }
+  if (exit == nullptr || invariant_if == nullptr || exit->GetPredecessors().size() != 1) {
+    return false;
+  }
+  DCHECK_EQ(preheader->GetSingleSuccessor(), header);
+  DCHECK(preheader->GetLastInstruction()->IsGoto());
+
+  // Put the loop in closed SSA form, so that the copy of the loop only needs to
+  // provide its values to the exit phis.
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HInstructionIterator i(block->GetPhis()); !i.Done(); i.Advance()) {
+      ReplaceOutsideUsesWithExitPhi(loop_info, i.Current(), exit);
+    }
+    for (HInstructionIterator i(block->GetInstructions()); !i.Done(); i.Advance()) {
+      ReplaceOutsideUsesWithExitPhi(loop_info, i.Current(), exit);
+    }
+  }
+
+  // Branch on the invariant condition in the preheader:
+  //   if (condition) goto orig_entry; else goto copy_entry;
+  // Both entries lead to the loop header; the cloner then redirects the entry
+  // of the false branch to the copy of the loop.
+  HInstruction* condition = invariant_if->InputAt(0);
+  HBasicBlock* orig_entry = new (global_allocator_) HBasicBlock(graph_, header->GetDexPc());
+  HBasicBlock* copy_entry = new (global_allocator_) HBasicBlock(graph_, header->GetDexPc());
+  graph_->AddBlock(orig_entry);
+  graph_->AddBlock(copy_entry);
+  orig_entry->InsertBetween(preheader, header);
+  size_t orig_entry_index = header->GetPredecessorIndexOf(orig_entry);
+  copy_entry->AddSuccessor(header);
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    phi->AddInput(phi->InputAt(orig_entry_index));
+  }
+  preheader->AddSuccessor(copy_entry);
+  preheader->ReplaceAndRemoveInstructionWith(
+      preheader->GetLastInstruction(),
+      new (global_allocator_) HIf(condition, invariant_if->GetDexPc()));
+  orig_entry->AddInstruction(new (global_allocator_) HGoto());
+  copy_entry->AddInstruction(new (global_allocator_) HGoto());
+
+  // Copy the loop.
+  SuperblockCloner::HBasicBlockSet bb_set(
+      global_allocator_, graph_->GetBlocks().size(), false, kArenaAllocSuperblockCloner);
+  bb_set.Union(&loop_info->GetBlocks());
+  SuperblockCloner::HBasicBlockMap bb_map(
+      std::less<HBasicBlock*>(), global_allocator_->Adapter(kArenaAllocSuperblockCloner));
+  SuperblockCloner::HInstructionMap hir_map(
+      std::less<HInstruction*>(), global_allocator_->Adapter(kArenaAllocSuperblockCloner));
+  SuperblockCloner::HEdgeSet remap_orig_internal(
+      global_allocator_->Adapter(kArenaAllocSuperblockCloner));
+  SuperblockCloner::HEdgeSet remap_copy_internal(
+      global_allocator_->Adapter(kArenaAllocSuperblockCloner));
+  SuperblockCloner::HEdgeSet remap_incoming(
+      global_allocator_->Adapter(kArenaAllocSuperblockCloner));
+  remap_incoming.Insert(HEdge(copy_entry, header));
+  SuperblockCloner cloner(graph_, &bb_set, &bb_map, &hir_map);
+  cloner.SetSuccessorRemappingInfo(&remap_orig_internal, &remap_copy_internal, &remap_incoming);
+  cloner.Run();
+
+  // The original loop only runs when the condition holds, the copy when it does
+  // not. Dead code elimination later removes the branches not taken.
+  HInstruction* copy_if = cloner.GetInstrCopy(invariant_if);
+  invariant_if->ReplaceInput(graph_->GetIntConstant(1), 0);
+  copy_if->ReplaceInput(graph_->GetIntConstant(0), 0);
+  cloner.CleanUp();
+  return true;
+}
+
 //
 // Optimization.
 //
@@ -725,8 +938,7 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_runtime_tests_->clear();
 
   // Phis in the loop-body prevent vectorization.
   if (!block->GetPhis().IsEmpty()) {
@@ -748,8 +960,8 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
   // (3) variable to record how many references share same alignment.
   // (4) variable to record suitable candidate for dynamic loop peeling.
   uint32_t desired_alignment = GetVectorSizeInBytes();
-  DCHECK_LE(desired_alignment, 16u);
-  uint32_t peeling_votes[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  DCHECK_LE(desired_alignment, kMaxVectorSizeInBytes);
+  uint32_t peeling_votes[kMaxVectorSizeInBytes] = { 0 };
   uint32_t max_num_same_alignment = 0;
   const ArrayReference* peeling_candidate = nullptr;
 
@@ -785,14 +997,19 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
           if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
+            bool is_new_test = true;
+            for (const std::pair<HInstruction*, HInstruction*>& test : *vector_runtime_tests_) {
+              if ((test.first == a && test.second == b) || (test.first == b && test.second == a)) {
+                is_new_test = false;
+                break;
+              }
+            }
+            if (is_new_test) {
+              // To avoid excessive overhead, we only accept a few a != b tests.
+              if (vector_runtime_tests_->size() == kMaxNumberOfRuntimeTests) {
+                return false;  // one more test would be needed
+              }
+              vector_runtime_tests_->emplace_back(a, b);
             }
           }
         }
@@ -810,7 +1027,7 @@ bool HLoopOptimization::ShouldVectorize(LoopNode* node, HBasicBlock* block, int6
       uint32_t vote = (offset == 0)
           ? 0
           : ((desired_alignment - offset) >> DataType::SizeShift(i->type));
-      DCHECK_LT(vote, 16u);
+      DCHECK_LT(vote, kMaxVectorSizeInBytes);
       ++peeling_votes[vote];
     } else if (BaseAlignment() >= desired_alignment &&
                num_same_alignment > max_num_same_alignment) {
@@ -921,12 +1138,13 @@ void HLoopOptimization::Vectorize(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
-  // vtc = a != b ? vtc : 0;
-  if (vector_runtime_test_a_ != nullptr) {
+  // Generate runtime disambiguation tests, which version the loop: the vector loop
+  // runs only if all tests pass, and the cleanup loop runs all iterations otherwise.
+  // vtc = a != b ? vtc : 0;  (for each test)
+  for (const std::pair<HInstruction*, HInstruction*>& test : *vector_runtime_tests_) {
     HInstruction* rt = Insert(
         preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
+        new (global_allocator_) HNotEqual(test.first, test.second));
     vtc = Insert(preheader,
                  new (global_allocator_)
                  HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
@@ -1380,6 +1598,12 @@ uint32_t HLoopOptimization::GetVectorSizeInBytes() {
     case InstructionSet::kArm:
     case InstructionSet::kThumb2:
       return 8;  // 64-bit SIMD
+    case InstructionSet::kX86_64: {
+      const InstructionSetFeatures* features = compiler_driver_->GetInstructionSetFeatures();
+      return features->AsX86_64InstructionSetFeatures()->HasAVX2()
+          ? 32   // 256-bit SIMD
+          : 16;  // 128-bit SIMD
+    }
     default:
       return 16;  // 128-bit SIMD
   }
@@ -1439,31 +1663,33 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
       }
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
-      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
+      // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD),
+      // widened to 256-bit SIMD on AVX2-enabled X86_64 devices.
       if (features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
+        uint32_t vector_size = GetVectorSizeInBytes();
         switch (type) {
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
           case DataType::Type::kInt8:
             *restrictions |=
                 kNoMul | kNoDiv | kNoShift | kNoAbs | kNoSignedHAdd | kNoUnroundedHAdd | kNoSAD;
-            return TrySetVectorLength(16);
+            return TrySetVectorLength(vector_size);
           case DataType::Type::kUint16:
           case DataType::Type::kInt16:
             *restrictions |= kNoDiv | kNoAbs | kNoSignedHAdd | kNoUnroundedHAdd | kNoSAD;
-            return TrySetVectorLength(8);
+            return TrySetVectorLength(vector_size / 2);
           case DataType::Type::kInt32:
             *restrictions |= kNoDiv | kNoSAD;
-            return TrySetVectorLength(4);
+            return TrySetVectorLength(vector_size / 4);
           case DataType::Type::kInt64:
             *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoMinMax | kNoSAD;
-            return TrySetVectorLength(2);
+            return TrySetVectorLength(vector_size / 8);
           case DataType::Type::kFloat32:
             *restrictions |= kNoMinMax | kNoReduction;  // minmax: -0.0 vs +0.0
-            return TrySetVectorLength(4);
+            return TrySetVectorLength(vector_size / 4);
           case DataType::Type::kFloat64:
             *restrictions |= kNoMinMax | kNoReduction;  // minmax: -0.0 vs +0.0
-            return TrySetVectorLength(2);
+            return TrySetVectorLength(vector_size / 8);
           default:
             break;
         }  // switch type
@@ -2100,7 +2326,7 @@ void HLoopOptimization::SetAlignmentStrategy(uint32_t peeling_votes[],
   // Current heuristic: pick the best static loop peeling factor, if any,
   // or otherwise use dynamic loop peeling on suggested peeling candidate.
   uint32_t max_vote = 0;
-  for (int32_t i = 0; i < 16; i++) {
+  for (uint32_t i = 0; i < kMaxVectorSizeInBytes; i++) {
     if (peeling_votes[i] > max_vote) {
       max_vote = peeling_votes[i];
       vector_static_peeling_factor_ = i;
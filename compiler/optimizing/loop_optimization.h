@@ -29,8 +29,8 @@ class CompilerDriver;
 
 /**
  * Loop optimizations. Builds a loop hierarchy and applies optimizations to
- * the detected nested loops, such as removal of dead induction and empty loops
- * and inner loop vectorization.
+ * the detected nested loops, such as unswitching, removal of dead induction
+ * and empty loops and inner loop vectorization.
  */
 class HLoopOptimization : public HOptimization {
  public:
@@ -127,6 +127,16 @@ class HLoopOptimization : public HOptimization {
   // Returns true if loops nested inside current loop (node) have changed.
   bool TraverseLoopsInnerToOuter(LoopNode* node);
 
+  //
+  // Loop unswitching.
+  //
+
+  // Unswitches the inner loops on a loop-invariant condition, so that each version
+  // of the loop only contains one side of the condition. Returns true if any loop
+  // has been unswitched.
+  bool TryUnswitchLoops();
+  bool TryUnswitchLoop(HLoopInformation* loop_info);
+
   //
   // Optimization.
   //
@@ -270,9 +280,11 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b. These tests version the loop
+  // into the vector loop and the sequential cleanup loop, which runs all iterations
+  // if any test fails.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>>* vector_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
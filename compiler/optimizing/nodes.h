@@ -315,6 +315,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
          InvokeType invoke_type = kInvalidInvokeType,
          bool debuggable = false,
          bool osr = false,
+         bool baseline = false,
          int start_instruction_id = 0)
       : allocator_(allocator),
         arena_stack_(arena_stack),
@@ -349,6 +350,7 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         art_method_(nullptr),
         inexact_object_rti_(ReferenceTypeInfo::CreateInvalid()),
         osr_(osr),
+        baseline_(baseline),
         cha_single_implementation_list_(allocator->Adapter(kArenaAllocCHA)) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
@@ -573,6 +575,8 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   bool IsCompilingOsr() const { return osr_; }
 
+  bool IsCompilingBaseline() const { return baseline_; }
+
   ArenaSet<ArtMethod*>& GetCHASingleImplementationList() {
     return cha_single_implementation_list_;
   }
@@ -751,6 +755,10 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
   // compiled code entries which the interpreter can directly jump to.
   const bool osr_;
 
+  // Whether we are compiling baseline code for the JIT: no optimizations are run
+  // and the code counts its own hotness to request an optimized recompilation.
+  const bool baseline_;
+
   // List of methods that are assumed to have single implementation.
   ArenaSet<ArtMethod*> cha_single_implementation_list_;
 
@@ -1407,6 +1415,7 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(Shr, BinaryOperation)                                               \
   M(StaticFieldGet, Instruction)                                        \
   M(StaticFieldSet, Instruction)                                        \
+  M(StringBuilderAppend, Instruction)                                   \
   M(UnresolvedInstanceFieldGet, Instruction)                            \
   M(UnresolvedInstanceFieldSet, Instruction)                            \
   M(UnresolvedStaticFieldGet, Instruction)                              \
@@ -4381,7 +4390,10 @@ class HInvokePolymorphic FINAL : public HInvoke {
                      uint32_t number_of_arguments,
                      DataType::Type return_type,
                      uint32_t dex_pc,
-                     uint32_t dex_method_index)
+                     uint32_t dex_method_index,
+                     // The signature polymorphic method, e.g. VarHandle.get, or null if it
+                     // could not be resolved.
+                     ArtMethod* resolved_method)
       : HInvoke(kInvokePolymorphic,
                 allocator,
                 number_of_arguments,
@@ -4389,8 +4401,8 @@ class HInvokePolymorphic FINAL : public HInvoke {
                 return_type,
                 dex_pc,
                 dex_method_index,
-                nullptr,
-                kVirtual) {
+                resolved_method,
+                kPolymorphic) {
   }
 
   bool IsClonable() const OVERRIDE { return true; }
@@ -4684,6 +4696,10 @@ class HInvokeVirtual FINAL : public HInvoke {
       case Intrinsics::kStringBufferAppend:
       case Intrinsics::kStringBufferToString:
       case Intrinsics::kStringBuilderAppend:
+      case Intrinsics::kStringBuilderAppendBoolean:
+      case Intrinsics::kStringBuilderAppendChar:
+      case Intrinsics::kStringBuilderAppendInt:
+      case Intrinsics::kStringBuilderAppendLong:
       case Intrinsics::kStringBuilderToString:
         return false;
       default:
@@ -4814,6 +4830,64 @@ class HNewArray FINAL : public HExpression<2> {
   DEFAULT_COPY_CONSTRUCTOR(NewArray);
 };
 
+// Fused `new StringBuilder().append(...)...append(...).toString()` chain. The inputs
+// are the appended values followed by an HIntConstant describing their kinds, in the
+// format expected by StringBuilderAppend::AppendF().
+class HStringBuilderAppend FINAL : public HVariableInputSizeInstruction {
+ public:
+  HStringBuilderAppend(HIntConstant* format,
+                       uint32_t number_of_arguments,
+                       ArenaAllocator* allocator,
+                       uint32_t dex_pc)
+      : HVariableInputSizeInstruction(
+            kStringBuilderAppend,
+            // The runtime call may allocate and thus trigger GC. The StringBuilder
+            // replaced by this instruction does not escape, so there are no other
+            // observable side effects.
+            SideEffects::CanTriggerGC(),
+            dex_pc,
+            allocator,
+            number_of_arguments + /* format */ 1u,
+            kArenaAllocInvokeInputs) {
+    DCHECK_GE(number_of_arguments, 1u);  // There must be something to append.
+    SetRawInputAt(FormatIndex(), format);
+  }
+
+  void SetArgumentAt(size_t index, HInstruction* argument) {
+    DCHECK_LT(index, GetNumberOfArguments());
+    SetRawInputAt(index, argument);
+  }
+
+  // Return the number of arguments, excluding the format.
+  size_t GetNumberOfArguments() const {
+    DCHECK_GE(InputCount(), 1u);
+    return InputCount() - 1u;
+  }
+
+  size_t FormatIndex() const {
+    return GetNumberOfArguments();
+  }
+
+  HIntConstant* GetFormat() {
+    return InputAt(FormatIndex())->AsIntConstant();
+  }
+
+  DataType::Type GetType() const OVERRIDE { return DataType::Type::kReference; }
+
+  // Calls runtime so needs an environment.
+  bool NeedsEnvironment() const OVERRIDE { return true; }
+
+  // May throw OutOfMemoryError.
+  bool CanThrow() const OVERRIDE { return true; }
+
+  bool CanBeNull() const OVERRIDE { return false; }
+
+  DECLARE_INSTRUCTION(StringBuilderAppend);
+
+ protected:
+  DEFAULT_COPY_CONSTRUCTOR(StringBuilderAppend);
+};
+
 class HAdd FINAL : public HBinaryOperation {
  public:
   HAdd(DataType::Type result_type,
@@ -50,6 +50,7 @@
 #include "load_store_analysis.h"
 #include "load_store_elimination.h"
 #include "loop_optimization.h"
+#include "partial_escape_analysis.h"
 #include "scheduler.h"
 #include "select_generator.h"
 #include "sharpening.h"
@@ -97,6 +98,8 @@ const char* OptimizationPassName(OptimizationPass pass) {
       return CodeSinking::kCodeSinkingPassName;
     case OptimizationPass::kConstructorFenceRedundancyElimination:
       return ConstructorFenceRedundancyElimination::kCFREPassName;
+    case OptimizationPass::kPartialEscapeAnalysis:
+      return PartialEscapeAnalysis::kPartialEscapeAnalysisPassName;
     case OptimizationPass::kScheduling:
       return HInstructionScheduling::kInstructionSchedulingPassName;
 #ifdef ART_ENABLE_CODEGEN_arm
@@ -142,6 +145,7 @@ OptimizationPass OptimizationPassByName(const std::string& name) {
   X(OptimizationPass::kLoadStoreAnalysis);
   X(OptimizationPass::kLoadStoreElimination);
   X(OptimizationPass::kLoopOptimization);
+  X(OptimizationPass::kPartialEscapeAnalysis);
   X(OptimizationPass::kScheduling);
   X(OptimizationPass::kSelectGenerator);
   X(OptimizationPass::kSharpening);
@@ -225,7 +229,7 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kBoundsCheckElimination:
         CHECK(most_recent_side_effects != nullptr && most_recent_induction != nullptr);
         opt = new (allocator) BoundsCheckElimination(
-            graph, *most_recent_side_effects, most_recent_induction, name);
+            graph, *most_recent_side_effects, most_recent_induction, stats, name);
         break;
       case OptimizationPass::kLoadStoreElimination:
         CHECK(most_recent_side_effects != nullptr && most_recent_induction != nullptr);
@@ -280,9 +284,15 @@ ArenaVector<HOptimization*> ConstructOptimizations(
       case OptimizationPass::kConstructorFenceRedundancyElimination:
         opt = new (allocator) ConstructorFenceRedundancyElimination(graph, stats, name);
         break;
+      case OptimizationPass::kPartialEscapeAnalysis:
+        opt = new (allocator) PartialEscapeAnalysis(graph, stats, name);
+        break;
       case OptimizationPass::kScheduling:
-        opt = new (allocator) HInstructionScheduling(
-            graph, driver->GetInstructionSet(), codegen, name);
+        opt = new (allocator) HInstructionScheduling(graph,
+                                                     driver->GetInstructionSet(),
+                                                     codegen,
+                                                     driver->GetInstructionSetFeatures(),
+                                                     name);
         break;
       //
       // Arch-specific passes.
@@ -81,6 +81,7 @@ enum class OptimizationPass {
   kLoadStoreAnalysis,
   kLoadStoreElimination,
   kLoopOptimization,
+  kPartialEscapeAnalysis,
   kScheduling,
   kSelectGenerator,
   kSharpening,
@@ -292,6 +292,7 @@ class OptimizingCompiler FINAL : public Compiler {
   bool JitCompile(Thread* self,
                   jit::JitCodeCache* code_cache,
                   ArtMethod* method,
+                  bool baseline,
                   bool osr,
                   jit::JitLogger* jit_logger)
       OVERRIDE
@@ -354,12 +355,15 @@ class OptimizingCompiler FINAL : public Compiler {
   // 1) Builds the graph. Returns null if it failed to build it.
   // 2) Transforms the graph to SSA. Returns null if it failed.
   // 3) Runs optimizations on the graph, including register allocator.
+  //    For `baseline` compilation, only the passes required by code generation
+  //    are run and registers are allocated with linear scan.
   // 4) Generates code with the `code_allocator` provided.
   CodeGenerator* TryCompile(ArenaAllocator* allocator,
                             ArenaStack* arena_stack,
                             CodeVectorAllocator* code_allocator,
                             const DexCompilationUnit& dex_compilation_unit,
                             ArtMethod* method,
+                            bool baseline,
                             bool osr,
                             VariableSizedHandleScope* handles) const;
 
@@ -382,6 +386,12 @@ class OptimizingCompiler FINAL : public Compiler {
                             PassObserver* pass_observer,
                             VariableSizedHandleScope* handles) const;
 
+  void RunBaselineOptimizations(HGraph* graph,
+                                CodeGenerator* codegen,
+                                const DexCompilationUnit& dex_compilation_unit,
+                                PassObserver* pass_observer,
+                                VariableSizedHandleScope* handles) const;
+
   void GenerateJitDebugInfo(ArtMethod* method, debug::MethodDebugInfo method_debug_info)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -555,6 +565,9 @@ void OptimizingCompiler::RunArchOptimizations(HGraph* graph,
       OptimizationDef x86_64_optimizations[] = {
         OptDef(OptimizationPass::kSideEffectsAnalysis),
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+        // Schedule before memory operand generation, which relies on the ArrayLength
+        // staying next to its BoundsCheck.
+        OptDef(OptimizationPass::kScheduling),
         OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       RunOptimizations(graph,
@@ -571,6 +584,26 @@ void OptimizingCompiler::RunArchOptimizations(HGraph* graph,
   }
 }
 
+void OptimizingCompiler::RunBaselineOptimizations(
+    HGraph* graph,
+    CodeGenerator* codegen,
+    const DexCompilationUnit& dex_compilation_unit,
+    PassObserver* pass_observer,
+    VariableSizedHandleScope* handles) const {
+  // Sharpening is a single cheap walk over the graph and saves the runtime
+  // calls of unsharpened invokes and loads. Nothing else is needed by the
+  // code generators supporting baseline compilation.
+  OptimizationDef optimizations[] = {
+    OptDef(OptimizationPass::kSharpening)
+  };
+  RunOptimizations(graph,
+                   codegen,
+                   dex_compilation_unit,
+                   pass_observer,
+                   handles,
+                   optimizations);
+}
+
 NO_INLINE  // Avoid increasing caller's frame size by large stack-allocated objects.
 static void AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
@@ -592,8 +625,11 @@ static void AllocateRegisters(HGraph* graph,
   }
   {
     PassScope scope(RegisterAllocator::kRegisterAllocatorPassName, pass_observer);
+    if (strategy == RegisterAllocator::kRegisterAllocatorGraphColor) {
+      MaybeRecordStat(stats, MethodCompilationStat::kRegisterAllocatedWithGraphColor);
+    }
     std::unique_ptr<RegisterAllocator> register_allocator =
-        RegisterAllocator::Create(&local_allocator, codegen, liveness, strategy);
+        RegisterAllocator::Create(&local_allocator, codegen, liveness, strategy, stats);
     register_allocator->AllocateRegisters();
   }
 }
@@ -663,6 +699,8 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     // Evaluates code generated by dynamic bce.
     OptDef(OptimizationPass::kConstantFolding,       "constant_folding$after_bce"),
     OptDef(OptimizationPass::kInstructionSimplifier, "instruction_simplifier$after_bce"),
+    // Makes allocations that escape only on some paths removable by LSE.
+    OptDef(OptimizationPass::kPartialEscapeAnalysis),
     OptDef(OptimizationPass::kSideEffectsAnalysis,   "side_effects$before_lse"),
     OptDef(OptimizationPass::kLoadStoreAnalysis),
     OptDef(OptimizationPass::kLoadStoreElimination),
@@ -739,6 +777,7 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
                                               CodeVectorAllocator* code_allocator,
                                               const DexCompilationUnit& dex_compilation_unit,
                                               ArtMethod* method,
+                                              bool baseline,
                                               bool osr,
                                               VariableSizedHandleScope* handles) const {
   MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kAttemptBytecodeCompilation);
@@ -784,7 +823,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
       compiler_driver->GetInstructionSet(),
       kInvalidInvokeType,
       compiler_driver->GetCompilerOptions().GetDebuggable(),
-      osr);
+      osr,
+      baseline);
 
   ArrayRef<const uint8_t> interpreter_metadata;
   // For AOT compilation, we may not get a method, for example if its class is erroneous.
@@ -858,14 +898,23 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
     }
   }
 
-  RunOptimizations(graph,
-                   codegen.get(),
-                   dex_compilation_unit,
-                   &pass_observer,
-                   handles);
-
   RegisterAllocator::Strategy regalloc_strategy =
     compiler_options.GetRegisterAllocationStrategy();
+  if (baseline) {
+    RunBaselineOptimizations(graph,
+                             codegen.get(),
+                             dex_compilation_unit,
+                             &pass_observer,
+                             handles);
+    regalloc_strategy = RegisterAllocator::kRegisterAllocatorLinearScan;
+  } else {
+    RunOptimizations(graph,
+                     codegen.get(),
+                     dex_compilation_unit,
+                     &pass_observer,
+                     handles);
+  }
+
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
@@ -875,7 +924,9 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
   codegen->Compile(code_allocator);
   pass_observer.DumpDisassembly();
 
-  MaybeRecordStat(compilation_stats_.get(), MethodCompilationStat::kCompiledBytecode);
+  MaybeRecordStat(compilation_stats_.get(),
+                  baseline ? MethodCompilationStat::kCompiledBaselineBytecode
+                           : MethodCompilationStat::kCompiledBytecode);
   return codegen.release();
 }
 
@@ -1042,6 +1093,7 @@ CompiledMethod* OptimizingCompiler::Compile(const DexFile::CodeItem* code_item,
                        &code_allocator,
                        dex_compilation_unit,
                        method,
+                       /* baseline */ false,
                        /* osr */ false,
                        &handles));
       }
@@ -1185,6 +1237,7 @@ bool CanEncodeInlinedMethodInStackMap(const DexFile& caller_dex_file, ArtMethod*
 bool OptimizingCompiler::JitCompile(Thread* self,
                                     jit::JitCodeCache* code_cache,
                                     ArtMethod* method,
+                                    bool baseline,
                                     bool osr,
                                     jit::JitLogger* jit_logger) {
   StackHandleScope<3> hs(self);
@@ -1221,6 +1274,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
         jni_compiled_method.GetCode().size(),
         /* data_size */ 0u,
         osr,
+        /* baseline */ false,
         roots,
         /* has_should_deoptimize_flag */ false,
         cha_single_implementation_list);
@@ -1284,6 +1338,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                    &code_allocator,
                    dex_compilation_unit,
                    method,
+                   baseline,
                    osr,
                    &handles));
     if (codegen.get() == nullptr) {
@@ -1342,6 +1397,7 @@ bool OptimizingCompiler::JitCompile(Thread* self,
       code_allocator.GetSize(),
       data_size,
       osr,
+      baseline,
       roots,
       codegen->GetGraph()->HasShouldDeoptimizeFlag(),
       codegen->GetGraph()->GetCHASingleImplementationList());
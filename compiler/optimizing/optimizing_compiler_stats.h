@@ -34,6 +34,7 @@ enum class MethodCompilationStat {
   kCompiledNativeStub,
   kCompiledIntrinsic,
   kCompiledBytecode,
+  kCompiledBaselineBytecode,
   kCHAInline,
   kInlinedInvoke,
   kReplacedInvokeWithSimplePattern,
@@ -45,6 +46,9 @@ enum class MethodCompilationStat {
   kRemovedCheckedCast,
   kRemovedDeadInstruction,
   kRemovedNullCheck,
+  kRemovedBoundsCheck,
+  kRemovedBoundsCheckWithDeoptimization,
+  kRemainingBoundsCheck,
   kNotCompiledSkipped,
   kNotCompiledInvalidBytecode,
   kNotCompiledThrowCatchLoop,
@@ -69,6 +73,7 @@ enum class MethodCompilationStat {
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopUnswitched,
   kSelectGenerated,
   kRemovedInstanceOf,
   kInlinedInvokeVirtualOrInterface,
@@ -99,6 +104,10 @@ enum class MethodCompilationStat {
   kConstructorFenceRemovedLSE,
   kConstructorFenceRemovedPFRA,
   kConstructorFenceRemovedCFRE,
+  kPartialEscapeAllocationSunk,
+  kRegisterSpill,
+  kRegisterReload,
+  kRegisterAllocatedWithGraphColor,
   kJitOutOfMemoryForCommit,
   kLastStat
 };
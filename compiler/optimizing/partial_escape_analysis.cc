@@ -0,0 +1,342 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "partial_escape_analysis.h"
+
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+
+/**
+ * The escape analysis used by load-store elimination (see escape.h) is all or
+ * nothing: a single escaping use, for example passing the object to a logging
+ * call or to the constructor of an exception on a cold path, keeps the object
+ * allocated on every path through the method.
+ *
+ * This pass handles the common shape of such code:
+ * - The allocation and all its initializing stores are in one basic block.
+ * - Every escaping use is an instruction with an environment in a block
+ *   dominated by, but different from, the allocation block.
+ *
+ * For each escape point E (in reverse post order, skipping escapes already
+ * covered by a previous escape point), a new allocation is inserted right
+ * before E, with the last values stored in the allocation block, and every use
+ * of the original allocation in E's block after E and in the blocks dominated
+ * by E's block is redirected to the new allocation. The transformation is only
+ * done if no other use of the original allocation can be reached from E
+ * without going through the allocation block again, i.e. after the rewrite the
+ * original object and its copy are never live on the same path, and E's block
+ * cannot be reached again from itself for the same object, which would require
+ * merging the copies in a phi.
+ *
+ * After the transformation, the original allocation only has non-escaping
+ * uses and is removed by load-store elimination, together with its stores and
+ * loads, leaving the allocation on the escaping paths only.
+ */
+
+namespace art {
+
+// Largest array for which we insert element by element stores at escape points.
+static constexpr int32_t kMaximumArrayLength = 16;
+
+// Returns the value of `index` if it is a constant within [0, `length`), -1 otherwise.
+static int32_t GetConstantIndex(HInstruction* index, int32_t length) {
+  if (!index->IsIntConstant()) {
+    return -1;
+  }
+  int32_t value = index->AsIntConstant()->GetValue();
+  return (value >= 0 && value < length) ? value : -1;
+}
+
+static int32_t GetArrayLength(HInstruction* allocation) {
+  DCHECK(allocation->IsNewArray());
+  return allocation->AsNewArray()->GetLength()->AsIntConstant()->GetValue();
+}
+
+static bool IsCandidate(HInstruction* instruction) {
+  if (instruction->IsNewInstance()) {
+    HNewInstance* new_instance = instruction->AsNewInstance();
+    // Finalizable objects are visible to the finalizer, and string allocations
+    // are replaced by StringFactory calls.
+    return !new_instance->IsFinalizable() && !new_instance->IsStringAlloc();
+  } else if (instruction->IsNewArray()) {
+    HInstruction* length = instruction->AsNewArray()->GetLength();
+    return length->IsIntConstant() &&
+        length->AsIntConstant()->GetValue() >= 0 &&
+        length->AsIntConstant()->GetValue() <= kMaximumArrayLength;
+  }
+  return false;
+}
+
+// Returns whether `user` stores into `allocation`.
+static bool IsStoreInto(HInstruction* allocation, HInstruction* user) {
+  return (user->IsInstanceFieldSet() || user->IsArraySet()) && user->InputAt(0) == allocation;
+}
+
+// Returns whether `user` accesses `allocation` without making it visible to
+// anything else. Reference stores into arrays are not considered, as the
+// materialized copy would need a type check.
+static bool IsNonEscapingAccess(HInstruction* allocation, HInstruction* user) {
+  if (user->IsInstanceFieldGet()) {
+    return !user->AsInstanceFieldGet()->IsVolatile();
+  } else if (user->IsInstanceFieldSet()) {
+    return user->InputAt(0) == allocation &&
+        user->InputAt(1) != allocation &&
+        !user->AsInstanceFieldSet()->IsVolatile();
+  } else if (user->IsArrayGet()) {
+    return GetConstantIndex(user->InputAt(1), GetArrayLength(allocation)) != -1;
+  } else if (user->IsArraySet()) {
+    return user->InputAt(0) == allocation &&
+        user->InputAt(2)->GetType() != DataType::Type::kReference &&
+        GetConstantIndex(user->InputAt(1), GetArrayLength(allocation)) != -1;
+  } else if (user->IsArrayLength() || user->IsConstructorFence()) {
+    return true;
+  }
+  return false;
+}
+
+void PartialEscapeAnalysis::Run() {
+  // Materializing a copy changes the identity of the object seen by a debugger.
+  // Like load-store elimination, we do not handle the special block merging
+  // structure of try/catch.
+  if (graph_->IsDebuggable() || graph_->HasTryCatch()) {
+    return;
+  }
+
+  // Collect the candidates first, as the transformation inserts new allocations.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> candidates(allocator.Adapter(kArenaAllocPartialEscape));
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (IsCandidate(it.Current())) {
+        candidates.push_back(it.Current());
+      }
+    }
+  }
+
+  for (HInstruction* allocation : candidates) {
+    if (TryMaterializeAtEscapes(allocation)) {
+      MaybeRecordStat(stats_, MethodCompilationStat::kPartialEscapeAllocationSunk);
+    }
+  }
+}
+
+bool PartialEscapeAnalysis::TryMaterializeAtEscapes(HInstruction* allocation) {
+  HBasicBlock* allocation_block = allocation->GetBlock();
+
+  // The interpreter needs the object itself when deoptimizing.
+  for (const HUseListNode<HEnvironment*>& use : allocation->GetEnvUses()) {
+    if (use.GetUser()->GetHolder()->IsDeoptimize()) {
+      return false;
+    }
+  }
+
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaSet<HInstruction*> escapes(allocator.Adapter(kArenaAllocPartialEscape));
+  bool has_constructor_fence = false;
+  for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (IsNonEscapingAccess(allocation, user)) {
+      // The materialized copies are initialized with the values stored in the allocation block.
+      if (IsStoreInto(allocation, user) && user->GetBlock() != allocation_block) {
+        return false;
+      }
+      has_constructor_fence = has_constructor_fence || user->IsConstructorFence();
+    } else if (user->GetBlock() == allocation_block || !user->HasEnvironment()) {
+      // We need a separate block to move the allocation to, and an environment
+      // for the materialized allocation. This rejects phis, returns and heap stores.
+      return false;
+    } else {
+      escapes.insert(user);
+    }
+  }
+  if (escapes.empty()) {
+    // Load-store elimination handles allocations that do not escape at all.
+    return false;
+  }
+
+  // Find the escape points and the uses they cover, without changing the graph yet.
+  ScopedArenaVector<HInstruction*> escape_points(allocator.Adapter(kArenaAllocPartialEscape));
+  ScopedArenaVector<std::pair<HInstruction*, size_t>> covered_uses(
+      allocator.Adapter(kArenaAllocPartialEscape));
+  ScopedArenaVector<std::pair<HEnvironment*, size_t>> covered_env_uses(
+      allocator.Adapter(kArenaAllocPartialEscape));
+  // Index in `escape_points` of each entry in `covered_uses` and `covered_env_uses`.
+  ScopedArenaVector<size_t> use_points(allocator.Adapter(kArenaAllocPartialEscape));
+  ScopedArenaVector<size_t> env_use_points(allocator.Adapter(kArenaAllocPartialEscape));
+  ScopedArenaSet<HInstruction*> covered(allocator.Adapter(kArenaAllocPartialEscape));
+
+  ArenaBitVector reachable(
+      &allocator, graph_->GetBlocks().size(), /* expandable */ false, kArenaAllocPartialEscape);
+  ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocPartialEscape));
+
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    if (block == allocation_block || !allocation_block->Dominates(block)) {
+      continue;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* escape = it.Current();
+      if (escapes.find(escape) == escapes.end() || covered.find(escape) != covered.end()) {
+        continue;
+      }
+
+      // Compute the blocks reachable from the escape without allocating a new object.
+      reachable.ClearAllBits();
+      DCHECK(worklist.empty());
+      for (HBasicBlock* successor : block->GetSuccessors()) {
+        worklist.push_back(successor);
+      }
+      while (!worklist.empty()) {
+        HBasicBlock* current = worklist.back();
+        worklist.pop_back();
+        if (current == block) {
+          // The object escapes again at the same point, we would need a phi to merge copies.
+          return false;
+        }
+        if (current == allocation_block || reachable.IsBitSet(current->GetBlockId())) {
+          continue;
+        }
+        reachable.SetBit(current->GetBlockId());
+        for (HBasicBlock* successor : current->GetSuccessors()) {
+          worklist.push_back(successor);
+        }
+      }
+
+      size_t point = escape_points.size();
+      escape_points.push_back(escape);
+      for (const HUseListNode<HInstruction*>& use : allocation->GetUses()) {
+        HInstruction* user = use.GetUser();
+        HBasicBlock* user_block = user->GetBlock();
+        if (user == escape ||
+            (user_block == block && escape->StrictlyDominates(user)) ||
+            (user_block != block && block->Dominates(user_block))) {
+          covered_uses.emplace_back(user, use.GetIndex());
+          use_points.push_back(point);
+          covered.insert(user);
+        } else if (reachable.IsBitSet(user_block->GetBlockId())) {
+          // The use can see both the original object and the copy.
+          return false;
+        }
+      }
+      // Environment uses that can see both the original object and the copy
+      // are left unchanged, like load-store elimination does for singletons.
+      for (const HUseListNode<HEnvironment*>& use : allocation->GetEnvUses()) {
+        HInstruction* holder = use.GetUser()->GetHolder();
+        HBasicBlock* holder_block = holder->GetBlock();
+        if (holder == escape ||
+            (holder_block == block && escape->StrictlyDominates(holder)) ||
+            (holder_block != block && block->Dominates(holder_block))) {
+          covered_env_uses.emplace_back(use.GetUser(), use.GetIndex());
+          env_use_points.push_back(point);
+        }
+      }
+    }
+  }
+  DCHECK(!escape_points.empty());
+
+  // Collect the last values stored into the allocation, keyed by field offset or array index.
+  ScopedArenaSafeMap<uint32_t, HInstruction*> last_stores(
+      std::less<uint32_t>(), allocator.Adapter(kArenaAllocPartialEscape));
+  for (HInstructionIterator it(allocation_block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (!IsStoreInto(allocation, instruction)) {
+      continue;
+    }
+    uint32_t key = instruction->IsInstanceFieldSet()
+        ? instruction->AsInstanceFieldSet()->GetFieldOffset().Uint32Value()
+        : static_cast<uint32_t>(instruction->InputAt(1)->AsIntConstant()->GetValue());
+    last_stores.Overwrite(key, instruction);
+  }
+
+  // Materialize a copy of the allocation at each escape point.
+  ArenaAllocator* graph_allocator = graph_->GetAllocator();
+  ScopedArenaVector<HInstruction*> copies(allocator.Adapter(kArenaAllocPartialEscape));
+  for (HInstruction* escape : escape_points) {
+    HInstruction* copy = nullptr;
+    if (allocation->IsNewInstance()) {
+      HNewInstance* new_instance = allocation->AsNewInstance();
+      copy = new (graph_allocator) HNewInstance(new_instance->InputAt(0),
+                                                escape->GetDexPc(),
+                                                new_instance->GetTypeIndex(),
+                                                new_instance->GetDexFile(),
+                                                /* finalizable */ false,
+                                                new_instance->GetEntrypoint());
+    } else {
+      HNewArray* new_array = allocation->AsNewArray();
+      copy = new (graph_allocator) HNewArray(new_array->InputAt(0),
+                                             new_array->GetLength(),
+                                             escape->GetDexPc());
+    }
+    escape->GetBlock()->InsertInstructionBefore(copy, escape);
+    copy->CopyEnvironmentFrom(escape->GetEnvironment());
+    copy->SetReferenceTypeInfo(allocation->GetReferenceTypeInfo());
+
+    for (const auto& entry : last_stores) {
+      HInstruction* store = entry.second;
+      HInstruction* new_store = nullptr;
+      if (store->IsInstanceFieldSet()) {
+        HInstanceFieldSet* field_set = store->AsInstanceFieldSet();
+        const FieldInfo& info = field_set->GetFieldInfo();
+        HInstanceFieldSet* new_field_set = new (graph_allocator) HInstanceFieldSet(
+            copy,
+            field_set->GetValue(),
+            info.GetField(),
+            info.GetFieldType(),
+            info.GetFieldOffset(),
+            info.IsVolatile(),
+            info.GetFieldIndex(),
+            info.GetDeclaringClassDefIndex(),
+            info.GetDexFile(),
+            field_set->GetDexPc());
+        if (!field_set->GetValueCanBeNull()) {
+          new_field_set->ClearValueCanBeNull();
+        }
+        new_store = new_field_set;
+      } else {
+        HArraySet* array_set = store->AsArraySet();
+        new_store = new (graph_allocator) HArraySet(copy,
+                                                    array_set->GetIndex(),
+                                                    array_set->GetValue(),
+                                                    array_set->GetComponentType(),
+                                                    array_set->GetDexPc());
+      }
+      escape->GetBlock()->InsertInstructionBefore(new_store, escape);
+    }
+    if (has_constructor_fence) {
+      HConstructorFence* fence =
+          new (graph_allocator) HConstructorFence(copy, escape->GetDexPc(), graph_allocator);
+      escape->GetBlock()->InsertInstructionBefore(fence, escape);
+    }
+    copies.push_back(copy);
+  }
+
+  // Redirect the covered uses to the copies.
+  for (size_t i = 0; i < covered_uses.size(); ++i) {
+    covered_uses[i].first->ReplaceInput(copies[use_points[i]], covered_uses[i].second);
+  }
+  for (size_t i = 0; i < covered_env_uses.size(); ++i) {
+    HEnvironment* environment = covered_env_uses[i].first;
+    size_t index = covered_env_uses[i].second;
+    HInstruction* copy = copies[env_use_points[i]];
+    environment->RemoveAsUserOfInput(index);
+    environment->SetRawEnvAt(index, copy);
+    copy->AddEnvUseAt(environment, index);
+  }
+  return true;
+}
+
+}  // namespace art
@@ -19,15 +19,18 @@
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
 #include "linear_order.h"
+#include "optimizing_compiler_stats.h"
 #include "ssa_liveness_analysis.h"
 
 namespace art {
 
 RegisterAllocationResolver::RegisterAllocationResolver(CodeGenerator* codegen,
-                                                       const SsaLivenessAnalysis& liveness)
+                                                       const SsaLivenessAnalysis& liveness,
+                                                       OptimizingCompilerStats* stats)
       : allocator_(codegen->GetGraph()->GetAllocator()),
         codegen_(codegen),
-        liveness_(liveness) {}
+        liveness_(liveness),
+        stats_(stats) {}
 
 void RegisterAllocationResolver::Resolve(ArrayRef<HInstruction* const> safepoints,
                                          size_t reserved_out_slots,
@@ -307,6 +310,7 @@ void RegisterAllocationResolver::ConnectSiblings(LiveInterval* interval) {
       case 1: loc = Location::StackSlot(interval->GetParent()->GetSpillSlot()); break;
       case 2: loc = Location::DoubleStackSlot(interval->GetParent()->GetSpillSlot()); break;
       case 4: loc = Location::SIMDStackSlot(interval->GetParent()->GetSpillSlot()); break;
+      case 8: loc = Location::SIMDStackSlot(interval->GetParent()->GetSpillSlot()); break;
       default: LOG(FATAL) << "Unexpected number of spill slots"; UNREACHABLE();
     }
     InsertMoveAfter(interval->GetDefinedBy(), interval->ToLocation(), loc);
@@ -470,6 +474,7 @@ void RegisterAllocationResolver::ConnectSplitSiblings(LiveInterval* interval,
         case 1: location_source = Location::StackSlot(parent->GetSpillSlot()); break;
         case 2: location_source = Location::DoubleStackSlot(parent->GetSpillSlot()); break;
         case 4: location_source = Location::SIMDStackSlot(parent->GetSpillSlot()); break;
+        case 8: location_source = Location::SIMDStackSlot(parent->GetSpillSlot()); break;
         default: LOG(FATAL) << "Unexpected number of spill slots"; UNREACHABLE();
       }
     }
@@ -496,6 +501,10 @@ void RegisterAllocationResolver::ConnectSplitSiblings(LiveInterval* interval,
   }
 }
 
+static bool IsStackLocation(Location location) {
+  return location.IsStackSlot() || location.IsDoubleStackSlot() || location.IsSIMDStackSlot();
+}
+
 static bool IsValidDestination(Location destination) {
   return destination.IsRegister()
       || destination.IsRegisterPair()
@@ -511,6 +520,12 @@ void RegisterAllocationResolver::AddMove(HParallelMove* move,
                                          Location destination,
                                          HInstruction* instruction,
                                          DataType::Type type) const {
+  // Moves between registers and spill slots are reported as spills and reloads.
+  if (source.IsRegisterKind() && IsStackLocation(destination)) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kRegisterSpill);
+  } else if (IsStackLocation(source) && destination.IsRegisterKind()) {
+    MaybeRecordStat(stats_, MethodCompilationStat::kRegisterReload);
+  }
   if (type == DataType::Type::kInt64
       && codegen_->ShouldSplitLongMoves()
       // The parallel move resolver knows how to deal with long constants.
@@ -30,6 +30,7 @@ class HInstruction;
 class HParallelMove;
 class LiveInterval;
 class Location;
+class OptimizingCompilerStats;
 class SsaLivenessAnalysis;
 
 /**
@@ -39,7 +40,9 @@ class SsaLivenessAnalysis;
  */
 class RegisterAllocationResolver : ValueObject {
  public:
-  RegisterAllocationResolver(CodeGenerator* codegen, const SsaLivenessAnalysis& liveness);
+  RegisterAllocationResolver(CodeGenerator* codegen,
+                             const SsaLivenessAnalysis& liveness,
+                             OptimizingCompilerStats* stats = nullptr);
 
   void Resolve(ArrayRef<HInstruction* const> safepoints,
                size_t reserved_out_slots,  // Includes slot(s) for the art method.
@@ -90,6 +93,7 @@ class RegisterAllocationResolver : ValueObject {
   ArenaAllocator* const allocator_;
   CodeGenerator* const codegen_;
   const SsaLivenessAnalysis& liveness_;
+  OptimizingCompilerStats* const stats_;
 
   DISALLOW_COPY_AND_ASSIGN(RegisterAllocationResolver);
 };
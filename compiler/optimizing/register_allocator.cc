@@ -31,22 +31,25 @@ namespace art {
 
 RegisterAllocator::RegisterAllocator(ScopedArenaAllocator* allocator,
                                      CodeGenerator* codegen,
-                                     const SsaLivenessAnalysis& liveness)
+                                     const SsaLivenessAnalysis& liveness,
+                                     OptimizingCompilerStats* stats)
     : allocator_(allocator),
       codegen_(codegen),
-      liveness_(liveness) {}
+      liveness_(liveness),
+      stats_(stats) {}
 
 std::unique_ptr<RegisterAllocator> RegisterAllocator::Create(ScopedArenaAllocator* allocator,
                                                              CodeGenerator* codegen,
                                                              const SsaLivenessAnalysis& analysis,
-                                                             Strategy strategy) {
+                                                             Strategy strategy,
+                                                             OptimizingCompilerStats* stats) {
   switch (strategy) {
     case kRegisterAllocatorLinearScan:
       return std::unique_ptr<RegisterAllocator>(
-          new (allocator) RegisterAllocatorLinearScan(allocator, codegen, analysis));
+          new (allocator) RegisterAllocatorLinearScan(allocator, codegen, analysis, stats));
     case kRegisterAllocatorGraphColor:
       return std::unique_ptr<RegisterAllocator>(
-          new (allocator) RegisterAllocatorGraphColor(allocator, codegen, analysis));
+          new (allocator) RegisterAllocatorGraphColor(allocator, codegen, analysis, stats));
     default:
       LOG(FATAL) << "Invalid register allocation strategy: " << strategy;
       UNREACHABLE();
@@ -31,6 +31,7 @@ class HInstruction;
 class HParallelMove;
 class LiveInterval;
 class Location;
+class OptimizingCompilerStats;
 class SsaLivenessAnalysis;
 
 /**
@@ -48,7 +49,8 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
   static std::unique_ptr<RegisterAllocator> Create(ScopedArenaAllocator* allocator,
                                                    CodeGenerator* codegen,
                                                    const SsaLivenessAnalysis& analysis,
-                                                   Strategy strategy = kRegisterAllocatorDefault);
+                                                   Strategy strategy = kRegisterAllocatorDefault,
+                                                   OptimizingCompilerStats* stats = nullptr);
 
   virtual ~RegisterAllocator();
 
@@ -76,7 +78,8 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
  protected:
   RegisterAllocator(ScopedArenaAllocator* allocator,
                     CodeGenerator* codegen,
-                    const SsaLivenessAnalysis& analysis);
+                    const SsaLivenessAnalysis& analysis,
+                    OptimizingCompilerStats* stats);
 
   // Split `interval` at the position `position`. The new interval starts at `position`.
   // If `position` is at the start of `interval`, returns `interval` with its
@@ -90,6 +93,7 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
   ScopedArenaAllocator* const allocator_;
   CodeGenerator* const codegen_;
   const SsaLivenessAnalysis& liveness_;
+  OptimizingCompilerStats* const stats_;
 };
 
 }  // namespace art
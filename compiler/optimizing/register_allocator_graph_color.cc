@@ -575,8 +575,9 @@ static size_t ComputeReservedArtMethodSlots(const CodeGenerator& codegen) {
 RegisterAllocatorGraphColor::RegisterAllocatorGraphColor(ScopedArenaAllocator* allocator,
                                                          CodeGenerator* codegen,
                                                          const SsaLivenessAnalysis& liveness,
+                                                         OptimizingCompilerStats* stats,
                                                          bool iterative_move_coalescing)
-      : RegisterAllocator(allocator, codegen, liveness),
+      : RegisterAllocator(allocator, codegen, liveness, stats),
         iterative_move_coalescing_(iterative_move_coalescing),
         core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
@@ -714,7 +715,7 @@ void RegisterAllocatorGraphColor::AllocateRegisters() {
   }  // for processing_core_instructions
 
   // (6) Resolve locations and deconstruct SSA form.
-  RegisterAllocationResolver(codegen_, liveness_)
+  RegisterAllocationResolver(codegen_, liveness_, stats_)
       .Resolve(ArrayRef<HInstruction* const>(safepoints_),
                reserved_art_method_slots_ + reserved_out_slots_,
                num_int_spill_slots_,
@@ -32,6 +32,7 @@ class HGraph;
 class HInstruction;
 class HParallelMove;
 class Location;
+class OptimizingCompilerStats;
 class SsaLivenessAnalysis;
 class InterferenceNode;
 struct CoalesceOpportunity;
@@ -89,6 +90,7 @@ class RegisterAllocatorGraphColor : public RegisterAllocator {
   RegisterAllocatorGraphColor(ScopedArenaAllocator* allocator,
                               CodeGenerator* codegen,
                               const SsaLivenessAnalysis& analysis,
+                              OptimizingCompilerStats* stats = nullptr,
                               bool iterative_move_coalescing = true);
   ~RegisterAllocatorGraphColor() OVERRIDE;
 
@@ -42,8 +42,9 @@ static bool IsLowOfUnalignedPairInterval(LiveInterval* low) {
 
 RegisterAllocatorLinearScan::RegisterAllocatorLinearScan(ScopedArenaAllocator* allocator,
                                                          CodeGenerator* codegen,
-                                                         const SsaLivenessAnalysis& liveness)
-      : RegisterAllocator(allocator, codegen, liveness),
+                                                         const SsaLivenessAnalysis& liveness,
+                                                         OptimizingCompilerStats* stats)
+      : RegisterAllocator(allocator, codegen, liveness, stats),
         unhandled_core_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         unhandled_fp_intervals_(allocator->Adapter(kArenaAllocRegisterAllocator)),
         unhandled_(nullptr),
@@ -92,7 +93,7 @@ static bool ShouldProcess(bool processing_core_registers, LiveInterval* interval
 
 void RegisterAllocatorLinearScan::AllocateRegisters() {
   AllocateRegistersInternal();
-  RegisterAllocationResolver(codegen_, liveness_)
+  RegisterAllocationResolver(codegen_, liveness_, stats_)
       .Resolve(ArrayRef<HInstruction* const>(safepoints_),
                reserved_out_slots_,
                int_spill_slots_.size(),
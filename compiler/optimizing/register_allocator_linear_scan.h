@@ -32,6 +32,7 @@ class HParallelMove;
 class HPhi;
 class LiveInterval;
 class Location;
+class OptimizingCompilerStats;
 class SsaLivenessAnalysis;
 
 /**
@@ -41,7 +42,8 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
  public:
   RegisterAllocatorLinearScan(ScopedArenaAllocator* allocator,
                               CodeGenerator* codegen,
-                              const SsaLivenessAnalysis& analysis);
+                              const SsaLivenessAnalysis& analysis,
+                              OptimizingCompilerStats* stats = nullptr);
   ~RegisterAllocatorLinearScan() OVERRIDE;
 
   void AllocateRegisters() OVERRIDE;
@@ -18,6 +18,7 @@
 
 #include "scheduler.h"
 
+#include "arch/instruction_set_features.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 #include "data_type-inl.h"
@@ -31,6 +32,10 @@
 #include "scheduler_arm.h"
 #endif
 
+#ifdef ART_ENABLE_CODEGEN_x86_64
+#include "scheduler_x86_64.h"
+#endif
+
 namespace art {
 
 void SchedulingGraph::AddDependency(SchedulingNode* node,
@@ -551,6 +556,12 @@ void HScheduler::Schedule(HGraph* graph) {
     scheduling_graph_.SetHeapLocationCollector(lsa.GetHeapLocationCollector());
   }
 
+  for (HBasicBlock* block : graph->GetReversePostOrder()) {
+    if (IsSchedulable(block)) {
+      ExtendLoopExitBlock(block);
+    }
+  }
+
   for (HBasicBlock* block : graph->GetReversePostOrder()) {
     if (IsSchedulable(block)) {
       Schedule(block);
@@ -558,6 +569,95 @@ void HScheduler::Schedule(HGraph* graph) {
   }
 }
 
+// The maximum number of instructions speculatively moved into a loop exit block.
+// This limits the increase of register pressure at the loop exit test.
+static constexpr size_t kMaxSpeculatedInstructions = 8;
+
+// Returns whether `instruction` can be executed speculatively, on the path that
+// exits the loop, without changing the behavior of the program.
+static bool CanSpeculate(const HInstruction* instruction) {
+  if (!instruction->CanBeMoved() ||
+      instruction->CanThrow() ||
+      instruction->HasSideEffects() ||
+      instruction->NeedsEnvironment()) {
+    return false;
+  }
+  if (instruction->IsDiv() || instruction->IsRem()) {
+    // The divisor may only be known to be non-zero (and not -1 with a minimum
+    // dividend) inside the loop body.
+    return DataType::IsFloatingPointType(instruction->GetType());
+  }
+  // Conditions are kept next to their users, to let them set the flags for the
+  // branch or select instead of being materialized.
+  return (instruction->IsBinaryOperation() && !instruction->IsCondition()) ||
+      instruction->IsUnaryOperation() ||
+      instruction->IsTypeConversion();
+}
+
+void HScheduler::ExtendLoopExitBlock(HBasicBlock* block) {
+  HLoopInformation* loop_info = block->GetLoopInformation();
+  if (loop_info == nullptr || loop_info->IsIrreducible() || !block->EndsWithIf()) {
+    return;
+  }
+  // Find the successor that stays in the loop, when the other one exits it.
+  HBasicBlock* true_successor = block->GetSuccessors()[0];
+  HBasicBlock* false_successor = block->GetSuccessors()[1];
+  HBasicBlock* body;
+  if (loop_info->Contains(*true_successor) && !loop_info->Contains(*false_successor)) {
+    body = true_successor;
+  } else if (loop_info->Contains(*false_successor) && !loop_info->Contains(*true_successor)) {
+    body = false_successor;
+  } else {
+    return;
+  }
+  if (body->GetPredecessors().size() != 1u ||
+      body->GetLoopInformation() != loop_info ||
+      !IsSchedulable(body)) {
+    return;
+  }
+
+  HInstruction* cursor = block->GetLastInstruction();
+  if (cursor->GetPrevious() == cursor->InputAt(0)) {
+    // Keep the condition next to the `HIf`, so that it can be emitted at its use site.
+    cursor = cursor->GetPrevious();
+  }
+  size_t number_of_speculated_instructions = 0;
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (!CanSpeculate(instruction)) {
+      continue;
+    }
+    // Instructions feeding loop phis compute the values of the next iteration and would
+    // only extend live ranges across the body without shortening its critical path.
+    bool has_phi_use = false;
+    for (const HUseListNode<HInstruction*>& use : instruction->GetUses()) {
+      if (use.GetUser()->IsPhi()) {
+        has_phi_use = true;
+        break;
+      }
+    }
+    if (has_phi_use) {
+      continue;
+    }
+    // As `block` is the single predecessor of `body`, the inputs defined outside `body`
+    // dominate `block`, and all but the condition are defined before `cursor`.
+    bool inputs_available = true;
+    for (const HInstruction* input : instruction->GetInputs()) {
+      if (input->GetBlock() == body || input == cursor) {
+        inputs_available = false;
+        break;
+      }
+    }
+    if (!inputs_available) {
+      continue;
+    }
+    instruction->MoveBefore(cursor);
+    if (++number_of_speculated_instructions == kMaxSpeculatedInstructions) {
+      break;
+    }
+  }
+}
+
 void HScheduler::Schedule(HBasicBlock* block) {
   ScopedArenaVector<SchedulingNode*> scheduling_nodes(allocator_->Adapter(kArenaAllocScheduler));
 
@@ -773,7 +873,9 @@ bool HScheduler::IsSchedulingBarrier(const HInstruction* instr) const {
 
 void HInstructionScheduling::Run(bool only_optimize_loop_blocks,
                                  bool schedule_randomly) {
-#if defined(ART_ENABLE_CODEGEN_arm64) || defined(ART_ENABLE_CODEGEN_arm)
+#if defined(ART_ENABLE_CODEGEN_arm64) || \
+    defined(ART_ENABLE_CODEGEN_arm) || \
+    defined(ART_ENABLE_CODEGEN_x86_64)
   // Phase-local allocator that allocates scheduler internal data structures like
   // scheduling nodes, internel nodes map, dependencies, etc.
   ScopedArenaAllocator allocator(graph_->GetArenaStack());
@@ -787,12 +889,15 @@ void HInstructionScheduling::Run(bool only_optimize_loop_blocks,
   UNUSED(only_optimize_loop_blocks);
   UNUSED(schedule_randomly);
   UNUSED(codegen_);
+  UNUSED(features_);
 #endif
 
   switch (instruction_set_) {
 #ifdef ART_ENABLE_CODEGEN_arm64
     case InstructionSet::kArm64: {
-      arm64::HSchedulerARM64 scheduler(&allocator, selector);
+      const Arm64InstructionSetFeatures* arm64_features =
+          (features_ != nullptr) ? features_->AsArm64InstructionSetFeatures() : nullptr;
+      arm64::HSchedulerARM64 scheduler(&allocator, selector, arm64_features);
       scheduler.SetOnlyOptimizeLoopBlocks(only_optimize_loop_blocks);
       scheduler.Schedule(graph_);
       break;
@@ -807,6 +912,16 @@ void HInstructionScheduling::Run(bool only_optimize_loop_blocks,
       scheduler.Schedule(graph_);
       break;
     }
+#endif
+#ifdef ART_ENABLE_CODEGEN_x86_64
+    case InstructionSet::kX86_64: {
+      const X86_64InstructionSetFeatures* x86_64_features =
+          (features_ != nullptr) ? features_->AsX86_64InstructionSetFeatures() : nullptr;
+      x86_64::HSchedulerX86_64 scheduler(&allocator, selector, x86_64_features);
+      scheduler.SetOnlyOptimizeLoopBlocks(only_optimize_loop_blocks);
+      scheduler.Schedule(graph_);
+      break;
+    }
 #endif
     default:
       break;
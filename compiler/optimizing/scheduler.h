@@ -35,8 +35,12 @@ namespace art {
 // This pass tries to improve the quality of the generated code by reordering
 // instructions in the graph to avoid execution delays caused by execution
 // dependencies.
-// Currently, scheduling is performed at the block level, so no `HInstruction`
-// ever leaves its block in this pass.
+// Scheduling is performed at the block level. The only `HInstruction`s that
+// leave their block are side-effect free, non-trapping arithmetic instructions of
+// loop bodies, which are speculatively moved into the block that tests for the
+// loop exit (see `HScheduler::ExtendLoopExitBlock()`). This makes the block
+// scheduling of hot loops overlap the work of the loop exit test with the work
+// of the loop body, as the exit branch is taken only once.
 //
 // The scheduling process iterates through blocks in the graph. For blocks that
 // we can and want to schedule:
@@ -458,6 +462,11 @@ class HScheduler {
   void Schedule(SchedulingNode* scheduling_node);
   void Schedule(HInstruction* instruction);
 
+  // If `block` ends with a loop exit test, move speculatable instructions from its
+  // successor in the loop into `block`, so that they are scheduled together with
+  // the exit test.
+  void ExtendLoopExitBlock(HBasicBlock* block);
+
   // Any instruction returning `false` via this method will prevent its
   // containing basic block from being scheduled.
   // This method is used to restrict scheduling to instructions that we know are
@@ -503,10 +512,12 @@ class HInstructionScheduling : public HOptimization {
   HInstructionScheduling(HGraph* graph,
                          InstructionSet instruction_set,
                          CodeGenerator* cg = nullptr,
+                         const InstructionSetFeatures* features = nullptr,
                          const char* name = kInstructionSchedulingPassName)
       : HOptimization(graph, name),
         codegen_(cg),
-        instruction_set_(instruction_set) {}
+        instruction_set_(instruction_set),
+        features_(features) {}
 
   void Run() {
     Run(/*only_optimize_loop_blocks*/ true, /*schedule_randomly*/ false);
@@ -518,6 +529,8 @@ class HInstructionScheduling : public HOptimization {
  private:
   CodeGenerator* const codegen_;
   const InstructionSet instruction_set_;
+  // The features of the target CPU, used to select the latencies. May be null.
+  const InstructionSetFeatures* const features_;
   DISALLOW_COPY_AND_ASSIGN(HInstructionScheduling);
 };
 
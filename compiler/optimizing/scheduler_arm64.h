@@ -20,46 +20,54 @@
 #include "scheduler.h"
 
 namespace art {
+
+class Arm64InstructionSetFeatures;
+
 namespace arm64 {
 
-static constexpr uint32_t kArm64MemoryLoadLatency = 5;
-static constexpr uint32_t kArm64MemoryStoreLatency = 3;
-
-static constexpr uint32_t kArm64CallInternalLatency = 10;
-static constexpr uint32_t kArm64CallLatency = 5;
-
-// AArch64 instruction latency.
-// We currently assume that all arm64 CPUs share the same instruction latency list.
-static constexpr uint32_t kArm64IntegerOpLatency = 2;
-static constexpr uint32_t kArm64FloatingPointOpLatency = 5;
-
-
-static constexpr uint32_t kArm64DataProcWithShifterOpLatency = 3;
-static constexpr uint32_t kArm64DivDoubleLatency = 30;
-static constexpr uint32_t kArm64DivFloatLatency = 15;
-static constexpr uint32_t kArm64DivIntegerLatency = 5;
-static constexpr uint32_t kArm64LoadStringInternalLatency = 7;
-static constexpr uint32_t kArm64MulFloatingPointLatency = 6;
-static constexpr uint32_t kArm64MulIntegerLatency = 6;
-static constexpr uint32_t kArm64TypeConversionFloatingPointIntegerLatency = 5;
-static constexpr uint32_t kArm64BranchLatency = kArm64IntegerOpLatency;
-
-static constexpr uint32_t kArm64SIMDFloatingPointOpLatency = 10;
-static constexpr uint32_t kArm64SIMDIntegerOpLatency = 6;
-static constexpr uint32_t kArm64SIMDMemoryLoadLatency = 10;
-static constexpr uint32_t kArm64SIMDMemoryStoreLatency = 6;
-static constexpr uint32_t kArm64SIMDMulFloatingPointLatency = 12;
-static constexpr uint32_t kArm64SIMDMulIntegerLatency = 12;
-static constexpr uint32_t kArm64SIMDReplicateOpLatency = 16;
-static constexpr uint32_t kArm64SIMDDivDoubleLatency = 60;
-static constexpr uint32_t kArm64SIMDDivFloatLatency = 30;
-static constexpr uint32_t kArm64SIMDTypeConversionInt2FPLatency = 10;
+// AArch64 instruction latencies, in cycles, for one class of CPUs.
+struct Arm64SchedulingLatencies {
+  uint32_t memory_load;
+  uint32_t memory_store;
+
+  uint32_t call_internal;
+  uint32_t call;
+
+  uint32_t integer_op;
+  uint32_t floating_point_op;
+
+  uint32_t data_proc_with_shifter_op;
+  uint32_t div_double;
+  uint32_t div_float;
+  uint32_t div_integer;
+  uint32_t load_string_internal;
+  uint32_t mul_floating_point;
+  uint32_t mul_integer;
+  uint32_t type_conversion_floating_point_integer;
+  uint32_t branch;
+
+  uint32_t simd_floating_point_op;
+  uint32_t simd_integer_op;
+  uint32_t simd_memory_load;
+  uint32_t simd_memory_store;
+  uint32_t simd_mul_floating_point;
+  uint32_t simd_mul_integer;
+  uint32_t simd_replicate_op;
+  uint32_t simd_div_double;
+  uint32_t simd_div_float;
+  uint32_t simd_type_conversion_int2fp;
+};
 
 class SchedulingLatencyVisitorARM64 : public SchedulingLatencyVisitor {
  public:
+  // The latency table is selected from the `features` of the target CPU. Without
+  // `features`, latencies of a generic core (that may be a Cortex-A53) are used.
+  explicit SchedulingLatencyVisitorARM64(const Arm64InstructionSetFeatures* features = nullptr)
+      : latencies_(GetLatencies(features)) {}
+
   // Default visitor for instructions not handled specifically below.
   void VisitInstruction(HInstruction* ATTRIBUTE_UNUSED) {
-    last_visited_latency_ = kArm64IntegerOpLatency;
+    last_visited_latency_ = latencies_.integer_op;
   }
 
 // We add a second unused parameter to be able to use this macro like the others
@@ -125,14 +133,21 @@ class SchedulingLatencyVisitorARM64 : public SchedulingLatencyVisitor {
 #undef DECLARE_VISIT_INSTRUCTION
 
  private:
+  static const Arm64SchedulingLatencies& GetLatencies(const Arm64InstructionSetFeatures* features);
+
   void HandleSimpleArithmeticSIMD(HVecOperation *instr);
   void HandleVecAddress(HVecMemoryOperation* instruction, size_t size);
+
+  const Arm64SchedulingLatencies& latencies_;
 };
 
 class HSchedulerARM64 : public HScheduler {
  public:
-  HSchedulerARM64(ScopedArenaAllocator* allocator, SchedulingNodeSelector* selector)
-      : HScheduler(allocator, &arm64_latency_visitor_, selector) {}
+  HSchedulerARM64(ScopedArenaAllocator* allocator,
+                  SchedulingNodeSelector* selector,
+                  const Arm64InstructionSetFeatures* features = nullptr)
+      : HScheduler(allocator, &arm64_latency_visitor_, selector),
+        arm64_latency_visitor_(features) {}
   ~HSchedulerARM64() OVERRIDE {}
 
   bool IsSchedulable(const HInstruction* instruction) const OVERRIDE {
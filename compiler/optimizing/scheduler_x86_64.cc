@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scheduler_x86_64.h"
+
+#include "arch/x86_64/instruction_set_features_x86_64.h"
+#include "code_generator_utils.h"
+#include "mirror/string.h"
+
+namespace art {
+namespace x86_64 {
+
+// Latencies of the in-order Atom cores, which lack SSE4.1.
+static constexpr X86_64SchedulingLatencies kX86_64AtomLatencies = {
+  /* memory_load */ 3,
+  /* memory_store */ 1,
+  /* call_internal */ 10,
+  /* call */ 5,
+  /* integer_op */ 1,
+  /* floating_point_op */ 5,
+  /* div_double */ 62,
+  /* div_float */ 34,
+  /* div_integer */ 50,
+  /* div_long */ 100,
+  /* load_string_internal */ 4,
+  /* mul_floating_point */ 5,
+  /* mul_integer */ 5,
+  /* type_conversion_floating_point_integer */ 6,
+  /* branch */ 1,
+  /* simd_floating_point_op */ 5,
+  /* simd_integer_op */ 1,
+  /* simd_memory_load */ 3,
+  /* simd_memory_store */ 1,
+  /* simd_mul_floating_point */ 5,
+  /* simd_mul_integer */ 5,
+  /* simd_replicate_op */ 4,
+  /* simd_div_double */ 124,
+  /* simd_div_float */ 70,
+  /* simd_type_conversion_int2fp */ 6,
+};
+
+// Latencies of the Silvermont and Sandy Bridge class cores. This is also the
+// default when the CPU is not known.
+static constexpr X86_64SchedulingLatencies kX86_64GenericLatencies = {
+  /* memory_load */ 5,
+  /* memory_store */ 1,
+  /* call_internal */ 10,
+  /* call */ 5,
+  /* integer_op */ 1,
+  /* floating_point_op */ 3,
+  /* div_double */ 22,
+  /* div_float */ 14,
+  /* div_integer */ 26,
+  /* div_long */ 40,
+  /* load_string_internal */ 5,
+  /* mul_floating_point */ 5,
+  /* mul_integer */ 3,
+  /* type_conversion_floating_point_integer */ 4,
+  /* branch */ 1,
+  /* simd_floating_point_op */ 3,
+  /* simd_integer_op */ 1,
+  /* simd_memory_load */ 6,
+  /* simd_memory_store */ 1,
+  /* simd_mul_floating_point */ 5,
+  /* simd_mul_integer */ 5,
+  /* simd_replicate_op */ 3,
+  /* simd_div_double */ 44,
+  /* simd_div_float */ 28,
+  /* simd_type_conversion_int2fp */ 4,
+};
+
+// Latencies of the Haswell and later cores, which support AVX2.
+static constexpr X86_64SchedulingLatencies kX86_64AVX2Latencies = {
+  /* memory_load */ 5,
+  /* memory_store */ 1,
+  /* call_internal */ 10,
+  /* call */ 5,
+  /* integer_op */ 1,
+  /* floating_point_op */ 4,
+  /* div_double */ 14,
+  /* div_float */ 11,
+  /* div_integer */ 26,
+  /* div_long */ 42,
+  /* load_string_internal */ 5,
+  /* mul_floating_point */ 4,
+  /* mul_integer */ 3,
+  /* type_conversion_floating_point_integer */ 5,
+  /* branch */ 1,
+  /* simd_floating_point_op */ 4,
+  /* simd_integer_op */ 1,
+  /* simd_memory_load */ 6,
+  /* simd_memory_store */ 1,
+  /* simd_mul_floating_point */ 4,
+  /* simd_mul_integer */ 10,
+  /* simd_replicate_op */ 3,
+  /* simd_div_double */ 14,
+  /* simd_div_float */ 11,
+  /* simd_type_conversion_int2fp */ 4,
+};
+
+const X86_64SchedulingLatencies& SchedulingLatencyVisitorX86_64::GetLatencies(
+    const X86_64InstructionSetFeatures* features) {
+  // The instruction set features do not record the CPU variant, so pick the table
+  // from the extensions that distinguish the classes of cores.
+  if (features == nullptr) {
+    return kX86_64GenericLatencies;
+  } else if (features->HasAVX2()) {
+    return kX86_64AVX2Latencies;
+  } else if (!features->HasSSE4_1()) {
+    return kX86_64AtomLatencies;
+  } else {
+    return kX86_64GenericLatencies;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitBinaryOperation(HBinaryOperation* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? latencies_.floating_point_op
+      : latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArrayGet(HArrayGet* instruction) {
+  if (instruction->IsStringCharAt() && mirror::kUseStringCompression) {
+    // Take the test of the compression flag into account.
+    last_visited_internal_latency_ = latencies_.memory_load + latencies_.branch;
+  }
+  // The index computation is folded into the addressing mode.
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArrayLength(HArrayLength* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitArraySet(HArraySet* instruction) {
+  if (instruction->NeedsTypeCheck()) {
+    // Loads of the component type and of the value's class.
+    last_visited_internal_latency_ = 2 * latencies_.memory_load + latencies_.branch;
+  }
+  last_visited_latency_ = latencies_.memory_store;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitBoundsCheck(HBoundsCheck* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.integer_op;
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorX86_64::HandleDivRemConstantIntegral(HBinaryOperation* instruction,
+                                                                   int64_t imm) {
+  // Follow the code path used by code generation.
+  if (imm == 0) {
+    last_visited_internal_latency_ = 0;
+    last_visited_latency_ = 0;
+  } else if (imm == 1 || imm == -1) {
+    last_visited_internal_latency_ = 0;
+    last_visited_latency_ = latencies_.integer_op;
+  } else if (IsPowerOfTwo(AbsOrMin(imm))) {
+    last_visited_internal_latency_ = 3 * latencies_.integer_op;
+    last_visited_latency_ = latencies_.integer_op;
+  } else {
+    DCHECK(imm <= -2 || imm >= 2);
+    last_visited_internal_latency_ = latencies_.mul_integer + 2 * latencies_.integer_op;
+    last_visited_latency_ = latencies_.integer_op;
+  }
+  if (instruction->IsRem() && imm != 0 && imm != 1 && imm != -1) {
+    // The remainder is computed from the quotient.
+    last_visited_internal_latency_ += last_visited_latency_ + latencies_.mul_integer;
+    last_visited_latency_ = latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitDiv(HDiv* instr) {
+  DataType::Type type = instr->GetResultType();
+  switch (type) {
+    case DataType::Type::kFloat32:
+      last_visited_latency_ = latencies_.div_float;
+      break;
+    case DataType::Type::kFloat64:
+      last_visited_latency_ = latencies_.div_double;
+      break;
+    default:
+      if (instr->GetRight()->IsConstant()) {
+        HandleDivRemConstantIntegral(instr, Int64FromConstant(instr->GetRight()->AsConstant()));
+      } else {
+        // Take the test for a -1 divisor into account.
+        last_visited_internal_latency_ = latencies_.integer_op + latencies_.branch;
+        last_visited_latency_ =
+            (type == DataType::Type::kInt64) ? latencies_.div_long : latencies_.div_integer;
+      }
+      break;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitInstanceFieldGet(HInstanceFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitInstanceOf(HInstanceOf* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.call_internal;
+  last_visited_latency_ = latencies_.integer_op;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitInvoke(HInvoke* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.call_internal;
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitLoadString(HLoadString* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.load_string_internal;
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitMul(HMul* instr) {
+  last_visited_latency_ = DataType::IsFloatingPointType(instr->GetResultType())
+      ? latencies_.mul_floating_point
+      : latencies_.mul_integer;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitNewArray(HNewArray* ATTRIBUTE_UNUSED) {
+  last_visited_internal_latency_ = latencies_.integer_op + latencies_.call_internal;
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitNewInstance(HNewInstance* instruction) {
+  if (instruction->IsStringAlloc()) {
+    last_visited_internal_latency_ = 2 + latencies_.memory_load + latencies_.call_internal;
+  } else {
+    last_visited_internal_latency_ = latencies_.call_internal;
+  }
+  last_visited_latency_ = latencies_.call;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitRem(HRem* instruction) {
+  DataType::Type type = instruction->GetResultType();
+  if (DataType::IsFloatingPointType(type)) {
+    // The remainder is computed with an x87 `fprem` loop through the stack.
+    last_visited_internal_latency_ =
+        (type == DataType::Type::kFloat32) ? latencies_.div_float : latencies_.div_double;
+    last_visited_latency_ = latencies_.memory_load;
+  } else if (instruction->GetRight()->IsConstant()) {
+    HandleDivRemConstantIntegral(instruction,
+                                 Int64FromConstant(instruction->GetRight()->AsConstant()));
+  } else {
+    last_visited_internal_latency_ = latencies_.integer_op + latencies_.branch;
+    last_visited_latency_ =
+        (type == DataType::Type::kInt64) ? latencies_.div_long : latencies_.div_integer;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitStaticFieldGet(HStaticFieldGet* ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.memory_load;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitSuspendCheck(HSuspendCheck* instruction) {
+  HBasicBlock* block = instruction->GetBlock();
+  DCHECK((block->GetLoopInformation() != nullptr) ||
+         (block->IsEntryBlock() && instruction->GetNext()->IsGoto()));
+  // Users do not use any data results.
+  last_visited_latency_ = 0;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitTypeConversion(HTypeConversion* instr) {
+  DataType::Type result_type = instr->GetResultType();
+  DataType::Type input_type = instr->GetInputType();
+  if (DataType::IsFloatingPointType(input_type) && DataType::IsIntegralType(result_type)) {
+    // Java semantics for NaN and out of range values require compares and branches
+    // around the `cvtts*2si`.
+    last_visited_internal_latency_ = latencies_.floating_point_op + 2 * latencies_.branch;
+    last_visited_latency_ = latencies_.type_conversion_floating_point_integer;
+  } else if (DataType::IsFloatingPointType(result_type) ||
+             DataType::IsFloatingPointType(input_type)) {
+    last_visited_latency_ = latencies_.type_conversion_floating_point_integer;
+  } else {
+    last_visited_latency_ = latencies_.integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::HandleSimpleArithmeticSIMD(HVecOperation* instr) {
+  if (DataType::IsFloatingPointType(instr->GetPackedType())) {
+    last_visited_latency_ = latencies_.simd_floating_point_op;
+  } else {
+    last_visited_latency_ = latencies_.simd_integer_op;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecReplicateScalar(
+    HVecReplicateScalar* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_replicate_op;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecExtractScalar(HVecExtractScalar* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecReduce(HVecReduce* instr) {
+  // The reduction is a sequence of horizontal operations.
+  HandleSimpleArithmeticSIMD(instr);
+  last_visited_internal_latency_ = 2 * last_visited_latency_;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecCnv(HVecCnv* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_type_conversion_int2fp;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecNeg(HVecNeg* instr) {
+  // Negation subtracts from a zeroed register.
+  last_visited_internal_latency_ = latencies_.simd_integer_op;
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecAbs(HVecAbs* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecNot(HVecNot* instr ATTRIBUTE_UNUSED) {
+  // The complement is an `xor` with an all-ones register.
+  last_visited_internal_latency_ = latencies_.simd_integer_op;
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecAdd(HVecAdd* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecHalvingAdd(HVecHalvingAdd* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecSub(HVecSub* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecMul(HVecMul* instr) {
+  if (DataType::IsFloatingPointType(instr->GetPackedType())) {
+    last_visited_latency_ = latencies_.simd_mul_floating_point;
+  } else {
+    last_visited_latency_ = latencies_.simd_mul_integer;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecDiv(HVecDiv* instr) {
+  if (instr->GetPackedType() == DataType::Type::kFloat32) {
+    last_visited_latency_ = latencies_.simd_div_float;
+  } else {
+    DCHECK(instr->GetPackedType() == DataType::Type::kFloat64);
+    last_visited_latency_ = latencies_.simd_div_double;
+  }
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecMin(HVecMin* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecMax(HVecMax* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecAnd(HVecAnd* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecAndNot(HVecAndNot* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecOr(HVecOr* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecXor(HVecXor* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_integer_op;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecShl(HVecShl* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecShr(HVecShr* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecUShr(HVecUShr* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecSetScalars(HVecSetScalars* instr) {
+  HandleSimpleArithmeticSIMD(instr);
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecLoad(HVecLoad* instr) {
+  if (instr->GetPackedType() == DataType::Type::kUint16
+      && mirror::kUseStringCompression
+      && instr->IsStringCharAt()) {
+    // Set latencies for the uncompressed case.
+    last_visited_internal_latency_ = latencies_.memory_load + latencies_.branch;
+  }
+  // The index computation is folded into the addressing mode.
+  last_visited_latency_ = latencies_.simd_memory_load;
+}
+
+void SchedulingLatencyVisitorX86_64::VisitVecStore(HVecStore* instr ATTRIBUTE_UNUSED) {
+  last_visited_latency_ = latencies_.simd_memory_store;
+}
+
+}  // namespace x86_64
+}  // namespace art
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SCHEDULER_X86_64_H_
+#define ART_COMPILER_OPTIMIZING_SCHEDULER_X86_64_H_
+
+#include "scheduler.h"
+
+namespace art {
+
+class X86_64InstructionSetFeatures;
+
+namespace x86_64 {
+
+// x86-64 instruction latencies, in cycles, for one class of CPUs.
+struct X86_64SchedulingLatencies {
+  uint32_t memory_load;
+  uint32_t memory_store;
+
+  uint32_t call_internal;
+  uint32_t call;
+
+  uint32_t integer_op;
+  uint32_t floating_point_op;
+
+  uint32_t div_double;
+  uint32_t div_float;
+  uint32_t div_integer;
+  uint32_t div_long;
+  uint32_t load_string_internal;
+  uint32_t mul_floating_point;
+  uint32_t mul_integer;
+  uint32_t type_conversion_floating_point_integer;
+  uint32_t branch;
+
+  uint32_t simd_floating_point_op;
+  uint32_t simd_integer_op;
+  uint32_t simd_memory_load;
+  uint32_t simd_memory_store;
+  uint32_t simd_mul_floating_point;
+  uint32_t simd_mul_integer;
+  uint32_t simd_replicate_op;
+  uint32_t simd_div_double;
+  uint32_t simd_div_float;
+  uint32_t simd_type_conversion_int2fp;
+};
+
+class SchedulingLatencyVisitorX86_64 : public SchedulingLatencyVisitor {
+ public:
+  // The latency table is selected from the `features` of the target CPU. Without
+  // `features`, latencies of a generic core are used.
+  explicit SchedulingLatencyVisitorX86_64(const X86_64InstructionSetFeatures* features = nullptr)
+      : latencies_(GetLatencies(features)) {}
+
+  // Default visitor for instructions not handled specifically below.
+  void VisitInstruction(HInstruction* ATTRIBUTE_UNUSED) {
+    last_visited_latency_ = latencies_.integer_op;
+  }
+
+// We add a second unused parameter to be able to use this macro like the others
+// defined in `nodes.h`.
+#define FOR_EACH_SCHEDULED_X86_64_INSTRUCTION(M)     \
+  M(ArrayGet             , unused)                   \
+  M(ArrayLength          , unused)                   \
+  M(ArraySet             , unused)                   \
+  M(BinaryOperation      , unused)                   \
+  M(BoundsCheck          , unused)                   \
+  M(Div                  , unused)                   \
+  M(InstanceFieldGet     , unused)                   \
+  M(InstanceOf           , unused)                   \
+  M(Invoke               , unused)                   \
+  M(LoadString           , unused)                   \
+  M(Mul                  , unused)                   \
+  M(NewArray             , unused)                   \
+  M(NewInstance          , unused)                   \
+  M(Rem                  , unused)                   \
+  M(StaticFieldGet       , unused)                   \
+  M(SuspendCheck         , unused)                   \
+  M(TypeConversion       , unused)                   \
+  M(VecReplicateScalar   , unused)                   \
+  M(VecExtractScalar     , unused)                   \
+  M(VecReduce            , unused)                   \
+  M(VecCnv               , unused)                   \
+  M(VecNeg               , unused)                   \
+  M(VecAbs               , unused)                   \
+  M(VecNot               , unused)                   \
+  M(VecAdd               , unused)                   \
+  M(VecHalvingAdd        , unused)                   \
+  M(VecSub               , unused)                   \
+  M(VecMul               , unused)                   \
+  M(VecDiv               , unused)                   \
+  M(VecMin               , unused)                   \
+  M(VecMax               , unused)                   \
+  M(VecAnd               , unused)                   \
+  M(VecAndNot            , unused)                   \
+  M(VecOr                , unused)                   \
+  M(VecXor               , unused)                   \
+  M(VecShl               , unused)                   \
+  M(VecShr               , unused)                   \
+  M(VecUShr              , unused)                   \
+  M(VecSetScalars        , unused)                   \
+  M(VecLoad              , unused)                   \
+  M(VecStore             , unused)
+
+#define DECLARE_VISIT_INSTRUCTION(type, unused)  \
+  void Visit##type(H##type* instruction) OVERRIDE;
+
+  FOR_EACH_SCHEDULED_X86_64_INSTRUCTION(DECLARE_VISIT_INSTRUCTION)
+
+#undef DECLARE_VISIT_INSTRUCTION
+
+ private:
+  static const X86_64SchedulingLatencies& GetLatencies(
+      const X86_64InstructionSetFeatures* features);
+
+  void HandleDivRemConstantIntegral(HBinaryOperation* instruction, int64_t imm);
+  void HandleSimpleArithmeticSIMD(HVecOperation* instr);
+
+  const X86_64SchedulingLatencies& latencies_;
+};
+
+class HSchedulerX86_64 : public HScheduler {
+ public:
+  HSchedulerX86_64(ScopedArenaAllocator* allocator,
+                   SchedulingNodeSelector* selector,
+                   const X86_64InstructionSetFeatures* features = nullptr)
+      : HScheduler(allocator, &x86_64_latency_visitor_, selector),
+        x86_64_latency_visitor_(features) {}
+  ~HSchedulerX86_64() OVERRIDE {}
+
+  bool IsSchedulable(const HInstruction* instruction) const OVERRIDE {
+#define CASE_INSTRUCTION_KIND(type, unused) case \
+  HInstruction::InstructionKind::k##type:
+    switch (instruction->GetKind()) {
+      FOR_EACH_SCHEDULED_X86_64_INSTRUCTION(CASE_INSTRUCTION_KIND)
+        return true;
+      default:
+        return HScheduler::IsSchedulable(instruction);
+    }
+#undef CASE_INSTRUCTION_KIND
+  }
+
+  // As on arm64, the compiler has no notion of SIMD registers and none of the XMM
+  // registers are callee-saved, so do not reorder vector instructions whose live
+  // ranges may exceed the vectorized loop boundaries.
+  bool IsSchedulingBarrier(const HInstruction* instr) const OVERRIDE {
+    return HScheduler::IsSchedulingBarrier(instr) ||
+           instr->IsVecReduce() ||
+           instr->IsVecExtractScalar() ||
+           instr->IsVecSetScalars() ||
+           instr->IsVecReplicateScalar();
+  }
+
+ private:
+  SchedulingLatencyVisitorX86_64 x86_64_latency_visitor_;
+  DISALLOW_COPY_AND_ASSIGN(HSchedulerX86_64);
+};
+
+}  // namespace x86_64
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SCHEDULER_X86_64_H_
@@ -509,6 +509,7 @@ Location LiveInterval::ToLocation() const {
         case 1: return Location::StackSlot(GetParent()->GetSpillSlot());
         case 2: return Location::DoubleStackSlot(GetParent()->GetSpillSlot());
         case 4: return Location::SIMDStackSlot(GetParent()->GetSpillSlot());
+        case 8: return Location::SIMDStackSlot(GetParent()->GetSpillSlot());
         default: LOG(FATAL) << "Unexpected number of spill slots"; UNREACHABLE();
       }
     } else {
@@ -36,13 +36,28 @@ void HEdge::Dump(std::ostream& stream) const {
 // Static helper methods.
 //
 
+// Returns whether the phi is in a block which is a successor of the region, defined by basic
+// block set.
+static bool IsRegionExitPhi(const HInstruction* instr, const HBasicBlockSet& bb_set) {
+  if (!instr->IsPhi()) {
+    return false;
+  }
+  for (HBasicBlock* predecessor : instr->GetBlock()->GetPredecessors()) {
+    if (bb_set.IsBitSet(predecessor->GetBlockId())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 // Returns whether instruction has any uses (regular or environmental) outside the region,
-// defined by basic block set.
+// defined by basic block set. Uses by phis in the region exits are not counted: the copied
+// outgoing edges provide these phis with the copied values.
 static bool IsUsedOutsideRegion(const HInstruction* instr, const HBasicBlockSet& bb_set) {
   auto& uses = instr->GetUses();
   for (auto use_node = uses.begin(), e = uses.end(); use_node != e; ++use_node) {
     HInstruction* user = use_node->GetUser();
-    if (!bb_set.IsBitSet(user->GetBlock()->GetBlockId())) {
+    if (!bb_set.IsBitSet(user->GetBlock()->GetBlockId()) && !IsRegionExitPhi(user, bb_set)) {
       return true;
     }
   }
@@ -213,6 +228,21 @@ void SuperblockCloner::RemapCopyInternalEdge(HBasicBlock* orig_block,
   }
 }
 
+void SuperblockCloner::AddCopyOutgoingEdge(HBasicBlock* orig_block,
+                                           HBasicBlock* orig_succ) {
+  DCHECK(!IsInOrigBBSet(orig_succ));
+  HBasicBlock* copy_block = GetBlockCopy(orig_block);
+  size_t orig_index = orig_succ->GetPredecessorIndexOf(orig_block);
+  copy_block->AddSuccessor(orig_succ);
+
+  // The inputs are remapped to their copies in ResolveDataFlow.
+  for (HInstructionIterator it(orig_succ->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* orig_phi = it.Current()->AsPhi();
+    HInstruction* orig_phi_input = orig_phi->InputAt(orig_index);
+    orig_phi->AddInput(orig_phi_input);
+  }
+}
+
 //
 // Local versions of CF calculation/adjustment routines.
 //
@@ -450,8 +480,7 @@ void SuperblockCloner::RemapEdgesSuccessors() {
 
       // Check for outgoing edge.
       if (!IsInOrigBBSet(orig_succ)) {
-        HBasicBlock* copy_block = GetBlockCopy(orig_block);
-        copy_block->AddSuccessor(orig_succ);
+        AddCopyOutgoingEdge(orig_block, orig_succ);
         continue;
       }
 
@@ -501,6 +530,16 @@ void SuperblockCloner::ResolveDataFlow() {
       }
     }
   }
+
+  // Phis in the subgraph exits got inputs for the copy blocks in AddCopyOutgoingEdge. An exit
+  // may be listed more than once, which is fine as ResolvePhi is idempotent.
+  ArenaVector<HBasicBlock*> exits(arena_->Adapter(kArenaAllocSuperblockCloner));
+  SearchForSubgraphExits(&exits);
+  for (HBasicBlock* exit : exits) {
+    for (HInstructionIterator it(exit->GetPhis()); !it.Done(); it.Advance()) {
+      ResolvePhi(it.Current()->AsPhi());
+    }
+  }
 }
 
 //
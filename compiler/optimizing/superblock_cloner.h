@@ -252,6 +252,10 @@ class SuperblockCloner : public ValueObject {
   // Remaps copy internal edge to its origin, adjusts the phi inputs in orig_succ.
   void RemapCopyInternalEdge(HBasicBlock* orig_block, HBasicBlock* orig_succ);
 
+  // Adds copy outgoing edge (from copy_block to orig_succ outside the subgraph), adds the phi
+  // inputs in orig_succ.
+  void AddCopyOutgoingEdge(HBasicBlock* orig_block, HBasicBlock* orig_succ);
+
   //
   // Local versions of control flow calculation/adjustment routines.
   //
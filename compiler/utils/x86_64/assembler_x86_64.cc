@@ -1754,6 +1754,15 @@ void X86_64Assembler::pcmpeqq(XmmRegister dst, XmmRegister src) {
   EmitXmmRegisterOperand(dst.LowBits(), src);
 }
 
+void X86_64Assembler::pmovmskb(CpuRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0xD7);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
 void X86_64Assembler::pcmpgtb(XmmRegister dst, XmmRegister src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -2011,6 +2020,760 @@ void X86_64Assembler::psrldq(XmmRegister reg, const Immediate& shift_count) {
 }
 
 
+void X86_64Assembler::vmovaps(XmmRegister dst, const Address& src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x28);
+  EmitOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vmovaps(const Address& dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(src, XmmRegister(XMM0), dst, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x29);
+  EmitOperand(src.LowBits(), dst);
+}
+
+void X86_64Assembler::vmovups(XmmRegister dst, const Address& src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x10);
+  EmitOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vmovups(const Address& dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(src, XmmRegister(XMM0), dst, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x11);
+  EmitOperand(src.LowBits(), dst);
+}
+
+void X86_64Assembler::vmovapd(XmmRegister dst, const Address& src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x28);
+  EmitOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vmovapd(const Address& dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(src, XmmRegister(XMM0), dst, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x29);
+  EmitOperand(src.LowBits(), dst);
+}
+
+void X86_64Assembler::vmovupd(XmmRegister dst, const Address& src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x10);
+  EmitOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vmovupd(const Address& dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(src, XmmRegister(XMM0), dst, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x11);
+  EmitOperand(src.LowBits(), dst);
+}
+
+void X86_64Assembler::vmovdqa(XmmRegister dst, const Address& src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x6F);
+  EmitOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vmovdqa(const Address& dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(src, XmmRegister(XMM0), dst, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x7F);
+  EmitOperand(src.LowBits(), dst);
+}
+
+void X86_64Assembler::vmovdqu(XmmRegister dst, const Address& src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPpF3, kVexMap0F, length);
+  EmitUint8(0x6F);
+  EmitOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vmovdqu(const Address& dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(src, XmmRegister(XMM0), dst, kVexPpF3, kVexMap0F, length);
+  EmitUint8(0x7F);
+  EmitOperand(src.LowBits(), dst);
+}
+
+void X86_64Assembler::vmovaps(XmmRegister dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  if (src.NeedsRex() && !dst.NeedsRex()) {
+    // Use the store form, which allows the shorter two-byte VEX prefix.
+    EmitVexPrefix(src, XmmRegister(XMM0), dst, kVexPpNone, kVexMap0F, length);
+    EmitUint8(0x29);
+    EmitXmmRegisterOperand(src.LowBits(), dst);
+  } else {
+    EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPpNone, kVexMap0F, length);
+    EmitUint8(0x28);
+    EmitXmmRegisterOperand(dst.LowBits(), src);
+  }
+}
+
+void X86_64Assembler::vcvtdq2ps(XmmRegister dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x5B);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vpbroadcastb(XmmRegister dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x78);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vpbroadcastw(XmmRegister dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x79);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vpbroadcastd(XmmRegister dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x58);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vpbroadcastq(XmmRegister dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x59);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vbroadcastss(XmmRegister dst, XmmRegister src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x18);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vbroadcastsd(XmmRegister dst, XmmRegister src, VexLength length) {
+  DCHECK_EQ(length, kVexLength256);  // There is no 128-bit form.
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x19);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vpaddb(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xFC);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpaddw(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xFD);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpaddd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xFE);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpaddq(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xD4);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpsubb(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xF8);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpsubw(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xF9);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpsubd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xFA);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpsubq(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xFB);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpmullw(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xD5);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpmulld(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x40);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpavgb(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xE0);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpavgw(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xE3);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpminsb(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x38);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpmaxsb(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x3C);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpminsw(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xEA);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpmaxsw(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xEE);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpminsd(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x39);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpmaxsd(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x3D);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpminub(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xDA);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpmaxub(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xDE);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpminuw(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x3A);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpmaxuw(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x3E);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpminud(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x3B);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpmaxud(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x3F);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpand(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xDB);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpandn(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xDF);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpor(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xEB);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpxor(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0xEF);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpcmpeqb(XmmRegister dst,
+                               XmmRegister src1,
+                               XmmRegister src2,
+                               VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x74);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpcmpgtd(XmmRegister dst,
+                               XmmRegister src1,
+                               XmmRegister src2,
+                               VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x66);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vaddps(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x58);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vsubps(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x5C);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vmulps(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x59);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vdivps(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x5E);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vminps(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x5D);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vmaxps(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x5F);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vaddpd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x58);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vsubpd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x5C);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vmulpd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x59);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vdivpd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x5E);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vminpd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x5D);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vmaxpd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x5F);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vandps(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x54);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vandnps(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x55);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vorps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x56);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vxorps(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPpNone, kVexMap0F, length);
+  EmitUint8(0x57);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vandpd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x54);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vandnpd(XmmRegister dst,
+                              XmmRegister src1,
+                              XmmRegister src2,
+                              VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x55);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x56);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vxorpd(XmmRegister dst,
+                             XmmRegister src1,
+                             XmmRegister src2,
+                             VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, src1, src2, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x57);
+  EmitXmmRegisterOperand(dst.LowBits(), src2);
+}
+
+void X86_64Assembler::vpsllw(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             VexLength length) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), dst, src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x71);
+  EmitXmmRegisterOperand(6, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpslld(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             VexLength length) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), dst, src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x72);
+  EmitXmmRegisterOperand(6, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsllq(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             VexLength length) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), dst, src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x73);
+  EmitXmmRegisterOperand(6, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsraw(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             VexLength length) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), dst, src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x71);
+  EmitXmmRegisterOperand(4, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrad(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             VexLength length) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), dst, src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x72);
+  EmitXmmRegisterOperand(4, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrlw(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             VexLength length) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), dst, src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x71);
+  EmitXmmRegisterOperand(2, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrld(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             VexLength length) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), dst, src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x72);
+  EmitXmmRegisterOperand(2, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpsrlq(XmmRegister dst,
+                             XmmRegister src,
+                             const Immediate& shift_count,
+                             VexLength length) {
+  DCHECK(shift_count.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), dst, src, kVexPp66, kVexMap0F, length);
+  EmitUint8(0x73);
+  EmitXmmRegisterOperand(2, src);
+  EmitUint8(shift_count.value());
+}
+
+void X86_64Assembler::vpmovzxbw(XmmRegister dst, const Address& src, VexLength length) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(dst, XmmRegister(XMM0), src, kVexPp66, kVexMap0F38, length);
+  EmitUint8(0x30);
+  EmitOperand(dst.LowBits(), src);
+}
+
+void X86_64Assembler::vextracti128(XmmRegister dst, XmmRegister src, const Immediate& imm) {
+  DCHECK(imm.is_uint8());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // The destination is encoded in ModRM.rm and the source in ModRM.reg.
+  EmitVexPrefix(src, XmmRegister(XMM0), dst, kVexPp66, kVexMap0F3A, kVexLength256);
+  EmitUint8(0x39);
+  EmitXmmRegisterOperand(src.LowBits(), dst);
+  EmitUint8(imm.value());
+}
+
+void X86_64Assembler::vzeroupper() {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVexPrefix(XmmRegister(XMM0), XmmRegister(XMM0), XmmRegister(XMM0),
+                kVexPpNone, kVexMap0F, kVexLength128);
+  EmitUint8(0x77);
+}
+
+
 void X86_64Assembler::fldl(const Address& src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0xDD);
@@ -2184,6 +2947,14 @@ void X86_64Assembler::xchgl(CpuRegister reg, const Address& address) {
 }
 
 
+void X86_64Assembler::xchgq(CpuRegister reg, const Address& address) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitRex64(reg, address);
+  EmitUint8(0x87);
+  EmitOperand(reg.LowBits(), address);
+}
+
+
 void X86_64Assembler::cmpb(const Address& address, const Immediate& imm) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   CHECK(imm.is_int32());
@@ -3141,6 +3912,24 @@ void X86_64Assembler::cmpxchgq(const Address& address, CpuRegister reg) {
 }
 
 
+void X86_64Assembler::xaddl(const Address& address, CpuRegister reg) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitOptionalRex32(reg, address);
+  EmitUint8(0x0F);
+  EmitUint8(0xC1);
+  EmitOperand(reg.LowBits(), address);
+}
+
+
+void X86_64Assembler::xaddq(const Address& address, CpuRegister reg) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitRex64(reg, address);
+  EmitUint8(0x0F);
+  EmitUint8(0xC1);
+  EmitOperand(reg.LowBits(), address);
+}
+
+
 void X86_64Assembler::mfence() {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x0F);
@@ -3307,6 +4096,13 @@ void X86_64Assembler::repne_scasw() {
   EmitUint8(0xAF);
 }
 
+void X86_64Assembler::repe_cmpsb() {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0xF3);
+  EmitUint8(0xA6);
+}
+
+
 void X86_64Assembler::repe_cmpsw() {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -3636,6 +4432,47 @@ void X86_64Assembler::EmitOptionalByteRegNormalizingRex32(CpuRegister dst, const
   }
 }
 
+void X86_64Assembler::EmitVexPrefix(XmmRegister reg,
+                                    XmmRegister vvvv,
+                                    XmmRegister rm,
+                                    VexPp pp,
+                                    VexMap map,
+                                    VexLength length) {
+  EmitVexPrefix(reg.NeedsRex(), false, rm.NeedsRex(), vvvv, pp, map, length);
+}
+
+void X86_64Assembler::EmitVexPrefix(XmmRegister reg,
+                                    XmmRegister vvvv,
+                                    const Operand& rm,
+                                    VexPp pp,
+                                    VexMap map,
+                                    VexLength length) {
+  uint8_t rex = rm.rex();
+  EmitVexPrefix(reg.NeedsRex(), (rex & 0x02) != 0, (rex & 0x01) != 0, vvvv, pp, map, length);
+}
+
+void X86_64Assembler::EmitVexPrefix(bool r,
+                                    bool x,
+                                    bool b,
+                                    XmmRegister vvvv,
+                                    VexPp pp,
+                                    VexMap map,
+                                    VexLength length) {
+  // The R, X, B and vvvv fields are stored inverted.
+  uint8_t vvvv_l_pp = (static_cast<uint8_t>(~vvvv.AsFloatRegister() & 0xF) << 3) |
+                      (static_cast<uint8_t>(length) << 2) |
+                      static_cast<uint8_t>(pp);
+  if (!x && !b && map == kVexMap0F) {
+    // Two-byte form, implying VEX.W0 and the 0F opcode map.
+    EmitUint8(0xC5);
+    EmitUint8((r ? 0x00 : 0x80) | vvvv_l_pp);
+  } else {
+    EmitUint8(0xC4);
+    EmitUint8((r ? 0x00 : 0x80) | (x ? 0x00 : 0x40) | (b ? 0x00 : 0x20) | map);
+    EmitUint8(vvvv_l_pp);  // VEX.W0
+  }
+}
+
 void X86_64Assembler::AddConstantArea() {
   ArrayRef<const int32_t> area = constant_area_.GetBuffer();
   for (size_t i = 0, e = area.size(); i < e; i++) {
@@ -579,6 +579,8 @@ class X86_64Assembler FINAL : public Assembler {
   void pcmpeqd(XmmRegister dst, XmmRegister src);
   void pcmpeqq(XmmRegister dst, XmmRegister src);
 
+  void pmovmskb(CpuRegister dst, XmmRegister src);
+
   void pcmpgtb(XmmRegister dst, XmmRegister src);
   void pcmpgtw(XmmRegister dst, XmmRegister src);
   void pcmpgtd(XmmRegister dst, XmmRegister src);
@@ -611,6 +613,98 @@ class X86_64Assembler FINAL : public Assembler {
   void psrlq(XmmRegister reg, const Immediate& shift_count);
   void psrldq(XmmRegister reg, const Immediate& shift_count);
 
+  //
+  // AVX/AVX2 instructions, using the VEX encoding. The `length` of the operation selects
+  // either the 128-bit xmm registers or the 256-bit ymm registers. Note that VEX-encoded
+  // 128-bit operations zero the upper half of the destination ymm register.
+  //
+
+  void vmovaps(XmmRegister dst, const Address& src, VexLength length);
+  void vmovaps(const Address& dst, XmmRegister src, VexLength length);
+  void vmovups(XmmRegister dst, const Address& src, VexLength length);
+  void vmovups(const Address& dst, XmmRegister src, VexLength length);
+  void vmovapd(XmmRegister dst, const Address& src, VexLength length);
+  void vmovapd(const Address& dst, XmmRegister src, VexLength length);
+  void vmovupd(XmmRegister dst, const Address& src, VexLength length);
+  void vmovupd(const Address& dst, XmmRegister src, VexLength length);
+  void vmovdqa(XmmRegister dst, const Address& src, VexLength length);
+  void vmovdqa(const Address& dst, XmmRegister src, VexLength length);
+  void vmovdqu(XmmRegister dst, const Address& src, VexLength length);
+  void vmovdqu(const Address& dst, XmmRegister src, VexLength length);
+  void vmovaps(XmmRegister dst, XmmRegister src, VexLength length);
+  void vpmovzxbw(XmmRegister dst, const Address& src, VexLength length);
+
+  void vpaddb(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpaddw(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpaddd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpaddq(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpsubb(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpsubw(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpsubd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpsubq(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpmullw(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpmulld(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpavgb(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpavgw(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpminsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpmaxsb(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpminsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpmaxsw(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpminsd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpmaxsd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpminub(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpmaxub(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpminuw(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpmaxuw(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpminud(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpmaxud(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpand(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpandn(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpor(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpxor(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpcmpeqb(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vpcmpgtd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vaddps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vsubps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vmulps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vdivps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vminps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vmaxps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vaddpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vsubpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vmulpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vdivpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vminpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vmaxpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vandps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vandnps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vorps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vxorps(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vandpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vandnpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+  void vxorpd(XmmRegister dst, XmmRegister src1, XmmRegister src2, VexLength length);
+
+  void vcvtdq2ps(XmmRegister dst, XmmRegister src, VexLength length);
+  void vpbroadcastb(XmmRegister dst, XmmRegister src, VexLength length);
+  void vpbroadcastw(XmmRegister dst, XmmRegister src, VexLength length);
+  void vpbroadcastd(XmmRegister dst, XmmRegister src, VexLength length);
+  void vpbroadcastq(XmmRegister dst, XmmRegister src, VexLength length);
+  void vbroadcastss(XmmRegister dst, XmmRegister src, VexLength length);
+  void vbroadcastsd(XmmRegister dst, XmmRegister src, VexLength length);
+  void vextracti128(XmmRegister dst, XmmRegister src, const Immediate& imm);  // ymm -> xmm
+
+  void vpsllw(XmmRegister dst, XmmRegister src, const Immediate& shift_count, VexLength length);
+  void vpslld(XmmRegister dst, XmmRegister src, const Immediate& shift_count, VexLength length);
+  void vpsllq(XmmRegister dst, XmmRegister src, const Immediate& shift_count, VexLength length);
+  void vpsraw(XmmRegister dst, XmmRegister src, const Immediate& shift_count, VexLength length);
+  void vpsrad(XmmRegister dst, XmmRegister src, const Immediate& shift_count, VexLength length);
+  void vpsrlw(XmmRegister dst, XmmRegister src, const Immediate& shift_count, VexLength length);
+  void vpsrld(XmmRegister dst, XmmRegister src, const Immediate& shift_count, VexLength length);
+  void vpsrlq(XmmRegister dst, XmmRegister src, const Immediate& shift_count, VexLength length);
+
+  void vzeroupper();
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -642,6 +736,7 @@ class X86_64Assembler FINAL : public Assembler {
   void xchgl(CpuRegister dst, CpuRegister src);
   void xchgq(CpuRegister dst, CpuRegister src);
   void xchgl(CpuRegister reg, const Address& address);
+  void xchgq(CpuRegister reg, const Address& address);
 
   void cmpb(const Address& address, const Immediate& imm);
   void cmpw(const Address& address, const Immediate& imm);
@@ -772,6 +867,8 @@ class X86_64Assembler FINAL : public Assembler {
   X86_64Assembler* lock();
   void cmpxchgl(const Address& address, CpuRegister reg);
   void cmpxchgq(const Address& address, CpuRegister reg);
+  void xaddl(const Address& address, CpuRegister reg);
+  void xaddq(const Address& address, CpuRegister reg);
 
   void mfence();
 
@@ -809,6 +906,7 @@ class X86_64Assembler FINAL : public Assembler {
 
   void repne_scasb();
   void repne_scasw();
+  void repe_cmpsb();
   void repe_cmpsw();
   void repe_cmpsl();
   void repe_cmpsq();
@@ -830,6 +928,14 @@ class X86_64Assembler FINAL : public Assembler {
     lock()->cmpxchgq(address, reg);
   }
 
+  void LockXaddl(const Address& address, CpuRegister reg) {
+    lock()->xaddl(address, reg);
+  }
+
+  void LockXaddq(const Address& address, CpuRegister reg) {
+    lock()->xaddq(address, reg);
+  }
+
   //
   // Misc. functionality
   //
@@ -942,6 +1048,34 @@ class X86_64Assembler FINAL : public Assembler {
   void EmitOptionalByteRegNormalizingRex32(CpuRegister dst, CpuRegister src);
   void EmitOptionalByteRegNormalizingRex32(CpuRegister dst, const Operand& operand);
 
+  // Implied legacy prefix (VEX.pp) and implied leading opcode bytes (VEX.m-mmmm) of a
+  // VEX-encoded instruction.
+  enum VexPp : uint8_t { kVexPpNone = 0, kVexPp66 = 1, kVexPpF3 = 2, kVexPpF2 = 3 };
+  enum VexMap : uint8_t { kVexMap0F = 1, kVexMap0F38 = 2, kVexMap0F3A = 3 };
+
+  // Emit a VEX prefix for an instruction with `reg` in ModRM.reg, `rm` in ModRM.rm and
+  // `vvvv` as the additional source register (XMM0 when there is none). The two-byte
+  // form is used whenever possible.
+  void EmitVexPrefix(XmmRegister reg,
+                     XmmRegister vvvv,
+                     XmmRegister rm,
+                     VexPp pp,
+                     VexMap map,
+                     VexLength length);
+  void EmitVexPrefix(XmmRegister reg,
+                     XmmRegister vvvv,
+                     const Operand& rm,
+                     VexPp pp,
+                     VexMap map,
+                     VexLength length);
+  void EmitVexPrefix(bool r,
+                     bool x,
+                     bool b,
+                     XmmRegister vvvv,
+                     VexPp pp,
+                     VexMap map,
+                     VexLength length);
+
   ConstantArea constant_area_;
 
   DISALLOW_COPY_AND_ASSIGN(X86_64Assembler);
@@ -926,6 +926,14 @@ TEST_F(AssemblerX86_64Test, Xchgq) {
   DriverStr(RepeatRR(&x86_64::X86_64Assembler::xchgq, "xchgq %{reg2}, %{reg1}"), "xchgq");
 }
 
+TEST_F(AssemblerX86_64Test, XchgqAddress) {
+  DriverStr(RepeatRA(&x86_64::X86_64Assembler::xchgq, "xchgq %{reg}, {mem}"), "xchgq_a");
+}
+
+TEST_F(AssemblerX86_64Test, XchglAddress) {
+  DriverStr(RepeatrA(&x86_64::X86_64Assembler::xchgl, "xchgl %{reg}, {mem}"), "xchgl_a");
+}
+
 TEST_F(AssemblerX86_64Test, Xchgl) {
   // TODO: Test is disabled because GCC generates 0x87 0xC0 for xchgl eax, eax. All other cases
   // are the same. Anyone know why it doesn't emit a simple 0x90? It does so for xchgq rax, rax...
@@ -942,6 +950,16 @@ TEST_F(AssemblerX86_64Test, LockCmpxchgq) {
                      "lock cmpxchg %{reg}, {mem}"), "lock_cmpxchg");
 }
 
+TEST_F(AssemblerX86_64Test, LockXaddl) {
+  DriverStr(RepeatAr(&x86_64::X86_64Assembler::LockXaddl,
+                     "lock xaddl %{reg}, {mem}"), "lock_xaddl");
+}
+
+TEST_F(AssemblerX86_64Test, LockXaddq) {
+  DriverStr(RepeatAR(&x86_64::X86_64Assembler::LockXaddq,
+                     "lock xaddq %{reg}, {mem}"), "lock_xaddq");
+}
+
 TEST_F(AssemblerX86_64Test, MovqStore) {
   DriverStr(RepeatAR(&x86_64::X86_64Assembler::movq, "movq %{reg}, {mem}"), "movq_s");
 }
@@ -1534,6 +1552,10 @@ TEST_F(AssemblerX86_64Test, PCmpeqq) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::pcmpeqq, "pcmpeqq %{reg2}, %{reg1}"), "pcmpeqq");
 }
 
+TEST_F(AssemblerX86_64Test, PMovmskb) {
+  DriverStr(RepeatrF(&x86_64::X86_64Assembler::pmovmskb, "pmovmskb %{reg2}, %{reg1}"), "pmovmskb");
+}
+
 TEST_F(AssemblerX86_64Test, PCmpgtb) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::pcmpgtb, "pcmpgtb %{reg2}, %{reg1}"), "pcmpgtb");
 }
@@ -1668,6 +1690,125 @@ TEST_F(AssemblerX86_64Test, Psrldq) {
             "psrldq $2, %xmm15\n", "psrldqi");
 }
 
+TEST_F(AssemblerX86_64Test, VexMoves) {
+  GetAssembler()->vmovups(x86_64::XmmRegister(x86_64::XMM0),
+                          x86_64::Address(x86_64::CpuRegister(x86_64::RAX), 12),
+                          x86_64::kVexLength256);
+  GetAssembler()->vmovups(x86_64::Address(x86_64::CpuRegister(x86_64::R9),
+                                          x86_64::CpuRegister(x86_64::R12),
+                                          x86_64::TIMES_4,
+                                          16),
+                          x86_64::XmmRegister(x86_64::XMM15),
+                          x86_64::kVexLength256);
+  GetAssembler()->vmovdqa(x86_64::XmmRegister(x86_64::XMM1),
+                          x86_64::Address(x86_64::CpuRegister(x86_64::RSP), 32),
+                          x86_64::kVexLength128);
+  GetAssembler()->vmovapd(x86_64::Address(x86_64::CpuRegister(x86_64::RDI), 0),
+                          x86_64::XmmRegister(x86_64::XMM8),
+                          x86_64::kVexLength256);
+  GetAssembler()->vmovaps(x86_64::XmmRegister(x86_64::XMM3),
+                          x86_64::XmmRegister(x86_64::XMM11),
+                          x86_64::kVexLength256);
+  DriverStr("vmovups 12(%rax), %ymm0\n"
+            "vmovups %ymm15, 16(%r9,%r12,4)\n"
+            "vmovdqa 32(%rsp), %xmm1\n"
+            "vmovapd %ymm8, 0(%rdi)\n"
+            "vmovaps %ymm11, %ymm3\n", "vex_moves");
+}
+
+TEST_F(AssemblerX86_64Test, VexArithmetic) {
+  GetAssembler()->vpaddd(x86_64::XmmRegister(x86_64::XMM0),
+                         x86_64::XmmRegister(x86_64::XMM1),
+                         x86_64::XmmRegister(x86_64::XMM2),
+                         x86_64::kVexLength256);
+  GetAssembler()->vpaddd(x86_64::XmmRegister(x86_64::XMM8),
+                         x86_64::XmmRegister(x86_64::XMM9),
+                         x86_64::XmmRegister(x86_64::XMM10),
+                         x86_64::kVexLength256);
+  GetAssembler()->vpsubq(x86_64::XmmRegister(x86_64::XMM0),
+                         x86_64::XmmRegister(x86_64::XMM15),
+                         x86_64::XmmRegister(x86_64::XMM1),
+                         x86_64::kVexLength128);
+  GetAssembler()->vpmulld(x86_64::XmmRegister(x86_64::XMM4),
+                          x86_64::XmmRegister(x86_64::XMM5),
+                          x86_64::XmmRegister(x86_64::XMM6),
+                          x86_64::kVexLength256);
+  GetAssembler()->vpminub(x86_64::XmmRegister(x86_64::XMM7),
+                          x86_64::XmmRegister(x86_64::XMM7),
+                          x86_64::XmmRegister(x86_64::XMM12),
+                          x86_64::kVexLength256);
+  GetAssembler()->vaddps(x86_64::XmmRegister(x86_64::XMM1),
+                         x86_64::XmmRegister(x86_64::XMM2),
+                         x86_64::XmmRegister(x86_64::XMM3),
+                         x86_64::kVexLength256);
+  GetAssembler()->vdivpd(x86_64::XmmRegister(x86_64::XMM13),
+                         x86_64::XmmRegister(x86_64::XMM14),
+                         x86_64::XmmRegister(x86_64::XMM15),
+                         x86_64::kVexLength256);
+  GetAssembler()->vxorps(x86_64::XmmRegister(x86_64::XMM9),
+                         x86_64::XmmRegister(x86_64::XMM9),
+                         x86_64::XmmRegister(x86_64::XMM9),
+                         x86_64::kVexLength128);
+  DriverStr("vpaddd %ymm2, %ymm1, %ymm0\n"
+            "vpaddd %ymm10, %ymm9, %ymm8\n"
+            "vpsubq %xmm1, %xmm15, %xmm0\n"
+            "vpmulld %ymm6, %ymm5, %ymm4\n"
+            "vpminub %ymm12, %ymm7, %ymm7\n"
+            "vaddps %ymm3, %ymm2, %ymm1\n"
+            "vdivpd %ymm15, %ymm14, %ymm13\n"
+            "vxorps %xmm9, %xmm9, %xmm9\n", "vex_arithmetic");
+}
+
+TEST_F(AssemblerX86_64Test, VexShifts) {
+  GetAssembler()->vpsllw(x86_64::XmmRegister(x86_64::XMM0),
+                         x86_64::XmmRegister(x86_64::XMM1),
+                         x86_64::Immediate(3),
+                         x86_64::kVexLength256);
+  GetAssembler()->vpsrad(x86_64::XmmRegister(x86_64::XMM15),
+                         x86_64::XmmRegister(x86_64::XMM15),
+                         x86_64::Immediate(31),
+                         x86_64::kVexLength256);
+  GetAssembler()->vpsrlq(x86_64::XmmRegister(x86_64::XMM2),
+                         x86_64::XmmRegister(x86_64::XMM10),
+                         x86_64::Immediate(1),
+                         x86_64::kVexLength128);
+  DriverStr("vpsllw $3, %ymm1, %ymm0\n"
+            "vpsrad $31, %ymm15, %ymm15\n"
+            "vpsrlq $1, %xmm10, %xmm2\n", "vex_shifts");
+}
+
+TEST_F(AssemblerX86_64Test, VexBroadcastAndExtract) {
+  GetAssembler()->vpbroadcastb(x86_64::XmmRegister(x86_64::XMM0),
+                               x86_64::XmmRegister(x86_64::XMM0),
+                               x86_64::kVexLength256);
+  GetAssembler()->vpbroadcastd(x86_64::XmmRegister(x86_64::XMM8),
+                               x86_64::XmmRegister(x86_64::XMM1),
+                               x86_64::kVexLength256);
+  GetAssembler()->vbroadcastsd(x86_64::XmmRegister(x86_64::XMM15),
+                               x86_64::XmmRegister(x86_64::XMM9),
+                               x86_64::kVexLength256);
+  GetAssembler()->vextracti128(x86_64::XmmRegister(x86_64::XMM0),
+                               x86_64::XmmRegister(x86_64::XMM1),
+                               x86_64::Immediate(1));
+  GetAssembler()->vextracti128(x86_64::XmmRegister(x86_64::XMM15),
+                               x86_64::XmmRegister(x86_64::XMM8),
+                               x86_64::Immediate(1));
+  GetAssembler()->vpmovzxbw(x86_64::XmmRegister(x86_64::XMM3),
+                            x86_64::Address(x86_64::CpuRegister(x86_64::RDI), 16),
+                            x86_64::kVexLength256);
+  DriverStr("vpbroadcastb %xmm0, %ymm0\n"
+            "vpbroadcastd %xmm1, %ymm8\n"
+            "vbroadcastsd %xmm9, %ymm15\n"
+            "vextracti128 $1, %ymm1, %xmm0\n"
+            "vextracti128 $1, %ymm8, %xmm15\n"
+            "vpmovzxbw 16(%rdi), %ymm3\n", "vex_broadcast_extract");
+}
+
+TEST_F(AssemblerX86_64Test, Vzeroupper) {
+  GetAssembler()->vzeroupper();
+  DriverStr("vzeroupper\n", "vzeroupper");
+}
+
 std::string x87_fn(AssemblerX86_64Test::Base* assembler_test ATTRIBUTE_UNUSED,
                    x86_64::X86_64Assembler* assembler) {
   std::ostringstream str;
@@ -1927,6 +2068,12 @@ TEST_F(AssemblerX86_64Test, Repnescasw) {
   DriverStr(expected, "Repnescasw");
 }
 
+TEST_F(AssemblerX86_64Test, Repecmpsb) {
+  GetAssembler()->repe_cmpsb();
+  const char* expected = "repe cmpsb\n";
+  DriverStr(expected, "Repecmpsb");
+}
+
 TEST_F(AssemblerX86_64Test, Repecmpsw) {
   GetAssembler()->repe_cmpsw();
   const char* expected = "repe cmpsw\n";
@@ -85,6 +85,12 @@ enum ScaleFactor {
   TIMES_8 = 3
 };
 
+// Vector length of a VEX-encoded (AVX) instruction, i.e. the VEX.L bit.
+enum VexLength {
+  kVexLength128 = 0,  // xmm registers
+  kVexLength256 = 1   // ymm registers
+};
+
 enum Condition {
   kOverflow     =  0,
   kNoOverflow   =  1,
@@ -250,6 +250,12 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("      descriptor.");
   UsageError("      Example: --output-vdex-fd=6");
   UsageError("");
+  UsageError("  --input-oat=<file.oat>: specifies an oat file previously compiled from the same");
+  UsageError("      dex locations with the same options. The compiled code of methods that do");
+  UsageError("      not depend on changed dex files is copied instead of compiled again.");
+  UsageError("      Not supported when compiling images.");
+  UsageError("      Example: --input-oat=/data/app/base.odex.old");
+  UsageError("");
   UsageError("  --oat-location=<oat-name>: specifies a symbolic name for the file corresponding");
   UsageError("      to the file descriptor specified by --oat-fd.");
   UsageError("      Example: --oat-location=/data/dalvik-cache/system@app@Calculator.apk.oat");
@@ -776,6 +782,10 @@ class Dex2Oat FINAL {
       Usage("--oat-fd should not be used with --image");
     }
 
+    if (!input_oat_.empty() && !image_filenames_.empty()) {
+      Usage("--input-oat should not be used with --image or --app-image-file");
+    }
+
     if ((input_vdex_fd_ != -1 || !input_vdex_.empty()) &&
         (dm_fd_ != -1 || !dm_file_location_.empty())) {
       Usage("An input vdex should not be passed with a .dm file");
@@ -1201,6 +1211,7 @@ class Dex2Oat FINAL {
     AssignIfExists(args, M::OutputVdexFd, &output_vdex_fd_);
     AssignIfExists(args, M::InputVdex, &input_vdex_);
     AssignIfExists(args, M::OutputVdex, &output_vdex_);
+    AssignIfExists(args, M::InputOat, &input_oat_);
     AssignIfExists(args, M::DmFd, &dm_fd_);
     AssignIfExists(args, M::DmFile, &dm_file_location_);
     AssignIfExists(args, M::OatFd, &oat_fd_);
@@ -1880,6 +1891,9 @@ class Dex2Oat FINAL {
     if (!IsBootImage()) {
       driver_->SetClasspathDexFiles(class_loader_context_->FlattenOpenedDexFiles());
     }
+    if (!input_oat_.empty()) {
+      OpenInputOatFile();
+    }
 
     const bool compile_individually = ShouldCompileDexFilesIndividually();
     if (compile_individually) {
@@ -2285,10 +2299,75 @@ class Dex2Oat FINAL {
     return result;
   }
 
+  // Open the --input-oat file and let the compiler driver reuse its compiled code if it was
+  // compiled for the same target, boot image and class loader context. Otherwise, compile
+  // everything as usual.
+  void OpenInputOatFile() {
+    TimingLogger::ScopedTiming t("Open input oat file", timings_);
+    if (IsImage() || compiler_options_->GenerateAnyDebugInfo()) {
+      // The input oat file does not have the debug info of the methods.
+      LOG(WARNING) << "Ignoring --input-oat when generating images or debug info";
+      return;
+    }
+    std::string error_msg;
+    input_oat_file_.reset(OatFile::Open(/* zip_fd */ -1,
+                                        input_oat_,
+                                        input_oat_,
+                                        /* requested_base */ nullptr,
+                                        /* oat_file_begin */ nullptr,
+                                        /* executable */ false,
+                                        /* low_4gb */ false,
+                                        /* abs_dex_location */ nullptr,
+                                        &error_msg));
+    if (input_oat_file_ == nullptr) {
+      LOG(WARNING) << "Failed to open input oat file " << input_oat_ << ": " << error_msg;
+      return;
+    }
+    const OatHeader& header = input_oat_file_->GetOatHeader();
+    std::unique_ptr<const InstructionSetFeatures> features = InstructionSetFeatures::FromBitmap(
+        instruction_set_, header.GetInstructionSetFeaturesBitmap());
+    const char* mismatch = nullptr;
+    if (header.GetInstructionSet() != instruction_set_ ||
+        !features->Equals(instruction_set_features_.get())) {
+      mismatch = "instruction set";
+    } else if (header.GetImageFileLocationOatChecksum() != image_file_location_oat_checksum_) {
+      mismatch = "boot image";
+    } else {
+      for (const char* key : { OatHeader::kCompilerFilter,
+                               OatHeader::kClassPathKey,
+                               OatHeader::kPicKey,
+                               OatHeader::kDebuggableKey,
+                               OatHeader::kNativeDebuggableKey,
+                               OatHeader::kConcurrentCopying }) {
+        const char* input_value = header.GetStoreValueByKey(key);
+        auto it = key_value_store_->find(key);
+        const char* value = (it != key_value_store_->end()) ? it->second.c_str() : nullptr;
+        if ((input_value == nullptr) != (value == nullptr) ||
+            (value != nullptr && strcmp(input_value, value) != 0)) {
+          mismatch = key;
+          break;
+        }
+      }
+    }
+    if (mismatch != nullptr) {
+      LOG(WARNING) << "Ignoring input oat file " << input_oat_ << " with different " << mismatch;
+      input_oat_file_.reset();
+      return;
+    }
+    driver_->SetInputOatFile(input_oat_file_.get());
+  }
+
   void DumpTiming() {
     if (compiler_options_->GetDumpTimings() ||
         (kIsDebugBuild && timings_->GetTotalNs() > MsToNs(1000))) {
       LOG(INFO) << Dumpable<TimingLogger>(*timings_);
+      if (driver_ != nullptr) {
+        std::ostringstream oss;
+        driver_->DumpCompileThreadTimes(oss);
+        if (!oss.str().empty()) {
+          LOG(INFO) << oss.str();
+        }
+      }
     }
   }
 
@@ -2891,6 +2970,8 @@ class Dex2Oat FINAL {
   std::string input_vdex_;
   std::string output_vdex_;
   std::unique_ptr<VdexFile> input_vdex_file_;
+  std::string input_oat_;
+  std::unique_ptr<OatFile> input_oat_file_;
   int dm_fd_;
   std::string dm_file_location_;
   std::unique_ptr<ZipArchive> dm_file_;
@@ -2182,4 +2182,165 @@ TEST_F(Dex2oatClassLoaderContextTest, StoredClassLoaderContext) {
   });
 }
 
+class Dex2oatInputOatTest : public Dex2oatTest {
+ protected:
+  // Compile with --dump-stats and return the number of methods reported as copied from the
+  // input oat file.
+  size_t CompileWithInputOat(const std::string& dex_location,
+                             const std::string& oat_location,
+                             const std::string& input_oat_location) {
+    output_ = "";
+    GenerateOdexForTest(dex_location,
+                        oat_location,
+                        CompilerFilter::Filter::kSpeed,
+                        { "--input-oat=" + input_oat_location,
+                          "--dump-stats",
+                          "--runtime-arg",
+                          "-Xuse-stderr-logger" });
+    std::regex reused_regex("Reused ([0-9]+) compiled methods from the input oat file");
+    std::smatch reused_match;
+    if (!std::regex_search(output_, reused_match, reused_regex)) {
+      ADD_FAILURE() << "No reused methods count in " << output_;
+      return 0u;
+    }
+    return std::stoul(reused_match[1].str());
+  }
+
+  std::unique_ptr<OatFile> OpenOatFile(const std::string& oat_location,
+                                       const std::string& dex_location) {
+    std::string error_msg;
+    std::unique_ptr<OatFile> oat_file(OatFile::Open(/* zip_fd */ -1,
+                                                    oat_location,
+                                                    oat_location,
+                                                    nullptr,
+                                                    nullptr,
+                                                    false,
+                                                    /*low_4gb*/false,
+                                                    dex_location.c_str(),
+                                                    &error_msg));
+    EXPECT_TRUE(oat_file != nullptr) << error_msg;
+    return oat_file;
+  }
+
+  // Return the number of methods of the dex file whose code the oat file marks as reusable.
+  static size_t CountReusableMethods(const DexFile& dex_file,
+                                     const OatFile::OatDexFile* oat_dex_file) {
+    size_t count = 0u;
+    for (uint32_t i = 0; i != dex_file.NumClassDefs(); ++i) {
+      const uint8_t* class_data = dex_file.GetClassData(dex_file.GetClassDef(i));
+      if (class_data == nullptr) {
+        continue;
+      }
+      ClassDataItemIterator it(dex_file, class_data);
+      it.SkipAllFields();
+      for (; it.HasNextMethod(); it.Next()) {
+        if (oat_dex_file->IsReusableMethod(it.GetMemberIndex())) {
+          ++count;
+        }
+      }
+    }
+    return count;
+  }
+
+  static void WriteJar(File* jar, const std::vector<std::vector<uint8_t>>& dex_files) {
+    FILE* file = fdopen(jar->Fd(), "w+b");
+    ZipWriter writer(file);
+    for (size_t i = 0; i != dex_files.size(); ++i) {
+      const std::string entry_name =
+          (i == 0u) ? "classes.dex" : "classes" + std::to_string(i + 1u) + ".dex";
+      ASSERT_EQ(writer.StartEntry(entry_name.c_str(), ZipWriter::kCompress), 0);
+      ASSERT_GE(writer.WriteBytes(dex_files[i].data(), dex_files[i].size()), 0);
+      ASSERT_EQ(writer.FinishEntry(), 0);
+    }
+    ASSERT_EQ(writer.Finish(), 0);
+    ASSERT_EQ(jar->Flush(), 0);
+  }
+};
+
+TEST_F(Dex2oatInputOatTest, ReuseUnchangedMethods) {
+  std::unique_ptr<const DexFile> dex(OpenTestDexFile("StaticLeafMethods"));
+  std::string out_dir = GetScratchDir();
+  const std::string input_oat_name = out_dir + "/input.odex";
+  const std::string output_oat_name = out_dir + "/output.odex";
+  GenerateOdexForTest(dex->GetLocation(), input_oat_name, CompilerFilter::Filter::kSpeed);
+  const size_t num_reused_methods =
+      CompileWithInputOat(dex->GetLocation(), output_oat_name, input_oat_name);
+
+  std::unique_ptr<OatFile> input_oat = OpenOatFile(input_oat_name, dex->GetLocation());
+  ASSERT_TRUE(input_oat != nullptr);
+  std::unique_ptr<OatFile> output_oat = OpenOatFile(output_oat_name, dex->GetLocation());
+  ASSERT_TRUE(output_oat != nullptr);
+  ASSERT_EQ(1u, input_oat->GetOatDexFiles().size());
+  ASSERT_EQ(1u, output_oat->GetOatDexFiles().size());
+  const OatFile::OatDexFile* input_oat_dex_file = input_oat->GetOatDexFiles()[0];
+  const OatFile::OatDexFile* output_oat_dex_file = output_oat->GetOatDexFiles()[0];
+
+  // The leaf methods have no linker patches. Their code must be copied, not compiled again.
+  const size_t num_reusable_methods = CountReusableMethods(*dex, input_oat_dex_file);
+  EXPECT_NE(0u, num_reusable_methods);
+  EXPECT_EQ(num_reusable_methods, num_reused_methods);
+  EXPECT_EQ(num_reusable_methods, CountReusableMethods(*dex, output_oat_dex_file));
+}
+
+TEST_F(Dex2oatInputOatTest, RecompileOnlyChangedDexFile) {
+  // The main dex file of MultiDex only defines Main, which uses Second from the second dex file.
+  std::vector<std::unique_ptr<const DexFile>> dex_files = OpenTestDexFiles("MultiDex");
+  ASSERT_EQ(2u, dex_files.size());
+  std::vector<std::vector<uint8_t>> contents;
+  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+    contents.emplace_back(dex_file->Begin(), dex_file->Begin() + dex_file->Size());
+  }
+  const std::string dex_location = GetScratchDir() + "/MultiDex.jar";
+  const std::string input_oat_name = GetScratchDir() + "/input.odex";
+  const std::string output_oat_name = GetScratchDir() + "/output.odex";
+  {
+    std::unique_ptr<File> jar(OS::CreateEmptyFile(dex_location.c_str()));
+    ASSERT_TRUE(jar != nullptr);
+    WriteJar(jar.get(), contents);
+    ASSERT_EQ(jar->FlushCloseOrErase(), 0);
+  }
+  GenerateOdexForTest(dex_location, input_oat_name, CompilerFilter::Filter::kSpeed);
+  std::unique_ptr<OatFile> input_oat = OpenOatFile(input_oat_name, dex_location);
+  ASSERT_TRUE(input_oat != nullptr);
+  ASSERT_EQ(2u, input_oat->GetOatDexFiles().size());
+  const size_t num_reusable_main_methods =
+      CountReusableMethods(*dex_files[0], input_oat->GetOatDexFiles()[0]);
+  const size_t num_reusable_second_methods =
+      CountReusableMethods(*dex_files[1], input_oat->GetOatDexFiles()[1]);
+  ASSERT_NE(0u, num_reusable_second_methods);
+
+  // Change the main dex file. Altering its signature is enough to change its checksum.
+  DexFile::Header* header = reinterpret_cast<DexFile::Header*>(contents[0].data());
+  header->signature_[0] ^= 0xffu;
+  header->checksum_ = DexFile::CalculateChecksum(contents[0].data(), contents[0].size());
+  {
+    std::unique_ptr<File> jar(OS::CreateEmptyFile(dex_location.c_str()));
+    ASSERT_TRUE(jar != nullptr);
+    WriteJar(jar.get(), contents);
+    ASSERT_EQ(jar->FlushCloseOrErase(), 0);
+  }
+  // Second does not refer to Main, so only the methods of Main are compiled again.
+  const size_t num_reused_methods =
+      CompileWithInputOat(dex_location, output_oat_name, input_oat_name);
+  EXPECT_EQ(num_reusable_second_methods, num_reused_methods)
+      << "Main has " << num_reusable_main_methods << " reusable methods";
+
+  // Changing the second dex file makes the main dex file stale too, nothing is reused.
+  std::vector<std::vector<uint8_t>> original_contents;
+  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+    original_contents.emplace_back(dex_file->Begin(), dex_file->Begin() + dex_file->Size());
+  }
+  header = reinterpret_cast<DexFile::Header*>(original_contents[1].data());
+  header->signature_[0] ^= 0xffu;
+  header->checksum_ =
+      DexFile::CalculateChecksum(original_contents[1].data(), original_contents[1].size());
+  {
+    std::unique_ptr<File> jar(OS::CreateEmptyFile(dex_location.c_str()));
+    ASSERT_TRUE(jar != nullptr);
+    WriteJar(jar.get(), original_contents);
+    ASSERT_EQ(jar->FlushCloseOrErase(), 0);
+  }
+  EXPECT_EQ(0u, CompileWithInputOat(dex_location, output_oat_name, input_oat_name));
+}
+
 }  // namespace art
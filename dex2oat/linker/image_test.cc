@@ -93,6 +93,46 @@ TEST_F(ImageTest, ImageHeaderIsValid) {
     ASSERT_FALSE(image_header.IsValid());
 }
 
+TEST_F(ImageTest, ImageBlockDecompressRejectsCorruptData) {
+  std::vector<uint8_t> in(64u, 0xffu);
+  std::vector<uint8_t> out(128u, 0u);
+  std::string error_msg;
+  // Garbage LZ4 data.
+  ImageHeader::Block lz4_block(ImageHeader::kStorageModeLZ4,
+                               /*data_offset*/ 0u,
+                               /*data_size*/ in.size(),
+                               /*image_offset*/ 0u,
+                               /*image_size*/ out.size());
+  EXPECT_FALSE(lz4_block.Decompress(out.data(), in.data(), &error_msg));
+  EXPECT_FALSE(error_msg.empty());
+  // Uncompressed block whose stored size does not match its image size.
+  error_msg.clear();
+  ImageHeader::Block uncompressed_block(ImageHeader::kStorageModeUncompressed,
+                                        /*data_offset*/ 0u,
+                                        /*data_size*/ in.size(),
+                                        /*image_offset*/ 0u,
+                                        /*image_size*/ out.size());
+  EXPECT_FALSE(uncompressed_block.Decompress(out.data(), in.data(), &error_msg));
+  EXPECT_FALSE(error_msg.empty());
+  // Unknown storage mode.
+  error_msg.clear();
+  ImageHeader::Block invalid_block(ImageHeader::kStorageModeCount,
+                                   /*data_offset*/ 0u,
+                                   /*data_size*/ in.size(),
+                                   /*image_offset*/ 0u,
+                                   /*image_size*/ in.size());
+  EXPECT_FALSE(invalid_block.Decompress(out.data(), in.data(), &error_msg));
+  EXPECT_FALSE(error_msg.empty());
+  // A valid uncompressed block is copied.
+  ImageHeader::Block valid_block(ImageHeader::kStorageModeUncompressed,
+                                 /*data_offset*/ 0u,
+                                 /*data_size*/ in.size(),
+                                 /*image_offset*/ out.size() - in.size(),
+                                 /*image_size*/ in.size());
+  EXPECT_TRUE(valid_block.Decompress(out.data(), in.data(), &error_msg));
+  EXPECT_EQ(0, memcmp(out.data() + out.size() - in.size(), in.data(), in.size()));
+}
+
 // Test that pointer to quick code is the same in
 // a default method of an interface and in a copied method
 // of a class which implements the interface. This should be true
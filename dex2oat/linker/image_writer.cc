@@ -20,6 +20,7 @@
 #include <lz4hc.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <unordered_set>
@@ -87,6 +88,9 @@ namespace linker {
 // Separate objects into multiple bins to optimize dirty memory use.
 static constexpr bool kBinObjects = true;
 
+// Size of the independently compressed blocks of compressed images.
+static constexpr size_t kImageBlockSize = 512 * KB;
+
 // Return true if an object is already in an image space.
 bool ImageWriter::IsInBootImage(const void* obj) const {
   gc::Heap* const heap = Runtime::Current()->GetHeap();
@@ -240,29 +244,44 @@ bool ImageWriter::Write(int image_fd,
     switch (image_storage_mode_) {
       case ImageHeader::kStorageModeLZ4HC:  // Fall-through.
       case ImageHeader::kStorageModeLZ4: {
-        const size_t compressed_max_size = LZ4_compressBound(image_data_size);
-        compressed_data.reset(new char[compressed_max_size]);
-        data_size = LZ4_compress_default(
-            reinterpret_cast<char*>(image_info.image_->Begin()) + sizeof(ImageHeader),
-            &compressed_data[0],
-            image_data_size,
-            compressed_max_size);
-
-        break;
-      }
-      /*
-       * Disabled due to image_test64 flakyness. Both use same decompression. b/27560444
-      case ImageHeader::kStorageModeLZ4HC: {
-        // Bound is same as non HC.
-        const size_t compressed_max_size = LZ4_compressBound(image_data_size);
-        compressed_data.reset(new char[compressed_max_size]);
-        data_size = LZ4_compressHC(
-            reinterpret_cast<char*>(image_info.image_->Begin()) + sizeof(ImageHeader),
-            &compressed_data[0],
-            image_data_size);
+        // Compress the image data in blocks that the runtime decompresses in parallel. The
+        // compressed data is laid out as in the file, after room for the header, and is followed
+        // by the block table. Zero-initialize it so that the padding is deterministic.
+        const size_t block_count = RoundUp(image_data_size, kImageBlockSize) / kImageBlockSize;
+        const size_t blocks_offset_max =
+            RoundUp(sizeof(ImageHeader) + block_count * LZ4_compressBound(kImageBlockSize),
+                    alignof(ImageHeader::Block));
+        compressed_data.reset(
+            new char[blocks_offset_max + block_count * sizeof(ImageHeader::Block)]());
+        std::vector<ImageHeader::Block> blocks;
+        blocks.reserve(block_count);
+        size_t data_offset = sizeof(ImageHeader);
+        for (size_t offset = 0; offset < image_data_size; offset += kImageBlockSize) {
+          const size_t block_size = std::min(image_data_size - offset, kImageBlockSize);
+          // LZ4HC compression is disabled due to image_test64 flakyness. Both use same
+          // decompression. b/27560444
+          const int compressed_size = LZ4_compress_default(image_data + offset,
+                                                           &compressed_data[data_offset],
+                                                           block_size,
+                                                           LZ4_compressBound(block_size));
+          CHECK_GT(compressed_size, 0) << "Failed to compress image block at " << offset;
+          blocks.emplace_back(image_storage_mode_,
+                              data_offset,
+                              compressed_size,
+                              sizeof(ImageHeader) + offset,
+                              block_size);
+          data_offset += compressed_size;
+        }
+        const size_t blocks_offset = RoundUp(data_offset, alignof(ImageHeader::Block));
+        std::copy(blocks.begin(),
+                  blocks.end(),
+                  reinterpret_cast<ImageHeader::Block*>(&compressed_data[blocks_offset]));
+        image_header->blocks_offset_ = blocks_offset;
+        image_header->blocks_count_ = blocks.size();
+        data_size =
+            blocks_offset + blocks.size() * sizeof(ImageHeader::Block) - sizeof(ImageHeader);
         break;
       }
-      */
       case ImageHeader::kStorageModeUncompressed: {
         data_size = image_data_size;
         image_data_to_write = image_data;
@@ -275,18 +294,19 @@ bool ImageWriter::Write(int image_fd,
     }
 
     if (compressed_data != nullptr) {
-      image_data_to_write = &compressed_data[0];
+      image_data_to_write = &compressed_data[sizeof(ImageHeader)];
       VLOG(compiler) << "Compressed from " << image_data_size << " to " << data_size << " in "
+                     << image_header->blocks_count_ << " blocks in "
                      << PrettyDuration(NanoTime() - compress_start_time);
       if (kIsDebugBuild) {
-        std::unique_ptr<uint8_t[]> temp(new uint8_t[image_data_size]);
-        const size_t decompressed_size = LZ4_decompress_safe(
-            reinterpret_cast<char*>(&compressed_data[0]),
-            reinterpret_cast<char*>(&temp[0]),
-            data_size,
-            image_data_size);
-        CHECK_EQ(decompressed_size, image_data_size);
-        CHECK_EQ(memcmp(image_data, &temp[0], image_data_size), 0) << image_storage_mode_;
+        std::unique_ptr<uint8_t[]> temp(new uint8_t[image_header->GetImageSize()]);
+        const uint8_t* file_data = reinterpret_cast<const uint8_t*>(&compressed_data[0]);
+        for (const ImageHeader::Block& block : image_header->GetBlocks(file_data)) {
+          std::string error_msg;
+          CHECK(block.Decompress(&temp[0], file_data, &error_msg)) << error_msg;
+        }
+        CHECK_EQ(memcmp(image_data, &temp[sizeof(ImageHeader)], image_data_size), 0)
+            << image_storage_mode_;
       }
     }
 
@@ -331,6 +331,9 @@ class OatWriter::OatDexFile {
   uint32_t type_bss_mapping_offset_;
   uint32_t string_bss_mapping_offset_;
 
+  // Offset of the reusable methods bitmap, set in InitReusableMethods.
+  uint32_t reusable_methods_offset_;
+
   // Offset of dex sections that will have different runtime madvise states.
   // Set in WriteDexLayoutSections.
   uint32_t dex_sections_layout_offset_;
@@ -425,6 +428,7 @@ OatWriter::OatWriter(bool compiling_boot_image,
     size_oat_dex_file_method_bss_mapping_offset_(0),
     size_oat_dex_file_type_bss_mapping_offset_(0),
     size_oat_dex_file_string_bss_mapping_offset_(0),
+    size_oat_dex_file_reusable_methods_offset_(0),
     size_oat_lookup_table_alignment_(0),
     size_oat_lookup_table_(0),
     size_oat_class_offsets_alignment_(0),
@@ -436,6 +440,7 @@ OatWriter::OatWriter(bool compiling_boot_image,
     size_method_bss_mappings_(0u),
     size_type_bss_mappings_(0u),
     size_string_bss_mappings_(0u),
+    size_reusable_methods_(0u),
     relative_patcher_(nullptr),
     absolute_patch_locations_(),
     profile_compilation_info_(info),
@@ -728,6 +733,10 @@ void OatWriter::PrepareLayout(MultiOatRelativePatcher* relative_patcher) {
     TimingLogger::ScopedTiming split("InitIndexBssMappings", timings_);
     offset = InitIndexBssMappings(offset);
   }
+  {
+    TimingLogger::ScopedTiming split("InitReusableMethods", timings_);
+    offset = InitReusableMethods(offset);
+  }
   {
     TimingLogger::ScopedTiming split("InitOatMaps", timings_);
     offset = InitOatMaps(offset);
@@ -875,6 +884,18 @@ class OatWriter::InitBssLayoutMethodVisitor : public DexMethodVisitor {
           writer_->map_boot_image_tables_to_bss_ = true;
         }
       }
+      if (compiled_method->GetPatches().empty() && !writer_->compiling_boot_image_) {
+        auto reusable_it = writer_->reusable_methods_.find(dex_file_);
+        if (reusable_it == writer_->reusable_methods_.end()) {
+          reusable_it = writer_->reusable_methods_.Put(
+              dex_file_,
+              BitVector(dex_file_->NumMethodIds(),
+                        /* expandable */ false,
+                        Allocator::GetMallocAllocator()));
+          reusable_it->second.ClearAllBits();
+        }
+        reusable_it->second.SetBit(it.GetMemberIndex());
+      }
     } else {
       DCHECK(compiled_method == nullptr || compiled_method->GetPatches().empty());
     }
@@ -2401,6 +2422,19 @@ size_t OatWriter::InitIndexBssMappings(size_t offset) {
   return offset;
 }
 
+size_t OatWriter::InitReusableMethods(size_t offset) {
+  // The index bss mappings and class offsets keep the offset aligned.
+  DCHECK_ALIGNED(offset, sizeof(uint32_t));
+  for (size_t i = 0, size = dex_files_->size(); i != size; ++i) {
+    const DexFile* dex_file = (*dex_files_)[i];
+    if (reusable_methods_.find(dex_file) != reusable_methods_.end()) {
+      oat_dex_files_[i].reusable_methods_offset_ = offset;
+      offset += BitVector::BitsToWords(dex_file->NumMethodIds()) * sizeof(uint32_t);
+    }
+  }
+  return offset;
+}
+
 size_t OatWriter::InitOatDexFiles(size_t offset) {
   // Initialize offsets of oat dex files.
   for (OatDexFile& oat_dex_file : oat_dex_files_) {
@@ -2603,6 +2637,12 @@ bool OatWriter::WriteRodata(OutputStream* out) {
     return false;
   }
 
+  relative_offset = WriteReusableMethods(out, file_offset, relative_offset);
+  if (relative_offset == 0) {
+    PLOG(ERROR) << "Failed to write reusable methods to " << out->GetLocation();
+    return false;
+  }
+
   relative_offset = WriteMaps(out, file_offset, relative_offset);
   if (relative_offset == 0) {
     PLOG(ERROR) << "Failed to write oat code to " << out->GetLocation();
@@ -2962,6 +3002,7 @@ bool OatWriter::WriteCode(OutputStream* out) {
     DO_STAT(size_oat_dex_file_method_bss_mapping_offset_);
     DO_STAT(size_oat_dex_file_type_bss_mapping_offset_);
     DO_STAT(size_oat_dex_file_string_bss_mapping_offset_);
+    DO_STAT(size_oat_dex_file_reusable_methods_offset_);
     DO_STAT(size_oat_lookup_table_alignment_);
     DO_STAT(size_oat_lookup_table_);
     DO_STAT(size_oat_class_offsets_alignment_);
@@ -2973,6 +3014,7 @@ bool OatWriter::WriteCode(OutputStream* out) {
     DO_STAT(size_method_bss_mappings_);
     DO_STAT(size_type_bss_mappings_);
     DO_STAT(size_string_bss_mappings_);
+    DO_STAT(size_reusable_methods_);
     #undef DO_STAT
 
     VLOG(compiler) << "size_total=" << PrettySize(size_total) << " (" << size_total << "B)";
@@ -3241,6 +3283,33 @@ size_t OatWriter::WriteIndexBssMappings(OutputStream* out,
   return relative_offset;
 }
 
+size_t OatWriter::WriteReusableMethods(OutputStream* out,
+                                       size_t file_offset,
+                                       size_t relative_offset) {
+  TimingLogger::ScopedTiming split("WriteReusableMethods", timings_);
+  DCHECK_ALIGNED(relative_offset, sizeof(uint32_t));
+  for (size_t i = 0, size = dex_files_->size(); i != size; ++i) {
+    const DexFile* dex_file = (*dex_files_)[i];
+    OatDexFile* oat_dex_file = &oat_dex_files_[i];
+    auto it = reusable_methods_.find(dex_file);
+    if (it != reusable_methods_.end()) {
+      DCHECK_EQ(relative_offset, oat_dex_file->reusable_methods_offset_);
+      DCHECK_OFFSET();
+      const size_t reusable_methods_size =
+          BitVector::BitsToWords(dex_file->NumMethodIds()) * sizeof(uint32_t);
+      DCHECK_LE(reusable_methods_size, it->second.GetSizeOf());
+      if (!out->WriteFully(it->second.GetRawStorage(), reusable_methods_size)) {
+        return 0u;
+      }
+      size_reusable_methods_ += reusable_methods_size;
+      relative_offset += reusable_methods_size;
+    } else {
+      DCHECK_EQ(0u, oat_dex_file->reusable_methods_offset_);
+    }
+  }
+  return relative_offset;
+}
+
 size_t OatWriter::WriteOatDexFiles(OutputStream* out, size_t file_offset, size_t relative_offset) {
   TimingLogger::ScopedTiming split("WriteOatDexFiles", timings_);
 
@@ -4197,6 +4266,7 @@ OatWriter::OatDexFile::OatDexFile(const char* dex_file_location,
       method_bss_mapping_offset_(0u),
       type_bss_mapping_offset_(0u),
       string_bss_mapping_offset_(0u),
+      reusable_methods_offset_(0u),
       dex_sections_layout_offset_(0u),
       class_offsets_() {
 }
@@ -4211,6 +4281,7 @@ size_t OatWriter::OatDexFile::SizeOf() const {
           + sizeof(method_bss_mapping_offset_)
           + sizeof(type_bss_mapping_offset_)
           + sizeof(string_bss_mapping_offset_)
+          + sizeof(reusable_methods_offset_)
           + sizeof(dex_sections_layout_offset_);
 }
 
@@ -4278,6 +4349,12 @@ bool OatWriter::OatDexFile::Write(OatWriter* oat_writer, OutputStream* out) cons
   }
   oat_writer->size_oat_dex_file_string_bss_mapping_offset_ += sizeof(string_bss_mapping_offset_);
 
+  if (!out->WriteFully(&reusable_methods_offset_, sizeof(reusable_methods_offset_))) {
+    PLOG(ERROR) << "Failed to write reusable methods offset to " << out->GetLocation();
+    return false;
+  }
+  oat_writer->size_oat_dex_file_reusable_methods_offset_ += sizeof(reusable_methods_offset_);
+
   return true;
 }
 
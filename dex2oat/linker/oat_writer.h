@@ -320,6 +320,7 @@ class OatWriter {
   size_t InitOatClasses(size_t offset);
   size_t InitOatMaps(size_t offset);
   size_t InitIndexBssMappings(size_t offset);
+  size_t InitReusableMethods(size_t offset);
   size_t InitOatDexFiles(size_t offset);
   size_t InitOatCode(size_t offset);
   size_t InitOatCodeDexFiles(size_t offset);
@@ -329,6 +330,7 @@ class OatWriter {
   size_t WriteClasses(OutputStream* out, size_t file_offset, size_t relative_offset);
   size_t WriteMaps(OutputStream* out, size_t file_offset, size_t relative_offset);
   size_t WriteIndexBssMappings(OutputStream* out, size_t file_offset, size_t relative_offset);
+  size_t WriteReusableMethods(OutputStream* out, size_t file_offset, size_t relative_offset);
   size_t WriteOatDexFiles(OutputStream* out, size_t file_offset, size_t relative_offset);
   size_t WriteCode(OutputStream* out, size_t file_offset, size_t relative_offset);
   size_t WriteCodeDexFiles(OutputStream* out, size_t file_offset, size_t relative_offset);
@@ -425,6 +427,10 @@ class OatWriter {
   // Map for recording references to GcRoot<mirror::String> entries in .bss.
   SafeMap<const DexFile*, BitVector> bss_string_entry_references_;
 
+  // Map for recording methods with compiled code that has no linker patches. Such code does not
+  // depend on the layout of the oat file and dex2oat --input-oat can copy it to a new oat file.
+  SafeMap<const DexFile*, BitVector> reusable_methods_;
+
   // Map for allocating ArtMethod entries in .bss. Indexed by MethodReference for the target
   // method in the dex file with the "method reference value comparator" for deduplication.
   // The value is the target offset for patching, starting at `bss_start_ + bss_methods_offset_`.
@@ -500,6 +506,7 @@ class OatWriter {
   uint32_t size_oat_dex_file_method_bss_mapping_offset_;
   uint32_t size_oat_dex_file_type_bss_mapping_offset_;
   uint32_t size_oat_dex_file_string_bss_mapping_offset_;
+  uint32_t size_oat_dex_file_reusable_methods_offset_;
   uint32_t size_oat_lookup_table_alignment_;
   uint32_t size_oat_lookup_table_;
   uint32_t size_oat_class_offsets_alignment_;
@@ -511,6 +518,7 @@ class OatWriter {
   uint32_t size_method_bss_mappings_;
   uint32_t size_type_bss_mappings_;
   uint32_t size_string_bss_mappings_;
+  uint32_t size_reusable_methods_;
 
   // The helper for processing relative patches is external so that we can patch across oat files.
   MultiOatRelativePatcher* relative_patcher_;
@@ -1115,6 +1115,11 @@ DISASSEMBLER_ENTRY(cmp,
         has_modrm = true;
         load = true;
         break;
+      case 0xC1:
+        opcode1 = "xadd";
+        has_modrm = true;
+        store = true;
+        break;
       case 0xC3:
         opcode1 = "movnti";
         store = true;
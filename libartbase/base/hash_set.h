@@ -523,6 +523,12 @@ class HashSet {
     return num_buckets_;
   }
 
+  // Return the bucket array, NumBuckets() elements long. Empty buckets satisfy
+  // EmptyFn::IsEmpty(), occupied ones are found by linear probing from hash % NumBuckets().
+  const T* Data() const {
+    return data_;
+  }
+
  private:
   T& ElementForIndex(size_t index) {
     DCHECK_LT(index, NumBuckets());
@@ -189,6 +189,18 @@ inline void FlushDataCache(char* begin, char* end) {
   __builtin___clear_cache(begin, end);
 }
 
+// Hint to the CPU that we are busy-waiting, to save power and give the CPU time to a sibling
+// hardware thread. Call once per iteration of a spin loop.
+inline void SpinLoopHint() {
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield" ::: "memory");
+#else
+  __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
 template <typename T>
 constexpr PointerSize ConvertToPointerSize(T any) {
   if (any == 4 || any == 8) {
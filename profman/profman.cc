@@ -174,6 +174,7 @@ static const std::string kInvalidMethod = "invalid_method";  // NOLINT [runtime/
 static const std::string kClassAllMethods = "*";  // NOLINT [runtime/string] [4]
 static constexpr char kProfileParsingInlineChacheSep = '+';
 static constexpr char kProfileParsingTypeSep = ',';
+static constexpr char kProfileParsingCountSep = ':';
 static constexpr char kProfileParsingFirstCharInSignature = '(';
 static constexpr char kMethodFlagStringHot = 'H';
 static constexpr char kMethodFlagStringStartup = 'S';
@@ -819,12 +820,13 @@ class ProfMan FINAL {
     return dex_file->GetIndexForMethodId(*method_id);
   }
 
-  // Given a method, return true if the method has a single INVOKE_VIRTUAL in its byte code.
+  // Given a method, return true if the method has a single INVOKE_VIRTUAL or INVOKE_INTERFACE
+  // in its byte code.
   // Upon success it returns true and stores the method index and the invoke dex pc
   // in the output parameters.
   // The format of the method spec is "inlinePolymorphic(LSuper;)I+LSubA;,LSubB;,LSubC;".
   //
-  // TODO(calin): support INVOKE_INTERFACE and the range variants.
+  // TODO(calin): support the range variants.
   bool HasSingleInvoke(const TypeReference& class_ref,
                        uint16_t method_index,
                        /*out*/uint32_t* dex_pc) {
@@ -836,9 +838,10 @@ class ProfMan FINAL {
 
     bool found_invoke = false;
     for (const DexInstructionPcPair& inst : CodeItemInstructionAccessor(*dex_file, code_item)) {
-      if (inst->Opcode() == Instruction::INVOKE_VIRTUAL) {
+      if (inst->Opcode() == Instruction::INVOKE_VIRTUAL ||
+          inst->Opcode() == Instruction::INVOKE_INTERFACE) {
         if (found_invoke) {
-          LOG(ERROR) << "Multiple invoke INVOKE_VIRTUAL found: "
+          LOG(ERROR) << "Multiple invoke INVOKE_VIRTUAL or INVOKE_INTERFACE found: "
                      << dex_file->PrettyMethod(method_index);
           return false;
         }
@@ -847,7 +850,8 @@ class ProfMan FINAL {
       }
     }
     if (!found_invoke) {
-      LOG(ERROR) << "Could not find any INVOKE_VIRTUAL: " << dex_file->PrettyMethod(method_index);
+      LOG(ERROR) << "Could not find any INVOKE_VIRTUAL or INVOKE_INTERFACE: "
+                 << dex_file->PrettyMethod(method_index);
     }
     return found_invoke;
   }
@@ -858,6 +862,7 @@ class ProfMan FINAL {
   // "LJustTheCass;".
   // "LTestInline;->inlinePolymorphic(LSuper;)I+LSubA;,LSubB;,LSubC;".
   // "LTestInline;->inlinePolymorphic(LSuper;)I+LSubA;,LSubB;,invalid_class".
+  // "LTestInline;->inlineMegamorphic(LSuper;)I+LSubA;:96,LSubB;:1,LSubC;:1,LSubD;:1,LSubE;:1".
   // "LTestInline;->inlineMissingTypes(LSuper;)I+missing_types".
   // "LTestInline;->inlineNoInlineCaches(LSuper;)I".
   // "LTestInline;->*".
@@ -983,14 +988,25 @@ class ProfMan FINAL {
       }
       std::vector<TypeReference> classes(inline_cache_elems.size(),
                                          TypeReference(/* dex_file */ nullptr, dex::TypeIndex()));
+      std::vector<uint32_t> counts(inline_cache_elems.size(), 0u);
       size_t class_it = 0;
-      for (const std::string& ic_class : inline_cache_elems) {
+      for (const std::string& ic_elem : inline_cache_elems) {
+        // A class may be followed by the number of times it has been seen as receiver.
+        std::string ic_class = ic_elem;
+        const size_t count_sep_index = ic_elem.find(kProfileParsingCountSep);
+        if (count_sep_index != std::string::npos) {
+          ic_class = ic_elem.substr(0, count_sep_index);
+          if (!ParseUint(ic_elem.substr(count_sep_index + 1).c_str(), &counts[class_it])) {
+            LOG(ERROR) << "Invalid inline cache count: " << ic_elem;
+            return false;
+          }
+        }
         if (!FindClass(dex_files, ic_class, &(classes[class_it++]))) {
           LOG(ERROR) << "Could not find class: " << ic_class;
           return false;
         }
       }
-      inline_caches.emplace_back(dex_pc, is_missing_types, classes);
+      inline_caches.emplace_back(dex_pc, is_missing_types, classes, counts);
     }
     MethodReference ref(class_ref.dex_file, method_index);
     if (is_hot) {
@@ -1028,6 +1044,8 @@ class ProfMan FINAL {
   //   # Methods with inline caches
   //   LTestInline;->inlinePolymorphic(LSuper;)I+LSubA;,LSubB;,LSubC;
   //   LTestInline;->noInlineCache(LSuper;)I
+  //   # Methods with inline caches and receiver counts
+  //   LTestInline;->inlineMonomorphic(LSuper;)I+LSubA;:12
   int CreateProfile() {
     // Validate parameters for this command.
     if (apk_files_.empty() && apks_fd_.empty()) {
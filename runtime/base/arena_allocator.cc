@@ -75,6 +75,7 @@ const char* const ArenaAllocatorStatsImpl<kCount>::kAllocNames[] = {
   "DCE          ",
   "LSA          ",
   "LSE          ",
+  "PartialEscape",
   "CFRE         ",
   "LICM         ",
   "LoopOpt      ",
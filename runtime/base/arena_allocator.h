@@ -81,6 +81,7 @@ enum ArenaAllocKind {
   kArenaAllocDCE,
   kArenaAllocLSA,
   kArenaAllocLSE,
+  kArenaAllocPartialEscape,
   kArenaAllocCFRE,
   kArenaAllocLICM,
   kArenaAllocLoopOptimization,
@@ -101,6 +101,10 @@ extern "C" int32_t art_quick_indexof(void*, uint32_t, uint32_t);
 extern "C" int32_t art_quick_string_compareto(void*, void*);
 extern "C" void* art_quick_memcpy(void*, const void*, size_t);
 
+// StringBuilder append entrypoint. The arguments are passed in the caller's outgoing
+// arguments area, as described by the format.
+extern "C" void* art_quick_string_builder_append(uint32_t format);
+
 // Invoke entrypoints.
 extern "C" void art_quick_imt_conflict_trampoline(art::ArtMethod*);
 extern "C" void art_quick_resolution_trampoline(art::ArtMethod*);
@@ -66,6 +66,10 @@ bool EntrypointRequiresStackMap(QuickEntrypointEnum trampoline) {
     case kQuickA64Store:
       return false;
 
+    /* Called from the frame entry of baseline code, does not suspend. */
+    case kQuickCompileOptimized:
+      return false;
+
     default:
       return true;
   }
@@ -117,6 +121,9 @@ bool EntrypointCanTriggerGC(QuickEntrypointEnum entrypoint) {
     case kQuickA64Store:
       return false;
 
+    case kQuickCompileOptimized:
+      return false;
+
     default:
       return true;
   }
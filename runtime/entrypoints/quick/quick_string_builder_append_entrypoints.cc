@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "art_method-inl.h"
+#include "callee_save_frame.h"
+#include "entrypoints/entrypoint_utils.h"
+#include "mirror/string.h"
+#include "obj_ptr-inl.h"
+#include "string_builder_append.h"
+
+namespace art {
+
+/*
+ * Append the arguments of a fused StringBuilder append chain, passed in the caller's
+ * outgoing arguments area, and return the resulting String.
+ */
+extern "C" mirror::String* artStringBuilderAppend(uint32_t format,
+                                                  const uint32_t* args,
+                                                  Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedQuickEntrypointChecks sqec(self);
+  return StringBuilderAppend::AppendF(format, args, self).Ptr();
+}
+
+}  // namespace art
@@ -33,6 +33,8 @@
 #include "index_bss_mapping.h"
 #include "instrumentation.h"
 #include "interpreter/interpreter.h"
+#include "interpreter/interpreter_common.h"
+#include "intrinsics_enum.h"
 #include "jit/jit.h"
 #include "linear_alloc.h"
 #include "method_handles.h"
@@ -42,6 +44,7 @@
 #include "mirror/method_handle_impl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
+#include "mirror/var_handle.h"
 #include "oat_file.h"
 #include "oat_quick_method_header.h"
 #include "quick_exception_handler.h"
@@ -2787,13 +2790,6 @@ extern "C" uintptr_t artInvokePolymorphic(
     return static_cast<uintptr_t>('V');
   }
 
-  // TODO(oth): Ensure this path isn't taken for VarHandle accessors (b/65872996).
-  DCHECK_EQ(resolved_method->GetDeclaringClass(),
-            WellKnownClasses::ToClass(WellKnownClasses::java_lang_invoke_MethodHandle));
-
-  Handle<mirror::MethodHandle> method_handle(hs.NewHandle(
-      ObjPtr<mirror::MethodHandle>::DownCast(MakeObjPtr(receiver_handle.Get()))));
-
   Handle<mirror::MethodType> method_type(
       hs.NewHandle(linker->ResolveMethodType(self, proto_idx, caller_method)));
 
@@ -2833,23 +2829,42 @@ extern "C" uintptr_t artInvokePolymorphic(
   // Call DoInvokePolymorphic with |is_range| = true, as shadow frame has argument registers in
   // consecutive order.
   RangeInstructionOperands operands(first_arg + 1, num_vregs - 1);
-  bool isExact = (jni::EncodeArtMethod(resolved_method) ==
-                  WellKnownClasses::java_lang_invoke_MethodHandle_invokeExact);
   bool success = false;
-  if (isExact) {
-    success = MethodHandleInvokeExact(self,
+  if (resolved_method->GetDeclaringClass() == mirror::VarHandle::StaticClass()) {
+    // A VarHandle accessor called from compiled code that could not use its inline fast path.
+    Handle<mirror::VarHandle> var_handle(hs.NewHandle(
+        ObjPtr<mirror::VarHandle>::DownCast(MakeObjPtr(receiver_handle.Get()))));
+    mirror::VarHandle::AccessMode access_mode = mirror::VarHandle::GetAccessModeByIntrinsic(
+        static_cast<Intrinsics>(resolved_method->GetIntrinsic()));
+    success = VarHandleInvokeAccessor(self,
                                       *shadow_frame,
-                                      method_handle,
+                                      var_handle,
                                       method_type,
+                                      access_mode,
                                       &operands,
                                       result);
   } else {
-    success = MethodHandleInvoke(self,
-                                 *shadow_frame,
-                                 method_handle,
-                                 method_type,
-                                 &operands,
-                                 result);
+    DCHECK_EQ(resolved_method->GetDeclaringClass(),
+              WellKnownClasses::ToClass(WellKnownClasses::java_lang_invoke_MethodHandle));
+    Handle<mirror::MethodHandle> method_handle(hs.NewHandle(
+        ObjPtr<mirror::MethodHandle>::DownCast(MakeObjPtr(receiver_handle.Get()))));
+    bool isExact = (jni::EncodeArtMethod(resolved_method) ==
+                    WellKnownClasses::java_lang_invoke_MethodHandle_invokeExact);
+    if (isExact) {
+      success = MethodHandleInvokeExact(self,
+                                        *shadow_frame,
+                                        method_handle,
+                                        method_type,
+                                        &operands,
+                                        result);
+    } else {
+      success = MethodHandleInvoke(self,
+                                   *shadow_frame,
+                                   method_handle,
+                                   method_type,
+                                   &operands,
+                                   result);
+    }
   }
   DCHECK(success || self->IsExceptionPending());
 
@@ -2859,4 +2874,13 @@ extern "C" uintptr_t artInvokePolymorphic(
   return static_cast<uintptr_t>(shorty[0]);
 }
 
+// Called by baseline JIT code whose hotness count reached the compile threshold.
+extern "C" void artCompileOptimized(ArtMethod* method, Thread* self)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  // The caller has not recorded a stack map for this call, and its reference
+  // arguments are still in registers: we must neither suspend nor walk the stack.
+  ScopedAssertNoThreadSuspension sants("Enqueuing optimized compilation");
+  Runtime::Current()->GetJit()->EnqueueOptimizedCompilation(method, self);
+}
+
 }  // namespace art
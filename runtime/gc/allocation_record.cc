@@ -16,10 +16,15 @@
 
 #include "allocation_record.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"  // For VLOG
 #include "base/stl_util.h"
+#include "base/time_utils.h"
+#include "base/utils.h"
+#include "handle_scope-inl.h"
 #include "obj_ptr-inl.h"
 #include "object_callbacks.h"
 #include "stack.h"
@@ -321,5 +326,244 @@ void AllocRecordObjectMap::Clear() {
 AllocRecordObjectMap::AllocRecordObjectMap()
     : new_record_condition_("New allocation record condition", *Locks::alloc_tracker_lock_) {}
 
+AllocRecordSampler::AllocRecordSampler(size_t mean_interval)
+    : mean_interval_(mean_interval),
+      random_(static_cast<std::minstd_rand::result_type>(NanoTime())),
+      interval_distribution_(1.0 / mean_interval) {
+  CHECK_NE(mean_interval, 0u);
+  sites_.emplace_back();
+  sites_[kNoManagedFramesSite].description = "<unknown>";
+  live_samples_.resize(kMaxLiveSamples);
+}
+
+size_t AllocRecordSampler::NextSampleInterval() {
+  // Never below one byte, so that a thread cannot take a sample for every buffer.
+  return std::max<size_t>(1u, static_cast<size_t>(interval_distribution_(random_)));
+}
+
+void AllocRecordSampler::CountAllocation(Thread* self,
+                                         ObjPtr<mirror::Object>* obj,
+                                         size_t bytes) {
+  size_t interval = self->GetAllocSampleInterval();
+  if (UNLIKELY(interval == 0u)) {
+    // The first buffer of the thread only draws its sampling point, so that new threads are not
+    // sampled more often than the others.
+    MutexLock mu(self, *Locks::alloc_tracker_lock_);
+    interval = NextSampleInterval();
+    self->SetAllocSampleInterval(interval);
+  }
+  const size_t sample_bytes = self->GetAllocSampleBytes() + bytes;
+  if (LIKELY(sample_bytes < interval)) {
+    self->SetAllocSampleBytes(sample_bytes);
+    return;
+  }
+  self->SetAllocSampleBytes(0u);
+
+  // Get stack trace outside of lock in case there are allocations during the stack walk.
+  // b/27858645.
+  AllocRecordStackTrace trace;
+  AllocRecordStackVisitor visitor(self, kMaxStackDepth, /*out*/ &trace);
+  {
+    StackHandleScope<1> hs(self);
+    auto obj_wrapper = hs.NewHandleWrapper(obj);
+    visitor.WalkStack();
+  }
+
+  MutexLock mu(self, *Locks::alloc_tracker_lock_);
+  self->SetAllocSampleInterval(NextSampleInterval());
+  uint32_t site = FindOrAddSite(std::move(trace));
+  sites_[site].total_bytes += sample_bytes;
+  ++sites_[site].total_samples;
+  // Do not create a weak root the GC may have already swept; the sample then only counts towards
+  // the total bytes of its site.
+  if ((!kUseReadBarrier && allow_new_samples_) ||
+      (kUseReadBarrier && self->GetWeakRefAccessEnabled())) {
+    AddLiveSample(obj->Ptr(), site, sample_bytes);
+  }
+}
+
+uint32_t AllocRecordSampler::FindOrAddSite(AllocRecordStackTrace&& trace) {
+  if (trace.GetDepth() == 0u) {
+    return kNoManagedFramesSite;
+  }
+  const size_t hash = HashAllocRecordTypes()(trace);
+  auto range = site_index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (sites_[it->second].trace == trace) {
+      return it->second;
+    }
+  }
+  if (free_sites_.empty() && sites_.size() == kMaxSites) {
+    return kNoManagedFramesSite;
+  }
+  const AllocRecordStackTraceElement& top = trace.GetStackElement(0);
+  std::string description = top.GetMethod()->PrettyMethod() + ":" +
+                            std::to_string(top.ComputeLineNumber());
+  uint32_t site;
+  if (!free_sites_.empty()) {
+    site = free_sites_.back();
+    free_sites_.pop_back();
+  } else {
+    site = static_cast<uint32_t>(sites_.size());
+    sites_.emplace_back();
+  }
+  sites_[site].trace = std::move(trace);
+  sites_[site].description = std::move(description);
+  site_index_.emplace(hash, site);
+  return site;
+}
+
+void AllocRecordSampler::AddLiveSample(mirror::Object* obj, uint32_t site, size_t bytes) {
+  Sample& sample = live_samples_[next_live_sample_];
+  next_live_sample_ = (next_live_sample_ + 1u) % live_samples_.size();
+  if (!sample.object.IsNull()) {
+    // Evict the oldest sample. Its object is no longer tracked and stops counting as live.
+    Site& old_site = sites_[sample.site];
+    old_site.live_bytes -= sample.bytes;
+    --old_site.live_samples;
+  }
+  sample.object = GcRoot<mirror::Object>(obj);
+  sample.site = site;
+  sample.bytes = bytes;
+  sites_[site].live_bytes += bytes;
+  ++sites_[site].live_samples;
+}
+
+size_t AllocRecordSampler::SweepSites(IsMarkedVisitor* visitor) {
+  size_t count_swept = 0u;
+  Site& unknown_site = sites_[kNoManagedFramesSite];
+  for (uint32_t i = kNoManagedFramesSite + 1u; i != sites_.size(); ++i) {
+    Site& site = sites_[i];
+    const size_t depth = site.trace.GetDepth();
+    if (depth == 0u) {
+      continue;  // Already swept.
+    }
+    // The sites are looked up by method pointer, and the methods of a class are freed when its
+    // class loader is unloaded.
+    bool marked = true;
+    for (size_t j = 0; j < depth && marked; ++j) {
+      ArtMethod* method = site.trace.GetStackElement(j).GetMethod();
+      DCHECK(method != nullptr);
+      // This does not need a read barrier because this is called by GC.
+      marked = visitor->IsMarked(method->GetDeclaringClassUnchecked<kWithoutReadBarrier>()) !=
+               nullptr;
+    }
+    if (marked) {
+      continue;
+    }
+    const size_t hash = HashAllocRecordTypes()(site.trace);
+    auto range = site_index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == i) {
+        site_index_.erase(it);
+        break;
+      }
+    }
+    unknown_site.total_bytes += site.total_bytes;
+    unknown_site.live_bytes += site.live_bytes;
+    unknown_site.total_samples += site.total_samples;
+    unknown_site.live_samples += site.live_samples;
+    site = Site();
+    free_sites_.push_back(i);
+    ++count_swept;
+  }
+  return count_swept;
+}
+
+void AllocRecordSampler::SweepSamples(IsMarkedVisitor* visitor) {
+  const size_t count_swept_sites = SweepSites(visitor);
+  size_t count_deleted = 0u;
+  uint64_t live_bytes = 0u;
+  for (Sample& sample : live_samples_) {
+    // This does not need a read barrier because this is called by GC.
+    mirror::Object* old_object = sample.object.Read<kWithoutReadBarrier>();
+    if (old_object == nullptr) {
+      continue;
+    }
+    if (sites_[sample.site].trace.GetDepth() == 0u) {
+      // The site was swept, and its live bytes now belong to kNoManagedFramesSite.
+      sample.site = kNoManagedFramesSite;
+    }
+    mirror::Object* new_object = visitor->IsMarked(old_object);
+    if (new_object == nullptr) {
+      Site& site = sites_[sample.site];
+      site.live_bytes -= sample.bytes;
+      --site.live_samples;
+      sample.object = GcRoot<mirror::Object>(nullptr);
+      ++count_deleted;
+    } else {
+      if (old_object != new_object) {
+        sample.object = GcRoot<mirror::Object>(new_object);
+      }
+      live_bytes += sample.bytes;
+    }
+  }
+  ++gc_count_;
+  VLOG(heap) << "Allocation sampler: " << (sites_.size() - free_sites_.size()) << " sites, swept "
+             << count_swept_sites << " sites, deleted " << count_deleted << " samples, " << PrettySize(live_bytes) << " sampled bytes live";
+}
+
+void AllocRecordSampler::DisallowNewSamples() {
+  CHECK(!kUseReadBarrier);
+  allow_new_samples_ = false;
+}
+
+void AllocRecordSampler::AllowNewSamples() {
+  CHECK(!kUseReadBarrier);
+  allow_new_samples_ = true;
+}
+
+AllocRecordSampler::Stats AllocRecordSampler::GetTotalStats() {
+  MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
+  Stats stats;
+  for (const Site& site : sites_) {
+    stats.total_bytes += site.total_bytes;
+    stats.live_bytes += site.live_bytes;
+  }
+  return stats;
+}
+
+AllocRecordSampler::Stats AllocRecordSampler::GetSiteStats(uint32_t site) {
+  MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
+  Stats stats;
+  if (site < sites_.size()) {
+    stats.total_bytes = sites_[site].total_bytes;
+    stats.live_bytes = sites_[site].live_bytes;
+  }
+  return stats;
+}
+
+void AllocRecordSampler::Dump(std::ostream& os) {
+  MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
+  uint64_t total_bytes = 0u;
+  uint64_t live_bytes = 0u;
+  std::vector<uint32_t> order;
+  order.reserve(sites_.size());
+  for (uint32_t i = 0; i != sites_.size(); ++i) {
+    if (i != kNoManagedFramesSite && sites_[i].trace.GetDepth() == 0u) {
+      continue;  // Swept.
+    }
+    total_bytes += sites_[i].total_bytes;
+    live_bytes += sites_[i].live_bytes;
+    order.push_back(i);
+  }
+  const size_t num_dumped = std::min(order.size(), kNumDumpedSites);
+  std::partial_sort(order.begin(),
+                    order.begin() + num_dumped,
+                    order.end(),
+                    [this](uint32_t lhs, uint32_t rhs) NO_THREAD_SAFETY_ANALYSIS {
+                      return sites_[lhs].live_bytes > sites_[rhs].live_bytes;
+                    });
+  os << "Sampled allocations (mean interval " << PrettySize(mean_interval_) << ", "
+     << (sites_.size() - free_sites_.size()) << " sites, after " << gc_count_ << " GCs): "
+     << PrettySize(live_bytes) << " live of " << PrettySize(total_bytes) << " allocated\n";
+  for (size_t i = 0; i != num_dumped; ++i) {
+    const Site& site = sites_[order[i]];
+    os << "  " << PrettySize(site.live_bytes) << " live of " << PrettySize(site.total_bytes)
+       << " (" << site.live_samples << "/" << site.total_samples << " samples) at "
+       << site.description << "\n";
+  }
+}
+
 }  // namespace gc
 }  // namespace art
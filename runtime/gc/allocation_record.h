@@ -17,8 +17,13 @@
 #ifndef ART_RUNTIME_GC_ALLOCATION_RECORD_H_
 #define ART_RUNTIME_GC_ALLOCATION_RECORD_H_
 
+#include <iosfwd>
 #include <list>
 #include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/mutex.h"
 #include "gc_root.h"
@@ -307,6 +312,106 @@ class AllocRecordObjectMap {
   void SetProperties() REQUIRES(Locks::alloc_tracker_lock_);
 };
 
+// Samples allocations to attribute heap usage to allocation sites, cheaply enough to stay enabled.
+// A thread is sampled when the thread-local buffers (TLABs, RosAlloc runs) and large objects it
+// obtained since its last sample exceed a random, exponentially distributed number of bytes, so
+// the sampling points form a Poisson process over the allocated bytes. The allocation that needed
+// the new buffer is the one recorded. Each sample stands for all the bytes counted since the
+// previous one. Samples with the same stack trace are merged into one site. The sampled objects
+// are kept as weak roots in a fixed-size ring buffer, so that each GC can compute the live bytes
+// of every site.
+class AllocRecordSampler {
+ public:
+  explicit AllocRecordSampler(size_t mean_interval);
+
+  // Counts `bytes` of thread-local buffer or large object that `self` obtained to allocate `*obj`,
+  // and samples the allocation if `self` passed its sampling point.
+  void CountAllocation(Thread* self, ObjPtr<mirror::Object>* obj, size_t bytes)
+      REQUIRES(!Locks::alloc_tracker_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Drops the samples of dead objects and updates the live bytes of the sites. The methods of the
+  // stack traces are weak as well: the sites with a method of an unloaded class are folded into
+  // kNoManagedFramesSite, so that sampling never keeps a class from unloading.
+  void SweepSamples(IsMarkedVisitor* visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::alloc_tracker_lock_);
+
+  // Unlike AllocRecordObjectMap, allocations never wait for the GC. While new weak roots are
+  // disallowed, samples only count towards the total bytes of their site.
+  void DisallowNewSamples() REQUIRES(Locks::alloc_tracker_lock_);
+  void AllowNewSamples() REQUIRES(Locks::alloc_tracker_lock_);
+
+  // Prints the sites with the most live bytes.
+  void Dump(std::ostream& os) REQUIRES(!Locks::alloc_tracker_lock_);
+
+  // The site of the samples without managed frames.
+  static constexpr uint32_t kNoManagedFramesSite = 0u;
+
+  struct Stats {
+    uint64_t total_bytes = 0u;
+    uint64_t live_bytes = 0u;
+  };
+
+  // Returns the sampled bytes of all sites, or of one site.
+  Stats GetTotalStats() REQUIRES(!Locks::alloc_tracker_lock_);
+  Stats GetSiteStats(uint32_t site) REQUIRES(!Locks::alloc_tracker_lock_);
+
+ private:
+  static constexpr size_t kMaxStackDepth = 16;
+  static constexpr size_t kMaxSites = 64 * 1024;
+  static constexpr size_t kMaxLiveSamples = 64 * 1024;
+  static constexpr size_t kNumDumpedSites = 20;
+
+  struct Site {
+    AllocRecordStackTrace trace;  // With a tid of 0.
+    std::string description;      // Innermost frame, printable without the mutator lock.
+    uint64_t total_bytes = 0u;
+    uint64_t live_bytes = 0u;
+    size_t total_samples = 0u;
+    size_t live_samples = 0u;
+  };
+
+  struct Sample {
+    GcRoot<mirror::Object> object;  // Weak root, null once the object died or was evicted.
+    uint32_t site;
+    size_t bytes;
+  };
+
+  // Returns the number of bytes after which a thread takes its next sample.
+  size_t NextSampleInterval() REQUIRES(Locks::alloc_tracker_lock_);
+
+  uint32_t FindOrAddSite(AllocRecordStackTrace&& trace)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::alloc_tracker_lock_);
+
+  void AddLiveSample(mirror::Object* obj, uint32_t site, size_t bytes)
+      REQUIRES(Locks::alloc_tracker_lock_);
+
+  // Folds the sites whose methods' classes are not marked into kNoManagedFramesSite and frees
+  // their slots. Returns the number of swept sites.
+  size_t SweepSites(IsMarkedVisitor* visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(Locks::alloc_tracker_lock_);
+
+  const size_t mean_interval_;
+  std::minstd_rand random_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  std::exponential_distribution<double> interval_distribution_
+      GUARDED_BY(Locks::alloc_tracker_lock_);
+  bool allow_new_samples_ GUARDED_BY(Locks::alloc_tracker_lock_) = true;
+  // Site kNoManagedFramesSite has an empty trace. It takes the samples without managed frames,
+  // all samples of new stack traces while there are kMaxSites sites, and the swept sites.
+  std::vector<Site> sites_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // Indices of the swept sites, which have an empty trace and are reused for new stack traces.
+  std::vector<uint32_t> free_sites_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // Indices into sites_, keyed by the hash of the stack trace.
+  std::unordered_multimap<size_t, uint32_t> site_index_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  // Ring buffer of the samples whose objects may still be live.
+  std::vector<Sample> live_samples_ GUARDED_BY(Locks::alloc_tracker_lock_);
+  size_t next_live_sample_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0u;
+  size_t gc_count_ GUARDED_BY(Locks::alloc_tracker_lock_) = 0u;
+};
+
 }  // namespace gc
 }  // namespace art
 #endif  // ART_RUNTIME_GC_ALLOCATION_RECORD_H_
@@ -41,8 +41,9 @@ inline mirror::Object* ConcurrentCopying::MarkUnevacFromSpaceRegion(
   // mark stack again and get changed back to white after it is processed.
   if (kUseBakerReadBarrier) {
     // Test the bitmap first to avoid graying an object that has already been marked through most
-    // of the time.
-    if (bitmap->Test(ref)) {
+    // of the time. In a sticky collection, old objects have their bit set from the last GC but may
+    // reference from-space objects until their cards are scanned, so gray them until then.
+    if (bitmap->Test(ref) && (!young_gen_ || done_scanning_.LoadAcquire())) {
       return ref;
     }
   }
@@ -76,7 +77,7 @@ inline mirror::Object* ConcurrentCopying::MarkImmuneSpace(mirror::Object* ref) {
     // true). Also, a mutator doesn't (need to) gray an immune object after GC has updated all
     // immune space objects (when updated_all_immune_objects_ is true).
     if (kIsDebugBuild) {
-      if (Thread::Current() == thread_running_gc_) {
+      if (IsGcMarkingThread(Thread::Current())) {
         DCHECK(!kGrayImmuneObject ||
                updated_all_immune_objects_.LoadRelaxed() ||
                gc_grays_immune_objects_);
@@ -108,7 +109,7 @@ inline mirror::Object* ConcurrentCopying::Mark(mirror::Object* from_ref,
   DCHECK(heap_->collector_type_ == kCollectorTypeCC);
   if (kFromGCThread) {
     DCHECK(is_active_);
-    DCHECK_EQ(Thread::Current(), thread_running_gc_);
+    DCHECK(IsGcMarkingThread(Thread::Current()));
   } else if (UNLIKELY(kUseBakerReadBarrier && !is_active_)) {
     // In the lock word forward address state, the read barrier bits
     // in the lock word are part of the stored forwarding address and
@@ -42,6 +42,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -61,8 +62,16 @@ static constexpr bool kDisallowReadBarrierDuringScan = kIsDebugBuild;
 static constexpr size_t kReadBarrierMarkStackSize = 512 * KB;
 // Verify that there are no missing card marks.
 static constexpr bool kVerifyNoMissingCardMarks = kIsDebugBuild;
+// Minimum number of refs on the mark stacks for marking with the heap thread pool.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
+// A parallel marking thread checks for idle threads after processing this many refs.
+static constexpr size_t kParallelMarkShareInterval = 64;
+// A parallel marking thread keeps its refs if it has fewer than twice this many.
+static constexpr size_t kMinimumParallelMarkShareSize = 16;
 
 ConcurrentCopying::ConcurrentCopying(Heap* heap,
+                                     bool young_gen,
+                                     bool use_generational_cc,
                                      const std::string& name_prefix,
                                      bool measure_read_barrier_slow_path)
     : GarbageCollector(heap,
@@ -78,6 +87,10 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       rb_mark_bit_stack_full_(false),
       mark_stack_lock_("concurrent copying mark stack lock", kMarkSweepMarkStackLock),
       thread_running_gc_(nullptr),
+      parallel_marking_(false),
+      num_parallel_mark_threads_(0),
+      num_idle_parallel_mark_threads_(0),
+      parallel_mark_count_(0),
       is_marking_(false),
       is_using_read_barrier_entrypoints_(false),
       is_active_(false),
@@ -101,11 +114,18 @@ ConcurrentCopying::ConcurrentCopying(Heap* heap,
       rb_slow_path_count_gc_total_(0),
       rb_table_(heap_->GetReadBarrierTable()),
       force_evacuate_all_(false),
+      young_gen_(young_gen),
+      use_generational_cc_(use_generational_cc),
+      done_scanning_(false),
       gc_grays_immune_objects_(false),
       immune_gray_stack_lock_("concurrent copying immune gray stack lock",
                               kMarkSweepMarkStackLock) {
   static_assert(space::RegionSpace::kRegionSize == accounting::ReadBarrierTable::kRegionSize,
                 "The region space size and the read barrier table region size must match");
+  CHECK(!young_gen_ || use_generational_cc_);
+  // Sticky collections use the Baker read barrier state as the mark bit of old objects until
+  // their cards are scanned.
+  CHECK(!use_generational_cc_ || kUseBakerReadBarrier);
   Thread* self = Thread::Current();
   {
     ReaderMutexLock mu(self, *Locks::heap_bitmap_lock_);
@@ -270,7 +290,21 @@ void ConcurrentCopying::BindBitmaps() {
       // It is OK to clear the bitmap with mutators running since the only place it is read is
       // VisitObjects which has exclusion with CC.
       region_space_bitmap_ = region_space_->GetMarkBitmap();
-      region_space_bitmap_->Clear();
+      // A sticky collection considers the objects which survived the last GC marked, and those
+      // are exactly the objects whose bits are set.
+      if (!young_gen_) {
+        region_space_bitmap_->Clear();
+      }
+    } else if (young_gen_ && space->IsContinuousMemMapAllocSpace()) {
+      // Consider the objects which survived the last GC marked (see StickyMarkSweep).
+      DCHECK_EQ(space->GetGcRetentionPolicy(), space::kGcRetentionPolicyAlwaysCollect);
+      space->AsContinuousMemMapAllocSpace()->GetMarkBitmap()->CopyFrom(space->GetLiveBitmap());
+    }
+  }
+  if (young_gen_) {
+    space::LargeObjectSpace* const los = heap_->GetLargeObjectsSpace();
+    if (los != nullptr) {
+      los->CopyLiveToMarked();
     }
   }
 }
@@ -300,13 +334,15 @@ void ConcurrentCopying::InitializePhase() {
   bytes_moved_.StoreRelaxed(0);
   objects_moved_.StoreRelaxed(0);
   GcCause gc_cause = GetCurrentIteration()->GetGcCause();
-  if (gc_cause == kGcCauseExplicit ||
-      gc_cause == kGcCauseCollectorTransition ||
-      GetCurrentIteration()->GetClearSoftReferences()) {
+  if (!young_gen_ &&
+      (gc_cause == kGcCauseExplicit ||
+       gc_cause == kGcCauseCollectorTransition ||
+       GetCurrentIteration()->GetClearSoftReferences())) {
     force_evacuate_all_ = true;
   } else {
     force_evacuate_all_ = false;
   }
+  done_scanning_.StoreRelaxed(!young_gen_);
   if (kUseBakerReadBarrier) {
     updated_all_immune_objects_.StoreRelaxed(false);
     // GC may gray immune objects in the thread flip.
@@ -421,7 +457,17 @@ class ConcurrentCopying::FlipCallback : public Closure {
     Locks::mutator_lock_->AssertExclusiveHeld(self);
     {
       TimingLogger::ScopedTiming split2("(Paused)SetFromSpace", cc->GetTimings());
-      cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_);
+      space::RegionSpace::EvacMode evac_mode =
+          space::RegionSpace::EvacMode::kEvacModeLivePercentNewlyAllocated;
+      if (cc->young_gen_) {
+        evac_mode = space::RegionSpace::EvacMode::kEvacModeNewlyAllocated;
+      } else if (cc->force_evacuate_all_) {
+        evac_mode = space::RegionSpace::EvacMode::kEvacModeForceAll;
+      }
+      cc->region_space_->SetFromSpace(cc->rb_table_, evac_mode);
+    }
+    if (cc->use_generational_cc_) {
+      cc->AgeCards();
     }
     cc->SwapStacks();
     if (ConcurrentCopying::kEnableFromSpaceAccountingCheck) {
@@ -431,7 +477,7 @@ class ConcurrentCopying::FlipCallback : public Closure {
     }
     cc->is_marking_ = true;
     cc->mark_stack_mode_.StoreRelaxed(ConcurrentCopying::kMarkStackModeThreadLocal);
-    if (kIsDebugBuild) {
+    if (kIsDebugBuild && !cc->young_gen_) {
       cc->region_space_->AssertAllRegionLiveBytesZeroOrCleared();
     }
     if (UNLIKELY(Runtime::Current()->IsActiveTransaction())) {
@@ -731,6 +777,63 @@ void ConcurrentCopying::GrayAllNewlyDirtyImmuneObjects() {
   updated_all_immune_objects_.StoreRelaxed(true);
 }
 
+void ConcurrentCopying::AgeCards() {
+  TimingLogger::ScopedTiming split("(Paused)AgeCards", GetTimings());
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  for (space::ContinuousSpace* space : heap_->GetContinuousSpaces()) {
+    // Immune space cards are handled by GrayAllDirtyImmuneObjects and the mod-union tables.
+    if (space->IsContinuousMemMapAllocSpace() && !immune_spaces_.ContainsSpace(space)) {
+      card_table->ModifyCardsAtomic(space->Begin(), space->End(), AgeCardVisitor(), VoidFunctor());
+    }
+  }
+}
+
+// Used to scan the old objects on aged or dirty cards in a sticky collection.
+class ConcurrentCopying::AgedCardScanVisitor {
+ public:
+  AgedCardScanVisitor(ConcurrentCopying* cc, space::ContinuousSpace* space)
+      : collector_(cc), space_(space) {}
+
+  void operator()(mirror::Object* obj) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    // Region space objects outside the unevacuated regions are either young or were copied by
+    // this collection, and are marked through the mark stack.
+    if (space_ == collector_->region_space_ &&
+        !collector_->region_space_->IsInUnevacFromSpace(obj)) {
+      return;
+    }
+    collector_->Scan(obj);
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  space::ContinuousSpace* const space_;
+};
+
+void ConcurrentCopying::ScanCardsForSpaces() {
+  TimingLogger::ScopedTiming split("ScanCardsForSpaces", GetTimings());
+  DCHECK(young_gen_);
+  accounting::CardTable* const card_table = heap_->GetCardTable();
+  {
+    WriterMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+    for (space::ContinuousSpace* space : heap_->GetContinuousSpaces()) {
+      if (!space->IsContinuousMemMapAllocSpace() || immune_spaces_.ContainsSpace(space)) {
+        continue;
+      }
+      // The live bitmap holds the objects which survived the last GC. Only those can reference
+      // young objects without being reachable through them. Cards aged in the pause were dirtied
+      // since the last GC; cards dirtied after the pause only refer to to-space objects.
+      AgedCardScanVisitor visitor(this, space);
+      card_table->Scan</* kClearCard */ false>(space->GetLiveBitmap(),
+                                               space->Begin(),
+                                               space->End(),
+                                               visitor,
+                                               accounting::CardTable::kCardAged);
+    }
+  }
+  // Old objects no longer hold from-space references; the mark bits can be trusted again.
+  done_scanning_.StoreRelease(true);
+}
+
 void ConcurrentCopying::SwapStacks() {
   heap_->SwapStacks();
 }
@@ -837,6 +940,10 @@ void ConcurrentCopying::MarkingPhase() {
     immune_gray_stack_.clear();
   }
 
+  if (young_gen_) {
+    ScanCardsForSpaces();
+  }
+
   {
     TimingLogger::ScopedTiming split2("VisitConcurrentRoots", GetTimings());
     Runtime::Current()->VisitConcurrentRoots(this, kVisitRootFlagAllRoots);
@@ -1088,17 +1195,7 @@ void ConcurrentCopying::PushOntoMarkStack(mirror::Object* to_ref) {
       if (UNLIKELY(tl_mark_stack == nullptr || tl_mark_stack->IsFull())) {
         MutexLock mu(self, mark_stack_lock_);
         // Get a new thread local mark stack.
-        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack;
-        if (!pooled_mark_stacks_.empty()) {
-          // Use a pooled mark stack.
-          new_tl_mark_stack = pooled_mark_stacks_.back();
-          pooled_mark_stacks_.pop_back();
-        } else {
-          // None pooled. Create a new one.
-          new_tl_mark_stack =
-              accounting::AtomicStack<mirror::Object>::Create(
-                  "thread local mark stack", 4 * KB, 4 * KB);
-        }
+        accounting::AtomicStack<mirror::Object>* new_tl_mark_stack = GetPooledMarkStack();
         DCHECK(new_tl_mark_stack != nullptr);
         DCHECK(new_tl_mark_stack->IsEmpty());
         new_tl_mark_stack->PushBack(to_ref);
@@ -1415,8 +1512,16 @@ bool ConcurrentCopying::ProcessMarkStackOnce() {
   MarkStackMode mark_stack_mode = mark_stack_mode_.LoadRelaxed();
   if (mark_stack_mode == kMarkStackModeThreadLocal) {
     // Process the thread-local mark stacks and the GC mark stack.
-    count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access */ false,
-                                          /* checkpoint_callback */ nullptr);
+    // Marking runs concurrently with the mutators.
+    const size_t thread_count = heap_->GetGcThreadCount(/* paused */ false);
+    if (thread_count > 1) {
+      RevokeThreadLocalMarkStacks(/* disable_weak_ref_access */ false,
+                                  /* checkpoint_callback */ nullptr);
+      count += ProcessMarkStacksParallel(thread_count);
+    } else {
+      count += ProcessThreadLocalMarkStacks(/* disable_weak_ref_access */ false,
+                                            /* checkpoint_callback */ nullptr);
+    }
     while (!gc_mark_stack_->IsEmpty()) {
       mirror::Object* to_ref = gc_mark_stack_->PopBack();
       ProcessMarkStackRef(to_ref);
@@ -1476,6 +1581,10 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
                                                        Closure* checkpoint_callback) {
   // Run a checkpoint to collect all thread local mark stacks and iterate over them all.
   RevokeThreadLocalMarkStacks(disable_weak_ref_access, checkpoint_callback);
+  return ProcessRevokedMarkStacks();
+}
+
+size_t ConcurrentCopying::ProcessRevokedMarkStacks() {
   size_t count = 0;
   std::vector<accounting::AtomicStack<mirror::Object>*> mark_stacks;
   {
@@ -1492,19 +1601,207 @@ size_t ConcurrentCopying::ProcessThreadLocalMarkStacks(bool disable_weak_ref_acc
     }
     {
       MutexLock mu(Thread::Current(), mark_stack_lock_);
-      if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
-        // The pool has enough. Delete it.
-        delete mark_stack;
-      } else {
-        // Otherwise, put it into the pool for later reuse.
-        mark_stack->Reset();
-        pooled_mark_stacks_.push_back(mark_stack);
+      RecyclePooledMarkStack(mark_stack);
+    }
+  }
+  return count;
+}
+
+accounting::ObjectStack* ConcurrentCopying::GetPooledMarkStack() {
+  if (!pooled_mark_stacks_.empty()) {
+    // Use a pooled mark stack.
+    accounting::ObjectStack* mark_stack = pooled_mark_stacks_.back();
+    pooled_mark_stacks_.pop_back();
+    return mark_stack;
+  }
+  // None pooled. Create a new one.
+  return accounting::ObjectStack::Create("thread local mark stack", 4 * KB, 4 * KB);
+}
+
+void ConcurrentCopying::RecyclePooledMarkStack(accounting::ObjectStack* mark_stack) {
+  if (pooled_mark_stacks_.size() >= kMarkStackPoolSize) {
+    // The pool has enough. Delete it.
+    delete mark_stack;
+  } else {
+    // Otherwise, put it into the pool for later reuse.
+    mark_stack->Reset();
+    pooled_mark_stacks_.push_back(mark_stack);
+  }
+}
+
+class ConcurrentCopying::ParallelMarkTask : public Task {
+ public:
+  explicit ParallelMarkTask(ConcurrentCopying* collector) : collector_(collector) {}
+
+  virtual void Run(Thread* self) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    size_t count = collector_->ParallelMarkWork(self);
+    collector_->parallel_mark_count_.FetchAndAddRelaxed(count);
+  }
+
+  virtual void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+size_t ConcurrentCopying::ProcessMarkStacksParallel(size_t thread_count) {
+  Thread* self = Thread::Current();
+  DCHECK_EQ(self, thread_running_gc_);
+  DCHECK_GT(thread_count, 1u);
+  size_t num_refs = gc_mark_stack_->Size();
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    for (accounting::ObjectStack* mark_stack : revoked_mark_stacks_) {
+      num_refs += mark_stack->Size();
+    }
+  }
+  if (num_refs < kMinimumParallelMarkStackSize) {
+    return ProcessRevokedMarkStacks();
+  }
+  TimingLogger::ScopedTiming split("ProcessMarkStacksParallel", GetTimings());
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    // Hand the GC mark stack over in chunks so that all the marking threads, including this one,
+    // start from the shared stacks.
+    const size_t chunk_size = gc_mark_stack_->Size() / thread_count + 1;
+    while (!gc_mark_stack_->IsEmpty()) {
+      accounting::ObjectStack* mark_stack = GetPooledMarkStack();
+      DCHECK(mark_stack->IsEmpty());
+      for (size_t i = 0; i < chunk_size && !mark_stack->IsFull() && !gc_mark_stack_->IsEmpty();
+           ++i) {
+        mark_stack->PushBack(gc_mark_stack_->PopBack());
       }
+      revoked_mark_stacks_.push_back(mark_stack);
+    }
+    num_parallel_mark_threads_ = 0;
+    num_idle_parallel_mark_threads_.StoreRelaxed(0);
+  }
+  parallel_mark_count_.StoreRelaxed(0);
+  parallel_marking_ = true;
+  ThreadPool* thread_pool = heap_->GetThreadPool();
+  for (size_t i = 0; i < thread_count; ++i) {
+    thread_pool->AddTask(self, new ParallelMarkTask(this));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /* do_work */ true, /* may_hold_locks */ true);
+  thread_pool->StopWorkers(self);
+  parallel_marking_ = false;
+  return parallel_mark_count_.LoadRelaxed();
+}
+
+size_t ConcurrentCopying::ParallelMarkWork(Thread* self) {
+  {
+    MutexLock mu(self, mark_stack_lock_);
+    ++num_parallel_mark_threads_;
+  }
+  size_t count = 0;
+  while (true) {
+    // Refs pushed while processing go to the mark stack of this thread (see PushOntoMarkStack());
+    // drain it before looking for more work.
+    count += DrainLocalMarkStack(self);
+    accounting::ObjectStack* mark_stack = StealMarkStack(self);
+    if (mark_stack == nullptr) {
+      break;
+    }
+    while (!mark_stack->IsEmpty()) {
+      ProcessMarkStackRef(mark_stack->PopBack());
+      ++count;
+    }
+    MutexLock mu(self, mark_stack_lock_);
+    RecyclePooledMarkStack(mark_stack);
+  }
+  if (self != thread_running_gc_) {
+    // Give the emptied thread-local mark stack of the pool worker back.
+    accounting::ObjectStack* tl_mark_stack = self->GetThreadLocalMarkStack();
+    if (tl_mark_stack != nullptr) {
+      DCHECK(tl_mark_stack->IsEmpty());
+      self->SetThreadLocalMarkStack(nullptr);
+      MutexLock mu(self, mark_stack_lock_);
+      RecyclePooledMarkStack(tl_mark_stack);
+    }
+  }
+  return count;
+}
+
+size_t ConcurrentCopying::DrainLocalMarkStack(Thread* self) {
+  size_t count = 0;
+  while (true) {
+    // A pool worker's thread-local mark stack may be replaced when it overflows.
+    accounting::ObjectStack* local_mark_stack =
+        self == thread_running_gc_ ? gc_mark_stack_.get() : self->GetThreadLocalMarkStack();
+    if (local_mark_stack == nullptr || local_mark_stack->IsEmpty()) {
+      break;
+    }
+    ProcessMarkStackRef(local_mark_stack->PopBack());
+    ++count;
+    if (count % kParallelMarkShareInterval == 0 &&
+        num_idle_parallel_mark_threads_.LoadRelaxed() != 0) {
+      ShareMarkStackRefs(self, local_mark_stack);
     }
   }
   return count;
 }
 
+void ConcurrentCopying::ShareMarkStackRefs(Thread* self,
+                                           accounting::ObjectStack* local_mark_stack) {
+  size_t num_refs = local_mark_stack->Size() / 2;
+  if (num_refs < kMinimumParallelMarkShareSize) {
+    return;
+  }
+  MutexLock mu(self, mark_stack_lock_);
+  accounting::ObjectStack* mark_stack = GetPooledMarkStack();
+  DCHECK(mark_stack->IsEmpty());
+  for (; num_refs != 0 && !mark_stack->IsFull(); --num_refs) {
+    mark_stack->PushBack(local_mark_stack->PopBack());
+  }
+  revoked_mark_stacks_.push_back(mark_stack);
+}
+
+accounting::ObjectStack* ConcurrentCopying::StealMarkStack(Thread* self) {
+  bool idle = false;
+  while (true) {
+    {
+      MutexLock mu(self, mark_stack_lock_);
+      if (!revoked_mark_stacks_.empty()) {
+        accounting::ObjectStack* mark_stack = revoked_mark_stacks_.back();
+        revoked_mark_stacks_.pop_back();
+        if (idle) {
+          num_idle_parallel_mark_threads_.FetchAndSubSequentiallyConsistent(1);
+        }
+        return mark_stack;
+      }
+      if (!idle) {
+        idle = true;
+        num_idle_parallel_mark_threads_.FetchAndAddSequentiallyConsistent(1);
+      }
+      // Only busy threads can publish more refs. Stacks that mutators revoke after everyone
+      // left are processed by the GC-running thread in the next ProcessMarkStackOnce().
+      if (num_idle_parallel_mark_threads_.LoadRelaxed() == num_parallel_mark_threads_) {
+        return nullptr;
+      }
+    }
+    sched_yield();
+  }
+}
+
+bool ConcurrentCopying::IsGcMarkingThread(Thread* self) const {
+  if (self == thread_running_gc_) {
+    return true;
+  }
+  if (!parallel_marking_) {
+    return false;
+  }
+  for (ThreadPoolWorker* worker : heap_->GetThreadPool()->GetWorkers()) {
+    if (worker->GetThread() == self) {
+      return true;
+    }
+  }
+  return false;
+}
+
 inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   DCHECK(!region_space_->IsInFromSpace(to_ref));
   if (kUseBakerReadBarrier) {
@@ -1514,8 +1811,15 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
   }
   bool add_to_live_bytes = false;
   if (region_space_->IsInUnevacFromSpace(to_ref)) {
-    // Mark the bitmap only in the GC thread here so that we don't need a CAS.
-    if (!kUseBakerReadBarrier || !region_space_bitmap_->Set(to_ref)) {
+    // Mark the bitmap only in the GC thread here so that we don't need a CAS, unless the mark
+    // stacks are drained by several threads.
+    bool already_marked = false;
+    if (kUseBakerReadBarrier) {
+      already_marked = UNLIKELY(parallel_marking_)
+          ? region_space_bitmap_->AtomicTestAndSet(to_ref)
+          : region_space_bitmap_->Set(to_ref);
+    }
+    if (!already_marked) {
       // It may be already marked if we accidentally pushed the same object twice due to the racy
       // bitmap read in MarkUnevacFromSpaceRegion.
       Scan(to_ref);
@@ -1556,12 +1860,16 @@ inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
 #endif
 
   if (add_to_live_bytes) {
-    // Add to the live bytes per unevacuated from-space. Note this code is always run by the
-    // GC-running thread (no synchronization required).
+    // Add to the live bytes per unevacuated from-space. Note this code is run by the GC-running
+    // thread (no synchronization required) unless marking in parallel.
     DCHECK(region_space_bitmap_->Test(to_ref));
     size_t obj_size = to_ref->SizeOf<kDefaultVerifyFlags>();
     size_t alloc_size = RoundUp(obj_size, space::RegionSpace::kAlignment);
-    region_space_->AddLiveBytes(to_ref, alloc_size);
+    if (UNLIKELY(parallel_marking_)) {
+      region_space_->AtomicAddLiveBytes(to_ref, alloc_size);
+    } else {
+      region_space_->AddLiveBytes(to_ref, alloc_size);
+    }
   }
   if (ReadBarrier::kEnableToSpaceInvariantChecks) {
     CHECK(to_ref != nullptr);
@@ -1768,7 +2076,9 @@ void ConcurrentCopying::ReclaimPhase() {
     uint64_t cleared_objects;
     {
       TimingLogger::ScopedTiming split4("ClearFromSpace", GetTimings());
-      region_space_->ClearFromSpace(&cleared_bytes, &cleared_objects);
+      region_space_->ClearFromSpace(&cleared_bytes,
+                                    &cleared_objects,
+                                    /*clear_bitmap*/ !use_generational_cc_);
       // `cleared_bytes` and `cleared_objects` may be greater than the from space equivalents since
       // RegionSpace::ClearFromSpace may clear empty unevac regions.
       CHECK_GE(cleared_bytes, from_bytes);
@@ -2114,7 +2424,7 @@ inline void ConcurrentCopying::Scan(mirror::Object* to_ref) {
     Thread::Current()->ModifyDebugDisallowReadBarrier(1);
   }
   DCHECK(!region_space_->IsInFromSpace(to_ref));
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK(IsGcMarkingThread(Thread::Current()));
   RefFieldsVisitor visitor(this);
   // Disable the read barrier for a performance reason.
   to_ref->VisitReferences</*kVisitNativeRoots*/true, kDefaultVerifyFlags, kWithoutReadBarrier>(
@@ -2125,7 +2435,7 @@ inline void ConcurrentCopying::Scan(mirror::Object* to_ref) {
 }
 
 inline void ConcurrentCopying::Process(mirror::Object* obj, MemberOffset offset) {
-  DCHECK_EQ(Thread::Current(), thread_running_gc_);
+  DCHECK(IsGcMarkingThread(Thread::Current()));
   mirror::Object* ref = obj->GetFieldObject<
       mirror::Object, kVerifyNone, kWithoutReadBarrier, false>(offset);
   mirror::Object* to_ref = Mark</*kGrayImmuneObject*/false, /*kFromGCThread*/true>(
@@ -2482,6 +2792,11 @@ mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref,
       bytes_moved_.FetchAndAddRelaxed(region_space_alloc_size);
       if (LIKELY(!fall_back_to_non_moving)) {
         DCHECK(region_space_->IsInToSpace(to_ref));
+        if (use_generational_cc_) {
+          // Sticky collections consider region space objects with their mark bit set old. Use an
+          // atomic update since mutators copy objects concurrently.
+          region_space_bitmap_->AtomicTestAndSet(to_ref);
+        }
       } else {
         DCHECK(heap_->non_moving_space_->HasAddress(to_ref));
         DCHECK_EQ(bytes_allocated, non_moving_space_bytes_allocated);
@@ -2582,6 +2897,16 @@ mirror::Object* ConcurrentCopying::MarkNonMoving(mirror::Object* ref,
   accounting::LargeObjectBitmap* los_bitmap =
       heap_mark_bitmap_->GetLargeObjectBitmap(ref);
   bool is_los = mark_bitmap == nullptr;
+  if (young_gen_ && !is_los && !done_scanning_.LoadAcquire() && mark_bitmap->Test(ref)) {
+    // An old object whose cards may not be scanned yet, so it may still reference from-space
+    // objects. Gray it so that mutators go through the read barrier until it is processed.
+    // Large objects need no graying since they do not hold references (see
+    // Heap::ShouldAllocLargeObject).
+    if (ref->AtomicSetReadBarrierState(ReadBarrier::WhiteState(), ReadBarrier::GrayState())) {
+      PushOntoMarkStack(ref);
+    }
+    return ref;
+  }
   if (!is_los && mark_bitmap->Test(ref)) {
     // Already marked.
     if (kUseBakerReadBarrier) {
@@ -2660,8 +2985,8 @@ void ConcurrentCopying::FinishPhase() {
     CHECK_EQ(pooled_mark_stacks_.size(), kMarkStackPoolSize);
   }
   // kVerifyNoMissingCardMarks relies on the region space cards not being cleared to avoid false
-  // positives.
-  if (!kVerifyNoMissingCardMarks) {
+  // positives. Generational collections need them to find old-to-young references.
+  if (!kVerifyNoMissingCardMarks && !use_generational_cc_) {
     TimingLogger::ScopedTiming split("ClearRegionSpaceCards", GetTimings());
     // We do not currently use the region space cards at all, madvise them away to save ram.
     heap_->GetCardTable()->ClearCardRange(region_space_->Begin(), region_space_->Limit());
@@ -65,9 +65,16 @@ class ConcurrentCopying : public GarbageCollector {
   // pages.
   static constexpr bool kGrayDirtyImmuneObjects = true;
 
-  explicit ConcurrentCopying(Heap* heap,
-                             const std::string& name_prefix = "",
-                             bool measure_read_barrier_slow_path = false);
+  // If `young_gen` is true, this collector is a sticky collector which only evacuates the regions
+  // allocated since the last GC and finds old-to-young references through the card table.
+  // `use_generational_cc` must be true for both collectors when the heap runs sticky
+  // collections, since the full collector then has to maintain the region space mark bitmap
+  // for the young one.
+  ConcurrentCopying(Heap* heap,
+                    bool young_gen,
+                    bool use_generational_cc,
+                    const std::string& name_prefix = "",
+                    bool measure_read_barrier_slow_path = false);
   ~ConcurrentCopying();
 
   virtual void RunPhases() OVERRIDE
@@ -87,7 +94,7 @@ class ConcurrentCopying : public GarbageCollector {
   void BindBitmaps() REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::heap_bitmap_lock_);
   virtual GcType GetGcType() const OVERRIDE {
-    return kGcTypePartial;
+    return young_gen_ ? kGcTypeSticky : kGcTypePartial;
   }
   virtual CollectorType GetCollectorType() const OVERRIDE {
     return kCollectorTypeCC;
@@ -189,8 +196,43 @@ class ConcurrentCopying : public GarbageCollector {
   void VerifyNoMissingCardMarks()
       REQUIRES(Locks::mutator_lock_)
       REQUIRES(!mark_stack_lock_);
+  // Age the cards of the region space and the non-moving spaces so that the next sticky
+  // collection scans the cards dirtied since this pause.
+  void AgeCards() REQUIRES(Locks::mutator_lock_);
+  // Scan the objects on aged or dirty cards of the unevacuated region space and the non-moving
+  // spaces for references to young objects. Only used by sticky collections.
+  void ScanCardsForSpaces()
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_, !skipped_blocks_lock_, !immune_gray_stack_lock_);
   size_t ProcessThreadLocalMarkStacks(bool disable_weak_ref_access, Closure* checkpoint_callback)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!mark_stack_lock_);
+  // Process the mark stacks revoked from the mutators and return the number of processed refs.
+  size_t ProcessRevokedMarkStacks() REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Drain the revoked mark stacks and the GC mark stack with `thread_count` threads of the heap
+  // thread pool. Threads steal from each other through `revoked_mark_stacks_`. Falls back to
+  // ProcessRevokedMarkStacks() if there is too little work to be worth it.
+  size_t ProcessMarkStacksParallel(size_t thread_count) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Body of a parallel marking task. Returns the number of processed refs.
+  size_t ParallelMarkWork(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  // Process the refs on the mark stack `self` pushes onto, handing half of them over to idle
+  // parallel marking threads from time to time.
+  size_t DrainLocalMarkStack(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!mark_stack_lock_);
+  void ShareMarkStackRefs(Thread* self, accounting::ObjectStack* local_mark_stack)
+      REQUIRES(!mark_stack_lock_);
+  // Take a mark stack published by another thread, waiting while some marking thread is still
+  // busy. Returns null once all parallel marking threads ran out of work.
+  accounting::ObjectStack* StealMarkStack(Thread* self) REQUIRES(!mark_stack_lock_);
+  // Return a mark stack from the pool, or a new one if the pool is empty.
+  accounting::ObjectStack* GetPooledMarkStack() REQUIRES(mark_stack_lock_);
+  // Return an empty mark stack to the pool, or delete it if the pool is full.
+  void RecyclePooledMarkStack(accounting::ObjectStack* mark_stack) REQUIRES(mark_stack_lock_);
+  // Whether `self` is the GC-running thread or one of the parallel marking threads. Only used
+  // in debug checks.
+  bool IsGcMarkingThread(Thread* self) const;
   void RevokeThreadLocalMarkStacks(bool disable_weak_ref_access, Closure* checkpoint_callback)
       REQUIRES_SHARED(Locks::mutator_lock_);
   void SwitchToSharedMarkStackMode() REQUIRES_SHARED(Locks::mutator_lock_)
@@ -304,6 +346,14 @@ class ConcurrentCopying : public GarbageCollector {
   std::vector<accounting::ObjectStack*> pooled_mark_stacks_
       GUARDED_BY(mark_stack_lock_);
   Thread* thread_running_gc_;
+  // True while the mark stacks are drained by the threads of the heap thread pool. The marking
+  // threads then update the region space bitmap and live bytes atomically.
+  bool parallel_marking_;
+  // Number of threads that joined the current parallel marking, and how many of them are out
+  // of work. Busy threads read the latter without the lock to decide when to share refs.
+  size_t num_parallel_mark_threads_ GUARDED_BY(mark_stack_lock_);
+  Atomic<size_t> num_idle_parallel_mark_threads_;
+  Atomic<size_t> parallel_mark_count_;
   bool is_marking_;                       // True while marking is ongoing.
   // True while we might dispatch on the read barrier entrypoints.
   bool is_using_read_barrier_entrypoints_;
@@ -359,6 +409,14 @@ class ConcurrentCopying : public GarbageCollector {
 
   accounting::ReadBarrierTable* rb_table_;
   bool force_evacuate_all_;  // True if all regions are evacuated.
+  // True if this is a sticky collector (see the constructor).
+  const bool young_gen_;
+  // True if the heap alternates sticky and full concurrent copying collections.
+  const bool use_generational_cc_;
+  // Set once a sticky collection has scanned the cards of the old objects. Until then, old
+  // objects may hold from-space references and are grayed when marked even though their mark
+  // bit is already set. Always true for full collections.
+  Atomic<bool> done_scanning_;
   Atomic<bool> updated_all_immune_objects_;
   bool gc_grays_immune_objects_;
   Mutex immune_gray_stack_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
@@ -371,6 +429,7 @@ class ConcurrentCopying : public GarbageCollector {
 
   class ActivateReadBarrierEntrypointsCallback;
   class ActivateReadBarrierEntrypointsCheckpoint;
+  class AgedCardScanVisitor;
   class AssertToSpaceInvariantFieldVisitor;
   class AssertToSpaceInvariantRefsVisitor;
   class ClearBlackPtrsVisitor;
@@ -382,6 +441,7 @@ class ConcurrentCopying : public GarbageCollector {
   template <bool kConcurrent> class GrayImmuneObjectVisitor;
   class ImmuneSpaceScanObjVisitor;
   class LostCopyVisitor;
+  class ParallelMarkTask;
   class RefFieldsVisitor;
   class RevokeThreadLocalMarkStackCheckpoint;
   class ScopedGcGraysImmuneObjects;
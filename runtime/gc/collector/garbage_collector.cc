@@ -94,6 +94,8 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   // change in the middle of a GC.
   is_transaction_active_ = Runtime::Current()->IsActiveTransaction();
   RunPhases();  // Run all the GC phases.
+  // Deflating idle monitors needs a pause, count it with the other pauses of this collection.
+  heap_->DeflateIdleMonitors(this);
   // Add the current timings to the cumulative timings.
   cumulative_timings_.AddLogger(*GetTimings());
   // Update cumulative statistics with how many bytes the GC iteration freed.
@@ -867,12 +867,7 @@ class MarkSweep::CardScanTask : public MarkStackTask<false> {
 };
 
 size_t MarkSweep::GetThreadCount(bool paused) const {
-  // Use less threads if we are in a background state (non jank perceptible) since we want to leave
-  // more CPU time for the foreground apps.
-  if (heap_->GetThreadPool() == nullptr || !Runtime::Current()->InJankPerceptibleProcessState()) {
-    return 1;
-  }
-  return (paused ? heap_->GetParallelGCThreadCount() : heap_->GetConcGCThreadCount()) + 1;
+  return heap_->GetGcThreadCount(paused);
 }
 
 void MarkSweep::ScanGrayObjects(bool paused, uint8_t minimum_age) {
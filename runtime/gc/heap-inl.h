@@ -162,6 +162,10 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self,
       // Only trace when we get an increase in the number of bytes allocated. This happens when
       // obtaining a new TLAB and isn't often enough to hurt performance according to golem.
       TraceHeapSize(new_num_bytes_allocated);
+      // Sampling is driven by the same buffer refills, so it does not slow down the fast path.
+      if (UNLIKELY(allocation_sampler_ != nullptr)) {
+        allocation_sampler_->CountAllocation(self, &obj, bytes_tl_bulk_allocated);
+      }
     }
   }
   if (kIsDebugBuild && Runtime::Current()->IsStarted()) {
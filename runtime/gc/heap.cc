@@ -105,6 +105,10 @@ static constexpr size_t kMaxConcurrentRemainingBytes = 512 * KB;
 // relative to partial/full GC. This may be desirable since sticky GCs interfere less with mutator
 // threads (lower pauses, use less memory bandwidth).
 static constexpr double kStickyGcThroughputAdjustment = 1.0;
+// With generational CC, the fraction of the allocatable (non-evacuation) half of the region space
+// that may be in use after a sticky collection before the next collection is a full one. Sticky
+// collections never compact old regions, so the dead objects they keep fragment the region space.
+static constexpr double kGenerationalCcFullGcRegionUsageThreshold = 0.75;
 // Whether or not we compact the zygote in PreZygoteFork.
 static constexpr bool kCompactZygote = kMovingCollector;
 // How many reserve entries are at the end of the allocation stack, these are only needed if the
@@ -141,6 +145,9 @@ static constexpr bool kLogAllGCs = false;
 
 // How much we grow the TLAB if we can do it.
 static constexpr size_t kPartialTlabSize = 16 * KB;
+// Maximum number of monitors visited by a pause deflating idle monitors in a jank perceptible
+// process. This keeps the pause to about 100us, larger monitor lists take several GCs.
+static constexpr size_t kMaxMonitorsVisitedPerDeflationPause = 1024;
 static constexpr bool kUsePartialTlabs = true;
 
 #if defined(__LP64__) || !defined(ADDRESS_SANITIZER)
@@ -190,6 +197,7 @@ Heap::Heap(size_t initial_size,
            bool verify_post_gc_rosalloc,
            bool gc_stress_mode,
            bool measure_gc_performance,
+           bool use_generational_cc,
            bool use_homogeneous_space_compaction_for_oom,
            uint64_t min_interval_homogeneous_space_compaction_by_oom)
     : non_moving_space_(nullptr),
@@ -260,6 +268,8 @@ Heap::Heap(size_t initial_size,
       semi_space_collector_(nullptr),
       mark_compact_collector_(nullptr),
       concurrent_copying_collector_(nullptr),
+      young_concurrent_copying_collector_(nullptr),
+      active_concurrent_copying_collector_(nullptr),
       is_running_on_memory_tool_(Runtime::Current()->IsRunningOnMemoryTool()),
       use_tlab_(use_tlab),
       main_space_backup_(nullptr),
@@ -269,6 +279,7 @@ Heap::Heap(size_t initial_size,
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
+      use_generational_cc_(use_generational_cc && kUseBakerReadBarrier),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
       blocking_gc_time_(0U),
@@ -564,7 +575,9 @@ Heap::Heap(size_t initial_size,
   thread_flip_cond_.reset(new ConditionVariable("GC thread flip condition variable",
                                                 *thread_flip_lock_));
   task_processor_.reset(new TaskProcessor());
-  reference_processor_.reset(new ReferenceProcessor());
+  // One list of pending references per thread that may clear them.
+  reference_processor_.reset(
+      new ReferenceProcessor(std::max(parallel_gc_threads_, conc_gc_threads_) + 1));
   pending_task_lock_ = new Mutex("Pending task lock");
   if (ignore_max_footprint_) {
     SetIdealFootprint(std::numeric_limits<size_t>::max());
@@ -593,11 +606,24 @@ Heap::Heap(size_t initial_size,
     }
     if (MayUseCollector(kCollectorTypeCC)) {
       concurrent_copying_collector_ = new collector::ConcurrentCopying(this,
+                                                                       /*young_gen*/ false,
+                                                                       use_generational_cc_,
                                                                        "",
                                                                        measure_gc_performance);
       DCHECK(region_space_ != nullptr);
       concurrent_copying_collector_->SetRegionSpace(region_space_);
       garbage_collectors_.push_back(concurrent_copying_collector_);
+      if (use_generational_cc_) {
+        young_concurrent_copying_collector_ = new collector::ConcurrentCopying(
+            this,
+            /*young_gen*/ true,
+            use_generational_cc_,
+            "young",
+            measure_gc_performance);
+        young_concurrent_copying_collector_->SetRegionSpace(region_space_);
+        garbage_collectors_.push_back(young_concurrent_copying_collector_);
+      }
+      active_concurrent_copying_collector_ = concurrent_copying_collector_;
     }
     if (MayUseCollector(kCollectorTypeMC)) {
       mark_compact_collector_ = new collector::MarkCompact(this);
@@ -895,7 +921,7 @@ void Heap::UpdateProcessState(ProcessState old_process_state, ProcessState new_p
 void Heap::CreateThreadPool() {
   const size_t num_threads = std::max(parallel_gc_threads_, conc_gc_threads_);
   if (num_threads != 0) {
-    thread_pool_.reset(new ThreadPool("Heap thread pool", num_threads));
+    thread_pool_.reset(new WorkStealingThreadPool("Heap thread pool", num_threads));
   }
 }
 
@@ -1052,6 +1078,10 @@ void Heap::DumpGcPerformanceInfo(std::ostream& os) {
      << old_native_bytes_allocated_.LoadRelaxed() + new_native_bytes_allocated_.LoadRelaxed()
      << "\n";
 
+  if (allocation_sampler_ != nullptr) {
+    allocation_sampler_->Dump(os);
+  }
+
   BaseMutex::DumpAll(os);
 }
 
@@ -1129,6 +1159,7 @@ Heap::~Heap() {
   // If we don't reset then the mark stack complains in its destructor.
   allocation_stack_->Reset();
   allocation_records_.reset();
+  allocation_sampler_.reset();
   live_stack_->Reset();
   STLDeleteValues(&mod_union_tables_);
   STLDeleteValues(&remembered_sets_);
@@ -2129,6 +2160,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
     gc_plan_.clear();
     switch (collector_type_) {
       case kCollectorTypeCC: {
+        if (use_generational_cc_) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeRegionTLAB);
@@ -2578,7 +2612,13 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
         collector = semi_space_collector_;
         break;
       case kCollectorTypeCC:
-        collector = concurrent_copying_collector_;
+        if (use_generational_cc_ && gc_type == collector::kGcTypeSticky) {
+          active_concurrent_copying_collector_ = young_concurrent_copying_collector_;
+        } else {
+          active_concurrent_copying_collector_ = concurrent_copying_collector_;
+          gc_type = collector::kGcTypeFull;
+        }
+        collector = active_concurrent_copying_collector_;
         break;
       case kCollectorTypeMC:
         mark_compact_collector_->SetSpace(bump_pointer_space_);
@@ -2587,7 +2627,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       default:
         LOG(FATAL) << "Invalid collector type " << static_cast<size_t>(collector_type_);
     }
-    if (collector != mark_compact_collector_ && collector != concurrent_copying_collector_) {
+    if (collector != mark_compact_collector_ && collector_type_ != kCollectorTypeCC) {
       temp_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
       if (kIsDebugBuild) {
         // Try to read each page of the memory map in case mprotect didn't work properly b/19894268.
@@ -2595,7 +2635,9 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type,
       }
       CHECK(temp_space_->IsEmpty());
     }
-    gc_type = collector::kGcTypeFull;  // TODO: Not hard code this in.
+    if (collector_type_ != kCollectorTypeCC) {
+      gc_type = collector::kGcTypeFull;  // TODO: Not hard code this in.
+    }
   } else if (current_allocator_ == kAllocatorTypeRosAlloc ||
       current_allocator_ == kAllocatorTypeDlMalloc) {
     collector = FindCollectorByGcType(gc_type);
@@ -2657,6 +2699,8 @@ void Heap::LogGC(GcCause gc_cause, collector::GarbageCollector* collector) {
       pause_string << PrettyDuration((pause_times[i] / 1000) * 1000)
                    << ((i != pause_times.size() - 1) ? "," : "");
     }
+    std::ostringstream reference_string;
+    reference_processor_->DumpLastStats(reference_string);
     LOG(INFO) << gc_cause << " " << collector->GetName()
               << " GC freed "  << current_gc_iteration_.GetFreedObjects() << "("
               << PrettySize(current_gc_iteration_.GetFreedBytes()) << ") AllocSpace objects, "
@@ -2664,7 +2708,8 @@ void Heap::LogGC(GcCause gc_cause, collector::GarbageCollector* collector) {
               << PrettySize(current_gc_iteration_.GetFreedLargeObjectBytes()) << ") LOS objects, "
               << percent_free << "% free, " << PrettySize(current_heap_size) << "/"
               << PrettySize(total_memory) << ", " << "paused " << pause_string.str()
-              << " total " << PrettyDuration((duration / 1000) * 1000);
+              << " total " << PrettyDuration((duration / 1000) * 1000) << ", "
+              << reference_string.str();
     VLOG(heap) << Dumpable<TimingLogger>(*current_gc_iteration_.GetTimings());
   }
 }
@@ -3461,8 +3506,21 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     next_gc_type_ = collector::kGcTypeSticky;
   } else {
     collector::GcType non_sticky_gc_type = NonStickyGcType();
-    // Find what the next non sticky collector will be.
-    collector::GarbageCollector* non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
+    // Find what the next non sticky collector will be. The full CC collector reports the partial
+    // GC type, so look it up directly.
+    collector::GarbageCollector* non_sticky_collector = collector_type_ == kCollectorTypeCC
+        ? concurrent_copying_collector_
+        : FindCollectorByGcType(non_sticky_gc_type);
+    // Sticky CC collections never evacuate old regions, so also fall back to a full collection
+    // once too much of the region space is in use.
+    bool region_space_too_full = false;
+    if (collector_type_ == kCollectorTypeCC) {
+      DCHECK(region_space_ != nullptr);
+      // Half of the regions are reserved for evacuation.
+      const size_t max_non_free_regions = static_cast<size_t>(
+          region_space_->GetNumRegions() / 2 * kGenerationalCcFullGcRegionUsageThreshold);
+      region_space_too_full = region_space_->GetNumNonFreeRegions() > max_non_free_regions;
+    }
     // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
     // do another sticky collection next.
     // We also check that the bytes allocated aren't over the footprint limit in order to prevent a
@@ -3471,7 +3529,8 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
     if (current_gc_iteration_.GetEstimatedThroughput() * kStickyGcThroughputAdjustment >=
         non_sticky_collector->GetEstimatedMeanThroughput() &&
         non_sticky_collector->NumberOfIterations() > 0 &&
-        bytes_allocated <= max_allowed_footprint_) {
+        bytes_allocated <= max_allowed_footprint_ &&
+        !region_space_too_full) {
       next_gc_type_ = collector::kGcTypeSticky;
     } else {
       next_gc_type_ = non_sticky_gc_type;
@@ -3689,6 +3748,37 @@ void Heap::ClearPendingTrim(Thread* self) {
   pending_heap_trim_ = nullptr;
 }
 
+size_t Heap::GetGcThreadCount(bool paused) const {
+  if (thread_pool_ == nullptr || !CareAboutPauseTimes()) {
+    return 1;
+  }
+  return (paused ? parallel_gc_threads_ : conc_gc_threads_) + 1;
+}
+
+void Heap::DeflateIdleMonitors(collector::GarbageCollector* collector) {
+  MonitorList* const monitor_list = Runtime::Current()->GetMonitorList();
+  if (!monitor_list->ShouldDeflateIdleMonitors()) {
+    return;
+  }
+  ScopedTrace trace("Deflating idle monitors");
+  TimingLogger::ScopedTiming t(__FUNCTION__, collector->GetTimings());
+  const size_t max_visited = CareAboutPauseTimes()
+      ? kMaxMonitorsVisitedPerDeflationPause
+      : std::numeric_limits<size_t>::max();
+  uint64_t start_time = NanoTime();
+  size_t count;
+  if (Locks::mutator_lock_->IsExclusiveHeld(Thread::Current())) {
+    // The whole collection was a pause.
+    count = monitor_list->DeflateIdleMonitors(max_visited);
+  } else {
+    // We are the running GC, so there are no lock word races with CC.
+    collector::GarbageCollector::ScopedPause pause(collector);
+    count = monitor_list->DeflateIdleMonitors(max_visited);
+  }
+  VLOG(heap) << "Deflating " << count << " idle monitors took "
+      << PrettyDuration(NanoTime() - start_time);
+}
+
 void Heap::RequestTrim(Thread* self) {
   if (!CanAddHeapTask(self)) {
     return;
@@ -3880,6 +3970,10 @@ void Heap::SweepAllocationRecords(IsMarkedVisitor* visitor) const {
       GetAllocationRecords()->SweepAllocationRecords(visitor);
     }
   }
+  if (allocation_sampler_ != nullptr) {
+    MutexLock mu(Thread::Current(), *Locks::alloc_tracker_lock_);
+    allocation_sampler_->SweepSamples(visitor);
+  }
 }
 
 void Heap::AllowNewAllocationRecords() const {
@@ -3889,6 +3983,9 @@ void Heap::AllowNewAllocationRecords() const {
   if (allocation_records != nullptr) {
     allocation_records->AllowNewAllocationRecords();
   }
+  if (allocation_sampler_ != nullptr) {
+    allocation_sampler_->AllowNewSamples();
+  }
 }
 
 void Heap::DisallowNewAllocationRecords() const {
@@ -3898,6 +3995,15 @@ void Heap::DisallowNewAllocationRecords() const {
   if (allocation_records != nullptr) {
     allocation_records->DisallowNewAllocationRecords();
   }
+  if (allocation_sampler_ != nullptr) {
+    allocation_sampler_->DisallowNewSamples();
+  }
+}
+
+void Heap::EnableAllocationSampling(size_t mean_interval) {
+  CHECK(allocation_sampler_ == nullptr);
+  VLOG(heap) << "Sampling allocations every " << PrettySize(mean_interval) << " on average";
+  allocation_sampler_.reset(new AllocRecordSampler(mean_interval));
 }
 
 void Heap::BroadcastForNewAllocationRecords() const {
@@ -66,6 +66,7 @@ namespace gc {
 
 class AllocationListener;
 class AllocRecordObjectMap;
+class AllocRecordSampler;
 class GcPauseListener;
 class ReferenceProcessor;
 class TaskProcessor;
@@ -196,6 +197,7 @@ class Heap {
        bool verify_post_gc_rosalloc,
        bool gc_stress_mode,
        bool measure_gc_performance,
+       bool use_generational_cc,
        bool use_homogeneous_space_compaction,
        uint64_t min_interval_homogeneous_space_compaction_by_oom);
 
@@ -703,6 +705,10 @@ class Heap {
   size_t GetConcGCThreadCount() const {
     return conc_gc_threads_;
   }
+  // Number of threads, including the GC-running thread, to use for a phase of the GC that runs
+  // either while the mutators are paused or concurrently with them. A single thread in background
+  // states, to leave more CPU time for the foreground apps.
+  size_t GetGcThreadCount(bool paused) const;
   accounting::ModUnionTable* FindModUnionTableFromSpace(space::Space* space);
   void AddModUnionTable(accounting::ModUnionTable* mod_union_table);
 
@@ -727,8 +733,14 @@ class Heap {
     return zygote_space_ != nullptr;
   }
 
+  // Returns the concurrent copying collector that is running or ran last. With generational CC
+  // this is either the young or the full collector.
   collector::ConcurrentCopying* ConcurrentCopyingCollector() {
-    return concurrent_copying_collector_;
+    return active_concurrent_copying_collector_;
+  }
+
+  bool UseGenerationalConcurrentCopying() const {
+    return use_generational_cc_;
   }
 
   CollectorType CurrentCollectorType() {
@@ -809,6 +821,14 @@ class Heap {
   void BroadcastForNewAllocationRecords() const
       REQUIRES(!Locks::alloc_tracker_lock_);
 
+  // Starts sampling allocations, see AllocRecordSampler. Must be called before other threads
+  // allocate, since the sampler is never removed.
+  void EnableAllocationSampling(size_t mean_interval);
+
+  AllocRecordSampler* GetAllocationSampler() const {
+    return allocation_sampler_.get();
+  }
+
   void DisableGCForShutdown() REQUIRES(!*gc_complete_lock_);
 
   // Create a new alloc space and compact default alloc space to it.
@@ -1015,6 +1035,11 @@ class Heap {
   void GrowForUtilization(collector::GarbageCollector* collector_ran,
                           uint64_t bytes_allocated_before_gc = 0);
 
+  // Deflate monitors that are not in use if enough of them were inflated since the last time.
+  // Called by the collector at the end of a collection, so that the pause is recorded with its
+  // other pauses. The pause is bounded when pause times matter.
+  void DeflateIdleMonitors(collector::GarbageCollector* collector);
+
   size_t GetPercentFree();
 
   // Swap the allocation stack with the live stack.
@@ -1351,6 +1376,11 @@ class Heap {
   collector::SemiSpace* semi_space_collector_;
   collector::MarkCompact* mark_compact_collector_;
   collector::ConcurrentCopying* concurrent_copying_collector_;
+  // Sticky collector which only evacuates regions allocated since the last GC. Only created when
+  // use_generational_cc_ is true.
+  collector::ConcurrentCopying* young_concurrent_copying_collector_;
+  // The concurrent copying collector used by the current (or last) collection.
+  collector::ConcurrentCopying* active_concurrent_copying_collector_;
 
   const bool is_running_on_memory_tool_;
   const bool use_tlab_;
@@ -1387,6 +1417,9 @@ class Heap {
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
 
+  // Whether the concurrent copying collector runs sticky (young) collections between full ones.
+  const bool use_generational_cc_;
+
   // True if the currently running collection has made some thread wait.
   bool running_collection_is_blocking_ GUARDED_BY(gc_complete_lock_);
   // The number of blocking GC runs.
@@ -1412,6 +1445,7 @@ class Heap {
   // Allocation tracking support
   Atomic<bool> alloc_tracking_enabled_;
   std::unique_ptr<AllocRecordObjectMap> allocation_records_;
+  std::unique_ptr<AllocRecordSampler> allocation_sampler_;
 
   // GC stress related data structures.
   Mutex* backtrace_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
@@ -18,7 +18,9 @@
 #include "common_runtime_test.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/allocation_record.h"
 #include "handle_scope-inl.h"
+#include "mirror/array-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
@@ -108,5 +110,67 @@ TEST_F(ZygoteHeapTest, PreZygoteFork) {
   Runtime::Current()->GetHeap()->PreZygoteFork();
 }
 
+class AllocSampleHeapTest : public CommonRuntimeTest {
+  void SetUpRuntimeOptions(RuntimeOptions* options) {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:AllocSampleInterval=4k", nullptr));
+  }
+};
+
+TEST_F(AllocSampleHeapTest, SampleAllocations) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  AllocRecordSampler* sampler = heap->GetAllocationSampler();
+  ASSERT_TRUE(sampler != nullptr);
+  // The test allocates from native code, so its samples have no managed frames.
+  const uint32_t site = AllocRecordSampler::kNoManagedFramesSite;
+  // Drop the samples of objects that died during startup.
+  heap->CollectGarbage(/* clear_soft_references */ false);
+  const AllocRecordSampler::Stats total_before = sampler->GetTotalStats();
+  const AllocRecordSampler::Stats site_before = sampler->GetSiteStats(site);
+  uint64_t allocated_bytes;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<2> hs(soa.Self());
+    Handle<mirror::Class> c(
+        hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "[Ljava/lang/Object;")));
+    Handle<mirror::ObjectArray<mirror::Object>> live(
+        hs.NewHandle(mirror::ObjectArray<mirror::Object>::Alloc(soa.Self(), c.Get(), 256)));
+    // Allocate 16 MB and keep every fourth array live.
+    const uint64_t allocated_before = heap->GetBytesAllocatedEver();
+    for (size_t i = 0; i < 1024; ++i) {
+      mirror::ByteArray* array = mirror::ByteArray::Alloc(soa.Self(), 16 * KB);
+      ASSERT_TRUE(array != nullptr);
+      if (i % 4 == 0) {
+        live->Set<false>(i / 4, array);
+      }
+    }
+    allocated_bytes = heap->GetBytesAllocatedEver() - allocated_before;
+    heap->CollectGarbage(/* clear_soft_references */ false);
+  }
+  ASSERT_GE(allocated_bytes, 16 * MB);
+  const AllocRecordSampler::Stats total_after = sampler->GetTotalStats();
+  const AllocRecordSampler::Stats site_after = sampler->GetSiteStats(site);
+
+  // Each sample stands for the bytes counted since the previous one, so the sampled bytes only
+  // differ from the allocated bytes by what was counted before the first and after the last
+  // sample.
+  const double sampled_bytes = total_after.total_bytes - total_before.total_bytes;
+  EXPECT_NEAR(sampled_bytes, allocated_bytes, 1 * MB);
+  EXPECT_NEAR(site_after.total_bytes - site_before.total_bytes, allocated_bytes, 1 * MB);
+
+  // The arrays are larger than the mean interval, so almost all of them are sampled and a
+  // quarter of the sampled bytes stays live. Objects from before the test may die in the
+  // collection, which makes the difference in live bytes a lower bound.
+  const double live_bytes = static_cast<double>(site_after.live_bytes) -
+                            static_cast<double>(site_before.live_bytes);
+  EXPECT_GT(live_bytes, 0.20 * allocated_bytes);
+  EXPECT_LT(live_bytes, 0.30 * allocated_bytes);
+  EXPECT_LE(site_after.live_bytes, total_after.live_bytes);
+
+  std::ostringstream oss;
+  heap->DumpGcPerformanceInfo(oss);
+  EXPECT_NE(oss.str().find("Sampled allocations"), std::string::npos) << oss.str();
+}
+
 }  // namespace gc
 }  // namespace art
@@ -19,6 +19,7 @@
 #include "base/time_utils.h"
 #include "base/utils.h"
 #include "collector/garbage_collector.h"
+#include "heap.h"
 #include "java_vm_ext.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
@@ -27,8 +28,10 @@
 #include "object_callbacks.h"
 #include "reference_processor-inl.h"
 #include "reflection.h"
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "task_processor.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -36,14 +39,48 @@ namespace gc {
 
 static constexpr bool kAsyncReferenceQueueAdd = false;
 
-ReferenceProcessor::ReferenceProcessor()
+// Minimum number of pending references of one kind for clearing them in parallel. Fewer are
+// cleared by the GC thread alone.
+static constexpr size_t kMinParallelReferences = 4096;
+
+ReferenceProcessor::PendingReferenceLists::PendingReferenceLists(Mutex* lock, size_t num_lists)
+    : enqueue_count_(0) {
+  DCHECK_GT(num_lists, 0u);
+  for (size_t i = 0; i < num_lists; ++i) {
+    lists_.emplace_back(new ReferenceQueue(lock));
+  }
+}
+
+void ReferenceProcessor::PendingReferenceLists::AtomicEnqueueIfNotEnqueued(
+    Thread* self, ObjPtr<mirror::Reference> ref) {
+  const size_t index = enqueue_count_.FetchAndAddRelaxed(1) % lists_.size();
+  lists_[index]->AtomicEnqueueIfNotEnqueued(self, ref);
+}
+
+void ReferenceProcessor::PendingReferenceLists::ForwardSoftReferences(MarkObjectVisitor* visitor) {
+  for (const std::unique_ptr<ReferenceQueue>& list : lists_) {
+    list->ForwardSoftReferences(visitor);
+  }
+}
+
+bool ReferenceProcessor::PendingReferenceLists::IsEmpty() const {
+  for (const std::unique_ptr<ReferenceQueue>& list : lists_) {
+    if (!list->IsEmpty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ReferenceProcessor::ReferenceProcessor(size_t num_pending_lists)
     : collector_(nullptr),
       preserving_references_(false),
       condition_("reference processor condition", *Locks::reference_processor_lock_) ,
-      soft_reference_queue_(Locks::reference_queue_soft_references_lock_),
-      weak_reference_queue_(Locks::reference_queue_weak_references_lock_),
+      soft_reference_lists_(Locks::reference_queue_soft_references_lock_, num_pending_lists),
+      weak_reference_lists_(Locks::reference_queue_weak_references_lock_, num_pending_lists),
       finalizer_reference_queue_(Locks::reference_queue_finalizer_references_lock_),
-      phantom_reference_queue_(Locks::reference_queue_phantom_references_lock_),
+      phantom_reference_lists_(Locks::reference_queue_phantom_references_lock_,
+                               num_pending_lists),
       cleared_references_(Locks::reference_queue_cleared_references_lock_) {
 }
 
@@ -141,55 +178,91 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
       CHECK_EQ(!self->GetWeakRefAccessEnabled(), concurrent);
     }
   }
+  soft_reference_stats_.Reset();
+  weak_reference_stats_.Reset();
+  finalizer_reference_stats_.Reset();
+  phantom_reference_stats_.Reset();
+  const size_t thread_count = Runtime::Current()->GetHeap()->GetGcThreadCount(!concurrent);
   if (kIsDebugBuild && collector->IsTransactionActive()) {
     // In transaction mode, we shouldn't enqueue any Reference to the queues.
     // See DelayReferenceReferent().
-    DCHECK(soft_reference_queue_.IsEmpty());
-    DCHECK(weak_reference_queue_.IsEmpty());
+    DCHECK(soft_reference_lists_.IsEmpty());
+    DCHECK(weak_reference_lists_.IsEmpty());
     DCHECK(finalizer_reference_queue_.IsEmpty());
-    DCHECK(phantom_reference_queue_.IsEmpty());
+    DCHECK(phantom_reference_lists_.IsEmpty());
   }
   // Unless required to clear soft references with white references, preserve some white referents.
   if (!clear_soft_references) {
     TimingLogger::ScopedTiming split(concurrent ? "ForwardSoftReferences" :
         "(Paused)ForwardSoftReferences", timings);
+    const uint64_t start_time = NanoTime();
     if (concurrent) {
       StartPreservingReferences(self);
     }
     // TODO: Add smarter logic for preserving soft references. The behavior should be a conditional
     // mark if the SoftReference is supposed to be preserved.
-    soft_reference_queue_.ForwardSoftReferences(collector);
+    soft_reference_lists_.ForwardSoftReferences(collector);
     collector->ProcessMarkStack();
     if (concurrent) {
       StopPreservingReferences(self);
     }
+    soft_reference_stats_.duration_ns += NanoTime() - start_time;
   }
   // Clear all remaining soft and weak references with white referents.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteReferences(&soft_reference_lists_,
+                       &soft_reference_stats_,
+                       concurrent ? "ClearSoftReferences" : "(Paused)ClearSoftReferences",
+                       timings,
+                       collector,
+                       thread_count);
+  ClearWhiteReferences(&weak_reference_lists_,
+                       &weak_reference_stats_,
+                       concurrent ? "ClearWeakReferences" : "(Paused)ClearWeakReferences",
+                       timings,
+                       collector,
+                       thread_count);
   {
     TimingLogger::ScopedTiming t2(concurrent ? "EnqueueFinalizerReferences" :
         "(Paused)EnqueueFinalizerReferences", timings);
+    const uint64_t start_time = NanoTime();
     if (concurrent) {
       StartPreservingReferences(self);
     }
-    // Preserve all white objects with finalize methods and schedule them for finalization.
-    finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector);
+    // Preserve all white objects with finalize methods and schedule them for finalization. This
+    // stays on the GC thread since marking the referents is not thread safe for all collectors.
+    finalizer_reference_stats_.Add(
+        finalizer_reference_queue_.EnqueueFinalizerReferences(&cleared_references_, collector));
     collector->ProcessMarkStack();
     if (concurrent) {
       StopPreservingReferences(self);
     }
+    finalizer_reference_stats_.duration_ns += NanoTime() - start_time;
   }
   // Clear all finalizer referent reachable soft and weak references with white referents.
-  soft_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
-  weak_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteReferences(&soft_reference_lists_,
+                       &soft_reference_stats_,
+                       concurrent ? "ClearSoftReferences" : "(Paused)ClearSoftReferences",
+                       timings,
+                       collector,
+                       thread_count);
+  ClearWhiteReferences(&weak_reference_lists_,
+                       &weak_reference_stats_,
+                       concurrent ? "ClearWeakReferences" : "(Paused)ClearWeakReferences",
+                       timings,
+                       collector,
+                       thread_count);
   // Clear all phantom references with white referents.
-  phantom_reference_queue_.ClearWhiteReferences(&cleared_references_, collector);
+  ClearWhiteReferences(&phantom_reference_lists_,
+                       &phantom_reference_stats_,
+                       concurrent ? "ClearPhantomReferences" : "(Paused)ClearPhantomReferences",
+                       timings,
+                       collector,
+                       thread_count);
   // At this point all reference queues other than the cleared references should be empty.
-  DCHECK(soft_reference_queue_.IsEmpty());
-  DCHECK(weak_reference_queue_.IsEmpty());
+  DCHECK(soft_reference_lists_.IsEmpty());
+  DCHECK(weak_reference_lists_.IsEmpty());
   DCHECK(finalizer_reference_queue_.IsEmpty());
-  DCHECK(phantom_reference_queue_.IsEmpty());
+  DCHECK(phantom_reference_lists_.IsEmpty());
   {
     MutexLock mu(self, *Locks::reference_processor_lock_);
     // Need to always do this since the next GC may be concurrent. Doing this for only concurrent
@@ -204,6 +277,90 @@ void ReferenceProcessor::ProcessReferences(bool concurrent,
   }
 }
 
+class ReferenceProcessor::ClearWhiteReferencesTask : public Task {
+ public:
+  ClearWhiteReferencesTask(ReferenceQueue* references,
+                           ReferenceQueue* cleared_references,
+                           ReferenceStats* stats,
+                           collector::GarbageCollector* collector)
+      : references_(references),
+        local_cleared_references_(Locks::reference_queue_cleared_references_lock_),
+        cleared_references_(cleared_references),
+        stats_(stats),
+        collector_(collector) {}
+
+  virtual void Run(Thread* self) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    // Clear into a local queue so that the shared one is only locked once per list.
+    stats_->Add(references_->ClearWhiteReferences(&local_cleared_references_, collector_));
+    cleared_references_->AtomicSplice(self, &local_cleared_references_);
+  }
+
+  virtual void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  ReferenceQueue* const references_;
+  ReferenceQueue local_cleared_references_;
+  ReferenceQueue* const cleared_references_;
+  ReferenceStats* const stats_;
+  collector::GarbageCollector* const collector_;
+};
+
+void ReferenceProcessor::ClearWhiteReferences(PendingReferenceLists* lists,
+                                              ReferenceStats* stats,
+                                              const char* split_name,
+                                              TimingLogger* timings,
+                                              collector::GarbageCollector* collector,
+                                              size_t thread_count) {
+  if (lists->IsEmpty()) {
+    return;
+  }
+  TimingLogger::ScopedTiming t(split_name, timings);
+  const uint64_t start_time = NanoTime();
+  // Transactions record every write and are not thread safe; the lists are empty in transaction
+  // mode anyway (see DelayReferenceReferent).
+  if (thread_count == 1 ||
+      collector->IsTransactionActive() ||
+      lists->GetApproximateLength() < kMinParallelReferences) {
+    for (size_t i = 0; i < lists->GetNumLists(); ++i) {
+      stats->Add(lists->GetList(i)->ClearWhiteReferences(&cleared_references_, collector));
+    }
+  } else {
+    Thread* self = Thread::Current();
+    ThreadPool* thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+    for (size_t i = 0; i < lists->GetNumLists(); ++i) {
+      ReferenceQueue* list = lists->GetList(i);
+      if (!list->IsEmpty()) {
+        thread_pool->AddTask(
+            self, new ClearWhiteReferencesTask(list, &cleared_references_, stats, collector));
+      }
+    }
+    thread_pool->SetMaxActiveWorkers(thread_count - 1);
+    thread_pool->StartWorkers(self);
+    thread_pool->Wait(self, /* do_work */ true, /* may_hold_locks */ true);
+    thread_pool->StopWorkers(self);
+  }
+  DCHECK(lists->IsEmpty());
+  lists->ResetLength();
+  stats->duration_ns += NanoTime() - start_time;
+}
+
+void ReferenceProcessor::DumpLastStats(std::ostream& os) const {
+  auto dump = [&os](const char* name, const ReferenceStats& stats) {
+    os << name << " " << stats.processed.LoadRelaxed() << "/" << stats.cleared.LoadRelaxed()
+       << " " << PrettyDuration((stats.duration_ns / 1000) * 1000);
+  };
+  os << "processed/cleared references: ";
+  dump("soft", soft_reference_stats_);
+  os << ", ";
+  dump("weak", weak_reference_stats_);
+  os << ", ";
+  dump("finalizer", finalizer_reference_stats_);
+  os << ", ";
+  dump("phantom", phantom_reference_stats_);
+}
+
 // Process the "referent" field in a java.lang.ref.Reference.  If the referent has not yet been
 // marked, put it on the appropriate list in the heap for later processing.
 void ReferenceProcessor::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
@@ -230,13 +387,13 @@ void ReferenceProcessor::DelayReferenceReferent(ObjPtr<mirror::Class> klass,
     // We need to check that the references haven't already been enqueued since we can end up
     // scanning the same reference multiple times due to dirty cards.
     if (klass->IsSoftReferenceClass()) {
-      soft_reference_queue_.AtomicEnqueueIfNotEnqueued(self, ref);
+      soft_reference_lists_.AtomicEnqueueIfNotEnqueued(self, ref);
     } else if (klass->IsWeakReferenceClass()) {
-      weak_reference_queue_.AtomicEnqueueIfNotEnqueued(self, ref);
+      weak_reference_lists_.AtomicEnqueueIfNotEnqueued(self, ref);
     } else if (klass->IsFinalizerReferenceClass()) {
       finalizer_reference_queue_.AtomicEnqueueIfNotEnqueued(self, ref);
     } else if (klass->IsPhantomReferenceClass()) {
-      phantom_reference_queue_.AtomicEnqueueIfNotEnqueued(self, ref);
+      phantom_reference_lists_.AtomicEnqueueIfNotEnqueued(self, ref);
     } else {
       LOG(FATAL) << "Invalid reference type " << klass->PrettyClass() << " " << std::hex
                  << klass->GetAccessFlags();
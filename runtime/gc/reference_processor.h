@@ -17,6 +17,11 @@
 #ifndef ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 #define ART_RUNTIME_GC_REFERENCE_PROCESSOR_H_
 
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "base/atomic.h"
 #include "base/mutex.h"
 #include "globals.h"
 #include "jni.h"
@@ -25,6 +30,7 @@
 namespace art {
 
 class IsMarkedVisitor;
+class MarkObjectVisitor;
 class TimingLogger;
 
 namespace mirror {
@@ -45,7 +51,27 @@ class Heap;
 // Used to process java.lang.ref.Reference instances concurrently or paused.
 class ReferenceProcessor {
  public:
-  ReferenceProcessor();
+  // Statistics for one kind of reference over the last ProcessReferences call.
+  struct ReferenceStats {
+    // Updated by the GC worker threads clearing references in parallel.
+    Atomic<size_t> processed;
+    Atomic<size_t> cleared;
+    uint64_t duration_ns = 0;
+
+    void Reset() {
+      processed.StoreRelaxed(0);
+      cleared.StoreRelaxed(0);
+      duration_ns = 0;
+    }
+    void Add(const ReferenceCounts& counts) {
+      processed.FetchAndAddRelaxed(counts.processed);
+      cleared.FetchAndAddRelaxed(counts.cleared);
+    }
+  };
+
+  // num_pending_lists is the number of lists each kind of reference cleared in parallel is spread
+  // over, normally the maximum number of threads clearing them.
+  explicit ReferenceProcessor(size_t num_pending_lists);
   void ProcessReferences(bool concurrent,
                          TimingLogger* timings,
                          bool clear_soft_references,
@@ -76,8 +102,58 @@ class ReferenceProcessor {
   void ClearReferent(ObjPtr<mirror::Reference> ref)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::reference_processor_lock_);
+  // Print the per-type reference counts and timings of the last ProcessReferences call.
+  void DumpLastStats(std::ostream& os) const;
 
  private:
+  class ClearWhiteReferencesTask;
+
+  // References of one kind pending processing, spread round-robin over several lists so that
+  // the lists can be cleared in parallel without walking them first. The lists share one lock,
+  // which makes the check that a reference is not already enqueued atomic across all of them.
+  class PendingReferenceLists {
+   public:
+    PendingReferenceLists(Mutex* lock, size_t num_lists);
+
+    void AtomicEnqueueIfNotEnqueued(Thread* self, ObjPtr<mirror::Reference> ref)
+        REQUIRES_SHARED(Locks::mutator_lock_);
+    void ForwardSoftReferences(MarkObjectVisitor* visitor)
+        REQUIRES_SHARED(Locks::mutator_lock_);
+    bool IsEmpty() const;
+
+    size_t GetNumLists() const {
+      return lists_.size();
+    }
+    ReferenceQueue* GetList(size_t i) {
+      return lists_[i].get();
+    }
+    // Upper bound of the number of references enqueued since the last ResetLength, including
+    // the ones that were already enqueued.
+    size_t GetApproximateLength() const {
+      return enqueue_count_.LoadRelaxed();
+    }
+    void ResetLength() {
+      enqueue_count_.StoreRelaxed(0);
+    }
+
+   private:
+    std::vector<std::unique_ptr<ReferenceQueue>> lists_;
+    // Picks the list of the next enqueued reference.
+    Atomic<size_t> enqueue_count_;
+
+    DISALLOW_COPY_AND_ASSIGN(PendingReferenceLists);
+  };
+
+  // Clear the white references of lists, one task per list on the heap thread pool if there are
+  // enough of them and thread_count > 1.
+  void ClearWhiteReferences(PendingReferenceLists* lists,
+                            ReferenceStats* stats,
+                            const char* split_name,
+                            TimingLogger* timings,
+                            collector::GarbageCollector* collector,
+                            size_t thread_count)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   bool SlowPathEnabled() REQUIRES_SHARED(Locks::mutator_lock_);
   // Called by ProcessReferences.
   void DisableSlowPath(Thread* self) REQUIRES(Locks::reference_processor_lock_)
@@ -101,11 +177,16 @@ class ReferenceProcessor {
   // processing is in progress.
   ConditionVariable condition_ GUARDED_BY(Locks::reference_processor_lock_);
   // Reference queues used by the GC.
-  ReferenceQueue soft_reference_queue_;
-  ReferenceQueue weak_reference_queue_;
+  PendingReferenceLists soft_reference_lists_;
+  PendingReferenceLists weak_reference_lists_;
   ReferenceQueue finalizer_reference_queue_;
-  ReferenceQueue phantom_reference_queue_;
+  PendingReferenceLists phantom_reference_lists_;
   ReferenceQueue cleared_references_;
+  // Only written by the thread running the GC, and by the tasks it waits for.
+  ReferenceStats soft_reference_stats_;
+  ReferenceStats weak_reference_stats_;
+  ReferenceStats finalizer_reference_stats_;
+  ReferenceStats phantom_reference_stats_;
 
   DISALLOW_COPY_AND_ASSIGN(ReferenceProcessor);
 };
@@ -71,6 +71,23 @@ ObjPtr<mirror::Reference> ReferenceQueue::DequeuePendingReference() {
   return ref;
 }
 
+void ReferenceQueue::AtomicSplice(Thread* self, ReferenceQueue* other) {
+  DCHECK_NE(this, other);
+  if (other->IsEmpty()) {
+    return;
+  }
+  MutexLock mu(self, *lock_);
+  if (IsEmpty()) {
+    list_ = other->list_;
+  } else {
+    // Swapping the successors of the two list_ nodes joins the cycles.
+    ObjPtr<mirror::Reference> head = list_->GetPendingNext<kWithoutReadBarrier>();
+    list_->SetPendingNext(other->list_->GetPendingNext<kWithoutReadBarrier>());
+    other->list_->SetPendingNext(head);
+  }
+  other->list_ = nullptr;
+}
+
 // This must be called whenever DequeuePendingReference is called.
 void ReferenceQueue::DisableReadBarrierForReference(ObjPtr<mirror::Reference> ref) {
   Heap* heap = Runtime::Current()->GetHeap();
@@ -129,10 +146,12 @@ size_t ReferenceQueue::GetLength() const {
   return count;
 }
 
-void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
-                                          collector::GarbageCollector* collector) {
+ReferenceCounts ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
+                                                     collector::GarbageCollector* collector) {
+  ReferenceCounts counts;
   while (!IsEmpty()) {
     ObjPtr<mirror::Reference> ref = DequeuePendingReference();
+    ++counts.processed;
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
     // do_atomic_update is false because this happens during the reference processing phase where
     // Reference.clear() would block.
@@ -144,17 +163,22 @@ void ReferenceQueue::ClearWhiteReferences(ReferenceQueue* cleared_references,
         ref->ClearReferent<false>();
       }
       cleared_references->EnqueueReference(ref);
+      ++counts.cleared;
     }
     // Delay disabling the read barrier until here so that the ClearReferent call above in
     // transaction mode will trigger the read barrier.
     DisableReadBarrierForReference(ref);
   }
+  return counts;
 }
 
-void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
-                                                collector::GarbageCollector* collector) {
+ReferenceCounts ReferenceQueue::EnqueueFinalizerReferences(
+    ReferenceQueue* cleared_references,
+    collector::GarbageCollector* collector) {
+  ReferenceCounts counts;
   while (!IsEmpty()) {
     ObjPtr<mirror::FinalizerReference> ref = DequeuePendingReference()->AsFinalizerReference();
+    ++counts.processed;
     mirror::HeapReference<mirror::Object>* referent_addr = ref->GetReferentReferenceAddr();
     // do_atomic_update is false because this happens during the reference processing phase where
     // Reference.clear() would block.
@@ -169,11 +193,13 @@ void ReferenceQueue::EnqueueFinalizerReferences(ReferenceQueue* cleared_referenc
         ref->ClearReferent<false>();
       }
       cleared_references->EnqueueReference(ref);
+      ++counts.cleared;
     }
     // Delay disabling the read barrier until here so that the ClearReferent call above in
     // transaction mode will trigger the read barrier.
     DisableReadBarrierForReference(ref->AsReference());
   }
+  return counts;
 }
 
 void ReferenceQueue::ForwardSoftReferences(MarkObjectVisitor* visitor) {
@@ -46,6 +46,13 @@ class GarbageCollector;
 
 class Heap;
 
+// Number of references taken off a ReferenceQueue by one pass over it, and how many of them were
+// cleared and moved to the cleared references queue.
+struct ReferenceCounts {
+  size_t processed = 0;
+  size_t cleared = 0;
+};
+
 // Used to temporarily store java.lang.ref.Reference(s) during GC and prior to queueing on the
 // appropriate java.lang.ref.ReferenceQueue. The linked list is maintained as an unordered,
 // circular, and singly-linked list using the pendingNext fields of the java.lang.ref.Reference
@@ -68,6 +75,11 @@ class ReferenceQueue {
   // Call DisableReadBarrierForReference for the reference that's returned from this function.
   ObjPtr<mirror::Reference> DequeuePendingReference() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Move all the references of other to this queue in constant time. Thread safe to call from
+  // multiple threads as long as the other queues are distinct.
+  void AtomicSplice(Thread* self, ReferenceQueue* other)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*lock_);
+
   // If applicable, disable the read barrier for the reference after its referent is handled (see
   // ConcurrentCopying::ProcessMarkStackRef.) This must be called for a reference that's dequeued
   // from pending queue (DequeuePendingReference).
@@ -76,8 +88,8 @@ class ReferenceQueue {
 
   // Enqueues finalizer references with white referents.  White referents are blackened, moved to
   // the zombie field, and the referent field is cleared.
-  void EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
-                                  collector::GarbageCollector* collector)
+  ReferenceCounts EnqueueFinalizerReferences(ReferenceQueue* cleared_references,
+                                             collector::GarbageCollector* collector)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Walks the reference list marking any references subject to the reference clearing policy.
@@ -88,8 +100,9 @@ class ReferenceQueue {
 
   // Unlink the reference list clearing references objects with white referents. Cleared references
   // registered to a reference queue are scheduled for appending by the heap worker thread.
-  void ClearWhiteReferences(ReferenceQueue* cleared_references,
-                            collector::GarbageCollector* collector)
+  // Only reads the mark state of the collector, so disjoint queues may be processed in parallel.
+  ReferenceCounts ClearWhiteReferences(ReferenceQueue* cleared_references,
+                                       collector::GarbageCollector* collector)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   void Dump(std::ostream& os) const REQUIRES_SHARED(Locks::mutator_lock_);
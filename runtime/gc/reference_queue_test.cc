@@ -15,6 +15,7 @@
  */
 
 #include <sstream>
+#include <vector>
 
 #include "common_runtime_test.h"
 #include "handle_scope-inl.h"
@@ -61,6 +62,51 @@ TEST_F(ReferenceQueueTest, EnqueueDequeue) {
   ASSERT_EQ(refs, dequeued);
 }
 
+TEST_F(ReferenceQueueTest, AtomicSplice) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<20> hs(self);
+  Mutex lock("Reference queue lock");
+  ReferenceQueue queue(&lock);
+  ReferenceQueue other(&lock);
+  auto ref_class = hs.NewHandle(
+      Runtime::Current()->GetClassLinker()->FindClass(self, "Ljava/lang/ref/WeakReference;",
+                                                      ScopedNullHandle<mirror::ClassLoader>()));
+  ASSERT_TRUE(ref_class != nullptr);
+  std::set<mirror::Reference*> refs;
+  std::vector<Handle<mirror::Reference>> handles;
+  for (size_t i = 0; i < 5; ++i) {
+    handles.push_back(hs.NewHandle(ref_class->AllocObject(self)->AsReference()));
+    ASSERT_TRUE(handles.back() != nullptr);
+  }
+  // Splicing an empty queue is a no-op.
+  queue.AtomicSplice(self, &other);
+  ASSERT_TRUE(queue.IsEmpty());
+  for (size_t i = 0; i < handles.size(); ++i) {
+    (i < 2 ? &other : &queue)->EnqueueReference(handles[i].Get());
+    refs.insert(handles[i].Get());
+  }
+  ASSERT_EQ(other.GetLength(), 2U);
+  ASSERT_EQ(queue.GetLength(), 3U);
+
+  queue.AtomicSplice(self, &other);
+  ASSERT_TRUE(other.IsEmpty());
+  ASSERT_EQ(queue.GetLength(), 5U);
+  queue.AtomicSplice(self, &other);
+  ASSERT_EQ(queue.GetLength(), 5U);
+
+  // Splicing into an empty queue takes the whole list.
+  other.AtomicSplice(self, &queue);
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(other.GetLength(), 5U);
+  queue.AtomicSplice(self, &other);
+  std::set<mirror::Reference*> dequeued;
+  while (!queue.IsEmpty()) {
+    dequeued.insert(queue.DequeuePendingReference().Ptr());
+  }
+  ASSERT_EQ(refs, dequeued);
+}
+
 TEST_F(ReferenceQueueTest, Dump) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
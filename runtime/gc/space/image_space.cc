@@ -17,10 +17,12 @@
 #include "image_space.h"
 
 #include <lz4.h>
+#include <pthread.h>
 #include <sys/statvfs.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <random>
 
 #include "android-base/stringprintf.h"
@@ -505,6 +507,9 @@ std::ostream& operator<<(std::ostream& os, const RelocationRange& reloc) {
             << reinterpret_cast<const void*>(reloc.Dest() + reloc.Length()) << ")";
 }
 
+// Maximum number of threads, including the loading thread, decompressing the blocks of an image.
+static constexpr size_t kMaxImageDecompressionThreads = 4;
+
 // Helper class encapsulating loading, so we can access private ImageSpace members (this is a
 // friend class), but not declare functions in the header.
 class ImageSpaceLoader {
@@ -837,7 +842,6 @@ class ImageSpaceLoader {
                                                      error_msg));
     if (map != nullptr) {
       const size_t stored_size = image_header.GetDataSize();
-      const size_t decompress_offset = sizeof(ImageHeader);  // Skip the header.
       std::unique_ptr<MemMap> temp_map(MemMap::MapFile(sizeof(ImageHeader) + stored_size,
                                                        PROT_READ,
                                                        MAP_PRIVATE,
@@ -851,33 +855,140 @@ class ImageSpaceLoader {
         return nullptr;
       }
       memcpy(map->Begin(), &image_header, sizeof(ImageHeader));
+      if (!ValidateImageBlocks(image_header, temp_map->Begin(), error_msg)) {
+        return nullptr;
+      }
       const uint64_t start = NanoTime();
-      // LZ4HC and LZ4 have same internal format, both use LZ4_decompress.
       TimingLogger::ScopedTiming timing2("LZ4 decompress image", &logger);
-      const size_t decompressed_size = LZ4_decompress_safe(
-          reinterpret_cast<char*>(temp_map->Begin()) + sizeof(ImageHeader),
-          reinterpret_cast<char*>(map->Begin()) + decompress_offset,
-          stored_size,
-          map->Size() - decompress_offset);
+      BlockDecompressor decompressor(image_header.GetBlocks(temp_map->Begin()),
+                                     map->Begin(),
+                                     temp_map->Begin());
+      if (!decompressor.Run(error_msg)) {
+        return nullptr;
+      }
       const uint64_t time = NanoTime() - start;
       // Add one 1 ns to prevent possible divide by 0.
       VLOG(image) << "Decompressing image took " << PrettyDuration(time) << " ("
                   << PrettySize(static_cast<uint64_t>(map->Size()) * MsToNs(1000) / (time + 1))
-                  << "/s)";
-      if (decompressed_size + sizeof(ImageHeader) != image_header.GetImageSize()) {
+                  << "/s, " << image_header.GetBlockCount() << " blocks)";
+    }
+
+    return map.release();
+  }
+
+  // Check that the blocks of a compressed image lie within the stored data and cover the image
+  // after the header in order.
+  static bool ValidateImageBlocks(const ImageHeader& image_header,
+                                  const uint8_t* image_data,
+                                  std::string* error_msg) {
+    const uint64_t data_end = sizeof(ImageHeader) + image_header.GetDataSize();
+    const uint64_t blocks_offset = image_header.GetBlocksOffset();
+    const uint64_t blocks_end =
+        blocks_offset + image_header.GetBlockCount() * sizeof(ImageHeader::Block);
+    if (image_header.GetBlockCount() == 0u ||
+        blocks_offset < sizeof(ImageHeader) ||
+        !IsAligned<alignof(ImageHeader::Block)>(blocks_offset) ||
+        blocks_end > data_end) {
+      if (error_msg != nullptr) {
+        *error_msg = StringPrintf("Invalid image block table offset %" PRIu64 " count %u",
+                                  blocks_offset,
+                                  image_header.GetBlockCount());
+      }
+      return false;
+    }
+    uint64_t image_offset = sizeof(ImageHeader);
+    for (const ImageHeader::Block& block : image_header.GetBlocks(image_data)) {
+      const uint64_t block_data_offset = block.GetDataOffset();
+      if (block.GetImageOffset() != image_offset ||
+          block_data_offset < sizeof(ImageHeader) ||
+          block_data_offset + block.GetDataSize() > blocks_offset) {
         if (error_msg != nullptr) {
-          *error_msg = StringPrintf(
-              "Decompressed size does not match expected image size %zu vs %zu",
-              decompressed_size + sizeof(ImageHeader),
-              image_header.GetImageSize());
+          *error_msg = StringPrintf("Invalid image block at image offset %u data offset %u",
+                                    block.GetImageOffset(),
+                                    block.GetDataOffset());
         }
-        return nullptr;
+        return false;
       }
+      image_offset += block.GetImageSize();
     }
-
-    return map.release();
+    if (image_offset != image_header.GetImageSize()) {
+      if (error_msg != nullptr) {
+        *error_msg = StringPrintf("Image blocks size does not match expected image size %" PRIu64
+                                  " vs %u",
+                                  image_offset,
+                                  image_header.GetImageSize());
+      }
+      return false;
+    }
+    return true;
   }
 
+  // Decompresses the blocks of a compressed image on the loading thread and a few helper
+  // threads. Images are loaded before the runtime can attach threads, so the helpers are plain
+  // pthreads that only touch the image data.
+  class BlockDecompressor {
+   public:
+    BlockDecompressor(ArrayRef<const ImageHeader::Block> blocks,
+                      uint8_t* out_ptr,
+                      const uint8_t* in_ptr)
+        : blocks_(blocks),
+          out_ptr_(out_ptr),
+          in_ptr_(in_ptr),
+          next_block_(0u),
+          failed_(false) {}
+
+    bool Run(std::string* error_msg) {
+      const size_t thread_count = std::min({
+          blocks_.size(),
+          kMaxImageDecompressionThreads,
+          static_cast<size_t>(std::max(sysconf(_SC_NPROCESSORS_CONF), 1L))});
+      std::vector<pthread_t> helpers(thread_count - 1u);
+      for (pthread_t& helper : helpers) {
+        CHECK_PTHREAD_CALL(pthread_create, (&helper, nullptr, &HelperCallback, this),
+                           "image decompression thread");
+      }
+      DecompressBlocks();
+      for (pthread_t& helper : helpers) {
+        CHECK_PTHREAD_CALL(pthread_join, (helper, nullptr), "image decompression thread");
+      }
+      if (failed_.LoadSequentiallyConsistent()) {
+        if (error_msg != nullptr) {
+          *error_msg = error_msg_;
+        }
+        return false;
+      }
+      return true;
+    }
+
+   private:
+    static void* HelperCallback(void* arg) {
+      reinterpret_cast<BlockDecompressor*>(arg)->DecompressBlocks();
+      return nullptr;
+    }
+
+    void DecompressBlocks() {
+      while (!failed_.LoadRelaxed()) {
+        const size_t index = next_block_.FetchAndAddRelaxed(1u);
+        if (index >= blocks_.size()) {
+          break;
+        }
+        std::string error_msg;
+        if (!blocks_[index].Decompress(out_ptr_, in_ptr_, &error_msg) &&
+            failed_.CompareAndSetStrongSequentiallyConsistent(false, true)) {
+          // Only the first failing thread records its message.
+          error_msg_ = error_msg;
+        }
+      }
+    }
+
+    const ArrayRef<const ImageHeader::Block> blocks_;
+    uint8_t* const out_ptr_;
+    const uint8_t* const in_ptr_;
+    Atomic<size_t> next_block_;
+    Atomic<bool> failed_;
+    std::string error_msg_;
+  };
+
   class FixupVisitor : public ValueObject {
    public:
     FixupVisitor(const RelocationRange& boot_image,
@@ -282,6 +282,8 @@ inline mirror::Object* RegionSpace::AllocLarge(size_t num_bytes,
       if (kForEvac) {
         ++num_evac_regions_;
       } else {
+        // Make sure sticky collections consider this large object young.
+        first_reg->SetNewlyAllocated();
         ++num_non_free_regions_;
       }
       size_t allocated = num_regs * kRegionSize;
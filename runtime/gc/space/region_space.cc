@@ -156,14 +156,22 @@ size_t RegionSpace::ToSpaceSize() {
   return num_regions * kRegionSize;
 }
 
-inline bool RegionSpace::Region::ShouldBeEvacuated() {
+inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
   DCHECK((IsAllocated() || IsLarge()) && IsInToSpace());
   // The region should be evacuated if:
-  // - the region was allocated after the start of the previous GC (newly allocated region); or
-  // - the live ratio is below threshold (`kEvacuateLivePercentThreshold`).
+  // - the evacuation is forced (`evac_mode == kEvacModeForceAll`); or
+  // - the region was allocated after the start of the previous GC (newly allocated region),
+  //   large regions excepted; or
+  // - the live ratio is below threshold (`kEvacuateLivePercentThreshold`), unless this is a
+  //   sticky collection (`evac_mode == kEvacModeNewlyAllocated`).
+  if (UNLIKELY(evac_mode == EvacMode::kEvacModeForceAll)) {
+    return true;
+  }
   bool result;
-  if (is_newly_allocated_) {
+  if (is_newly_allocated_ && !IsLarge()) {
     result = true;
+  } else if (evac_mode == EvacMode::kEvacModeNewlyAllocated) {
+    result = false;
   } else {
     bool is_live_percent_valid = (live_bytes_ != static_cast<size_t>(-1));
     if (is_live_percent_valid) {
@@ -191,7 +199,7 @@ inline bool RegionSpace::Region::ShouldBeEvacuated() {
 
 // Determine which regions to evacuate and mark them as
 // from-space. Mark the rest as unevacuated from-space.
-void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all) {
+void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, EvacMode evac_mode) {
   ++time_;
   if (kUseTableLookupReadBarrier) {
     DCHECK(rb_table->IsAllCleared());
@@ -217,12 +225,16 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = force_evacuate_all || r->ShouldBeEvacuated();
+        bool should_evacuate = r->ShouldBeEvacuated(evac_mode);
         if (should_evacuate) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
         } else {
-          r->SetAsUnevacFromSpace();
+          // A sticky collection only marks the objects of regions allocated since the last GC,
+          // so the live bytes of older regions must be preserved.
+          bool clear_live_bytes =
+              evac_mode != EvacMode::kEvacModeNewlyAllocated || r->IsNewlyAllocated();
+          r->SetAsUnevacFromSpace(clear_live_bytes);
           DCHECK(r->IsInUnevacFromSpace());
         }
         if (UNLIKELY(state == RegionState::kRegionStateLarge &&
@@ -238,7 +250,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
         } else {
-          r->SetAsUnevacFromSpace();
+          r->SetAsUnevacFromSpace(/*clear_live_bytes*/ true);
           DCHECK(r->IsInUnevacFromSpace());
         }
         --num_expected_large_tails;
@@ -264,7 +276,8 @@ static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end) {
 }
 
 void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
-                                 /* out */ uint64_t* cleared_objects) {
+                                 /* out */ uint64_t* cleared_objects,
+                                 bool clear_bitmap) {
   DCHECK(cleared_bytes != nullptr);
   DCHECK(cleared_objects != nullptr);
   *cleared_bytes = 0;
@@ -362,9 +375,13 @@ void RegionSpace::ClearFromSpace(/* out */ uint64_t* cleared_bytes,
         //   live bits (see RegionSpace::WalkInternal).
         // Therefore, we can clear the bits for these objects in the
         // (live) region space bitmap (and release the corresponding pages).
-        GetLiveBitmap()->ClearRange(
-            reinterpret_cast<mirror::Object*>(r->Begin()),
-            reinterpret_cast<mirror::Object*>(r->Begin() + regions_to_clear_bitmap * kRegionSize));
+        // Generational collections keep these bits to identify old objects.
+        if (clear_bitmap) {
+          GetLiveBitmap()->ClearRange(
+              reinterpret_cast<mirror::Object*>(r->Begin()),
+              reinterpret_cast<mirror::Object*>(
+                  r->Begin() + regions_to_clear_bitmap * kRegionSize));
+        }
         // Skip over extra regions for which we cleared the bitmaps: we shall not clear them,
         // as they are unevac regions that are live.
         // Subtract one for the for-loop.
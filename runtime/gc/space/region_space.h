@@ -130,6 +130,16 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     kRegionTypeNone,             // None.
   };
 
+  // How RegionSpace::SetFromSpace selects the regions to evacuate.
+  enum class EvacMode {
+    // Evacuate only newly allocated (non-large) regions. Used by sticky (young) collections.
+    kEvacModeNewlyAllocated,
+    // Evacuate newly allocated regions and regions whose live ratio is below threshold.
+    kEvacModeLivePercentNewlyAllocated,
+    // Evacuate all regions.
+    kEvacModeForceAll,
+  };
+
   enum class RegionState : uint8_t {
     kRegionStateFree,            // Free region.
     kRegionStateAllocated,       // Allocated region.
@@ -163,6 +173,10 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   size_t GetNumRegions() const {
     return num_regions_;
   }
+  size_t GetNumNonFreeRegions() REQUIRES(!region_lock_) {
+    MutexLock mu(Thread::Current(), region_lock_);
+    return num_non_free_regions_;
+  }
 
   bool CanMoveObjects() const OVERRIDE {
     return true;
@@ -250,13 +264,19 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
 
   // Determine which regions to evacuate and tag them as
   // from-space. Tag the rest as unevacuated from-space.
-  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all)
+  void SetFromSpace(accounting::ReadBarrierTable* rb_table, EvacMode evac_mode)
       REQUIRES(!region_lock_);
 
   size_t FromSpaceSize() REQUIRES(!region_lock_);
   size_t UnevacFromSpaceSize() REQUIRES(!region_lock_);
   size_t ToSpaceSize() REQUIRES(!region_lock_);
-  void ClearFromSpace(/* out */ uint64_t* cleared_bytes, /* out */ uint64_t* cleared_objects)
+  // Reclaim the from-space regions and the unevacuated regions without live objects. If
+  // `clear_bitmap` is false, the live bits of the surviving unevacuated regions are kept even
+  // when all their objects are live; generational collections rely on them to tell old objects
+  // apart.
+  void ClearFromSpace(/* out */ uint64_t* cleared_bytes,
+                      /* out */ uint64_t* cleared_objects,
+                      bool clear_bitmap)
       REQUIRES(!region_lock_);
 
   void AddLiveBytes(mirror::Object* ref, size_t alloc_size) {
@@ -264,6 +284,12 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     reg->AddLiveBytes(alloc_size);
   }
 
+  // Same as AddLiveBytes() but safe to call from several marking threads at once.
+  void AtomicAddLiveBytes(mirror::Object* ref, size_t alloc_size) {
+    Region* reg = RefToRegionUnlocked(ref);
+    reg->AtomicAddLiveBytes(alloc_size);
+  }
+
   void AssertAllRegionLiveBytesZeroOrCleared() REQUIRES(!region_lock_) {
     if (kIsDebugBuild) {
       MutexLock mu(Thread::Current(), region_lock_);
@@ -417,11 +443,15 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     // Set this region as unevacuated from-space. At the end of the
     // collection, RegionSpace::ClearFromSpace will preserve the space
     // used by this region, and tag it as to-space (see
-    // Region::SetUnevacFromSpaceAsToSpace below).
-    void SetAsUnevacFromSpace() {
+    // Region::SetUnevacFromSpaceAsToSpace below). Sticky collections
+    // do not mark old objects again, so they keep the live bytes of
+    // old regions by passing `clear_live_bytes` = false.
+    void SetAsUnevacFromSpace(bool clear_live_bytes) {
       DCHECK(!IsFree() && IsInToSpace());
       type_ = RegionType::kRegionTypeUnevacFromSpace;
-      live_bytes_ = 0U;
+      if (clear_live_bytes) {
+        live_bytes_ = 0U;
+      }
     }
 
     // Set this region as to-space. Used by RegionSpace::ClearFromSpace.
@@ -429,10 +459,11 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     void SetUnevacFromSpaceAsToSpace() {
       DCHECK(!IsFree() && IsInUnevacFromSpace());
       type_ = RegionType::kRegionTypeToSpace;
+      is_newly_allocated_ = false;
     }
 
     // Return whether this region should be evacuated. Used by RegionSpace::SetFromSpace.
-    ALWAYS_INLINE bool ShouldBeEvacuated();
+    ALWAYS_INLINE bool ShouldBeEvacuated(EvacMode evac_mode);
 
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(IsInUnevacFromSpace());
@@ -444,6 +475,14 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       DCHECK_LE(live_bytes_, BytesAllocated());
     }
 
+    void AtomicAddLiveBytes(size_t live_bytes) {
+      DCHECK(IsInUnevacFromSpace());
+      DCHECK(!IsLargeTail());
+      DCHECK_NE(live_bytes_, static_cast<size_t>(-1));
+      reinterpret_cast<Atomic<size_t>*>(&live_bytes_)->FetchAndAddRelaxed(
+          IsLarge() ? Top() - begin_ : live_bytes);
+    }
+
     bool AllAllocatedBytesAreLive() const {
       return LiveBytes() == static_cast<size_t>(Top() - Begin());
     }
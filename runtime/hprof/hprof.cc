@@ -15,11 +15,11 @@
  */
 
 /*
- * Preparation and completion of hprof data generation.  The output is
- * written into two files and then combined.  This is necessary because
- * we generate some of the data (strings and classes) while we dump the
- * heap, and some analysis tools require that the class and string data
- * appear first.
+ * Preparation and completion of hprof data generation.  The heap is walked
+ * once and the output is streamed through a fixed-size buffer.  Strings and
+ * classes are generated while we dump the heap, and some analysis tools
+ * require that the class and string data appear first, so their records are
+ * emitted just ahead of the first record that refers to them.
  */
 
 #include "hprof.h"
@@ -80,6 +80,10 @@ static constexpr uint32_t kHprofNullThread = 0;
 static constexpr size_t kMaxObjectsPerSegment = 128;
 static constexpr size_t kMaxBytesPerSegment = 4096;
 
+// Size of the buffer the dump is streamed through. Records larger than this (huge arrays) are
+// written in pieces, and their length is patched once they are complete.
+static constexpr size_t kStreamBufferSize = 1 * MB;
+
 // The static field-name for the synthetic object generated to account for class static overhead.
 static constexpr const char* kClassOverheadName = "$classOverhead";
 
@@ -388,11 +392,211 @@ class EndianOutputBuffered : public EndianOutput {
   std::vector<uint8_t> buffer_;
 };
 
-class FileEndianOutput FINAL : public EndianOutputBuffered {
+// Collects complete records, e.g. the strings and classes that the heap walk discovers.
+class VectorEndianOuputput FINAL : public EndianOutputBuffered {
+ public:
+  VectorEndianOuputput(std::vector<uint8_t>& data, size_t reserved_size)
+      : EndianOutputBuffered(reserved_size), full_data_(data) {}
+  ~VectorEndianOuputput() {}
+
+ protected:
+  void HandleFlush(const uint8_t* buf, size_t length) OVERRIDE {
+    size_t old_size = full_data_.size();
+    full_data_.resize(old_size + length);
+    memcpy(full_data_.data() + old_size, buf, length);
+  }
+
+ private:
+  std::vector<uint8_t>& full_data_;
+};
+
+// This keeps data in a fixed-size buffer and hands it out in large chunks, so that the memory
+// needed does not grow with the size of the dump. Complete records found in `pending_records`
+// when a record ends are emitted in front of it. This lets the heap walk register strings and
+// classes while it writes a record that refers to them. A record that outgrows the buffer is
+// handed out in pieces and its length is patched afterwards, when the sink supports that.
+class EndianOutputStreamed : public EndianOutput {
+ public:
+  EndianOutputStreamed(size_t buffer_size, std::vector<uint8_t>* pending_records)
+      : buffer_(buffer_size),
+        pos_(0u),
+        record_start_(0u),
+        record_spilled_(false),
+        record_stream_offset_(0u),
+        record_flushed_bytes_(0u),
+        stream_length_(0u),
+        pending_records_(pending_records) {}
+  virtual ~EndianOutputStreamed() {}
+
+  void UpdateU4(size_t offset, uint32_t new_value) OVERRIDE {
+    DCHECK_LE(offset, length_ - 4);
+    const uint8_t bytes[] = {
+        static_cast<uint8_t>((new_value >> 24) & 0xFF),
+        static_cast<uint8_t>((new_value >> 16) & 0xFF),
+        static_cast<uint8_t>((new_value >> 8)  & 0xFF),
+        static_cast<uint8_t>((new_value >> 0)  & 0xFF),
+    };
+    if (!record_spilled_) {
+      memcpy(buffer_.data() + record_start_ + offset, bytes, sizeof(bytes));
+    } else {
+      // Only the record header is patched, and it has been handed out with the first piece.
+      DCHECK_LE(offset + sizeof(bytes), record_flushed_bytes_);
+      HandlePatch(record_stream_offset_ + offset, bytes, sizeof(bytes));
+    }
+  }
+
+  // Hands out all buffered data. Called once the last record has ended.
+  void Flush() {
+    DCHECK_EQ(length_, 0U);
+    Emit(buffer_.data(), pos_);
+    pos_ = 0u;
+    record_start_ = 0u;
+    EmitPendingRecords();
+  }
+
+  // Number of bytes handed out so far, including the pending records.
+  size_t StreamLength() const {
+    return stream_length_;
+  }
+
+ protected:
+  void HandleU1List(const uint8_t* values, size_t count) OVERRIDE {
+    while (count != 0u) {
+      if (pos_ == buffer_.size()) {
+        MakeRoom(1u);
+      }
+      size_t chunk = std::min(count, buffer_.size() - pos_);
+      memcpy(buffer_.data() + pos_, values, chunk);
+      pos_ += chunk;
+      values += chunk;
+      count -= chunk;
+    }
+  }
+
+  void HandleU2List(const uint16_t* values, size_t count) OVERRIDE {
+    for (size_t i = 0; i < count; ++i) {
+      uint16_t value = values[i];
+      uint8_t* out = Reserve(sizeof(uint16_t));
+      out[0] = static_cast<uint8_t>((value >> 8) & 0xFF);
+      out[1] = static_cast<uint8_t>((value >> 0) & 0xFF);
+    }
+  }
+
+  void HandleU4List(const uint32_t* values, size_t count) OVERRIDE {
+    for (size_t i = 0; i < count; ++i) {
+      uint32_t value = values[i];
+      uint8_t* out = Reserve(sizeof(uint32_t));
+      out[0] = static_cast<uint8_t>((value >> 24) & 0xFF);
+      out[1] = static_cast<uint8_t>((value >> 16) & 0xFF);
+      out[2] = static_cast<uint8_t>((value >> 8)  & 0xFF);
+      out[3] = static_cast<uint8_t>((value >> 0)  & 0xFF);
+    }
+  }
+
+  void HandleU8List(const uint64_t* values, size_t count) OVERRIDE {
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t value = values[i];
+      uint8_t* out = Reserve(sizeof(uint64_t));
+      out[0] = static_cast<uint8_t>((value >> 56) & 0xFF);
+      out[1] = static_cast<uint8_t>((value >> 48) & 0xFF);
+      out[2] = static_cast<uint8_t>((value >> 40) & 0xFF);
+      out[3] = static_cast<uint8_t>((value >> 32) & 0xFF);
+      out[4] = static_cast<uint8_t>((value >> 24) & 0xFF);
+      out[5] = static_cast<uint8_t>((value >> 16) & 0xFF);
+      out[6] = static_cast<uint8_t>((value >> 8)  & 0xFF);
+      out[7] = static_cast<uint8_t>((value >> 0)  & 0xFF);
+    }
+  }
+
+  void HandleEndRecord() OVERRIDE {
+    if (record_spilled_) {
+      // The pending records went out in front of the first piece of this record.
+      record_spilled_ = false;
+    } else if (pending_records_ != nullptr && !pending_records_->empty()) {
+      Emit(buffer_.data(), record_start_);
+      EmitPendingRecords();
+      pos_ -= record_start_;
+      memmove(buffer_.data(), buffer_.data() + record_start_, pos_);
+    }
+    record_start_ = pos_;
+  }
+
+  // Whether data that has been handed out can still be changed through HandlePatch().
+  virtual bool CanPatch() const = 0;
+  virtual void HandleFlush(const uint8_t* buffer, size_t length) = 0;
+  virtual void HandlePatch(size_t stream_offset, const uint8_t* bytes, size_t length) = 0;
+
+ private:
+  uint8_t* Reserve(size_t bytes) {
+    if (buffer_.size() - pos_ < bytes) {
+      MakeRoom(bytes);
+    }
+    uint8_t* out = buffer_.data() + pos_;
+    pos_ += bytes;
+    return out;
+  }
+
+  void MakeRoom(size_t bytes) {
+    if (!record_spilled_ && record_start_ != 0u) {
+      // Hand out the complete records and move the current one to the front.
+      Emit(buffer_.data(), record_start_);
+      pos_ -= record_start_;
+      memmove(buffer_.data(), buffer_.data() + record_start_, pos_);
+      record_start_ = 0u;
+      if (buffer_.size() - pos_ >= bytes) {
+        return;
+      }
+    }
+    if (CanPatch()) {
+      if (!record_spilled_) {
+        EmitPendingRecords();
+        record_stream_offset_ = stream_length_;
+        record_flushed_bytes_ = 0u;
+        record_spilled_ = true;
+      }
+      Emit(buffer_.data(), pos_);
+      record_flushed_bytes_ += pos_;
+      pos_ = 0u;
+    } else {
+      // The record length could not be patched once handed out, so keep the whole record.
+      buffer_.resize(std::max(2 * buffer_.size(), pos_ + bytes));
+    }
+  }
+
+  void Emit(const uint8_t* data, size_t length) {
+    if (length != 0u) {
+      HandleFlush(data, length);
+      stream_length_ += length;
+    }
+  }
+
+  void EmitPendingRecords() {
+    if (pending_records_ != nullptr && !pending_records_->empty()) {
+      Emit(pending_records_->data(), pending_records_->size());
+      pending_records_->clear();
+    }
+  }
+
+  std::vector<uint8_t> buffer_;
+  size_t pos_;                    // Bytes used in buffer_.
+  size_t record_start_;           // Offset of the current record in buffer_, if not spilled.
+  bool record_spilled_;           // Has a piece of the current record been handed out?
+  size_t record_stream_offset_;   // Stream offset of the current record, if spilled.
+  size_t record_flushed_bytes_;   // Bytes of the current record handed out, if spilled.
+  size_t stream_length_;          // Bytes handed out so far.
+  std::vector<uint8_t>* pending_records_;
+};
+
+class FileEndianOutput FINAL : public EndianOutputStreamed {
  public:
-  FileEndianOutput(File* fp, size_t reserved_size)
-      : EndianOutputBuffered(reserved_size), fp_(fp), errors_(false) {
+  FileEndianOutput(File* fp, size_t buffer_size, std::vector<uint8_t>* pending_records)
+      : EndianOutputStreamed(buffer_size, pending_records),
+        fp_(fp),
+        start_offset_(-1),
+        errors_(false) {
     DCHECK(fp != nullptr);
+    // Records are patched with pwrite(), which is not available for pipes and sockets.
+    start_offset_ = lseek(fp->Fd(), 0, SEEK_CUR);
   }
   ~FileEndianOutput() {
   }
@@ -402,28 +606,49 @@ class FileEndianOutput FINAL : public EndianOutputBuffered {
   }
 
  protected:
+  bool CanPatch() const OVERRIDE {
+    return start_offset_ >= 0;
+  }
+
   void HandleFlush(const uint8_t* buffer, size_t length) OVERRIDE {
     if (!errors_) {
       errors_ = !fp_->WriteFully(buffer, length);
     }
   }
 
+  void HandlePatch(size_t stream_offset, const uint8_t* bytes, size_t length) OVERRIDE {
+    if (!errors_) {
+      errors_ = !fp_->PwriteFully(bytes, length, start_offset_ + stream_offset);
+    }
+  }
+
  private:
   File* fp_;
+  off_t start_offset_;
   bool errors_;
 };
 
-class VectorEndianOuputput FINAL : public EndianOutputBuffered {
+// DDMS takes the whole dump as a single chunk, so this collects the stream in memory.
+class DdmsEndianOutput FINAL : public EndianOutputStreamed {
  public:
-  VectorEndianOuputput(std::vector<uint8_t>& data, size_t reserved_size)
-      : EndianOutputBuffered(reserved_size), full_data_(data) {}
-  ~VectorEndianOuputput() {}
+  DdmsEndianOutput(std::vector<uint8_t>& data,
+                   size_t buffer_size,
+                   std::vector<uint8_t>* pending_records)
+      : EndianOutputStreamed(buffer_size, pending_records), full_data_(data) {}
+  ~DdmsEndianOutput() {}
 
  protected:
-  void HandleFlush(const uint8_t* buf, size_t length) OVERRIDE {
-    size_t old_size = full_data_.size();
-    full_data_.resize(old_size + length);
-    memcpy(full_data_.data() + old_size, buf, length);
+  bool CanPatch() const OVERRIDE {
+    return true;
+  }
+
+  void HandleFlush(const uint8_t* buffer, size_t length) OVERRIDE {
+    full_data_.insert(full_data_.end(), buffer, buffer + length);
+  }
+
+  void HandlePatch(size_t stream_offset, const uint8_t* bytes, size_t length) OVERRIDE {
+    DCHECK_LE(stream_offset + length, full_data_.size());
+    memcpy(full_data_.data() + stream_offset, bytes, length);
   }
 
  private:
@@ -451,33 +676,20 @@ class Hprof : public SingleRootVisitor {
       }
     }
 
-    // First pass to measure the size of the dump.
-    size_t overall_size;
-    size_t max_length;
-    {
-      EndianOutput count_output;
-      output_ = &count_output;
-      ProcessHeap(false);
-      overall_size = count_output.SumLength();
-      max_length = count_output.MaxLength();
-      output_ = nullptr;
-    }
-
     bool okay;
-    visited_objects_.clear();
     if (direct_to_ddms_) {
       if (kDirectStream) {
-        okay = DumpToDdmsDirect(overall_size, max_length, CHUNK_TYPE("HPDS"));
+        okay = DumpToDdmsDirect(CHUNK_TYPE("HPDS"));
       } else {
-        okay = DumpToDdmsBuffered(overall_size, max_length);
+        okay = DumpToDdmsBuffered();
       }
     } else {
-      okay = DumpToFile(overall_size, max_length);
+      okay = DumpToFile();
     }
 
     if (okay) {
       const uint64_t duration = NanoTime() - start_ns_;
-      LOG(INFO) << "hprof: heap dump completed (" << PrettySize(RoundUp(overall_size, KB))
+      LOG(INFO) << "hprof: heap dump completed (" << PrettySize(RoundUp(dump_size_, KB))
                 << ") in " << PrettyDuration(duration)
                 << " objects " << total_objects_
                 << " objects with stack traces " << total_objects_with_stack_trace_;
@@ -504,19 +716,14 @@ class Hprof : public SingleRootVisitor {
 
   bool AddRuntimeInternalObjectsField(mirror::Class* klass) REQUIRES_SHARED(Locks::mutator_lock_);
 
-  void ProcessHeap(bool header_first)
+  void ProcessHeap()
       REQUIRES(Locks::mutator_lock_) {
     // Reset current heap and object count.
     current_heap_ = HPROF_HEAP_DEFAULT;
     objects_in_segment_ = 0;
 
-    if (header_first) {
-      ProcessHeader(true);
-      ProcessBody();
-    } else {
-      ProcessBody();
-      ProcessHeader(false);
-    }
+    ProcessHeader();
+    ProcessBody();
   }
 
   void ProcessBody() REQUIRES(Locks::mutator_lock_) {
@@ -536,57 +743,12 @@ class Hprof : public SingleRootVisitor {
     output_->EndRecord();
   }
 
-  void ProcessHeader(bool string_first) REQUIRES(Locks::mutator_lock_) {
+  void ProcessHeader() REQUIRES(Locks::mutator_lock_) {
     // Write the header.
     WriteFixedHeader();
-    // Write the string and class tables, and any stack traces, to the header.
-    // (jhat requires that these appear before any of the data in the body that refers to them.)
-    // jhat also requires the string table appear before class table and stack traces.
-    // However, WriteStackTraces() can modify the string table, so it's necessary to call
-    // WriteStringTable() last in the first pass, to compute the correct length of the output.
-    if (string_first) {
-      WriteStringTable();
-    }
-    WriteClassTable();
+    // Write any stack traces. The strings and classes they refer to are written ahead of them
+    // by LookupStringId() and LookupClassId(), as jhat requires.
     WriteStackTraces();
-    if (!string_first) {
-      WriteStringTable();
-    }
-    output_->EndRecord();
-  }
-
-  void WriteClassTable() REQUIRES_SHARED(Locks::mutator_lock_) {
-    for (const auto& p : classes_) {
-      mirror::Class* c = p.first;
-      HprofClassSerialNumber sn = p.second;
-      CHECK(c != nullptr);
-      output_->StartNewRecord(HPROF_TAG_LOAD_CLASS, kHprofTime);
-      // LOAD CLASS format:
-      // U4: class serial number (always > 0)
-      // ID: class object ID. We use the address of the class object structure as its ID.
-      // U4: stack trace serial number
-      // ID: class name string ID
-      __ AddU4(sn);
-      __ AddObjectId(c);
-      __ AddStackTraceSerialNumber(LookupStackTraceSerialNumber(c));
-      __ AddStringId(LookupClassNameId(c));
-    }
-  }
-
-  void WriteStringTable() {
-    for (const auto& p : strings_) {
-      const std::string& string = p.first;
-      const HprofStringId id = p.second;
-
-      output_->StartNewRecord(HPROF_TAG_STRING, kHprofTime);
-
-      // STRING format:
-      // ID:  ID for this string
-      // U1*: UTF8 characters for string (NOT null terminated)
-      //      (the record format encodes the length)
-      __ AddU4(id);
-      __ AddUtf8String(string.c_str());
-    }
   }
 
   void StartNewHeapDumpSegment() {
@@ -616,7 +778,18 @@ class Hprof : public SingleRootVisitor {
         HprofClassSerialNumber sn = next_class_serial_number_++;
         classes_.Put(c, sn);
         // Make sure that we've assigned a string ID for this class' name
-        LookupClassNameId(c);
+        HprofStringId name_id = LookupClassNameId(c);
+        // LOAD CLASS format:
+        // U4: class serial number (always > 0)
+        // ID: class object ID. We use the address of the class object structure as its ID.
+        // U4: stack trace serial number
+        // ID: class name string ID
+        pending_output_.StartNewRecord(HPROF_TAG_LOAD_CLASS, kHprofTime);
+        pending_output_.AddU4(sn);
+        pending_output_.AddObjectId(c);
+        pending_output_.AddStackTraceSerialNumber(LookupStackTraceSerialNumber(c));
+        pending_output_.AddStringId(name_id);
+        pending_output_.EndRecord();
       }
     }
     return PointerToLowMemUInt32(c);
@@ -650,6 +823,14 @@ class Hprof : public SingleRootVisitor {
     }
     HprofStringId id = next_string_id_++;
     strings_.Put(string, id);
+    // STRING format:
+    // ID:  ID for this string
+    // U1*: UTF8 characters for string (NOT null terminated)
+    //      (the record format encodes the length)
+    pending_output_.StartNewRecord(HPROF_TAG_STRING, kHprofTime);
+    pending_output_.AddU4(id);
+    pending_output_.AddUtf8String(string.c_str());
+    pending_output_.EndRecord();
     return id;
   }
 
@@ -718,9 +899,9 @@ class Hprof : public SingleRootVisitor {
           source_file = "";
         }
         __ AddStringId(LookupStringId(source_file));
-        auto class_result = classes_.find(method->GetDeclaringClass());
-        CHECK(class_result != classes_.end());
-        __ AddU4(class_result->second);
+        mirror::Class* declaring_class = method->GetDeclaringClass();
+        LookupClassId(declaring_class);
+        __ AddU4(classes_.Get(declaring_class));
         __ AddU4(frame->ComputeLineNumber());
       }
 
@@ -743,7 +924,7 @@ class Hprof : public SingleRootVisitor {
     }
   }
 
-  bool DumpToDdmsBuffered(size_t overall_size ATTRIBUTE_UNUSED, size_t max_length ATTRIBUTE_UNUSED)
+  bool DumpToDdmsBuffered()
       REQUIRES(Locks::mutator_lock_) {
     LOG(FATAL) << "Unimplemented";
     UNREACHABLE();
@@ -756,7 +937,7 @@ class Hprof : public SingleRootVisitor {
     //        Dbg::DdmSendChunkV(CHUNK_TYPE("HPDS"), iov, 2);
   }
 
-  bool DumpToFile(size_t overall_size, size_t max_length)
+  bool DumpToFile()
       REQUIRES(Locks::mutator_lock_) {
     // Where exactly are we writing to?
     int out_fd;
@@ -778,16 +959,12 @@ class Hprof : public SingleRootVisitor {
     std::unique_ptr<File> file(new File(out_fd, filename_, true));
     bool okay;
     {
-      FileEndianOutput file_output(file.get(), max_length);
+      FileEndianOutput file_output(file.get(), kStreamBufferSize, &pending_records_);
       output_ = &file_output;
-      ProcessHeap(true);
+      ProcessHeap();
+      file_output.Flush();
       okay = !file_output.Errors();
-
-      if (okay) {
-        // Check for expected size. Output is expected to be less-or-equal than first phase, see
-        // b/23521263.
-        DCHECK_LE(file_output.SumLength(), overall_size);
-      }
+      dump_size_ = file_output.StreamLength();
       output_ = nullptr;
     }
 
@@ -807,26 +984,28 @@ class Hprof : public SingleRootVisitor {
     return okay;
   }
 
-  bool DumpToDdmsDirect(size_t overall_size, size_t max_length, uint32_t chunk_type)
+  bool DumpToDdmsDirect(uint32_t chunk_type)
       REQUIRES(Locks::mutator_lock_) {
     CHECK(direct_to_ddms_);
 
+    // The dump is about as large as the allocated heap; reserve that much up front so that the
+    // vector is rarely copied while it grows.
     std::vector<uint8_t> out_data;
+    out_data.reserve(Runtime::Current()->GetHeap()->GetBytesAllocated());
 
     // TODO It would be really good to have some streaming thing again. b/73084059
-    VectorEndianOuputput output(out_data, max_length);
+    DdmsEndianOutput output(out_data, kStreamBufferSize, &pending_records_);
     output_ = &output;
 
     // Write the dump.
-    ProcessHeap(true);
+    ProcessHeap();
+    output.Flush();
+    dump_size_ = output.StreamLength();
+    output_ = nullptr;
 
     Runtime::Current()->GetRuntimeCallbacks()->DdmPublishChunk(
         chunk_type, ArrayRef<const uint8_t>(out_data.data(), out_data.size()));
 
-    // Check for expected size. See DumpToFile for comment.
-    DCHECK_LE(output.SumLength(), overall_size);
-    output_ = nullptr;
-
     return true;
   }
 
@@ -881,6 +1060,12 @@ class Hprof : public SingleRootVisitor {
 
   EndianOutput* output_ = nullptr;
 
+  // STRING and LOAD_CLASS records that still have to be written ahead of the current record.
+  std::vector<uint8_t> pending_records_;
+  VectorEndianOuputput pending_output_{pending_records_, 64u};
+
+  size_t dump_size_ = 0u;
+
   HprofHeapId current_heap_ = HPROF_HEAP_DEFAULT;  // Which heap we're currently dumping.
   size_t objects_in_segment_ = 0;
 
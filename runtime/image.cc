@@ -16,6 +16,10 @@
 
 #include "image.h"
 
+#include <lz4.h>
+
+#include "android-base/stringprintf.h"
+
 #include "base/bit_utils.h"
 #include "base/length_prefixed_array.h"
 #include "base/utils.h"
@@ -25,8 +29,10 @@
 
 namespace art {
 
+using android::base::StringPrintf;
+
 const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-const uint8_t ImageHeader::kImageVersion[] = { '0', '5', '6', '\0' };  // ReachabilityFence.
+const uint8_t ImageHeader::kImageVersion[] = { '0', '5', '7', '\0' };  // Compressed image blocks.
 
 ImageHeader::ImageHeader(uint32_t image_begin,
                          uint32_t image_size,
@@ -63,7 +69,9 @@ ImageHeader::ImageHeader(uint32_t image_begin,
     compile_pic_(compile_pic),
     is_pic_(is_pic),
     storage_mode_(storage_mode),
-    data_size_(data_size) {
+    data_size_(data_size),
+    blocks_offset_(0U),
+    blocks_count_(0U) {
   CHECK_EQ(image_begin, RoundUp(image_begin, kPageSize));
   CHECK_EQ(oat_file_begin, RoundUp(oat_file_begin, kPageSize));
   CHECK_EQ(oat_data_begin, RoundUp(oat_data_begin, kPageSize));
@@ -140,6 +148,55 @@ void ImageHeader::SetImageMethod(ImageMethod index, ArtMethod* method) {
   image_methods_[index] = reinterpret_cast<uint64_t>(method);
 }
 
+bool ImageHeader::Block::Decompress(uint8_t* out_ptr,
+                                    const uint8_t* in_ptr,
+                                    std::string* error_msg) const {
+  switch (storage_mode_) {
+    case kStorageModeUncompressed: {
+      if (image_size_ != data_size_) {
+        if (error_msg != nullptr) {
+          *error_msg = StringPrintf(
+              "Uncompressed block size does not match expected block size %u vs %u at offset %u",
+              data_size_,
+              image_size_,
+              image_offset_);
+        }
+        return false;
+      }
+      memcpy(out_ptr + image_offset_, in_ptr + data_offset_, data_size_);
+      break;
+    }
+    case kStorageModeLZ4:
+    case kStorageModeLZ4HC: {
+      // LZ4HC and LZ4 have same internal format, both use LZ4_decompress.
+      const int decompressed_size = LZ4_decompress_safe(
+          reinterpret_cast<const char*>(in_ptr) + data_offset_,
+          reinterpret_cast<char*>(out_ptr) + image_offset_,
+          data_size_,
+          image_size_);
+      if (decompressed_size < 0 || static_cast<uint32_t>(decompressed_size) != image_size_) {
+        if (error_msg != nullptr) {
+          *error_msg = StringPrintf(
+              "Decompressed size does not match expected block size %d vs %u at offset %u",
+              decompressed_size,
+              image_size_,
+              image_offset_);
+        }
+        return false;
+      }
+      break;
+    }
+    default: {
+      if (error_msg != nullptr) {
+        *error_msg = StringPrintf("Invalid storage mode in image block %d",
+                                  static_cast<int>(storage_mode_));
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
 std::ostream& operator<<(std::ostream& os, const ImageSection& section) {
   return os << "size=" << section.Size() << " range=" << section.Offset() << "-" << section.End();
 }
@@ -19,6 +19,7 @@
 
 #include <string.h>
 
+#include "base/array_ref.h"
 #include "base/bit_utils.h"
 #include "base/enums.h"
 #include "globals.h"
@@ -93,6 +94,57 @@ class PACKED(4) ImageHeader {
   };
   static constexpr StorageMode kDefaultStorageMode = kStorageModeUncompressed;
 
+  // Compressed images are split into blocks that can be decompressed independently of each
+  // other. The block table is stored in the image file after the compressed blocks.
+  class Block final {
+   public:
+    Block(StorageMode storage_mode,
+          uint32_t data_offset,
+          uint32_t data_size,
+          uint32_t image_offset,
+          uint32_t image_size)
+        : storage_mode_(storage_mode),
+          data_offset_(data_offset),
+          data_size_(data_size),
+          image_offset_(image_offset),
+          image_size_(image_size) {}
+
+    // Decompress the block from the image file data `in_ptr` into the image at `out_ptr`.
+    bool Decompress(uint8_t* out_ptr, const uint8_t* in_ptr, std::string* error_msg) const;
+
+    StorageMode GetStorageMode() const {
+      return storage_mode_;
+    }
+
+    uint32_t GetDataOffset() const {
+      return data_offset_;
+    }
+
+    uint32_t GetDataSize() const {
+      return data_size_;
+    }
+
+    uint32_t GetImageOffset() const {
+      return image_offset_;
+    }
+
+    uint32_t GetImageSize() const {
+      return image_size_;
+    }
+
+   private:
+    // Storage method for the block data.
+    StorageMode storage_mode_;
+
+    // Offset and size of the block data in the image file.
+    uint32_t data_offset_;
+    uint32_t data_size_;
+
+    // Offset and size of the decompressed block in the image.
+    uint32_t image_offset_;
+    uint32_t image_size_;
+  };
+
   ImageHeader()
       : image_begin_(0U),
         image_size_(0U),
@@ -111,7 +163,9 @@ class PACKED(4) ImageHeader {
         compile_pic_(0),
         is_pic_(0),
         storage_mode_(kDefaultStorageMode),
-        data_size_(0) {}
+        data_size_(0),
+        blocks_offset_(0U),
+        blocks_count_(0U) {}
 
   ImageHeader(uint32_t image_begin,
               uint32_t image_size,
@@ -321,6 +375,20 @@ class PACKED(4) ImageHeader {
     return data_size_;
   }
 
+  uint32_t GetBlocksOffset() const {
+    return blocks_offset_;
+  }
+
+  uint32_t GetBlockCount() const {
+    return blocks_count_;
+  }
+
+  // Return the block table of a compressed image. `image_data` is the start of the image file.
+  ArrayRef<const Block> GetBlocks(const uint8_t* image_data) const {
+    const Block* begin = reinterpret_cast<const Block*>(image_data + blocks_offset_);
+    return ArrayRef<const Block>(begin, blocks_count_);
+  }
+
   bool IsAppImage() const {
     // App images currently require a boot image, if the size is non zero then it is an app image
     // header.
@@ -447,9 +515,14 @@ class PACKED(4) ImageHeader {
   StorageMode storage_mode_;
 
   // Data size for the image data excluding the bitmap and the header. For compressed images, this
-  // is the compressed size in the file.
+  // is the compressed size in the file, including the block table.
   uint32_t data_size_;
 
+  // Offset of the block table in the image file and number of blocks. Zero for uncompressed
+  // images.
+  uint32_t blocks_offset_;
+  uint32_t blocks_count_;
+
   friend class linker::ImageWriter;
 };
 
@@ -16,8 +16,12 @@
 
 #include "intern_table.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
+#include "barrier.h"
+#include "base/quasi_atomic.h"
 #include "dex/utf.h"
 #include "gc/collector/garbage_collector.h"
 #include "gc/space/image_space.h"
@@ -31,6 +35,8 @@
 #include "object_callbacks.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
+#include "thread_list.h"
+#include "thread_pool.h"
 
 namespace art {
 
@@ -88,12 +94,35 @@ void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
   // Note: we deliberately don't visit the weak_interns_ table and the immutable image roots.
 }
 
+// The tables are only read here. Writers still serialize on intern_table_lock_ and keep the
+// storage seen by this lookup alive, see InternTable::Table.
+template <typename Key>
+inline bool InternTable::LookupConcurrent(bool is_strong,
+                                          const Key& key,
+                                          ObjPtr<mirror::String>* result)
+    NO_THREAD_SAFETY_ANALYSIS {
+  return is_strong ? strong_interns_.FindConcurrent(key, result)
+                   : weak_interns_.FindConcurrent(key, result);
+}
+
 ObjPtr<mirror::String> InternTable::LookupWeak(Thread* self, ObjPtr<mirror::String> s) {
+  // Weak interns may be swept while weak reference access is disabled, only read them without
+  // the lock while it is enabled for this thread.
+  ObjPtr<mirror::String> result;
+  if (kUseReadBarrier &&
+      self->GetWeakRefAccessEnabled() &&
+      LookupConcurrent(/*is_strong*/ false, s, &result)) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   return LookupWeakLocked(s);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::String> s) {
+  ObjPtr<mirror::String> result;
+  if (LIKELY(LookupConcurrent(/*is_strong*/ true, s, &result))) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   return LookupStrongLocked(s);
 }
@@ -105,6 +134,10 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
   Utf8String string(utf16_length,
                     utf8_data,
                     ComputeUtf16HashFromModifiedUtf8(utf8_data, utf16_length));
+  ObjPtr<mirror::String> result;
+  if (LIKELY(LookupConcurrent(/*is_strong*/ true, string, &result))) {
+    return result;
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   return strong_interns_.Find(string);
 }
@@ -208,6 +241,38 @@ void InternTable::WaitUntilAccessible(Thread* self) {
   Locks::intern_table_lock_->ExclusiveLock(self);
 }
 
+class PassBarrierClosure FINAL : public Closure {
+ public:
+  explicit PassBarrierClosure(Barrier* barrier) : barrier_(barrier) {}
+
+  void Run(Thread* thread ATTRIBUTE_UNUSED) OVERRIDE {
+    barrier_->Pass(Thread::Current());
+  }
+
+ private:
+  Barrier* const barrier_;
+};
+
+void InternTable::ReclaimRetiredStorage(Thread* self) {
+  Table::RetiredStorage strong_retired;
+  Table::RetiredStorage weak_retired;
+  {
+    MutexLock mu(self, *Locks::intern_table_lock_);
+    strong_interns_.TakeRetiredStorage(&strong_retired);
+    weak_interns_.TakeRetiredStorage(&weak_retired);
+  }
+  // Lock-free readers do not suspend while probing. Once every thread has run the checkpoint or
+  // is seen suspended, none of them can still see the retired storage, which is freed on return.
+  // Use our own barrier, the empty checkpoint one is reserved for the GC.
+  Barrier barrier(0);
+  PassBarrierClosure closure(&barrier);
+  size_t threads_running_checkpoint = Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
+  ScopedThreadSuspension sts(self, kSuspended);
+  if (threads_running_checkpoint != 0) {
+    barrier.Increment(self, threads_running_checkpoint);
+  }
+}
+
 ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
                                            bool is_strong,
                                            bool holding_locks) {
@@ -215,7 +280,38 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
     return nullptr;
   }
   Thread* const self = Thread::Current();
-  MutexLock mu(self, *Locks::intern_table_lock_);
+  // Most strings are already interned, try to find them without taking the lock.
+  ObjPtr<mirror::String> result;
+  if (LookupConcurrent(/*is_strong*/ true, s, &result) && result != nullptr) {
+    return result;
+  }
+  if (!is_strong &&
+      kUseReadBarrier &&
+      self->GetWeakRefAccessEnabled() &&
+      LookupConcurrent(/*is_strong*/ false, s, &result) &&
+      result != nullptr) {
+    return result;
+  }
+  bool reclaim;
+  {
+    MutexLock mu(self, *Locks::intern_table_lock_);
+    result = InsertLocked(self, s, is_strong, holding_locks);
+    // We may not suspend while holding other locks, leave the storage to a later insert.
+    reclaim = !holding_locks &&
+        (strong_interns_.HasRetiredStorage() || weak_interns_.HasRetiredStorage());
+  }
+  if (UNLIKELY(reclaim)) {
+    StackHandleScope<1> hs(self);
+    HandleWrapperObjPtr<mirror::String> h = hs.NewHandleWrapper(&result);
+    ReclaimRetiredStorage(self);
+  }
+  return result;
+}
+
+ObjPtr<mirror::String> InternTable::InsertLocked(Thread* self,
+                                                 ObjPtr<mirror::String> s,
+                                                 bool is_strong,
+                                                 bool holding_locks) {
   if (kDebugLocking && !holding_locks) {
     Locks::mutator_lock_->AssertSharedHeld(self);
     CHECK_EQ(2u, self->NumberOfHeldMutexes()) << "may only safely hold the mutator lock";
@@ -379,6 +475,7 @@ size_t InternTable::Table::AddTableFromMemory(const uint8_t* ptr) {
   }
   // Insert at the front since we add new interns into the back.
   tables_.insert(tables_.begin(), std::move(set));
+  PublishSnapshot();
   return read_count;
 }
 
@@ -405,7 +502,10 @@ void InternTable::Table::Remove(ObjPtr<mirror::String> s) {
   for (UnorderedSet& table : tables_) {
     auto it = table.Find(GcRoot<mirror::String>(s));
     if (it != table.end()) {
+      // Erasing moves later entries of the probe sequence back.
+      BeginWrite();
       table.Erase(it);
+      EndWrite();
       return;
     }
   }
@@ -434,18 +534,129 @@ ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string) {
   return nullptr;
 }
 
+template <typename Key>
+inline bool InternTable::Table::FindConcurrentWithHash(const Key& key,
+                                                       size_t hash,
+                                                       ObjPtr<mirror::String>* result) {
+  // A few attempts are enough to get past an erase, give up on longer writes such as sweeping.
+  static constexpr size_t kMaxAttempts = 4u;
+  StringHashEquals pred;
+  for (size_t attempt = 0; attempt != kMaxAttempts; ++attempt) {
+    uint32_t sequence = sequence_.LoadAcquire();
+    if ((sequence & 1u) != 0u) {
+      continue;
+    }
+    GcRoot<mirror::String> found;
+    for (const ConcurrentView& view : *snapshot_.LoadAcquire()) {
+      // Stop after a full round in case entries moved under us; the sequence check fails then.
+      for (size_t index = hash % std::max<size_t>(view.num_buckets, 1u), probes = 0u;
+           probes != view.num_buckets;
+           ++probes, index = (index + 1u != view.num_buckets) ? index + 1u : 0u) {
+        GcRoot<mirror::String> slot =
+            reinterpret_cast<const Atomic<GcRoot<mirror::String>>*>(&view.buckets[index])
+                ->LoadRelaxed();
+        if (slot.IsNull()) {
+          break;
+        }
+        if (pred(slot, key)) {
+          found = slot;
+          break;
+        }
+      }
+      if (!found.IsNull()) {
+        break;
+      }
+    }
+    QuasiAtomic::ThreadFenceAcquire();
+    if (sequence_.LoadRelaxed() == sequence) {
+      *result = found.IsNull() ? nullptr : found.Read();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool InternTable::Table::FindConcurrent(ObjPtr<mirror::String> s,
+                                        ObjPtr<mirror::String>* result) {
+  GcRoot<mirror::String> root(s);
+  return FindConcurrentWithHash(root, StringHashEquals()(root), result);
+}
+
+bool InternTable::Table::FindConcurrent(const Utf8String& string,
+                                        ObjPtr<mirror::String>* result) {
+  return FindConcurrentWithHash(string, StringHashEquals()(string), result);
+}
+
+void InternTable::Table::BeginWrite() {
+  DCHECK_EQ(sequence_.LoadRelaxed() & 1u, 0u);
+  sequence_.StoreRelaxed(sequence_.LoadRelaxed() + 1u);
+  QuasiAtomic::ThreadFenceRelease();
+}
+
+void InternTable::Table::EndWrite() {
+  DCHECK_EQ(sequence_.LoadRelaxed() & 1u, 1u);
+  sequence_.StoreRelease(sequence_.LoadRelaxed() + 1u);
+}
+
+void InternTable::Table::PublishSnapshot() {
+  std::unique_ptr<ConcurrentSnapshot> snapshot(new ConcurrentSnapshot());
+  snapshot->reserve(tables_.size());
+  for (const UnorderedSet& table : tables_) {
+    snapshot->push_back(ConcurrentView { table.Data(), table.NumBuckets() });
+  }
+  snapshot_.StoreRelease(snapshot.get());
+  if (current_snapshot_ != nullptr) {
+    retired_.snapshots.push_back(std::move(current_snapshot_));
+  }
+  current_snapshot_ = std::move(snapshot);
+}
+
+bool InternTable::Table::HasRetiredStorage() const {
+  return !retired_.sets.empty() || !retired_.snapshots.empty();
+}
+
+void InternTable::Table::TakeRetiredStorage(RetiredStorage* out) {
+  std::move(retired_.sets.begin(), retired_.sets.end(), std::back_inserter(out->sets));
+  std::move(retired_.snapshots.begin(),
+            retired_.snapshots.end(),
+            std::back_inserter(out->snapshots));
+  retired_.sets.clear();
+  retired_.snapshots.clear();
+}
+
 void InternTable::Table::AddNewTable() {
   tables_.push_back(UnorderedSet());
+  PublishSnapshot();
 }
 
 void InternTable::Table::Insert(ObjPtr<mirror::String> s) {
   // Always insert the last table, the image tables are before and we avoid inserting into these
   // to prevent dirty pages.
   DCHECK(!tables_.empty());
-  tables_.back().Insert(GcRoot<mirror::String>(s));
+  UnorderedSet& table = tables_.back();
+  if (UNLIKELY(table.Size() >= table.ElementsUntilExpand())) {
+    // Do not let the hash set resize itself, lock-free readers may be probing its buckets.
+    // Rehash into a new set, sized like HashSet::Expand() would, and retire the old one.
+    UnorderedSet grown(table.GetMinLoadFactor(), table.GetMaxLoadFactor());
+    grown.Reserve(
+        static_cast<size_t>(table.Size() * table.GetMaxLoadFactor() / table.GetMinLoadFactor()));
+    for (GcRoot<mirror::String>& string : table) {
+      grown.Insert(string);
+    }
+    table.swap(grown);
+    retired_.sets.push_back(std::move(grown));
+    PublishSnapshot();
+    DCHECK_LT(table.Size(), table.ElementsUntilExpand());
+  }
+  // Filling an empty bucket does not move other entries, but readers that see the new root
+  // must also see the string it points to.
+  QuasiAtomic::ThreadFenceRelease();
+  table.Insert(GcRoot<mirror::String>(s));
 }
 
 void InternTable::Table::VisitRoots(RootVisitor* visitor) {
+  // Roots are updated in place without bumping sequence_. Lock-free readers see either the old
+  // or the new reference to the same string and read it with a read barrier.
   BufferedRootVisitor<kDefaultBufferedRootCount> buffered_visitor(
       visitor, RootInfo(kRootInternedString));
   for (UnorderedSet& table : tables_) {
@@ -456,9 +667,11 @@ void InternTable::Table::VisitRoots(RootVisitor* visitor) {
 }
 
 void InternTable::Table::SweepWeaks(IsMarkedVisitor* visitor) {
+  BeginWrite();
   for (UnorderedSet& table : tables_) {
     SweepWeaks(&table, visitor);
   }
+  EndWrite();
 }
 
 void InternTable::Table::SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor) {
@@ -497,12 +710,13 @@ void InternTable::ChangeWeakRootStateLocked(gc::WeakRootState new_state) {
   }
 }
 
-InternTable::Table::Table() {
+InternTable::Table::Table() : sequence_(0u), snapshot_(nullptr) {
   Runtime* const runtime = Runtime::Current();
   // Initial table.
   tables_.push_back(UnorderedSet());
   tables_.back().SetLoadFactor(runtime->GetHashTableMinLoadFactor(),
                                runtime->GetHashTableMaxLoadFactor());
+  PublishSnapshot();
 }
 
 }  // namespace art
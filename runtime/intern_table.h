@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <memory>
 #include <unordered_set>
 
 #include "base/atomic.h"
@@ -188,6 +189,12 @@ class InternTable {
 
   // Table which holds pre zygote and post zygote interned strings. There is one instance for
   // weak interns and strong interns.
+  //
+  // Modifications require intern_table_lock_, but lookups may also be done without it through
+  // FindConcurrent(). To keep those safe, the hash sets are never resized in place: a full set is
+  // rehashed into a new one and the old storage is retired until no reader can still be probing
+  // it, see InternTable::ReclaimRetiredStorage(). Writers that move existing entries (erasing)
+  // bump a sequence counter so that concurrent readers can detect and retry a torn probe.
   class Table {
    public:
     Table();
@@ -195,6 +202,12 @@ class InternTable {
         REQUIRES(Locks::intern_table_lock_);
     ObjPtr<mirror::String> Find(const Utf8String& string) REQUIRES_SHARED(Locks::mutator_lock_)
         REQUIRES(Locks::intern_table_lock_);
+    // Lookup without holding intern_table_lock_. Returns false if the probe kept racing with
+    // writers, in which case the caller must redo the lookup with Find() under the lock.
+    bool FindConcurrent(ObjPtr<mirror::String> s, /*out*/ ObjPtr<mirror::String>* result)
+        REQUIRES_SHARED(Locks::mutator_lock_);
+    bool FindConcurrent(const Utf8String& string, /*out*/ ObjPtr<mirror::String>* result)
+        REQUIRES_SHARED(Locks::mutator_lock_);
     void Insert(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_)
         REQUIRES(Locks::intern_table_lock_);
     void Remove(ObjPtr<mirror::String> s)
@@ -220,6 +233,36 @@ class InternTable {
     typedef HashSet<GcRoot<mirror::String>, GcRootEmptyFn, StringHashEquals, StringHashEquals,
         TrackingAllocator<GcRoot<mirror::String>, kAllocatorTagInternTable>> UnorderedSet;
 
+    // The buckets of one of the tables_, as seen by lock-free readers.
+    struct ConcurrentView {
+      const GcRoot<mirror::String>* buckets;
+      size_t num_buckets;
+    };
+    typedef std::vector<ConcurrentView> ConcurrentSnapshot;
+
+   public:
+    // Hash set storage and snapshots that lock-free readers may still be using.
+    struct RetiredStorage {
+      std::vector<UnorderedSet> sets;
+      std::vector<std::unique_ptr<ConcurrentSnapshot>> snapshots;
+    };
+
+    bool HasRetiredStorage() const REQUIRES(Locks::intern_table_lock_);
+    // Move the retired storage to `out`. The caller frees it once no reader can be using it.
+    void TakeRetiredStorage(RetiredStorage* out) REQUIRES(Locks::intern_table_lock_);
+
+   private:
+    template <typename Key>
+    bool FindConcurrentWithHash(const Key& key, size_t hash, ObjPtr<mirror::String>* result)
+        REQUIRES_SHARED(Locks::mutator_lock_);
+
+    // Publish the current buckets of tables_ to lock-free readers.
+    void PublishSnapshot() REQUIRES(Locks::intern_table_lock_);
+
+    // Bracket modifications that may move existing entries.
+    void BeginWrite() REQUIRES(Locks::intern_table_lock_);
+    void EndWrite() REQUIRES(Locks::intern_table_lock_);
+
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
 
@@ -227,6 +270,13 @@ class InternTable {
     // modifying the zygote intern table. The back of table is modified when strings are interned.
     std::vector<UnorderedSet> tables_;
 
+    // Seqlock for lock-free readers, odd while entries are being moved.
+    Atomic<uint32_t> sequence_;
+    // What lock-free readers probe, owned by current_snapshot_.
+    Atomic<const ConcurrentSnapshot*> snapshot_;
+    std::unique_ptr<ConcurrentSnapshot> current_snapshot_;
+    RetiredStorage retired_;
+
     friend class linker::OatWriter;  // for boot image string table slot address lookup.
     ART_FRIEND_TEST(InternTableTest, CrossHash);
   };
@@ -236,6 +286,21 @@ class InternTable {
   // require GC is not running since it is not safe to wait while holding locks.
   ObjPtr<mirror::String> Insert(ObjPtr<mirror::String> s, bool is_strong, bool holding_locks)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+  ObjPtr<mirror::String> InsertLocked(Thread* self,
+                                      ObjPtr<mirror::String> s,
+                                      bool is_strong,
+                                      bool holding_locks)
+      REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Lock-free lookup in the strong or weak table, see Table::FindConcurrent().
+  template <typename Key>
+  bool LookupConcurrent(bool is_strong, const Key& key, /*out*/ ObjPtr<mirror::String>* result)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Free hash set storage replaced while lock-free readers may have been probing it. Runs a
+  // checkpoint, so it may cause thread suspension.
+  void ReclaimRetiredStorage(Thread* self)
+      REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
   ObjPtr<mirror::String> LookupStrongLocked(ObjPtr<mirror::String> s)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
@@ -23,6 +23,7 @@
 #include "handle_scope-inl.h"
 #include "mirror/object.h"
 #include "mirror/string.h"
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 
 namespace art {
@@ -234,4 +235,25 @@ TEST_F(InternTableTest, LookupStrong) {
   EXPECT_TRUE(lookup_foobbS == nullptr);
 }
 
+TEST_F(InternTableTest, LookupStrongAfterGrowth) {
+  ScopedObjectAccess soa(Thread::Current());
+  // Use the runtime's table, its strong interns are GC roots.
+  InternTable* intern_table = Runtime::Current()->GetInternTable();
+  // Enough strings to rehash the table into larger storage at least once.
+  static constexpr size_t kNumStrings = 2000u;
+  for (size_t i = 0; i != kNumStrings; ++i) {
+    std::string str = "lookup-after-growth-" + std::to_string(i);
+    ASSERT_TRUE(intern_table->InternStrong(str.c_str()) != nullptr);
+  }
+  for (size_t i = 0; i != kNumStrings; ++i) {
+    std::string str = "lookup-after-growth-" + std::to_string(i);
+    ObjPtr<mirror::String> lookup =
+        intern_table->LookupStrong(soa.Self(), str.size(), str.c_str());
+    ASSERT_TRUE(lookup != nullptr);
+    EXPECT_TRUE(lookup->Equals(str.c_str()));
+  }
+  std::string missing = "lookup-after-growth-" + std::to_string(kNumStrings);
+  EXPECT_TRUE(intern_table->LookupStrong(soa.Self(), missing.size(), missing.c_str()) == nullptr);
+}
+
 }  // namespace art
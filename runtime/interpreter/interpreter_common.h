@@ -50,6 +50,7 @@
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
 #include "mirror/string-inl.h"
+#include "mirror/var_handle.h"
 #include "obj_ptr.h"
 #include "stack.h"
 #include "thread.h"
@@ -243,6 +244,18 @@ bool DoInvokePolymorphic(Thread* self,
                          uint16_t inst_data,
                          JValue* result);
 
+// Performs a VarHandle accessor invocation for an invoke-polymorphic call site of type
+// `callsite_type`. The `operands` exclude the VarHandle receiver. Used by the interpreter and
+// by compiled code that could not take its inline VarHandle fast path.
+bool VarHandleInvokeAccessor(Thread* self,
+                             ShadowFrame& shadow_frame,
+                             Handle<mirror::VarHandle> var_handle,
+                             Handle<mirror::MethodType> callsite_type,
+                             mirror::VarHandle::AccessMode access_mode,
+                             InstructionOperands* operands,
+                             JValue* result)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
 // Performs a custom invoke (invoke-custom/invoke-custom-range).
 template<bool is_range>
 bool DoInvokeCustom(Thread* self,
@@ -17,6 +17,7 @@
 #include "jit.h"
 
 #include <dlfcn.h>
+#include <unistd.h>
 
 #include "art_method-inl.h"
 #include "base/enums.h"
@@ -52,12 +53,15 @@ static constexpr size_t kJitDefaultCompileThreshold           = 10000;  // Non-d
 static constexpr size_t kJitStressDefaultCompileThreshold     = 100;    // Fast-debug build.
 static constexpr size_t kJitSlowStressDefaultCompileThreshold = 2;      // Slow-debug build.
 
+// Upper bound of the default number of JIT threads. Can be overridden on the command line.
+static constexpr size_t kJitDefaultMaxThreadPoolSize = 4;
+
 // JIT compiler
 void* Jit::jit_library_handle_ = nullptr;
 void* Jit::jit_compiler_handle_ = nullptr;
 void* (*Jit::jit_load_)(bool*) = nullptr;
 void (*Jit::jit_unload_)(void*) = nullptr;
-bool (*Jit::jit_compile_method_)(void*, ArtMethod*, Thread*, bool) = nullptr;
+bool (*Jit::jit_compile_method_)(void*, ArtMethod*, Thread*, bool, bool) = nullptr;
 void (*Jit::jit_types_loaded_)(void*, mirror::Class**, size_t count) = nullptr;
 bool Jit::generate_debug_info_ = false;
 
@@ -114,6 +118,26 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
     }
   }
 
+  if (options.Exists(RuntimeArgumentMap::JITBaselineThreshold)) {
+    jit_options->baseline_threshold_ = *options.Get(RuntimeArgumentMap::JITBaselineThreshold);
+    if (jit_options->baseline_threshold_ != 0 &&
+        (jit_options->baseline_threshold_ <= jit_options->warmup_threshold_ ||
+         jit_options->baseline_threshold_ >= jit_options->compile_threshold_)) {
+      LOG(FATAL) << "Method baseline threshold must be between the warmup and compile thresholds.";
+    }
+  } else {
+    // Compile with the baseline compiler halfway between profiling and optimizing.
+    jit_options->baseline_threshold_ =
+        (jit_options->warmup_threshold_ + jit_options->compile_threshold_) / 2;
+    if (jit_options->baseline_threshold_ <= jit_options->warmup_threshold_) {
+      // The thresholds are too close to each other for an intermediate tier.
+      jit_options->baseline_threshold_ = 0;
+    }
+  }
+  if (!Jit::IsBaselineCompilationSupported(kRuntimeISA)) {
+    jit_options->baseline_threshold_ = 0;
+  }
+
   if (options.Exists(RuntimeArgumentMap::JITPriorityThreadWeight)) {
     jit_options->priority_thread_weight_ =
         *options.Get(RuntimeArgumentMap::JITPriorityThreadWeight);
@@ -142,6 +166,19 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
         static_cast<size_t>(1));
   }
 
+  if (options.Exists(RuntimeArgumentMap::JITThreadPoolSize)) {
+    jit_options->thread_pool_size_ = *options.Get(RuntimeArgumentMap::JITThreadPoolSize);
+    if (jit_options->thread_pool_size_ == 0) {
+      LOG(FATAL) << "JIT thread pool size cannot be 0.";
+    }
+  } else {
+    // Leave a core to the application threads that made the methods hot.
+    long number_of_cores = sysconf(_SC_NPROCESSORS_CONF);  // NOLINT(runtime/int)
+    jit_options->thread_pool_size_ = std::min(
+        static_cast<size_t>(std::max(number_of_cores - 1, 1L)),
+        kJitDefaultMaxThreadPoolSize);
+  }
+
   return jit_options;
 }
 
@@ -173,6 +210,7 @@ Jit::Jit() : dump_info_on_shutdown_(false),
              hot_method_threshold_(0),
              warm_method_threshold_(0),
              osr_method_threshold_(0),
+             baseline_method_threshold_(0),
              priority_thread_weight_(0),
              invoke_transition_weight_(0) {}
 
@@ -199,16 +237,19 @@ Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
       << PrettySize(options->GetCodeCacheInitialCapacity())
       << ", max_capacity=" << PrettySize(options->GetCodeCacheMaxCapacity())
       << ", compile_threshold=" << options->GetCompileThreshold()
+      << ", baseline_threshold=" << options->GetBaselineThreshold()
+      << ", thread_pool_size=" << options->GetThreadPoolSize()
       << ", profile_saver_options=" << options->GetProfileSaverOptions();
 
 
   jit->hot_method_threshold_ = options->GetCompileThreshold();
   jit->warm_method_threshold_ = options->GetWarmupThreshold();
   jit->osr_method_threshold_ = options->GetOsrThreshold();
+  jit->baseline_method_threshold_ = options->GetBaselineThreshold();
   jit->priority_thread_weight_ = options->GetPriorityThreadWeight();
   jit->invoke_transition_weight_ = options->GetInvokeTransitionWeight();
 
-  jit->CreateThreadPool();
+  jit->CreateThreadPool(options->GetThreadPoolSize());
 
   // Notify native debugger about the classes already loaded before the creation of the jit.
   jit->DumpTypeInfoForLoadedTypes(Runtime::Current()->GetClassLinker());
@@ -237,7 +278,7 @@ bool Jit::LoadCompilerLibrary(std::string* error_msg) {
     *error_msg = "JIT couldn't find jit_unload entry point";
     return false;
   }
-  jit_compile_method_ = reinterpret_cast<bool (*)(void*, ArtMethod*, Thread*, bool)>(
+  jit_compile_method_ = reinterpret_cast<bool (*)(void*, ArtMethod*, Thread*, bool, bool)>(
       dlsym(jit_library_handle_, "jit_compile_method"));
   if (jit_compile_method_ == nullptr) {
     dlclose(jit_library_handle_);
@@ -271,7 +312,7 @@ bool Jit::LoadCompiler(std::string* error_msg) {
   return true;
 }
 
-bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr) {
+bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr) {
   DCHECK(Runtime::Current()->UseJitCompilation());
   DCHECK(!method->IsRuntimeMethod());
 
@@ -294,18 +335,21 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr) {
   // If we get a request to compile a proxy method, we pass the actual Java method
   // of that proxy method, as the compiler does not expect a proxy method.
   ArtMethod* method_to_compile = method->GetInterfaceMethodIfProxy(kRuntimePointerSize);
-  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, osr)) {
+  if (!code_cache_->NotifyCompilationOf(method_to_compile, self, baseline, osr)) {
     return false;
   }
 
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
+            << " baseline=" << std::boolalpha << baseline
             << " osr=" << std::boolalpha << osr;
-  bool success = jit_compile_method_(jit_compiler_handle_, method_to_compile, self, osr);
+  bool success =
+      jit_compile_method_(jit_compiler_handle_, method_to_compile, self, baseline, osr);
   code_cache_->DoneCompiling(method_to_compile, self, osr);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
               << ArtMethod::PrettyMethod(method_to_compile)
+              << " baseline=" << std::boolalpha << baseline
               << " osr=" << std::boolalpha << osr;
   }
   if (kIsDebugBuild) {
@@ -320,13 +364,20 @@ bool Jit::CompileMethod(ArtMethod* method, Thread* self, bool osr) {
   return success;
 }
 
-void Jit::CreateThreadPool() {
+void Jit::CreateThreadPool(size_t thread_pool_size) {
   // There is a DCHECK in the 'AddSamples' method to ensure the tread pool
   // is not null when we instrument.
 
+  // The JIT logger and the native debug info writer expect a single compiler thread.
+  if (generate_debug_info_) {
+    thread_pool_size = 1u;
+  }
+  DCHECK_GE(thread_pool_size, 1u);
+
   // We need peers as we may report the JIT thread, e.g., in the debugger.
   constexpr bool kJitPoolNeedsPeers = true;
-  thread_pool_.reset(new ThreadPool("Jit thread pool", 1, kJitPoolNeedsPeers));
+  thread_pool_.reset(
+      new PriorityThreadPool("Jit thread pool", thread_pool_size, kJitPoolNeedsPeers));
 
   thread_pool_->SetPthreadPriority(kJitPoolThreadPthreadPriority);
   Start();
@@ -593,15 +644,17 @@ void Jit::AddMemoryUsage(ArtMethod* method, size_t bytes) {
   memory_use_.AddValue(bytes);
 }
 
-class JitCompileTask FINAL : public Task {
+class JitCompileTask FINAL : public PriorityTask {
  public:
   enum TaskKind {
     kAllocateProfile,
+    kCompileBaseline,
     kCompile,
     kCompileOsr
   };
 
-  JitCompileTask(ArtMethod* method, TaskKind kind) : method_(method), kind_(kind) {
+  JitCompileTask(ArtMethod* method, TaskKind kind, uint32_t min_priority = 0u)
+      : method_(method), kind_(kind), min_priority_(min_priority) {
     ScopedObjectAccess soa(Thread::Current());
     // Add a global ref to the class to prevent class unloading until compilation is done.
     klass_ = soa.Vm()->AddGlobalRef(soa.Self(), method_->GetDeclaringClass());
@@ -615,10 +668,15 @@ class JitCompileTask FINAL : public Task {
 
   void Run(Thread* self) OVERRIDE {
     ScopedObjectAccess soa(self);
-    if (kind_ == kCompile) {
-      Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ false);
+    if (kind_ == kCompileBaseline) {
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* baseline */ true, /* osr */ false);
+    } else if (kind_ == kCompile) {
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* baseline */ false, /* osr */ false);
     } else if (kind_ == kCompileOsr) {
-      Runtime::Current()->GetJit()->CompileMethod(method_, self, /* osr */ true);
+      Runtime::Current()->GetJit()->CompileMethod(
+          method_, self, /* baseline */ false, /* osr */ true);
     } else {
       DCHECK(kind_ == kAllocateProfile);
       if (ProfilingInfo::Create(self, method_, /* retry_allocation */ true)) {
@@ -632,9 +690,16 @@ class JitCompileTask FINAL : public Task {
     delete this;
   }
 
+  // Methods that got hotter while waiting are compiled first. The hotness counter may have been
+  // rewound since the task was added, so never go below the hotness the task was added with.
+  uint32_t GetPriority() OVERRIDE {
+    return std::max<uint32_t>(method_->GetCounter(), min_priority_);
+  }
+
  private:
   ArtMethod* const method_;
   const TaskKind kind_;
+  const uint32_t min_priority_;
   jobject klass_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
@@ -658,6 +723,8 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
   DCHECK(thread_pool_ != nullptr);
   DCHECK_GT(warm_method_threshold_, 0);
   DCHECK_GT(hot_method_threshold_, warm_method_threshold_);
+  DCHECK(!UseBaselineCompilation() || baseline_method_threshold_ > warm_method_threshold_);
+  DCHECK(!UseBaselineCompilation() || baseline_method_threshold_ < hot_method_threshold_);
   DCHECK_GT(osr_method_threshold_, hot_method_threshold_);
   DCHECK_GE(priority_thread_weight_, 1);
   DCHECK_LE(priority_thread_weight_, hot_method_threshold_);
@@ -667,6 +734,8 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
     count *= priority_thread_weight_;
   }
   int32_t new_count = starting_count + count;   // int32 here to avoid wrap-around;
+  // Tasks of hotter methods are picked first by the JIT threads, see JitCompileTask::GetPriority().
+  const uint32_t task_priority = static_cast<uint32_t>(new_count);
   // Note: Native method have no "warm" state or profiling info.
   if (LIKELY(!method->IsNative()) && starting_count < warm_method_threshold_) {
     if ((new_count >= warm_method_threshold_) &&
@@ -686,17 +755,33 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
       if (!success) {
         // We failed allocating. Instead of doing the collection on the Java thread, we push
         // an allocation to a compiler thread, that will do the collection.
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kAllocateProfile));
+        thread_pool_->AddPriorityTask(
+            self, new JitCompileTask(method, JitCompileTask::kAllocateProfile, task_priority));
       }
     }
     // Avoid jumping more than one state at a time.
-    new_count = std::min(new_count, hot_method_threshold_ - 1);
+    new_count = std::min(new_count,
+                         (UseBaselineCompilation() ? baseline_method_threshold_
+                                                   : hot_method_threshold_) - 1);
   } else if (use_jit_compilation_) {
-    if (starting_count < hot_method_threshold_) {
-      if ((new_count >= hot_method_threshold_) &&
+    if (UseBaselineCompilation() &&
+        LIKELY(!method->IsNative()) &&
+        starting_count < baseline_method_threshold_) {
+      if ((new_count >= baseline_method_threshold_) &&
           !code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
         DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kCompile));
+        thread_pool_->AddPriorityTask(
+            self, new JitCompileTask(method, JitCompileTask::kCompileBaseline, task_priority));
+      }
+      // Avoid jumping more than one state at a time.
+      new_count = std::min(new_count, hot_method_threshold_ - 1);
+    } else if (starting_count < hot_method_threshold_) {
+      if ((new_count >= hot_method_threshold_) &&
+          (!code_cache_->ContainsPc(method->GetEntryPointFromQuickCompiledCode()) ||
+           code_cache_->ShouldEnqueueOptimizedCompilation(method, self))) {
+        DCHECK(thread_pool_ != nullptr);
+        thread_pool_->AddPriorityTask(
+            self, new JitCompileTask(method, JitCompileTask::kCompile, task_priority));
       }
       // Avoid jumping more than one state at a time.
       new_count = std::min(new_count, osr_method_threshold_ - 1);
@@ -708,7 +793,8 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
       DCHECK(!method->IsNative());  // No back edges reported for native methods.
       if ((new_count >= osr_method_threshold_) &&  !code_cache_->IsOsrCompiled(method)) {
         DCHECK(thread_pool_ != nullptr);
-        thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kCompileOsr));
+        thread_pool_->AddPriorityTask(
+            self, new JitCompileTask(method, JitCompileTask::kCompileOsr, task_priority));
       }
     }
   }
@@ -716,6 +802,24 @@ void Jit::AddSamples(Thread* self, ArtMethod* method, uint16_t count, bool with_
   method->SetCounter(new_count);
 }
 
+void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
+  if (thread_pool_ == nullptr) {
+    // Should only see this when shutting down.
+    DCHECK(Runtime::Current()->IsShuttingDown(self));
+    return;
+  }
+  DCHECK(UseBaselineCompilation());
+  // Rewind the hotness so that the baseline code calls back only after another
+  // round of samples if this compilation fails or is not done yet.
+  method->SetCounter(baseline_method_threshold_);
+  if (!code_cache_->ShouldEnqueueOptimizedCompilation(method, self)) {
+    // Already compiled with the optimizing compiler, or already enqueued or being compiled.
+    return;
+  }
+  thread_pool_->AddPriorityTask(
+      self, new JitCompileTask(method, JitCompileTask::kCompile, hot_method_threshold_));
+}
+
 void Jit::MethodEntered(Thread* thread, ArtMethod* method) {
   Runtime* runtime = Runtime::Current();
   if (UNLIKELY(runtime->UseJitCompilation() && runtime->GetJit()->JitAtFirstUse())) {
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_JIT_JIT_H_
 #define ART_RUNTIME_JIT_JIT_H_
 
+#include "arch/instruction_set.h"
 #include "base/histogram-inl.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -54,9 +55,9 @@ class Jit {
 
   virtual ~Jit();
   static Jit* Create(JitOptions* options, std::string* error_msg);
-  bool CompileMethod(ArtMethod* method, Thread* self, bool osr)
+  bool CompileMethod(ArtMethod* method, Thread* self, bool baseline, bool osr)
       REQUIRES_SHARED(Locks::mutator_lock_);
-  void CreateThreadPool();
+  void CreateThreadPool(size_t thread_pool_size);
 
   const JitCodeCache* GetCodeCache() const {
     return code_cache_.get();
@@ -89,6 +90,22 @@ class Jit {
     return warm_method_threshold_;
   }
 
+  // Hotness count at which a method is compiled with the baseline compiler, or 0
+  // if methods go straight from the interpreter to the optimizing compiler.
+  size_t BaselineMethodThreshold() const {
+    return baseline_method_threshold_;
+  }
+
+  bool UseBaselineCompilation() const {
+    return baseline_method_threshold_ != 0;
+  }
+
+  // Return whether baseline compiled code can request its own optimized
+  // recompilation on `isa`.
+  static bool IsBaselineCompilationSupported(InstructionSet isa) {
+    return isa == InstructionSet::kArm64 || isa == InstructionSet::kX86_64;
+  }
+
   uint16_t PriorityThreadWeight() const {
     return priority_thread_weight_;
   }
@@ -112,6 +129,11 @@ class Jit {
   void AddSamples(Thread* self, ArtMethod* method, uint16_t samples, bool with_backedges)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called by baseline compiled code once its hotness count reaches the hot
+  // threshold. Enqueues the compilation of `method` with the optimizing compiler.
+  void EnqueueOptimizedCompilation(ArtMethod* method, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   void InvokeVirtualOrInterface(ObjPtr<mirror::Object> this_object,
                                 ArtMethod* caller,
                                 uint32_t dex_pc,
@@ -186,7 +208,7 @@ class Jit {
   static void* jit_compiler_handle_;
   static void* (*jit_load_)(bool*);
   static void (*jit_unload_)(void*);
-  static bool (*jit_compile_method_)(void*, ArtMethod*, Thread*, bool);
+  static bool (*jit_compile_method_)(void*, ArtMethod*, Thread*, bool, bool);
   static void (*jit_types_loaded_)(void*, mirror::Class**, size_t count);
 
   // Performance monitoring.
@@ -203,9 +225,11 @@ class Jit {
   uint16_t hot_method_threshold_;
   uint16_t warm_method_threshold_;
   uint16_t osr_method_threshold_;
+  uint16_t baseline_method_threshold_;
   uint16_t priority_thread_weight_;
   uint16_t invoke_transition_weight_;
-  std::unique_ptr<ThreadPool> thread_pool_;
+  // Compile tasks are ordered by the hotness of their method when they were added.
+  std::unique_ptr<PriorityThreadPool> thread_pool_;
 
   DISALLOW_COPY_AND_ASSIGN(Jit);
 };
@@ -222,12 +246,18 @@ class JitOptions {
   size_t GetOsrThreshold() const {
     return osr_threshold_;
   }
+  size_t GetBaselineThreshold() const {
+    return baseline_threshold_;
+  }
   uint16_t GetPriorityThreadWeight() const {
     return priority_thread_weight_;
   }
   size_t GetInvokeTransitionWeight() const {
     return invoke_transition_weight_;
   }
+  size_t GetThreadPoolSize() const {
+    return thread_pool_size_;
+  }
   size_t GetCodeCacheInitialCapacity() const {
     return code_cache_initial_capacity_;
   }
@@ -262,6 +292,7 @@ class JitOptions {
   void SetJitAtFirstUse() {
     use_jit_compilation_ = true;
     compile_threshold_ = 0;
+    baseline_threshold_ = 0;
   }
 
  private:
@@ -271,8 +302,10 @@ class JitOptions {
   size_t compile_threshold_;
   size_t warmup_threshold_;
   size_t osr_threshold_;
+  size_t baseline_threshold_;
   uint16_t priority_thread_weight_;
   size_t invoke_transition_weight_;
+  size_t thread_pool_size_;
   bool dump_info_on_shutdown_;
   ProfileSaverOptions profile_saver_options_;
 
@@ -283,8 +316,10 @@ class JitOptions {
         compile_threshold_(0),
         warmup_threshold_(0),
         osr_threshold_(0),
+        baseline_threshold_(0),
         priority_thread_weight_(0),
         invoke_transition_weight_(0),
+        thread_pool_size_(0),
         dump_info_on_shutdown_(false) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
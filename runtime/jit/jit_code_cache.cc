@@ -16,6 +16,7 @@
 
 #include "jit_code_cache.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "arch/context.h"
@@ -394,6 +395,7 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                   size_t code_size,
                                   size_t data_size,
                                   bool osr,
+                                  bool baseline,
                                   Handle<mirror::ObjectArray<mirror::Object>> roots,
                                   bool has_should_deoptimize_flag,
                                   const ArenaSet<ArtMethod*>& cha_single_implementation_list) {
@@ -409,6 +411,7 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                        code_size,
                                        data_size,
                                        osr,
+                                       baseline,
                                        roots,
                                        has_should_deoptimize_flag,
                                        cha_single_implementation_list);
@@ -427,6 +430,7 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                 code_size,
                                 data_size,
                                 osr,
+                                baseline,
                                 roots,
                                 has_should_deoptimize_flag,
                                 cha_single_implementation_list);
@@ -692,16 +696,33 @@ void JitCodeCache::DisallowInlineCacheAccess() {
 }
 
 void JitCodeCache::CopyInlineCacheInto(const InlineCache& ic,
-                                       Handle<mirror::ObjectArray<mirror::Class>> array) {
+                                       Handle<mirror::ObjectArray<mirror::Class>> array,
+                                       /*out*/ uint32_t* counts) {
   WaitUntilInlineCacheAccessible(Thread::Current());
   // Note that we don't need to lock `lock_` here, the compiler calling
   // this method has already ensured the inline cache will not be deleted.
-  for (size_t in_cache = 0, in_array = 0;
-       in_cache < InlineCache::kIndividualCacheSize;
-       ++in_cache) {
+  // The counts are updated concurrently, so take a snapshot before sorting.
+  std::pair<uint32_t, mirror::Class*> entries[InlineCache::kIndividualCacheSize];
+  size_t number_of_entries = 0;
+  for (size_t in_cache = 0; in_cache < InlineCache::kIndividualCacheSize; ++in_cache) {
     mirror::Class* object = ic.classes_[in_cache].Read();
     if (object != nullptr) {
-      array->Set(in_array++, object);
+      entries[number_of_entries++] = std::make_pair(ic.counts_[in_cache], object);
+    }
+  }
+  // Order by decreasing frequency, so that the compiler guards for the most frequent types first.
+  std::stable_sort(entries,
+                   entries + number_of_entries,
+                   [](const std::pair<uint32_t, mirror::Class*>& lhs,
+                      const std::pair<uint32_t, mirror::Class*>& rhs) {
+                     return lhs.first > rhs.first;
+                   });
+  for (size_t in_array = 0; in_array < InlineCache::kIndividualCacheSize; ++in_array) {
+    if (in_array < number_of_entries) {
+      array->Set(in_array, entries[in_array].second);
+      counts[in_array] = entries[in_array].first;
+    } else {
+      counts[in_array] = 0u;
     }
   }
 }
@@ -734,6 +755,7 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
                                           size_t code_size,
                                           size_t data_size,
                                           bool osr,
+                                          bool baseline,
                                           Handle<mirror::ObjectArray<mirror::Object>> roots,
                                           bool has_should_deoptimize_flag,
                                           const ArenaSet<ArtMethod*>&
@@ -850,6 +872,10 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
         number_of_osr_compilations_++;
         osr_code_map_.Put(method, code_ptr);
       } else {
+        ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+        if (info != nullptr) {
+          info->SetIsBaselineCompiled(baseline);
+        }
         Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
             method, method_header->GetEntryPoint());
       }
@@ -1372,6 +1398,10 @@ void JitCodeCache::DoCollection(Thread* self, bool collect_profiling_info) {
     // - discarded compiled code, that will be removed if not in a thread call stack.
     for (const auto& entry : jni_stubs_map_) {
       const JniStubData& data = entry.second;
+      if (!data.IsCompiled()) {
+        // Still being compiled.
+        continue;
+      }
       const void* code_ptr = data.GetCode();
       const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
       for (ArtMethod* method : data.GetMethods()) {
@@ -1629,6 +1659,7 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
 
     for (size_t i = 0; i < info->number_of_inline_caches_; ++i) {
       std::vector<TypeReference> profile_classes;
+      std::vector<uint32_t> profile_counts;
       const InlineCache& cache = info->cache_[i];
       ArtMethod* caller = info->GetMethod();
       bool is_missing_types = false;
@@ -1671,13 +1702,14 @@ void JitCodeCache::GetProfiledMethods(const std::set<std::string>& dex_base_loca
           // Only consider classes from the same apk (including multidex).
           profile_classes.emplace_back(/*ProfileMethodInfo::ProfileClassReference*/
               class_dex_file, type_index);
+          profile_counts.push_back(cache.counts_[k]);
         } else {
           is_missing_types = true;
         }
       }
       if (!profile_classes.empty()) {
         inline_caches.emplace_back(/*ProfileMethodInfo::ProfileInlineCache*/
-            cache.dex_pc_, is_missing_types, profile_classes);
+            cache.dex_pc_, is_missing_types, profile_classes, profile_counts);
       }
     }
     methods.emplace_back(/*ProfileMethodInfo*/
@@ -1694,12 +1726,51 @@ bool JitCodeCache::IsOsrCompiled(ArtMethod* method) {
   return osr_code_map_.find(method) != osr_code_map_.end();
 }
 
-bool JitCodeCache::NotifyCompilationOf(ArtMethod* method, Thread* self, bool osr) {
-  if (!osr && ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+bool JitCodeCache::IsBaselineCompiled(ArtMethod* method) {
+  MutexLock mu(Thread::Current(), lock_);
+  return IsBaselineCompiledLocked(method);
+}
+
+bool JitCodeCache::IsBaselineCompiledLocked(ArtMethod* method) {
+  if (method->IsNative() || !ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
     return false;
   }
+  ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+  return info != nullptr && info->IsBaselineCompiled();
+}
 
+bool JitCodeCache::ShouldEnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   MutexLock mu(self, lock_);
+  if (!IsBaselineCompiledLocked(method)) {
+    // Already compiled with the optimizing compiler.
+    return false;
+  }
+  ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+  if (info->IsOptimizedCompilationEnqueued() || info->IsMethodBeingCompiled(/* osr */ false)) {
+    return false;
+  }
+  info->SetIsOptimizedCompilationEnqueued(true);
+  return true;
+}
+
+bool JitCodeCache::NotifyCompilationOf(ArtMethod* method, Thread* self, bool baseline, bool osr) {
+  // Check the entry point with the lock held: another JIT thread commits code and then clears
+  // the being-compiled flag, each under the lock, so we see at least one of them.
+  MutexLock mu(self, lock_);
+  if (!baseline && !osr) {
+    // The optimized compilation is dequeued, whether or not it goes ahead.
+    ProfilingInfo* info = method->GetProfilingInfo(kRuntimePointerSize);
+    if (info != nullptr) {
+      info->SetIsOptimizedCompilationEnqueued(false);
+    }
+  }
+  if (!osr && ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+    // Only baseline code is replaced, and only with optimized code.
+    if (baseline || !IsBaselineCompiledLocked(method)) {
+      return false;
+    }
+  }
+
   if (osr && (osr_code_map_.find(method) != osr_code_map_.end())) {
     return false;
   }
@@ -52,10 +52,9 @@
 namespace art {
 
 const uint8_t ProfileCompilationInfo::kProfileMagic[] = { 'p', 'r', 'o', '\0' };
-// Last profile version: merge profiles directly from the file without creating
-// profile_compilation_info object. All the profile line headers are now placed together
-// before corresponding method_encodings and class_ids.
-const uint8_t ProfileCompilationInfo::kProfileVersion[] = { '0', '1', '0', '\0' };
+// Last profile version: record how many times each receiver type has been seen by an
+// inline cache, including the most frequent types of megamorphic inline caches.
+const uint8_t ProfileCompilationInfo::kProfileVersion[] = { '0', '1', '1', '\0' };
 
 // The name of the profile entry in the dex metadata file.
 // DO NOT CHANGE THIS! (it's similar to classes.dex in the apk files).
@@ -102,8 +101,15 @@ ProfileCompilationInfo::~ProfileCompilationInfo() {
 }
 
 void ProfileCompilationInfo::DexPcData::AddClass(uint16_t dex_profile_idx,
-                                                 const dex::TypeIndex& type_idx) {
-  if (is_megamorphic || is_missing_types) {
+                                                 const dex::TypeIndex& type_idx,
+                                                 uint32_t count) {
+  if (is_missing_types) {
+    return;
+  }
+
+  ClassReference ref(dex_profile_idx, type_idx);
+  AddClassCount(ref, count);
+  if (is_megamorphic) {
     return;
   }
 
@@ -111,7 +117,6 @@ void ProfileCompilationInfo::DexPcData::AddClass(uint16_t dex_profile_idx,
   // element. We do this because emplace() allocates the node before doing the
   // lookup and if it then finds an identical element, it shall deallocate the
   // node. For Arena allocations, that's essentially a leak.
-  ClassReference ref(dex_profile_idx, type_idx);
   auto it = classes.find(ref);
   if (it != classes.end()) {
     // The type index exists.
@@ -129,6 +134,36 @@ void ProfileCompilationInfo::DexPcData::AddClass(uint16_t dex_profile_idx,
   classes.insert(ref);
 }
 
+void ProfileCompilationInfo::DexPcData::AddClassCount(const ClassReference& ref,
+                                                      uint32_t count) {
+  auto it = class_counts.find(ref);
+  if (it != class_counts.end()) {
+    // Saturate rather than wrap around, so that the type stays dominant.
+    it->second = (it->second > std::numeric_limits<uint32_t>::max() - count)
+        ? std::numeric_limits<uint32_t>::max()
+        : it->second + count;
+    return;
+  }
+  if (class_counts.size() < InlineCache::kIndividualCacheSize) {
+    class_counts.Put(ref, count);
+    return;
+  }
+  // The histogram is full, replace its least frequent type if `ref` is more frequent.
+  // The classes of non megamorphic receivers are never replaced, as there are fewer
+  // of them than histogram entries.
+  DCHECK(is_megamorphic);
+  auto min_it = class_counts.begin();
+  for (auto count_it = class_counts.begin(); count_it != class_counts.end(); ++count_it) {
+    if (count_it->second < min_it->second) {
+      min_it = count_it;
+    }
+  }
+  if (min_it->second < count) {
+    class_counts.erase(min_it);
+    class_counts.Put(ref, count);
+  }
+}
+
 // Transform the actual dex location into relative paths.
 // Note: this is OK because we don't store profiles of different apps into the same file.
 // Apps with split apks don't cause trouble because each split has a different name and will not
@@ -486,9 +521,8 @@ void ProfileCompilationInfo::AddInlineCacheToBuffer(std::vector<uint8_t>* buffer
     // Add the dex pc.
     AddUintToBuffer(buffer, dex_pc);
 
-    // Add the megamorphic/missing_types encoding if needed and continue.
-    // In either cases we don't add any classes to the profiles and so there's
-    // no point to continue.
+    // Add the missing_types encoding if needed and continue. In that case we don't
+    // add any classes to the profiles and so there's no point to continue.
     // TODO(calin): in case we miss types there is still value to add the
     // rest of the classes. They can be added without bumping the profile version.
     if (dex_pc_data.is_missing_types) {
@@ -497,31 +531,33 @@ void ProfileCompilationInfo::AddInlineCacheToBuffer(std::vector<uint8_t>* buffer
       AddUintToBuffer(buffer, kIsMissingTypesEncoding);
       continue;
     } else if (dex_pc_data.is_megamorphic) {
+      // Megamorphic receivers are followed by the most frequent types they have seen.
       DCHECK_EQ(classes.size(), 0u);
       AddUintToBuffer(buffer, kIsMegamorphicEncoding);
-      continue;
+    } else {
+      DCHECK_LT(classes.size(), InlineCache::kIndividualCacheSize);
+      DCHECK_NE(classes.size(), 0u) << "InlineCache contains a dex_pc with 0 classes";
+      DCHECK_EQ(classes.size(), dex_pc_data.class_counts.size());
     }
 
-    DCHECK_LT(classes.size(), InlineCache::kIndividualCacheSize);
-    DCHECK_NE(classes.size(), 0u) << "InlineCache contains a dex_pc with 0 classes";
-
-    SafeMap<uint8_t, std::vector<dex::TypeIndex>> dex_to_classes_map;
+    SafeMap<uint8_t, std::vector<std::pair<dex::TypeIndex, uint32_t>>> dex_to_classes_map;
     // Group the classes by dex. We expect that most of the classes will come from
     // the same dex, so this will be more efficient than encoding the dex index
     // for each class reference.
-    GroupClassesByDex(classes, &dex_to_classes_map);
+    GroupClassCountsByDex(dex_pc_data.class_counts, &dex_to_classes_map);
     // Add the dex map size.
     AddUintToBuffer(buffer, static_cast<uint8_t>(dex_to_classes_map.size()));
     for (const auto& dex_it : dex_to_classes_map) {
       uint8_t dex_profile_index = dex_it.first;
-      const std::vector<dex::TypeIndex>& dex_classes = dex_it.second;
+      const std::vector<std::pair<dex::TypeIndex, uint32_t>>& dex_classes = dex_it.second;
       // Add the dex profile index.
       AddUintToBuffer(buffer, dex_profile_index);
       // Add the the number of classes for each dex profile index.
       AddUintToBuffer(buffer, static_cast<uint8_t>(dex_classes.size()));
       for (size_t i = 0; i < dex_classes.size(); i++) {
-        // Add the type index of the classes.
-        AddUintToBuffer(buffer, dex_classes[i].index_);
+        // Add the type index of the classes and the number of times they were seen.
+        AddUintToBuffer(buffer, dex_classes[i].first.index_);
+        AddUintToBuffer(buffer, dex_classes[i].second);
       }
     }
   }
@@ -534,27 +570,33 @@ uint32_t ProfileCompilationInfo::GetMethodsRegionSize(const DexFileData& dex_dat
     const InlineCacheMap& inline_cache = method_it.second;
     size += sizeof(uint16_t) * inline_cache.size();  // dex_pc
     for (const auto& inline_cache_it : inline_cache) {
-      const ClassSet& classes = inline_cache_it.second.classes;
-      SafeMap<uint8_t, std::vector<dex::TypeIndex>> dex_to_classes_map;
-      GroupClassesByDex(classes, &dex_to_classes_map);
-      size += sizeof(uint8_t);  // dex_to_classes_map size
+      const DexPcData& dex_pc_data = inline_cache_it.second;
+      size += sizeof(uint8_t);  // dex_to_classes_map size or encoding
+      if (dex_pc_data.is_missing_types) {
+        continue;
+      } else if (dex_pc_data.is_megamorphic) {
+        size += sizeof(uint8_t);  // dex_to_classes_map size
+      }
+      SafeMap<uint8_t, std::vector<std::pair<dex::TypeIndex, uint32_t>>> dex_to_classes_map;
+      GroupClassCountsByDex(dex_pc_data.class_counts, &dex_to_classes_map);
       for (const auto& dex_it : dex_to_classes_map) {
         size += sizeof(uint8_t);  // dex profile index
         size += sizeof(uint8_t);  // number of classes
-        const std::vector<dex::TypeIndex>& dex_classes = dex_it.second;
-        size += sizeof(uint16_t) * dex_classes.size();  // the actual classes
+        size_t number_of_classes = dex_it.second.size();
+        size += (sizeof(uint16_t) + sizeof(uint32_t)) * number_of_classes;  // classes and counts
       }
     }
   }
   return size;
 }
 
-void ProfileCompilationInfo::GroupClassesByDex(
-    const ClassSet& classes,
-    /*out*/SafeMap<uint8_t, std::vector<dex::TypeIndex>>* dex_to_classes_map) {
-  for (const auto& classes_it : classes) {
-    auto dex_it = dex_to_classes_map->FindOrAdd(classes_it.dex_profile_index);
-    dex_it->second.push_back(classes_it.type_index);
+void ProfileCompilationInfo::GroupClassCountsByDex(
+    const ClassCounts& class_counts,
+    /*out*/SafeMap<uint8_t, std::vector<std::pair<dex::TypeIndex, uint32_t>>>*
+        dex_to_classes_map) {
+  for (const auto& counts_it : class_counts) {
+    auto dex_it = dex_to_classes_map->FindOrAdd(counts_it.first.dex_profile_index);
+    dex_it->second.emplace_back(counts_it.first.type_index, counts_it.second);
   }
 }
 
@@ -672,8 +714,8 @@ bool ProfileCompilationInfo::AddMethod(const std::string& dex_location,
     uint16_t pmi_ic_dex_pc = pmi_inline_cache_it.first;
     const DexPcData& pmi_ic_dex_pc_data = pmi_inline_cache_it.second;
     DexPcData* dex_pc_data = FindOrAddDexPc(inline_cache, pmi_ic_dex_pc);
-    if (dex_pc_data->is_missing_types || dex_pc_data->is_megamorphic) {
-      // We are already megamorphic or we are missing types; no point in going forward.
+    if (dex_pc_data->is_missing_types) {
+      // We are missing types; no point in going forward.
       continue;
     }
 
@@ -683,10 +725,11 @@ bool ProfileCompilationInfo::AddMethod(const std::string& dex_location,
     }
     if (pmi_ic_dex_pc_data.is_megamorphic) {
       dex_pc_data->SetIsMegamorphic();
-      continue;
     }
 
-    for (const ClassReference& class_ref : pmi_ic_dex_pc_data.classes) {
+    // The histogram contains all the classes of non megamorphic receivers.
+    for (const auto& class_count : pmi_ic_dex_pc_data.class_counts) {
+      const ClassReference& class_ref = class_count.first;
       const DexReference& dex_ref = pmi.dex_references[class_ref.dex_profile_index];
       DexFileData* class_dex_data = GetOrAddDexFileData(
           GetProfileDexFileKey(dex_ref.dex_location),
@@ -695,7 +738,8 @@ bool ProfileCompilationInfo::AddMethod(const std::string& dex_location,
       if (class_dex_data == nullptr) {  // checksum mismatch
         return false;
       }
-      dex_pc_data->AddClass(class_dex_data->profile_index, class_ref.type_index);
+      dex_pc_data->AddClass(
+          class_dex_data->profile_index, class_ref.type_index, class_count.second);
     }
   }
   return true;
@@ -717,7 +761,8 @@ bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& pmi, MethodHotne
       FindOrAddDexPc(inline_cache, cache.dex_pc)->SetIsMissingTypes();
       continue;
     }
-    for (const TypeReference& class_ref : cache.classes) {
+    for (size_t i = 0; i < cache.classes.size(); ++i) {
+      const TypeReference& class_ref = cache.classes[i];
       DexFileData* class_dex_data = GetOrAddDexFileData(class_ref.dex_file);
       if (class_dex_data == nullptr) {  // checksum mismatch
         return false;
@@ -727,7 +772,8 @@ bool ProfileCompilationInfo::AddMethod(const ProfileMethodInfo& pmi, MethodHotne
         // Don't bother adding classes if we are missing types.
         break;
       }
-      dex_pc_data->AddClass(class_dex_data->profile_index, class_ref.TypeIndex());
+      uint32_t count = cache.counts.empty() ? 0u : cache.counts[i];
+      dex_pc_data->AddClass(class_dex_data->profile_index, class_ref.TypeIndex(), count);
     }
   }
   return true;
@@ -773,8 +819,9 @@ bool ProfileCompilationInfo::ReadInlineCache(
       continue;
     }
     if (dex_to_classes_map_size == kIsMegamorphicEncoding) {
+      // The encoding is followed by the histogram of the most frequent types.
       dex_pc_data->SetIsMegamorphic();
-      continue;
+      READ_UINT(uint8_t, buffer, dex_to_classes_map_size, error);
     }
     for (; dex_to_classes_map_size > 0; dex_to_classes_map_size--) {
       uint8_t dex_profile_index;
@@ -788,14 +835,16 @@ bool ProfileCompilationInfo::ReadInlineCache(
       }
       for (; dex_classes_size > 0; dex_classes_size--) {
         uint16_t type_index;
+        uint32_t count;
         READ_UINT(uint16_t, buffer, type_index, error);
+        READ_UINT(uint32_t, buffer, count, error);
         auto it = dex_profile_index_remap.find(dex_profile_index);
         if (it == dex_profile_index_remap.end()) {
           // If we don't have an index that's because the dex file was filtered out when loading.
           // Set missing types on the dex pc data.
           dex_pc_data->SetIsMissingTypes();
         } else {
-          dex_pc_data->AddClass(it->second, dex::TypeIndex(type_index));
+          dex_pc_data->AddClass(it->second, dex::TypeIndex(type_index), count);
         }
       }
     }
@@ -1116,17 +1165,17 @@ bool ProfileCompilationInfo::VerifyProfileData(const std::vector<const DexFile*>
       const InlineCacheMap &inline_cache_map = method_it.second;
       for (const auto& inline_cache_it : inline_cache_map) {
         const DexPcData dex_pc_data = inline_cache_it.second;
-        if (dex_pc_data.is_missing_types || dex_pc_data.is_megamorphic) {
+        if (dex_pc_data.is_missing_types) {
           // No class indices to verify.
           continue;
         }
 
-        const ClassSet &classes = dex_pc_data.classes;
+        // The histogram also contains the classes of megamorphic receivers.
         SafeMap<uint8_t, std::vector<dex::TypeIndex>> dex_to_classes_map;
-        // Group the classes by dex. We expect that most of the classes will come from
-        // the same dex, so this will be more efficient than encoding the dex index
-        // for each class reference.
-        GroupClassesByDex(classes, &dex_to_classes_map);
+        for (const auto& class_count : dex_pc_data.class_counts) {
+          dex_to_classes_map.FindOrAdd(class_count.first.dex_profile_index)->second.push_back(
+              class_count.first.type_index);
+        }
         for (const auto &dex_it : dex_to_classes_map) {
           uint8_t dex_profile_index = dex_it.first;
           const auto dex_file_inline_cache_it = key_to_dex_file.find(
@@ -1532,16 +1581,18 @@ bool ProfileCompilationInfo::MergeWith(const ProfileCompilationInfo& other,
       const auto& other_inline_cache = other_method_it.second;
       for (const auto& other_ic_it : other_inline_cache) {
         uint16_t other_dex_pc = other_ic_it.first;
-        const ClassSet& other_class_set = other_ic_it.second.classes;
+        const ClassCounts& other_class_counts = other_ic_it.second.class_counts;
         DexPcData* dex_pc_data = FindOrAddDexPc(inline_cache, other_dex_pc);
         if (other_ic_it.second.is_missing_types) {
           dex_pc_data->SetIsMissingTypes();
-        } else if (other_ic_it.second.is_megamorphic) {
-          dex_pc_data->SetIsMegamorphic();
         } else {
-          for (const auto& class_it : other_class_set) {
-            dex_pc_data->AddClass(dex_profile_index_remap.Get(
-                class_it.dex_profile_index), class_it.type_index);
+          if (other_ic_it.second.is_megamorphic) {
+            dex_pc_data->SetIsMegamorphic();
+          }
+          for (const auto& class_it : other_class_counts) {
+            dex_pc_data->AddClass(dex_profile_index_remap.Get(class_it.first.dex_profile_index),
+                                  class_it.first.type_index,
+                                  class_it.second);
           }
         }
       }
@@ -42,12 +42,20 @@ struct ProfileMethodInfo {
   struct ProfileInlineCache {
     ProfileInlineCache(uint32_t pc,
                        bool missing_types,
-                       const std::vector<TypeReference>& profile_classes)
-        : dex_pc(pc), is_missing_types(missing_types), classes(profile_classes) {}
+                       const std::vector<TypeReference>& profile_classes,
+                       const std::vector<uint32_t>& profile_counts = std::vector<uint32_t>())
+        : dex_pc(pc),
+          is_missing_types(missing_types),
+          classes(profile_classes),
+          counts(profile_counts) {
+      DCHECK(counts.empty() || counts.size() == classes.size());
+    }
 
     const uint32_t dex_pc;
     const bool is_missing_types;
     const std::vector<TypeReference> classes;
+    // Number of times each of `classes` has been seen, or empty if unknown.
+    const std::vector<uint32_t> counts;
   };
 
   explicit ProfileMethodInfo(MethodReference reference) : ref(reference) {}
@@ -132,15 +140,21 @@ class ProfileCompilationInfo {
   // The set of classes that can be found at a given dex pc.
   using ClassSet = ArenaSet<ClassReference>;
 
+  // The number of times each class has been seen at a given dex pc.
+  using ClassCounts = ArenaSafeMap<ClassReference, uint32_t>;
+
   // Encodes the actual inline cache for a given dex pc (whether or not the receiver is
   // megamorphic and its possible types).
   // If the receiver is megamorphic or is missing types the set of classes will be empty.
+  // The receiver type histogram is kept for megamorphic receivers, so that the compiler
+  // can still guard for their dominant types.
   struct DexPcData : public ArenaObject<kArenaAllocProfile> {
     explicit DexPcData(ArenaAllocator* allocator)
         : is_missing_types(false),
           is_megamorphic(false),
-          classes(std::less<ClassReference>(), allocator->Adapter(kArenaAllocProfile)) {}
-    void AddClass(uint16_t dex_profile_idx, const dex::TypeIndex& type_idx);
+          classes(std::less<ClassReference>(), allocator->Adapter(kArenaAllocProfile)),
+          class_counts(std::less<ClassReference>(), allocator->Adapter(kArenaAllocProfile)) {}
+    void AddClass(uint16_t dex_profile_idx, const dex::TypeIndex& type_idx, uint32_t count = 0);
     void SetIsMegamorphic() {
       if (is_missing_types) return;
       is_megamorphic = true;
@@ -150,6 +164,7 @@ class ProfileCompilationInfo {
       is_megamorphic = false;
       is_missing_types = true;
       classes.clear();
+      class_counts.clear();
     }
     bool operator==(const DexPcData& other) const {
       return is_megamorphic == other.is_megamorphic &&
@@ -163,6 +178,14 @@ class ProfileCompilationInfo {
     bool is_missing_types;
     bool is_megamorphic;
     ClassSet classes;
+    // Histogram of the receiver types seen at the dex pc. It contains all of `classes`
+    // and, for megamorphic receivers, the most frequent types seen before the inline
+    // cache overflowed. It holds at most InlineCache::kIndividualCacheSize entries.
+    // The counts are not part of the equality test, as they only weigh the types.
+    ClassCounts class_counts;
+
+   private:
+    void AddClassCount(const ClassReference& ref, uint32_t count);
   };
 
   // The inline cache map: DexPc -> DexPcData.
@@ -205,6 +228,11 @@ class ProfileCompilationInfo {
       return flags_ != 0;
     }
 
+    // Number of profiled call sites of a hot method.
+    size_t GetInlineCacheCount() const {
+      return inline_cache_map_ != nullptr ? inline_cache_map_->size() : 0u;
+    }
+
    private:
     const InlineCacheMap* inline_cache_map_ = nullptr;
     uint8_t flags_ = 0;
@@ -780,11 +808,12 @@ class ProfileCompilationInfo {
   // for the methods in dex_data.
   uint32_t GetMethodsRegionSize(const DexFileData& dex_data);
 
-  // Group `classes` by their owning dex profile index and put the result in
-  // `dex_to_classes_map`.
-  void GroupClassesByDex(
-      const ClassSet& classes,
-      /*out*/SafeMap<uint8_t, std::vector<dex::TypeIndex>>* dex_to_classes_map);
+  // Group the classes of `class_counts` and their counts by their owning dex profile
+  // index and put the result in `dex_to_classes_map`.
+  void GroupClassCountsByDex(
+      const ClassCounts& class_counts,
+      /*out*/SafeMap<uint8_t, std::vector<std::pair<dex::TypeIndex, uint32_t>>>*
+          dex_to_classes_map);
 
   // Find the data for the dex_pc in the inline cache. Adds an empty entry
   // if no previous data exists.
@@ -672,6 +672,57 @@ TEST_F(ProfileCompilationInfoTest, MegamorphicInlineCaches) {
   ASSERT_TRUE(*loaded_pmi1 == pmi_extra);
 }
 
+TEST_F(ProfileCompilationInfoTest, SaveInlineCacheHistograms) {
+  ScratchFile profile;
+
+  ProfileCompilationInfo::InlineCacheMap* ic_map = CreateInlineCacheMap();
+  // Polymorphic
+  ProfileCompilationInfo::DexPcData polymorphic(allocator_.get());
+  polymorphic.AddClass(0, dex::TypeIndex(0), /* count */ 10);
+  polymorphic.AddClass(1, dex::TypeIndex(1), /* count */ 30);
+  polymorphic.AddClass(0, dex::TypeIndex(0), /* count */ 5);
+  ic_map->Put(/* dex_pc */ 0, polymorphic);
+  // Megamorphic, only the most frequent types are kept.
+  ProfileCompilationInfo::DexPcData megamorphic(allocator_.get());
+  for (uint16_t k = 0; k <= 2 * InlineCache::kIndividualCacheSize; k++) {
+    megamorphic.AddClass(0, dex::TypeIndex(k), /* count */ k + 1u);
+  }
+  ic_map->Put(/* dex_pc */ 1, megamorphic);
+
+  ProfileCompilationInfo::OfflineProfileMethodInfo pmi(ic_map);
+  pmi.dex_references.emplace_back("dex_location1", /* checksum */ 1, kMaxMethodIds);
+  pmi.dex_references.emplace_back("dex_location2", /* checksum */ 2, kMaxMethodIds);
+
+  ProfileCompilationInfo saved_info;
+  ASSERT_TRUE(AddMethod("dex_location1", /* checksum */ 1, /* method_idx */ 0, pmi, &saved_info));
+  ASSERT_TRUE(saved_info.Save(GetFd(profile)));
+  ASSERT_EQ(0, profile.GetFile()->Flush());
+
+  ProfileCompilationInfo loaded_info;
+  ASSERT_TRUE(profile.GetFile()->ResetOffset());
+  ASSERT_TRUE(loaded_info.Load(GetFd(profile)));
+  ASSERT_TRUE(loaded_info.Equals(saved_info));
+
+  std::unique_ptr<ProfileCompilationInfo::OfflineProfileMethodInfo> loaded_pmi =
+      loaded_info.GetMethod("dex_location1", /* checksum */ 1, /* method_idx */ 0);
+  ASSERT_TRUE(loaded_pmi != nullptr);
+  ASSERT_TRUE(*loaded_pmi == pmi);
+
+  const ProfileCompilationInfo::DexPcData& loaded_polymorphic = loaded_pmi->inline_caches->Get(0);
+  ASSERT_EQ(2u, loaded_polymorphic.class_counts.size());
+  for (const auto& class_count : loaded_polymorphic.class_counts) {
+    ASSERT_EQ(class_count.first.type_index == dex::TypeIndex(0) ? 15u : 30u, class_count.second);
+  }
+
+  const ProfileCompilationInfo::DexPcData& loaded_megamorphic = loaded_pmi->inline_caches->Get(1);
+  ASSERT_TRUE(loaded_megamorphic.is_megamorphic);
+  ASSERT_EQ(InlineCache::kIndividualCacheSize, loaded_megamorphic.class_counts.size());
+  for (const auto& class_count : loaded_megamorphic.class_counts) {
+    ASSERT_GT(class_count.first.type_index.index_, InlineCache::kIndividualCacheSize);
+    ASSERT_EQ(class_count.first.type_index.index_ + 1u, class_count.second);
+  }
+}
+
 TEST_F(ProfileCompilationInfoTest, MissingTypesInlineCaches) {
   ScratchFile profile;
 
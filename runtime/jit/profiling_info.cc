@@ -30,6 +30,8 @@ ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& ent
         method_(method),
         is_method_being_compiled_(false),
         is_osr_method_being_compiled_(false),
+        is_baseline_compiled_(false),
+        is_optimized_compilation_enqueued_(false),
         current_inline_uses_(0),
         saved_entry_point_(nullptr) {
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
@@ -79,13 +81,25 @@ InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
   UNREACHABLE();
 }
 
+void ProfilingInfo::IncrementCount(InlineCache* cache, size_t index) {
+  if (cache->counts_[index] == std::numeric_limits<uint16_t>::max()) {
+    // Halve all counts to keep their ratios. This also ages the counts, so that the
+    // histogram follows changes in the receiver types.
+    for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
+      cache->counts_[i] /= 2;
+    }
+  }
+  cache->counts_[index]++;
+}
+
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
     if (marked == cls) {
-      // Receiver type is already in the cache, nothing else to do.
+      // Receiver type is already in the cache, just count it.
+      IncrementCount(cache, i);
       return;
     } else if (marked == nullptr) {
       // Cache entry is empty, try to put `cls` in it.
@@ -100,7 +114,9 @@ void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
         // entry in case the entry contains `cls`.
         --i;
       } else {
-        // We successfully set `cls`, just return.
+        // We successfully set `cls`, the entry may have been used by a class that has
+        // since been unloaded, so restart its count.
+        cache->counts_[i] = 1u;
         return;
       }
     }
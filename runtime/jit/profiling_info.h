@@ -44,6 +44,10 @@ class InlineCache {
  private:
   uint32_t dex_pc_;
   GcRoot<mirror::Class> classes_[kIndividualCacheSize];
+  // Number of times the corresponding entry of classes_ has been seen as receiver.
+  // The counts are updated without synchronization, and halved when one of them
+  // saturates, so they are only meaningful relative to each other.
+  uint16_t counts_[kIndividualCacheSize];
 
   friend class jit::JitCodeCache;
   friend class ProfilingInfo;
@@ -91,6 +95,24 @@ class ProfilingInfo {
     }
   }
 
+  // Whether the JIT code installed for the method comes from the baseline compiler.
+  bool IsBaselineCompiled() const {
+    return is_baseline_compiled_;
+  }
+
+  void SetIsBaselineCompiled(bool value) {
+    is_baseline_compiled_ = value;
+  }
+
+  // Whether the baseline code of the ArtMethod has enqueued its optimized compilation.
+  bool IsOptimizedCompilationEnqueued() const {
+    return is_optimized_compilation_enqueued_;
+  }
+
+  void SetIsOptimizedCompilationEnqueued(bool value) {
+    is_optimized_compilation_enqueued_ = value;
+  }
+
   void SetSavedEntryPoint(const void* entry_point) {
     saved_entry_point_ = entry_point;
   }
@@ -105,6 +127,7 @@ class ProfilingInfo {
       memset(&cache->classes_[0],
              0,
              InlineCache::kIndividualCacheSize * sizeof(GcRoot<mirror::Class>));
+      memset(&cache->counts_[0], 0, InlineCache::kIndividualCacheSize * sizeof(uint16_t));
     }
   }
 
@@ -132,6 +155,9 @@ class ProfilingInfo {
  private:
   ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
 
+  // Count one more occurrence of the receiver type at `index` in `cache`.
+  static void IncrementCount(InlineCache* cache, size_t index);
+
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
@@ -146,6 +172,15 @@ class ProfilingInfo {
   bool is_method_being_compiled_;
   bool is_osr_method_being_compiled_;
 
+  // Whether the last non-OSR code committed for the ArtMethod was compiled by the
+  // baseline compiler, and can therefore be replaced by optimized code. This flag
+  // is implicitly guarded by the JIT code cache lock.
+  bool is_baseline_compiled_;
+
+  // Whether an optimized compilation of the ArtMethod is waiting in the JIT thread pool.
+  // This flag is implicitly guarded by the JIT code cache lock.
+  bool is_optimized_compilation_enqueued_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
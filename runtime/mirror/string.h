@@ -24,6 +24,7 @@
 namespace art {
 
 template<class T> class Handle;
+class StringBuilderAppend;
 struct StringOffsets;
 class StringPiece;
 class StubTest_ReadBarrierForRoot_Test;
@@ -268,6 +269,7 @@ class MANAGED String FINAL : public Object {
 
   static GcRoot<Class> java_lang_String_;
 
+  friend class art::StringBuilderAppend;  // for Alloc() and IsASCII()
   friend struct art::StringOffsets;  // for verifying offset information
   ART_FRIEND_TEST(art::StubTest, ReadBarrierForRoot);  // For java_lang_String_.
 
@@ -147,16 +147,7 @@ class MANAGED VarHandle : public Object {
   static void ResetClass() REQUIRES_SHARED(Locks::mutator_lock_);
   static void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
 
- private:
-  Class* GetCoordinateType0() REQUIRES_SHARED(Locks::mutator_lock_);
-  Class* GetCoordinateType1() REQUIRES_SHARED(Locks::mutator_lock_);
-  int32_t GetAccessModesBitMask() REQUIRES_SHARED(Locks::mutator_lock_);
-
-  static MethodType* GetMethodTypeForAccessMode(Thread* self,
-                                                ObjPtr<VarHandle> var_handle,
-                                                AccessMode access_mode)
-      REQUIRES_SHARED(Locks::mutator_lock_);
-
+  // Offsets used by the compiled VarHandle accessors.
   static MemberOffset VarTypeOffset() {
     return MemberOffset(OFFSETOF_MEMBER(VarHandle, var_type_));
   }
@@ -173,6 +164,16 @@ class MANAGED VarHandle : public Object {
     return MemberOffset(OFFSETOF_MEMBER(VarHandle, access_modes_bit_mask_));
   }
 
+ private:
+  Class* GetCoordinateType0() REQUIRES_SHARED(Locks::mutator_lock_);
+  Class* GetCoordinateType1() REQUIRES_SHARED(Locks::mutator_lock_);
+  int32_t GetAccessModesBitMask() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static MethodType* GetMethodTypeForAccessMode(Thread* self,
+                                                ObjPtr<VarHandle> var_handle,
+                                                AccessMode access_mode)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   HeapReference<mirror::Class> coordinate_type0_;
   HeapReference<mirror::Class> coordinate_type1_;
   HeapReference<mirror::Class> var_type_;
@@ -203,11 +204,12 @@ class MANAGED FieldVarHandle : public VarHandle {
   static void ResetClass() REQUIRES_SHARED(Locks::mutator_lock_);
   static void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
 
- private:
   static MemberOffset ArtFieldOffset() {
     return MemberOffset(OFFSETOF_MEMBER(FieldVarHandle, art_field_));
   }
 
+ private:
+
   // ArtField instance corresponding to variable for accessors.
   int64_t art_field_;
 
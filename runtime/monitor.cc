@@ -16,6 +16,8 @@
 
 #include "monitor.h"
 
+#include <unistd.h>
+
 #include <vector>
 
 #include "android-base/stringprintf.h"
@@ -27,6 +29,7 @@
 #include "base/stl_util.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
+#include "base/utils.h"
 #include "class_linker.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_types.h"
@@ -60,7 +63,8 @@ static constexpr uint64_t kLongWaitMs = 100 * kDebugThresholdFudgeFactor;
  *
  * The two states of an Object's lock are referred to as "thin" and "fat".  A lock may transition
  * from the "thin" state to the "fat" state and this transition is referred to as inflation. Once
- * a lock has been inflated it remains in the "fat" state indefinitely.
+ * a lock has been inflated it remains in the "fat" state until it is deflated, which is only done
+ * with all threads suspended: by the GC for monitors that are idle, and on heap trims.
  *
  * The lock value itself is stored in mirror::Object::monitor_ and the representation is described
  * in the LockWord value type.
@@ -78,6 +82,7 @@ static constexpr uint64_t kLongWaitMs = 100 * kDebugThresholdFudgeFactor;
 
 uint32_t Monitor::lock_profiling_threshold_ = 0;
 uint32_t Monitor::stack_dump_lock_profiling_threshold_ = 0;
+bool Monitor::spin_on_contention_ = false;
 
 void Monitor::Init(uint32_t lock_profiling_threshold,
                    uint32_t stack_dump_lock_profiling_threshold) {
@@ -87,6 +92,7 @@ void Monitor::Init(uint32_t lock_profiling_threshold,
       lock_profiling_threshold * kDebugThresholdFudgeFactor;
   stack_dump_lock_profiling_threshold_ =
       stack_dump_lock_profiling_threshold * kDebugThresholdFudgeFactor;
+  spin_on_contention_ = sysconf(_SC_NPROCESSORS_CONF) > 1;
 }
 
 Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_code)
@@ -95,6 +101,8 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      spin_budget_(kMinSpinBudget),
+      contended_since_deflation_(false),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       hash_code_(hash_code),
@@ -118,6 +126,8 @@ Monitor::Monitor(Thread* self, Thread* owner, mirror::Object* obj, int32_t hash_
       num_waiters_(0),
       owner_(owner),
       lock_count_(0),
+      spin_budget_(kMinSpinBudget),
+      contended_since_deflation_(false),
       obj_(GcRoot<mirror::Object>(obj)),
       wait_set_(nullptr),
       hash_code_(hash_code),
@@ -409,16 +419,49 @@ class ScopedAssertNotHeld {
   DISALLOW_COPY_AND_ASSIGN(ScopedAssertNotHeld);
 };
 
+bool Monitor::SpinWhileOwned(Thread* self, uint32_t iterations) {
+  for (uint32_t i = 0; i != iterations; ++i) {
+    SpinLoopHint();
+    if (owner_ == nullptr) {
+      return true;
+    }
+    if (UNLIKELY(self->TestAllFlags())) {
+      // Do not delay a suspension or checkpoint request.
+      return false;
+    }
+  }
+  return false;
+}
+
 template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   ScopedAssertNotHeld sanh(self, monitor_lock_);
   bool called_monitors_callback = false;
+  bool spun = false;
   monitor_lock_.Lock(self);
   while (true) {
     if (TryLockLocked(self)) {
       break;
     }
     // Contended.
+    contended_since_deflation_ = true;
+    if (reason == LockReason::kForLock && spin_on_contention_ && !spun) {
+      // The owner is likely running and about to release the monitor. Spin before blocking, for
+      // as long as spinning has recently paid off on this monitor.
+      spun = true;
+      Runtime::Current()->GetMonitorList()->RecordSpin();
+      const uint32_t budget = spin_budget_;
+      monitor_lock_.Unlock(self);
+      const bool released = SpinWhileOwned(self, budget);
+      monitor_lock_.Lock(self);
+      if (released && TryLockLocked(self)) {
+        spin_budget_ = (budget < kMaxSpinBudget / 2u) ? budget * 2u : kMaxSpinBudget;
+        break;
+      }
+      if (!released) {
+        spin_budget_ = (budget > kMinSpinBudget * 2u) ? budget / 2u : kMinSpinBudget;
+      }
+    }
     const bool log_contention = (lock_profiling_threshold_ != 0);
     uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
     ArtMethod* owners_method = locking_method_;
@@ -904,6 +947,25 @@ void Monitor::NotifyAll(Thread* self) {
   }
 }
 
+bool Monitor::DeflateIfIdle(Thread* self, mirror::Object* obj) {
+  DCHECK(obj != nullptr);
+  // Don't need volatile since we only deflate with mutators suspended.
+  LockWord lw(obj->GetLockWord(false));
+  if (lw.GetState() == LockWord::kFatLocked) {
+    Monitor* monitor = lw.FatLockMonitor();
+    DCHECK(monitor != nullptr);
+    MutexLock mu(self, monitor->monitor_lock_);
+    // A contended monitor would likely be inflated again soon, give it another GC cycle.
+    const bool contended = monitor->contended_since_deflation_;
+    monitor->contended_since_deflation_ = false;
+    if (monitor->owner_ != nullptr || monitor->num_waiters_ > 0 || contended) {
+      return false;
+    }
+  }
+  // Nothing changes after releasing monitor_lock_ since mutators are suspended.
+  return Deflate(self, obj);
+}
+
 bool Monitor::Deflate(Thread* self, mirror::Object* obj) {
   DCHECK(obj != nullptr);
   // Don't need volatile since we only deflate with mutators suspended.
@@ -1021,6 +1083,28 @@ static mirror::Object* FakeUnlock(mirror::Object* obj)
   return obj;
 }
 
+bool Monitor::SpinWhileThinLocked(Thread* self,
+                                  Handle<mirror::Object> obj,
+                                  uint32_t owner_thread_id) {
+  if (!spin_on_contention_) {
+    return false;
+  }
+  Runtime::Current()->GetMonitorList()->RecordSpin();
+  for (size_t i = 0; i != kThinLockSpinIterations; ++i) {
+    SpinLoopHint();
+    LockWord lock_word = obj->GetLockWord(true);
+    if (lock_word.GetState() != LockWord::kThinLocked ||
+        lock_word.ThinLockOwner() != owner_thread_id) {
+      return true;
+    }
+    if (UNLIKELY(self->TestAllFlags())) {
+      // Do not delay a suspension or checkpoint request.
+      return false;
+    }
+  }
+  return false;
+}
+
 mirror::Object* Monitor::MonitorEnter(Thread* self, mirror::Object* obj, bool trylock) {
   DCHECK(self != nullptr);
   DCHECK(obj != nullptr);
@@ -1081,15 +1165,16 @@ mirror::Object* Monitor::MonitorEnter(Thread* self, mirror::Object* obj, bool tr
           contention_count++;
           Runtime* runtime = Runtime::Current();
           if (contention_count <= runtime->GetMaxSpinsBeforeThinLockInflation()) {
-            // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
-            // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much longer
-            // than the parameter you pass in. This can cause thread suspension to take excessively
-            // long and make long pauses. See b/16307460.
-            // TODO: We should literally spin first, without sched_yield. Sched_yield either does
-            // nothing (at significant expense), or guarantees that we wait at least microseconds.
-            // If the owner is running, I would expect the median lock hold time to be hundreds
-            // of nanoseconds or less.
-            sched_yield();
+            // If the owner is running, the median lock hold time is expected to be hundreds of
+            // nanoseconds or less. Spin first: sched_yield either does nothing (at significant
+            // expense), or guarantees that we wait at least microseconds.
+            if (!SpinWhileThinLocked(self, h_obj, owner_thread_id)) {
+              // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
+              // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much
+              // longer than the parameter you pass in. This can cause thread suspension to take
+              // excessively long and make long pauses. See b/16307460.
+              sched_yield();
+            }
           } else {
             contention_count = 0;
             // No ordering required for initial lockword read. Install rereads it anyway.
@@ -1491,7 +1576,12 @@ uint32_t Monitor::GetOwnerThreadId() {
 
 MonitorList::MonitorList()
     : allow_new_monitors_(true), monitor_list_lock_("MonitorList lock", kMonitorListLock),
-      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_) {
+      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_),
+      size_after_deflation_(0u),
+      monitors_to_visit_(0u),
+      spin_count_(0u),
+      inflation_count_(0u),
+      deflation_count_(0u) {
 }
 
 MonitorList::~MonitorList() {
@@ -1536,6 +1626,7 @@ void MonitorList::Add(Monitor* m) {
     monitor_add_condition_.WaitHoldingLocks(self);
   }
   list_.push_front(m);
+  ++inflation_count_;
 }
 
 void MonitorList::SweepMonitorList(IsMarkedVisitor* visitor) {
@@ -1588,9 +1679,65 @@ size_t MonitorList::DeflateMonitors() {
   MonitorDeflateVisitor visitor;
   Locks::mutator_lock_->AssertExclusiveHeld(visitor.self_);
   SweepMonitorList(&visitor);
+  MutexLock mu(visitor.self_, monitor_list_lock_);
+  size_after_deflation_ = list_.size();
+  monitors_to_visit_ = 0u;
+  deflation_count_ += visitor.deflate_count_;
   return visitor.deflate_count_;
 }
 
+size_t MonitorList::DeflateIdleMonitors(size_t max_visited) {
+  Thread* self = Thread::Current();
+  Locks::mutator_lock_->AssertExclusiveHeld(self);
+  MutexLock mu(self, monitor_list_lock_);
+  if (monitors_to_visit_ == 0u) {
+    // Start a new pass over the list.
+    monitors_to_visit_ = list_.size();
+  }
+  // Monitors swept since the previous call may leave fewer to visit.
+  monitors_to_visit_ = std::min(monitors_to_visit_, list_.size());
+  const size_t num_visited = std::min(max_visited, monitors_to_visit_);
+  size_t deflate_count = 0u;
+  // New monitors are added at the front. Visit the monitors from the back and move the ones that
+  // stay inflated to the front, so that successive calls go round the list.
+  for (size_t i = 0; i != num_visited; ++i) {
+    Monitor* m = list_.back();
+    // Disable the read barrier in GetObject() as this is called by GC.
+    mirror::Object* obj = m->GetObject<kWithoutReadBarrier>();
+    // The object of a monitor can be null if we have deflated it.
+    if (obj == nullptr || Monitor::DeflateIfIdle(self, obj)) {
+      if (obj != nullptr) {
+        DCHECK_NE(obj->GetLockWord(true).GetState(), LockWord::kFatLocked);
+        ++deflate_count;
+      }
+      MonitorPool::ReleaseMonitor(self, m);
+      list_.pop_back();
+    } else {
+      list_.splice(list_.begin(), list_, std::prev(list_.end()));
+    }
+  }
+  monitors_to_visit_ -= num_visited;
+  if (monitors_to_visit_ == 0u) {
+    size_after_deflation_ = list_.size();
+  }
+  deflation_count_ += deflate_count;
+  return deflate_count;
+}
+
+bool MonitorList::ShouldDeflateIdleMonitors() {
+  MutexLock mu(Thread::Current(), monitor_list_lock_);
+  return monitors_to_visit_ != 0u ||
+      list_.size() >= size_after_deflation_ + kIdleDeflationThreshold;
+}
+
+void MonitorList::DumpForSigQuit(std::ostream& os) {
+  MutexLock mu(Thread::Current(), monitor_list_lock_);
+  os << "Monitors: " << list_.size() << " inflated; "
+     << inflation_count_ << " inflations; "
+     << deflation_count_ << " deflations; "
+     << spin_count_.LoadRelaxed() << " contended spins\n";
+}
+
 MonitorInfo::MonitorInfo(mirror::Object* obj) : owner_(nullptr), entry_count_(0) {
   DCHECK(obj != nullptr);
   LockWord lock_word = obj->GetLockWord(true);
@@ -59,6 +59,14 @@ class Monitor {
   // a lock word. See Runtime::max_spins_before_thin_lock_inflation_.
   constexpr static size_t kDefaultMaxSpinsBeforeThinLockInflation = 50;
 
+  // How many SpinLoopHint() iterations a thread waits for a contended thin lock to be released
+  // before it yields the CPU.
+  constexpr static size_t kThinLockSpinIterations = 128;
+
+  // Bounds of the spin budget of a contended fat lock, see spin_budget_.
+  constexpr static uint32_t kMinSpinBudget = 16;
+  constexpr static uint32_t kMaxSpinBudget = 4096;
+
   ~Monitor();
 
   static void Init(uint32_t lock_profiling_threshold, uint32_t stack_dump_lock_profiling_threshold);
@@ -147,6 +155,12 @@ class Monitor {
   static bool Deflate(Thread* self, mirror::Object* obj)
       REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
 
+  // Deflate only if nobody owns or waits on the monitor and it was not contended since the last
+  // call for it. Must be called with all other threads suspended.
+  // NO_THREAD_SAFETY_ANALYSIS for monitor->monitor_lock_.
+  static bool DeflateIfIdle(Thread* self, mirror::Object* obj)
+      REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
+
 #ifndef __LP64__
   void* operator new(size_t size) {
     // Align Monitor* as per the monitor ID field size in the lock word.
@@ -282,8 +296,22 @@ class Monitor {
       REQUIRES_SHARED(Locks::mutator_lock_);
   ALWAYS_INLINE static void AtraceMonitorUnlock();
 
+  // Spin while another thread owns the monitor, for at most `iterations` iterations. Returns
+  // true if the monitor was released.
+  bool SpinWhileOwned(Thread* self, uint32_t iterations)
+      NO_THREAD_SAFETY_ANALYSIS;  // Reading the owner without holding the lock is racy.
+
+  // Spin while `obj` is thin locked by `owner_thread_id`, for at most kThinLockSpinIterations
+  // iterations. Returns true if the lock was released or changed state.
+  static bool SpinWhileThinLocked(Thread* self,
+                                  Handle<mirror::Object> obj,
+                                  uint32_t owner_thread_id)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   static uint32_t lock_profiling_threshold_;
   static uint32_t stack_dump_lock_profiling_threshold_;
+  // Spinning only helps if the lock owner can run at the same time.
+  static bool spin_on_contention_;
 
   Mutex monitor_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
@@ -298,6 +326,14 @@ class Monitor {
   // Owner's recursive lock depth.
   int lock_count_ GUARDED_BY(monitor_lock_);
 
+  // How long a contending thread spins before blocking, in SpinLoopHint() iterations. Doubled
+  // when the owner released the monitor within the budget and halved when it did not, so it
+  // follows how long the monitor has recently been held.
+  uint32_t spin_budget_ GUARDED_BY(monitor_lock_);
+
+  // Whether a thread had to wait for the monitor since the last DeflateIfIdle().
+  bool contended_since_deflation_ GUARDED_BY(monitor_lock_);
+
   // What object are we part of. This is a weak root. Do not access
   // this directly, use GetObject() to read it so it will be guarded
   // by a read barrier.
@@ -344,8 +380,26 @@ class MonitorList {
   void BroadcastForNewMonitors() REQUIRES(!monitor_list_lock_);
   // Returns how many monitors were deflated.
   size_t DeflateMonitors() REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
+  // Deflate the monitors that are not in use, see Monitor::DeflateIfIdle. Visits at most
+  // `max_visited` monitors to bound the pause, successive calls continue where the previous one
+  // stopped. Returns how many monitors were deflated.
+  size_t DeflateIdleMonitors(size_t max_visited)
+      REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
+  // Whether a pass over the monitors is in progress, or enough monitors were inflated since the
+  // last one to make deflating idle monitors worth a pause.
+  bool ShouldDeflateIdleMonitors() REQUIRES(!monitor_list_lock_);
   size_t Size() REQUIRES(!monitor_list_lock_);
 
+  void RecordSpin() {
+    spin_count_.FetchAndAddRelaxed(1u);
+  }
+
+  void DumpForSigQuit(std::ostream& os) REQUIRES(!monitor_list_lock_);
+
+  // Number of monitors that need to be inflated after a deflation before idle monitors are
+  // deflated by the GC again.
+  static constexpr size_t kIdleDeflationThreshold = 256;
+
   typedef std::list<Monitor*, TrackingAllocator<Monitor*, kAllocatorTagMonitorList>> Monitors;
 
  private:
@@ -357,6 +411,15 @@ class MonitorList {
   Mutex monitor_list_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable monitor_add_condition_ GUARDED_BY(monitor_list_lock_);
   Monitors list_ GUARDED_BY(monitor_list_lock_);
+  // Size of list_ after the last deflation.
+  size_t size_after_deflation_ GUARDED_BY(monitor_list_lock_);
+  // Number of monitors left to visit by the current DeflateIdleMonitors pass, zero if none.
+  size_t monitors_to_visit_ GUARDED_BY(monitor_list_lock_);
+
+  // Contention statistics: spin-waits for a contended lock, inflated and deflated monitors.
+  Atomic<size_t> spin_count_;
+  size_t inflation_count_ GUARDED_BY(monitor_list_lock_);
+  size_t deflation_count_ GUARDED_BY(monitor_list_lock_);
 
   friend class Monitor;
   DISALLOW_COPY_AND_ASSIGN(MonitorList);
@@ -28,6 +28,7 @@
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
 #include "object_lock.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_list.h"
 #include "thread_pool.h"
 
 namespace art {
@@ -374,5 +375,37 @@ TEST_F(MonitorTest, TestTryLock) {
   thread_pool.StopWorkers(self);
 }
 
+TEST_F(MonitorTest, DeflateIdleMonitors) {
+  Thread* const self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<2> hs(self);
+  Handle<mirror::Object> idle(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "idle")));
+  Handle<mirror::Object> locked(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "locked")));
+  // Taking the identity hash code of a thin locked object inflates its lock.
+  {
+    ObjectLock<mirror::Object> lock(self, idle);
+    idle->IdentityHashCode();
+  }
+  ObjectLock<mirror::Object> lock(self, locked);
+  locked->IdentityHashCode();
+  ASSERT_EQ(LockWord::kFatLocked, idle->GetLockWord(true).GetState());
+  ASSERT_EQ(LockWord::kFatLocked, locked->GetLockWord(true).GetState());
+
+  ScopedThreadSuspension sts(self, kSuspended);
+  ScopedSuspendAll ssa(__FUNCTION__);
+  MonitorList* monitor_list = Runtime::Current()->GetMonitorList();
+  // Visiting no monitor leaves them inflated.
+  EXPECT_EQ(0u, monitor_list->DeflateIdleMonitors(0u));
+  EXPECT_EQ(LockWord::kFatLocked, idle->GetLockWord(true).GetState());
+  // A pass started by an earlier GC may still be in progress, finish it before a full pass.
+  size_t count = monitor_list->DeflateIdleMonitors(monitor_list->Size());
+  count += monitor_list->DeflateIdleMonitors(monitor_list->Size());
+  EXPECT_LE(1u, count);
+  // The unlocked monitor keeps only its hash code, the owned one stays inflated.
+  EXPECT_EQ(LockWord::kHashCode, idle->GetLockWord(true).GetState());
+  EXPECT_EQ(LockWord::kFatLocked, locked->GetLockWord(true).GetState());
+}
 
 }  // namespace art
@@ -838,6 +838,35 @@ bool OatFileBase::Setup(int zip_fd, const char* abs_dex_location, std::string* e
     DCheckIndexToBssMapping(
         this, header->string_ids_size_, sizeof(GcRoot<mirror::String>), string_bss_mapping);
 
+    uint32_t reusable_methods_offset;
+    if (UNLIKELY(!ReadOatDexFileData(*this, &oat, &reusable_methods_offset))) {
+      *error_msg = StringPrintf("In oat file '%s' found OatDexFile #%zd for '%s' truncated "
+                                    "after reusable methods offset",
+                                GetLocation().c_str(),
+                                i,
+                                dex_file_location.c_str());
+      return false;
+    }
+    const size_t reusable_methods_size =
+        BitVector::BitsToWords(header->method_ids_size_) * sizeof(uint32_t);
+    if (reusable_methods_offset != 0u &&
+        (UNLIKELY(reusable_methods_offset > Size()) ||
+            UNLIKELY(!IsAligned<alignof(uint32_t)>(reusable_methods_offset)) ||
+            UNLIKELY(Size() - reusable_methods_offset < reusable_methods_size))) {
+      *error_msg = StringPrintf("In oat file '%s' found OatDexFile #%zu for '%s' with unaligned or "
+                                    "truncated reusable methods, offset %u of %zu, length %zu",
+                                GetLocation().c_str(),
+                                i,
+                                dex_file_location.c_str(),
+                                reusable_methods_offset,
+                                Size(),
+                                reusable_methods_size);
+      return false;
+    }
+    const uint32_t* reusable_methods = reusable_methods_offset != 0u
+        ? reinterpret_cast<const uint32_t*>(Begin() + reusable_methods_offset)
+        : nullptr;
+
     std::string canonical_location =
         DexFileLoader::GetDexCanonicalLocation(dex_file_location.c_str());
 
@@ -851,6 +880,7 @@ bool OatFileBase::Setup(int zip_fd, const char* abs_dex_location, std::string* e
                                               method_bss_mapping,
                                               type_bss_mapping,
                                               string_bss_mapping,
+                                              reusable_methods,
                                               class_offsets_pointer,
                                               dex_layout_sections);
     oat_dex_files_storage_.push_back(oat_dex_file);
@@ -1694,6 +1724,7 @@ OatFile::OatDexFile::OatDexFile(const OatFile* oat_file,
                                 const IndexBssMapping* method_bss_mapping_data,
                                 const IndexBssMapping* type_bss_mapping_data,
                                 const IndexBssMapping* string_bss_mapping_data,
+                                const uint32_t* reusable_methods,
                                 const uint32_t* oat_class_offsets_pointer,
                                 const DexLayoutSections* dex_layout_sections)
     : oat_file_(oat_file),
@@ -1705,6 +1736,7 @@ OatFile::OatDexFile::OatDexFile(const OatFile* oat_file,
       method_bss_mapping_(method_bss_mapping_data),
       type_bss_mapping_(type_bss_mapping_data),
       string_bss_mapping_(string_bss_mapping_data),
+      reusable_methods_(reusable_methods),
       oat_class_offsets_pointer_(oat_class_offsets_pointer),
       dex_layout_sections_(dex_layout_sections) {
   // Initialize TypeLookupTable.
@@ -1728,6 +1760,10 @@ OatFile::OatDexFile::OatDexFile(const OatFile* oat_file,
 OatFile::OatDexFile::OatDexFile(std::unique_ptr<TypeLookupTable>&& lookup_table)
     : lookup_table_(std::move(lookup_table)) {}
 
+bool OatFile::OatDexFile::IsReusableMethod(uint32_t method_idx) const {
+  return reusable_methods_ != nullptr && BitVector::IsBitSet(reusable_methods_, method_idx);
+}
+
 OatFile::OatDexFile::~OatDexFile() {}
 
 size_t OatFile::OatDexFile::FileSize() const {
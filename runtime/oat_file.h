@@ -491,6 +491,10 @@ class OatDexFile FINAL {
     return dex_file_pointer_;
   }
 
+  // Returns whether the compiled code of the method has no linker patches, so that it can be
+  // copied to an oat file compiled from the same dex file, see dex2oat --input-oat.
+  bool IsReusableMethod(uint32_t method_idx) const;
+
   // Looks up a class definition by its class descriptor. Hash must be
   // ComputeModifiedUtf8Hash(descriptor).
   static const DexFile::ClassDef* FindClassDef(const DexFile& dex_file,
@@ -524,6 +528,7 @@ class OatDexFile FINAL {
              const IndexBssMapping* method_bss_mapping,
              const IndexBssMapping* type_bss_mapping,
              const IndexBssMapping* string_bss_mapping,
+             const uint32_t* reusable_methods,
              const uint32_t* oat_class_offsets_pointer,
              const DexLayoutSections* dex_layout_sections);
 
@@ -538,6 +543,7 @@ class OatDexFile FINAL {
   const IndexBssMapping* const method_bss_mapping_ = nullptr;
   const IndexBssMapping* const type_bss_mapping_ = nullptr;
   const IndexBssMapping* const string_bss_mapping_ = nullptr;
+  const uint32_t* const reusable_methods_ = nullptr;
   const uint32_t* const oat_class_offsets_pointer_ = 0u;
   mutable std::unique_ptr<TypeLookupTable> lookup_table_;
   const DexLayoutSections* const dex_layout_sections_ = nullptr;
@@ -1283,9 +1283,15 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
                        xgc_option.verify_post_gc_rosalloc_,
                        xgc_option.gcstress_,
                        xgc_option.measure_,
+                       xgc_option.generational_cc_,
                        runtime_options.GetOrDefault(Opt::EnableHSpaceCompactForOOM),
                        runtime_options.GetOrDefault(Opt::HSpaceCompactForOOMMinIntervalsMs));
 
+  const size_t alloc_sample_interval = runtime_options.GetOrDefault(Opt::AllocSampleInterval);
+  if (alloc_sample_interval != 0u) {
+    heap_->EnableAllocationSampling(alloc_sample_interval);
+  }
+
   if (!heap_->HasBootImageSpace() && !allow_dex_file_fallback_) {
     LOG(ERROR) << "Dex file fallback disabled, cannot continue without image.";
     return false;
@@ -1810,6 +1816,7 @@ void Runtime::DumpDeoptimizations(std::ostream& os) {
 void Runtime::DumpForSigQuit(std::ostream& os) {
   GetClassLinker()->DumpForSigQuit(os);
   GetInternTable()->DumpForSigQuit(os);
+  GetMonitorList()->DumpForSigQuit(os);
   GetJavaVM()->DumpForSigQuit(os);
   GetHeap()->DumpForSigQuit(os);
   oat_file_manager_->DumpForSigQuit(os);
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "string_builder_append.h"
+
+#include <limits>
+
+#include "base/logging.h"
+#include "gc/heap.h"
+#include "handle_scope-inl.h"
+#include "mirror/string-inl.h"
+#include "obj_ptr-inl.h"
+#include "runtime.h"
+#include "stack_reference.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+class StringBuilderAppend::Builder {
+ public:
+  Builder(uint32_t format, const uint32_t* args, Thread* self)
+      : format_(format),
+        args_(args),
+        hs_(self) {}
+
+  // Collects the String arguments in handles and computes the length of the result,
+  // flagged with its compression state. Returns -1 with a pending OutOfMemoryError
+  // if the result does not fit into a String.
+  int32_t CalculateLengthWithFlag() REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Pre-fence visitor filling the newly allocated String.
+  void operator()(ObjPtr<mirror::Object> obj, size_t usable_size) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  static size_t Int64Length(int64_t value);
+
+  template <typename CharType>
+  static CharType* AppendLiteral(CharType* data, const char* literal, size_t length);
+
+  template <typename CharType>
+  static CharType* AppendString(CharType* data, ObjPtr<mirror::String> str)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  template <typename CharType>
+  static CharType* AppendInt64(CharType* data, int64_t value);
+
+  template <typename CharType>
+  void StoreData(ObjPtr<mirror::String> new_string, CharType* data) const
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  static constexpr char kNull[] = "null";
+  static constexpr size_t kNullLength = sizeof(kNull) - 1u;
+  static constexpr char kTrue[] = "true";
+  static constexpr size_t kTrueLength = sizeof(kTrue) - 1u;
+  static constexpr char kFalse[] = "false";
+  static constexpr size_t kFalseLength = sizeof(kFalse) - 1u;
+
+  // The format and arguments passed to StringBuilderAppend::AppendF().
+  const uint32_t format_;
+  const uint32_t* const args_;
+
+  // References to the String arguments, in argument order.
+  StackHandleScope<kMaxArgs> hs_;
+
+  // The length and compression flag of the result, see CalculateLengthWithFlag().
+  int32_t length_with_flag_ = 0;
+};
+
+constexpr char StringBuilderAppend::Builder::kNull[];
+constexpr size_t StringBuilderAppend::Builder::kNullLength;
+constexpr char StringBuilderAppend::Builder::kTrue[];
+constexpr size_t StringBuilderAppend::Builder::kTrueLength;
+constexpr char StringBuilderAppend::Builder::kFalse[];
+constexpr size_t StringBuilderAppend::Builder::kFalseLength;
+
+inline size_t StringBuilderAppend::Builder::Int64Length(int64_t value) {
+  uint64_t v = static_cast<uint64_t>(value);
+  size_t length = 1u;
+  if (value < 0) {
+    ++length;  // For the '-' sign.
+    v = -v;
+  }
+  while (v >= 10u) {
+    ++length;
+    v /= 10u;
+  }
+  return length;
+}
+
+template <typename CharType>
+inline CharType* StringBuilderAppend::Builder::AppendLiteral(CharType* data,
+                                                             const char* literal,
+                                                             size_t length) {
+  for (size_t i = 0; i != length; ++i) {
+    data[i] = static_cast<CharType>(literal[i]);
+  }
+  return data + length;
+}
+
+template <typename CharType>
+inline CharType* StringBuilderAppend::Builder::AppendString(CharType* data,
+                                                            ObjPtr<mirror::String> str) {
+  size_t length = dchecked_integral_cast<size_t>(str->GetLength());
+  if (str->IsCompressed()) {
+    const uint8_t* value = str->GetValueCompressed();
+    if (sizeof(CharType) == sizeof(uint8_t)) {
+      memcpy(data, value, length * sizeof(uint8_t));
+    } else {
+      for (size_t i = 0; i != length; ++i) {
+        data[i] = static_cast<CharType>(value[i]);
+      }
+    }
+  } else {
+    // The result is compressed only if all String arguments are compressed.
+    DCHECK_EQ(sizeof(CharType), sizeof(uint16_t));
+    memcpy(data, str->GetValue(), length * sizeof(uint16_t));
+  }
+  return data + length;
+}
+
+template <typename CharType>
+inline CharType* StringBuilderAppend::Builder::AppendInt64(CharType* data, int64_t value) {
+  size_t length = Int64Length(value);
+  uint64_t v = static_cast<uint64_t>(value);
+  if (value < 0) {
+    data[0] = '-';
+    v = -v;
+  }
+  // Write the digits backwards, starting with the least significant one.
+  CharType* end = data + length;
+  CharType* ptr = end;
+  do {
+    --ptr;
+    *ptr = static_cast<CharType>('0' + static_cast<uint32_t>(v % 10u));
+    v /= 10u;
+  } while (v != 0u);
+  DCHECK_EQ(ptr, data + ((value < 0) ? 1u : 0u));
+  return end;
+}
+
+int32_t StringBuilderAppend::Builder::CalculateLengthWithFlag() {
+  static_assert(static_cast<size_t>(Argument::kEnd) == 0u, "kEnd must be 0.");
+  bool compressible = kUseStringCompression;
+  uint64_t length = 0u;
+  const uint32_t* current_arg = args_;
+  for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
+    DCHECK_LE(f & kArgMask, static_cast<uint32_t>(Argument::kLast));
+    switch (static_cast<Argument>(f & kArgMask)) {
+      case Argument::kString: {
+        Handle<mirror::String> str = hs_.NewHandle(
+            reinterpret_cast<const StackReference<mirror::String>*>(current_arg)->AsMirrorPtr());
+        if (str != nullptr) {
+          length += str->GetLength();
+          compressible = compressible && str->IsCompressed();
+        } else {
+          length += kNullLength;
+        }
+        break;
+      }
+      case Argument::kBoolean: {
+        length += (*current_arg != 0u) ? kTrueLength : kFalseLength;
+        break;
+      }
+      case Argument::kChar: {
+        length += 1u;
+        compressible = compressible &&
+            mirror::String::IsASCII(static_cast<uint16_t>(*current_arg));
+        break;
+      }
+      case Argument::kInt: {
+        length += Int64Length(static_cast<int32_t>(*current_arg));
+        break;
+      }
+      case Argument::kLong: {
+        current_arg = AlignUp(current_arg, sizeof(int64_t));
+        length += Int64Length(*reinterpret_cast<const int64_t*>(current_arg));
+        ++current_arg;  // Skip the low word, let the common code skip the high word.
+        break;
+      }
+      default: {
+        LOG(FATAL) << "Unexpected arg format: 0x" << std::hex << (f & kArgMask)
+            << " full format: 0x" << std::hex << format_;
+        UNREACHABLE();
+      }
+    }
+    ++current_arg;
+  }
+
+  if (length > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+    // We cannot allocate memory for the entire result.
+    hs_.Self()->ThrowOutOfMemoryError("Out of memory for StringBuilder append.");
+    return -1;
+  }
+
+  length_with_flag_ =
+      mirror::String::GetFlaggedCount(static_cast<int32_t>(length), compressible);
+  return length_with_flag_;
+}
+
+template <typename CharType>
+inline void StringBuilderAppend::Builder::StoreData(ObjPtr<mirror::String> new_string,
+                                                    CharType* data) const {
+  CharType* const start = data;
+  size_t handle_index = 0u;
+  const uint32_t* current_arg = args_;
+  for (uint32_t f = format_; f != 0u; f >>= kBitsPerArg) {
+    switch (static_cast<Argument>(f & kArgMask)) {
+      case Argument::kString: {
+        ObjPtr<mirror::String> str = down_cast<mirror::String*>(hs_.GetReference(handle_index));
+        ++handle_index;
+        data = (str != nullptr) ? AppendString(data, str) : AppendLiteral(data, kNull, kNullLength);
+        break;
+      }
+      case Argument::kBoolean: {
+        data = (*current_arg != 0u) ? AppendLiteral(data, kTrue, kTrueLength)
+                                    : AppendLiteral(data, kFalse, kFalseLength);
+        break;
+      }
+      case Argument::kChar: {
+        *data = static_cast<CharType>(static_cast<uint16_t>(*current_arg));
+        ++data;
+        break;
+      }
+      case Argument::kInt: {
+        data = AppendInt64(data, static_cast<int32_t>(*current_arg));
+        break;
+      }
+      case Argument::kLong: {
+        current_arg = AlignUp(current_arg, sizeof(int64_t));
+        data = AppendInt64(data, *reinterpret_cast<const int64_t*>(current_arg));
+        ++current_arg;  // Skip the low word, let the common code skip the high word.
+        break;
+      }
+      default: {
+        LOG(FATAL) << "Unexpected arg format: 0x" << std::hex << (f & kArgMask)
+            << " full format: 0x" << std::hex << format_;
+        UNREACHABLE();
+      }
+    }
+    ++current_arg;
+  }
+  DCHECK_EQ(handle_index, hs_.NumberOfReferences());
+  DCHECK_EQ(data - start, new_string->GetLength());
+}
+
+void StringBuilderAppend::Builder::operator()(ObjPtr<mirror::Object> obj,
+                                              size_t usable_size ATTRIBUTE_UNUSED) const {
+  // Avoid AsString as object is not yet in live bitmap or allocation stack.
+  ObjPtr<mirror::String> new_string = ObjPtr<mirror::String>::DownCast(obj);
+  new_string->SetCount(length_with_flag_);
+  if (kUseStringCompression && mirror::String::IsCompressed(length_with_flag_)) {
+    StoreData(new_string, new_string->GetValueCompressed());
+  } else {
+    StoreData(new_string, new_string->GetValue());
+  }
+}
+
+ObjPtr<mirror::String> StringBuilderAppend::AppendF(uint32_t format,
+                                                    const uint32_t* args,
+                                                    Thread* self) {
+  Builder builder(format, args, self);
+  self->AssertNoPendingException();
+  int32_t length_with_flag = builder.CalculateLengthWithFlag();
+  if (self->IsExceptionPending()) {
+    return nullptr;
+  }
+  gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetCurrentAllocator();
+  ObjPtr<mirror::String> result = mirror::String::Alloc</* kIsInstrumented */ true>(
+      self, length_with_flag, allocator_type, builder);
+
+  return result;
+}
+
+}  // namespace art
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STRING_BUILDER_APPEND_H_
+#define ART_RUNTIME_STRING_BUILDER_APPEND_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/bit_utils.h"
+#include "base/mutex.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class Thread;
+
+namespace mirror {
+class String;
+}  // namespace mirror
+
+// Support for a fused `new StringBuilder().append(...)...append(...).toString()` chain.
+// The compiler replaces such chains with a single runtime call that computes the exact
+// length of the result and allocates and fills the resulting String in one step.
+class StringBuilderAppend {
+ public:
+  enum class Argument : uint8_t {
+    kEnd = 0u,
+    kString,
+    kBoolean,
+    kChar,
+    kInt,
+    kLong,
+    kLast = kLong
+  };
+
+  static constexpr size_t kBitsPerArg = 4u;
+  static constexpr size_t kMaxArgs = BitSizeOf<uint32_t>() / kBitsPerArg;
+  static_assert(kMaxArgs * kBitsPerArg == BitSizeOf<uint32_t>(), "Expecting no extra bits.");
+  static_assert(MinimumBitsToStore(static_cast<size_t>(Argument::kLast)) <= kBitsPerArg,
+                "Argument kinds must fit into kBitsPerArg bits.");
+  static constexpr uint32_t kArgMask = MaxInt<uint32_t>(kBitsPerArg);
+
+  // Appends the arguments described by `format` to an empty string. The `format` holds
+  // the Argument kind of the first argument in the lowest kBitsPerArg bits, the second
+  // argument in the next kBitsPerArg bits, and so on, up to the first kEnd. The `args`
+  // point to the values in 32-bit slots, with 64-bit values aligned to 8 bytes.
+  // Returns null with a pending OutOfMemoryError if the result is too long.
+  static ObjPtr<mirror::String> AppendF(uint32_t format, const uint32_t* args, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  class Builder;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STRING_BUILDER_APPEND_H_
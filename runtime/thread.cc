@@ -91,6 +91,7 @@
 #include "stack_map.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "trace.h"
 #include "verifier/method_verifier.h"
 #include "verify_object.h"
 #include "well_known_classes.h"
@@ -2235,6 +2236,9 @@ void Thread::Destroy() {
 
   {
     ScopedObjectAccess soa(self);
+    // Write the buffered trace events first, as it may allocate thread-local buffers or mark
+    // objects.
+    Trace::FlushExitingThreadBuffer(self);
     Runtime::Current()->GetHeap()->RevokeThreadLocalBuffers(this);
     if (kUseReadBarrier) {
       Runtime::Current()->GetHeap()->ConcurrentCopyingCollector()->RevokeThreadLocalMarkStack(this);
@@ -2284,6 +2288,7 @@ Thread::~Thread() {
   delete tlsPtr_.instrumentation_stack;
   delete tlsPtr_.name;
   delete tlsPtr_.deps_or_stack_trace_sample.stack_trace_sample;
+  delete[] tlsPtr_.method_trace_buffer;
 
   Runtime::Current()->GetHeap()->AssertThreadLocalBuffersAreRevoked(this);
 
@@ -3319,6 +3324,8 @@ void Thread::DumpThreadOffset(std::ostream& os, uint32_t offset) {
   QUICK_ENTRY_POINT_INFO(pReadBarrierMarkReg29)
   QUICK_ENTRY_POINT_INFO(pReadBarrierSlow)
   QUICK_ENTRY_POINT_INFO(pReadBarrierForRootSlow)
+  QUICK_ENTRY_POINT_INFO(pCompileOptimized)
+  QUICK_ENTRY_POINT_INFO(pStringBuilderAppend)
 
   QUICK_ENTRY_POINT_INFO(pJniMethodFastStart)
   QUICK_ENTRY_POINT_INFO(pJniMethodFastEnd)
@@ -985,6 +985,24 @@ class Thread {
     can_call_into_java_ = can_call_into_java;
   }
 
+  // Bytes counted towards the next allocation sample, see gc::AllocRecordSampler.
+  size_t GetAllocSampleBytes() const {
+    return alloc_sample_bytes_;
+  }
+
+  void SetAllocSampleBytes(size_t bytes) {
+    alloc_sample_bytes_ = bytes;
+  }
+
+  // Number of counted bytes at which the next allocation sample is taken.
+  size_t GetAllocSampleInterval() const {
+    return alloc_sample_interval_;
+  }
+
+  void SetAllocSampleInterval(size_t interval) {
+    alloc_sample_interval_ = interval;
+  }
+
   // Activates single step control for debugging. The thread takes the
   // ownership of the given SingleStepControl*. It is deleted by a call
   // to DeactivateSingleStepControl or upon thread destruction.
@@ -1090,6 +1108,22 @@ class Thread {
     tls64_.trace_clock_base = clock_base;
   }
 
+  uintptr_t* GetMethodTraceBuffer() const {
+    return tlsPtr_.method_trace_buffer;
+  }
+
+  void SetMethodTraceBuffer(uintptr_t* buffer) {
+    tlsPtr_.method_trace_buffer = buffer;
+  }
+
+  size_t GetMethodTraceBufferIndex() const {
+    return tlsPtr_.method_trace_buffer_index;
+  }
+
+  void SetMethodTraceBufferIndex(size_t index) {
+    tlsPtr_.method_trace_buffer_index = index;
+  }
+
   BaseMutex* GetHeldMutex(LockLevel level) const {
     return tlsPtr_.held_mutexes[level];
   }
@@ -1571,7 +1605,7 @@ class Thread {
       mterp_alt_ibase(nullptr), thread_local_alloc_stack_top(nullptr),
       thread_local_alloc_stack_end(nullptr),
       flip_function(nullptr), method_verifier(nullptr), thread_local_mark_stack(nullptr),
-      async_exception(nullptr) {
+      async_exception(nullptr), method_trace_buffer(nullptr), method_trace_buffer_index(0) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -1731,6 +1765,11 @@ class Thread {
 
     // The pending async-exception or null.
     mirror::Throwable* async_exception;
+
+    // Method trace events of this thread not yet written to the trace output, and the number
+    // of entries they use. See Trace::LogMethodTraceEvent().
+    uintptr_t* method_trace_buffer;
+    size_t method_trace_buffer_index;
   } tlsPtr_;
 
   // Guards the 'wait_monitor_' members.
@@ -1758,6 +1797,11 @@ class Thread {
   // By default this is true.
   bool can_call_into_java_;
 
+  // State of allocation sampling. A thread starts with an interval of zero, so that the first
+  // buffer it obtains draws its interval.
+  size_t alloc_sample_bytes_ = 0u;
+  size_t alloc_sample_interval_ = 0u;
+
   friend class Dbg;  // For SetStateUnsafe.
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
@@ -27,6 +27,7 @@
 
 #include "base/bit_utils.h"
 #include "base/casts.h"
+#include "base/quasi_atomic.h"
 #include "base/stl_util.h"
 #include "base/time_utils.h"
 #include "base/utils.h"
@@ -110,7 +111,7 @@ void ThreadPool::AddTask(Thread* self, Task* task) {
   MutexLock mu(self, task_queue_lock_);
   tasks_.push_back(task);
   // If we have any waiters, signal one.
-  if (started_ && waiting_count_ != 0) {
+  if (started_.LoadRelaxed() && waiting_count_ != 0) {
     task_queue_condition_.Signal(self);
   }
 }
@@ -130,11 +131,20 @@ ThreadPool::ThreadPool(const char* name, size_t num_threads, bool create_peers)
     waiting_count_(0),
     start_time_(0),
     total_wait_time_(0),
-    // Add one since the caller of constructor waits on the barrier too.
-    creation_barier_(num_threads + 1),
-    max_active_workers_(num_threads),
+    creation_barier_(0),
+    max_active_workers_(0),
     create_peers_(create_peers) {
+  CreateThreads(num_threads);
+}
+
+void ThreadPool::CreateThreads(size_t num_threads) {
   Thread* self = Thread::Current();
+  {
+    MutexLock mu(self, task_queue_lock_);
+    max_active_workers_.StoreRelease(num_threads);
+  }
+  // Add one since the creating thread waits on the barrier too.
+  creation_barier_.Init(self, num_threads + 1);
   while (GetThreadCount() < num_threads) {
     const std::string worker_name = StringPrintf("%s worker thread %zu", name_.c_str(),
                                                  GetThreadCount());
@@ -148,10 +158,14 @@ ThreadPool::ThreadPool(const char* name, size_t num_threads, bool create_peers)
 void ThreadPool::SetMaxActiveWorkers(size_t threads) {
   MutexLock mu(Thread::Current(), task_queue_lock_);
   CHECK_LE(threads, GetThreadCount());
-  max_active_workers_ = threads;
+  max_active_workers_.StoreRelease(threads);
 }
 
 ThreadPool::~ThreadPool() {
+  DeleteThreads();
+}
+
+void ThreadPool::DeleteThreads() {
   {
     Thread* self = Thread::Current();
     MutexLock mu(self, task_queue_lock_);
@@ -167,7 +181,7 @@ ThreadPool::~ThreadPool() {
 
 void ThreadPool::StartWorkers(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  started_ = true;
+  started_.StoreRelease(true);
   task_queue_condition_.Broadcast(self);
   start_time_ = NanoTime();
   total_wait_time_ = 0;
@@ -175,7 +189,7 @@ void ThreadPool::StartWorkers(Thread* self) {
 
 void ThreadPool::StopWorkers(Thread* self) {
   MutexLock mu(self, task_queue_lock_);
-  started_ = false;
+  started_.StoreRelease(false);
 }
 
 Task* ThreadPool::GetTask(Thread* self) {
@@ -185,7 +199,7 @@ Task* ThreadPool::GetTask(Thread* self) {
     // Ensure that we don't use more threads than the maximum active workers.
     const size_t active_threads = thread_count - waiting_count_;
     // <= since self is considered an active worker.
-    if (active_threads <= max_active_workers_) {
+    if (active_threads <= max_active_workers_.LoadRelaxed()) {
       Task* task = TryGetTaskLocked();
       if (task != nullptr) {
         return task;
@@ -216,7 +230,7 @@ Task* ThreadPool::TryGetTask(Thread* self) {
 }
 
 Task* ThreadPool::TryGetTaskLocked() {
-  if (HasOutstandingTasks()) {
+  if (started_.LoadRelaxed() && !tasks_.empty()) {
     Task* task = tasks_.front();
     tasks_.pop_front();
     return task;
@@ -255,4 +269,368 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+class WorkStealingTaskDeque::Buffer {
+ public:
+  explicit Buffer(size_t capacity) : mask_(capacity - 1u), tasks_(new Atomic<Task*>[capacity]) {
+    DCHECK(IsPowerOfTwo(capacity));
+  }
+
+  size_t Capacity() const {
+    return mask_ + 1u;
+  }
+
+  Task* Get(int64_t index) const {
+    return tasks_[static_cast<size_t>(index) & mask_].LoadRelaxed();
+  }
+
+  void Put(int64_t index, Task* task) {
+    tasks_[static_cast<size_t>(index) & mask_].StoreRelaxed(task);
+  }
+
+ private:
+  const size_t mask_;
+  std::unique_ptr<Atomic<Task*>[]> tasks_;
+};
+
+static constexpr size_t kInitialTaskDequeCapacity = 64;
+
+WorkStealingTaskDeque::WorkStealingTaskDeque() : top_(0), bottom_(0), buffer_(nullptr) {
+  buffers_.emplace_back(new Buffer(kInitialTaskDequeCapacity));
+  buffer_.StoreRelaxed(buffers_.back().get());
+}
+
+WorkStealingTaskDeque::Buffer* WorkStealingTaskDeque::Grow(Buffer* buffer,
+                                                           int64_t top,
+                                                           int64_t bottom) {
+  Buffer* new_buffer = new Buffer(buffer->Capacity() * 2u);
+  for (int64_t i = top; i != bottom; ++i) {
+    new_buffer->Put(i, buffer->Get(i));
+  }
+  buffers_.emplace_back(new_buffer);
+  buffer_.StoreRelease(new_buffer);
+  return new_buffer;
+}
+
+void WorkStealingTaskDeque::Push(Task* task) {
+  const int64_t bottom = bottom_.LoadRelaxed();
+  const int64_t top = top_.LoadAcquire();
+  Buffer* buffer = buffer_.LoadRelaxed();
+  if (bottom - top >= static_cast<int64_t>(buffer->Capacity())) {
+    buffer = Grow(buffer, top, bottom);
+  }
+  buffer->Put(bottom, task);
+  // Publish the task before the new bottom.
+  QuasiAtomic::ThreadFenceRelease();
+  bottom_.StoreRelaxed(bottom + 1);
+}
+
+Task* WorkStealingTaskDeque::Pop() {
+  const int64_t bottom = bottom_.LoadRelaxed() - 1;
+  Buffer* buffer = buffer_.LoadRelaxed();
+  bottom_.StoreRelaxed(bottom);
+  // Make the reservation of the bottom task visible to thieves before reading the top.
+  QuasiAtomic::ThreadFenceSequentiallyConsistent();
+  const int64_t top = top_.LoadRelaxed();
+  if (top > bottom) {
+    // Empty.
+    bottom_.StoreRelaxed(bottom + 1);
+    return nullptr;
+  }
+  Task* task = buffer->Get(bottom);
+  if (top == bottom) {
+    // Last task, race with the thieves for it.
+    if (!top_.CompareAndSetStrongSequentiallyConsistent(top, top + 1)) {
+      task = nullptr;
+    }
+    bottom_.StoreRelaxed(bottom + 1);
+  }
+  return task;
+}
+
+Task* WorkStealingTaskDeque::Steal() {
+  const int64_t top = top_.LoadAcquire();
+  QuasiAtomic::ThreadFenceSequentiallyConsistent();
+  const int64_t bottom = bottom_.LoadAcquire();
+  if (top >= bottom) {
+    return nullptr;
+  }
+  Buffer* buffer = buffer_.LoadAcquire();
+  Task* task = buffer->Get(top);
+  if (!top_.CompareAndSetStrongSequentiallyConsistent(top, top + 1)) {
+    // Lost the race with the owner or another thief.
+    return nullptr;
+  }
+  return task;
+}
+
+size_t WorkStealingTaskDeque::Size() const {
+  const int64_t size = bottom_.LoadRelaxed() - top_.LoadRelaxed();
+  return size > 0 ? static_cast<size_t>(size) : 0u;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(const char* name,
+                                               size_t num_threads,
+                                               bool create_peers)
+    : ThreadPool(name, /* num_threads */ 0u, create_peers),
+      num_waiting_workers_(0u),
+      next_deque_(0u) {
+  // The deques must exist before the workers start looking for tasks.
+  for (size_t i = 0; i < num_threads; ++i) {
+    deques_.emplace_back(new WorkStealingTaskDeque());
+    // Any non-zero seed works for the xorshift generator.
+    random_states_.push_back(static_cast<uint32_t>(i) + 1u);
+  }
+  CreateThreads(num_threads);
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  // Join the workers while the deques they steal from still exist.
+  DeleteThreads();
+}
+
+size_t WorkStealingThreadPool::GetWorkerIndex(Thread* self) const {
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    if (threads_[i]->GetThread() == self) {
+      return i;
+    }
+  }
+  return kNotAWorker;
+}
+
+bool WorkStealingThreadPool::MayTakeTasks(size_t worker_index) const {
+  return started_.LoadAcquire() && worker_index < max_active_workers_.LoadAcquire();
+}
+
+void WorkStealingThreadPool::AddTask(Thread* self, Task* task) {
+  const size_t worker_index = GetWorkerIndex(self);
+  if (worker_index != kNotAWorker) {
+    deques_[worker_index]->Push(task);
+    // Pairs with the fence in Steal() after a worker announced it is about to wait, so that
+    // either the worker sees the task or we see the worker waiting.
+    QuasiAtomic::ThreadFenceSequentiallyConsistent();
+    if (num_waiting_workers_.LoadRelaxed() != 0u) {
+      MutexLock mu(self, task_queue_lock_);
+      if (started_.LoadRelaxed()) {
+        // An inactive worker would ignore the signal.
+        if (max_active_workers_.LoadRelaxed() == GetThreadCount()) {
+          task_queue_condition_.Signal(self);
+        } else {
+          task_queue_condition_.Broadcast(self);
+        }
+      }
+    }
+    return;
+  }
+  MutexLock mu(self, task_queue_lock_);
+  if (!started_.LoadRelaxed() &&
+      waiting_count_ == GetThreadCount() &&
+      max_active_workers_.LoadRelaxed() != 0u) {
+    // All the workers wait for StartWorkers(), which publishes the task, and do not use their
+    // deques in the meantime.
+    deques_[next_deque_]->Push(task);
+    next_deque_ = (next_deque_ + 1u) % max_active_workers_.LoadRelaxed();
+    return;
+  }
+  tasks_.push_back(task);
+  // If we have any waiters, signal one.
+  if (started_.LoadRelaxed() && waiting_count_ != 0) {
+    task_queue_condition_.Signal(self);
+  }
+}
+
+void WorkStealingThreadPool::RemoveAllTasks(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  tasks_.clear();
+  for (const std::unique_ptr<WorkStealingTaskDeque>& deque : deques_) {
+    while (!deque->IsEmpty()) {
+      deque->Steal();
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::GetTaskCount(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  size_t count = tasks_.size();
+  for (const std::unique_ptr<WorkStealingTaskDeque>& deque : deques_) {
+    count += deque->Size();
+  }
+  return count;
+}
+
+bool WorkStealingThreadPool::HasOutstandingTasks() const {
+  if (!started_.LoadRelaxed()) {
+    return false;
+  }
+  if (!tasks_.empty()) {
+    return true;
+  }
+  for (const std::unique_ptr<WorkStealingTaskDeque>& deque : deques_) {
+    if (!deque->IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Task* WorkStealingThreadPool::StealTask(size_t thief_index, uint32_t* random_state) {
+  const size_t num_deques = deques_.size();
+  if (num_deques == 0u) {
+    return nullptr;
+  }
+  // Xorshift, good enough to spread the thieves over the victims.
+  uint32_t x = *random_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *random_state = x;
+  const size_t first_victim = x % num_deques;
+  for (size_t i = 0; i < num_deques; ++i) {
+    const size_t victim = (first_victim + i) % num_deques;
+    if (victim == thief_index) {
+      continue;
+    }
+    // Retry after losing a race so that a waiting worker never leaves a task behind.
+    WorkStealingTaskDeque* const deque = deques_[victim].get();
+    while (!deque->IsEmpty()) {
+      Task* task = deque->Steal();
+      if (task != nullptr) {
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+Task* WorkStealingThreadPool::TryGetDequeTask(size_t worker_index, uint32_t* random_state) {
+  Task* task = deques_[worker_index]->Pop();
+  if (task == nullptr) {
+    task = StealTask(worker_index, random_state);
+  }
+  return task;
+}
+
+Task* WorkStealingThreadPool::GetTask(Thread* self) {
+  const size_t worker_index = GetWorkerIndex(self);
+  CHECK_NE(worker_index, kNotAWorker);
+  uint32_t* const random_state = &random_states_[worker_index];
+  while (true) {
+    // Fast path without the lock.
+    if (MayTakeTasks(worker_index)) {
+      Task* task = TryGetDequeTask(worker_index, random_state);
+      if (task != nullptr) {
+        return task;
+      }
+    }
+    MutexLock mu(self, task_queue_lock_);
+    if (IsShuttingDown()) {
+      // We are shutting down, return null to tell the worker thread to stop looping.
+      return nullptr;
+    }
+    const bool may_take_tasks =
+        started_.LoadRelaxed() && worker_index < max_active_workers_.LoadRelaxed();
+    Task* task = may_take_tasks ? TryGetTaskLocked() : nullptr;
+    if (task != nullptr) {
+      return task;
+    }
+    ++waiting_count_;
+    num_waiting_workers_.FetchAndAddSequentiallyConsistent(1u);
+    // Look at the deques again now that workers adding tasks see us waiting.
+    if (may_take_tasks) {
+      task = TryGetDequeTask(worker_index, random_state);
+    }
+    if (task == nullptr) {
+      if (waiting_count_ == GetThreadCount() && !HasOutstandingTasks()) {
+        // We may be done, lets broadcast to the completion condition.
+        completion_condition_.Broadcast(self);
+      }
+      const uint64_t wait_start = kMeasureWaitTime ? NanoTime() : 0;
+      task_queue_condition_.Wait(self);
+      if (kMeasureWaitTime) {
+        const uint64_t wait_end = NanoTime();
+        total_wait_time_ += wait_end - std::max(wait_start, start_time_);
+      }
+    }
+    num_waiting_workers_.FetchAndSubSequentiallyConsistent(1u);
+    --waiting_count_;
+    if (task != nullptr) {
+      return task;
+    }
+  }
+}
+
+Task* WorkStealingThreadPool::TryGetTask(Thread* self) {
+  {
+    MutexLock mu(self, task_queue_lock_);
+    Task* task = TryGetTaskLocked();
+    if (task != nullptr || !started_.LoadRelaxed()) {
+      return task;
+    }
+  }
+  // Not a worker, only steal.
+  uint32_t random_state = static_cast<uint32_t>(NanoTime()) | 1u;
+  return StealTask(kNotAWorker, &random_state);
+}
+
+PriorityThreadPool::PriorityThreadPool(const char* name, size_t num_threads, bool create_peers)
+    : ThreadPool(name, /* num_threads */ 0u, create_peers),
+      next_sequence_number_(0u) {
+  // Start the workers only once they can dispatch to this class.
+  CreateThreads(num_threads);
+}
+
+PriorityThreadPool::~PriorityThreadPool() {
+  // Join the workers while the queue they take tasks from still exists.
+  DeleteThreads();
+}
+
+void PriorityThreadPool::AddTaskWithPriority(Thread* self, Task* task, uint32_t priority) {
+  AddPrioritizedTask(self, PrioritizedTask { priority, 0u, task, nullptr });
+}
+
+void PriorityThreadPool::AddPriorityTask(Thread* self, PriorityTask* task) {
+  AddPrioritizedTask(self, PrioritizedTask { 0u, 0u, task, task });
+}
+
+void PriorityThreadPool::AddPrioritizedTask(Thread* self, const PrioritizedTask& task) {
+  MutexLock mu(self, task_queue_lock_);
+  prioritized_tasks_.push_back(task);
+  prioritized_tasks_.back().sequence_number = next_sequence_number_++;
+  // If we have any waiters, signal one.
+  if (started_.LoadRelaxed() && waiting_count_ != 0) {
+    task_queue_condition_.Signal(self);
+  }
+}
+
+void PriorityThreadPool::RemoveAllTasks(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  prioritized_tasks_.clear();
+}
+
+size_t PriorityThreadPool::GetTaskCount(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  return prioritized_tasks_.size();
+}
+
+Task* PriorityThreadPool::TryGetTaskLocked() {
+  if (!started_.LoadRelaxed() || prioritized_tasks_.empty()) {
+    return nullptr;
+  }
+  size_t best = 0u;
+  uint32_t best_priority = prioritized_tasks_[0].GetPriority();
+  for (size_t i = 1; i != prioritized_tasks_.size(); ++i) {
+    const uint32_t priority = prioritized_tasks_[i].GetPriority();
+    if (priority > best_priority ||
+        (priority == best_priority &&
+         prioritized_tasks_[i].sequence_number < prioritized_tasks_[best].sequence_number)) {
+      best = i;
+      best_priority = priority;
+    }
+  }
+  Task* task = prioritized_tasks_[best].task;
+  // The order of the queue does not matter, the sequence numbers keep ties in insertion order.
+  prioritized_tasks_[best] = prioritized_tasks_.back();
+  prioritized_tasks_.pop_back();
+  return task;
+}
+
 }  // namespace art
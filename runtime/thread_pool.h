@@ -18,9 +18,11 @@
 #define ART_RUNTIME_THREAD_POOL_H_
 
 #include <deque>
+#include <memory>
 #include <vector>
 
 #include "barrier.h"
+#include "base/atomic.h"
 #include "base/mutex.h"
 #include "mem_map.h"
 
@@ -40,6 +42,13 @@ class Task : public Closure {
   virtual void Finalize() { }
 };
 
+// A task whose priority may change while it waits in a PriorityThreadPool.
+class PriorityTask : public Task {
+ public:
+  // Called with the task queue lock held each time a worker picks the next task to run.
+  virtual uint32_t GetPriority() = 0;
+};
+
 class SelfDeletingTask : public Task {
  public:
   virtual ~SelfDeletingTask() { }
@@ -100,10 +109,10 @@ class ThreadPool {
 
   // Add a new task, the first available started worker will process it. Does not delete the task
   // after running it, it is the caller's responsibility.
-  void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
+  virtual void AddTask(Thread* self, Task* task) REQUIRES(!task_queue_lock_);
 
   // Remove all tasks in the queue.
-  void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Create a named thread pool with the given number of threads.
   //
@@ -118,7 +127,13 @@ class ThreadPool {
   // When the pool was created with peers for workers, do_work must not be true (see ThreadPool()).
   void Wait(Thread* self, bool do_work, bool may_hold_locks) REQUIRES(!task_queue_lock_);
 
-  size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
+  virtual size_t GetTaskCount(Thread* self) REQUIRES(!task_queue_lock_);
+
+  // Whether the workers pop tasks they add themselves from a local deque, so that splitting work
+  // into many small tasks is cheap.
+  virtual bool IsWorkStealing() const {
+    return false;
+  }
 
   // Returns the total amount of workers waited for tasks.
   uint64_t GetWaitTime() const {
@@ -137,23 +152,32 @@ class ThreadPool {
   virtual Task* GetTask(Thread* self) REQUIRES(!task_queue_lock_);
 
   // Try to get a task, returning null if there is none available.
-  Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
-  Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
+  virtual Task* TryGetTask(Thread* self) REQUIRES(!task_queue_lock_);
+  // Try to get a task from the shared queue.
+  virtual Task* TryGetTaskLocked() REQUIRES(task_queue_lock_);
+
+  // Create the worker threads and wait for them to attach.
+  void CreateThreads(size_t num_threads) REQUIRES(!task_queue_lock_);
+
+  // Tell the workers to shut down and join them.
+  void DeleteThreads() REQUIRES(!task_queue_lock_);
 
   // Are we shutting down?
   bool IsShuttingDown() const REQUIRES(task_queue_lock_) {
     return shutting_down_;
   }
 
-  bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) {
-    return started_ && !tasks_.empty();
+  virtual bool HasOutstandingTasks() const REQUIRES(task_queue_lock_) {
+    return started_.LoadRelaxed() && !tasks_.empty();
   }
 
   const std::string name_;
   Mutex task_queue_lock_;
   ConditionVariable task_queue_condition_ GUARDED_BY(task_queue_lock_);
   ConditionVariable completion_condition_ GUARDED_BY(task_queue_lock_);
-  volatile bool started_ GUARDED_BY(task_queue_lock_);
+  // Written with task_queue_lock_ held. Also read without the lock by the workers of a
+  // WorkStealingThreadPool, see MayTakeTasks().
+  Atomic<bool> started_;
   volatile bool shutting_down_ GUARDED_BY(task_queue_lock_);
   // How many worker threads are waiting on the condition.
   volatile size_t waiting_count_ GUARDED_BY(task_queue_lock_);
@@ -164,7 +188,8 @@ class ThreadPool {
   uint64_t start_time_ GUARDED_BY(task_queue_lock_);
   uint64_t total_wait_time_;
   Barrier creation_barier_;
-  size_t max_active_workers_ GUARDED_BY(task_queue_lock_);
+  // Written with task_queue_lock_ held, like started_.
+  Atomic<size_t> max_active_workers_;
   const bool create_peers_;
 
  private:
@@ -173,6 +198,150 @@ class ThreadPool {
   DISALLOW_COPY_AND_ASSIGN(ThreadPool);
 };
 
+// A Chase-Lev work-stealing deque of tasks. The owner pushes and pops at the bottom without
+// synchronization, other threads steal from the top with a CAS.
+class WorkStealingTaskDeque {
+ public:
+  WorkStealingTaskDeque();
+
+  // Only called by the owner, or by another thread while the owner does not use the deque.
+  void Push(Task* task);
+  Task* Pop();
+
+  // Returns null if the deque is empty or another thread took the top task first.
+  Task* Steal();
+
+  size_t Size() const;
+
+  bool IsEmpty() const {
+    return Size() == 0u;
+  }
+
+ private:
+  class Buffer;
+
+  Buffer* Grow(Buffer* buffer, int64_t top, int64_t bottom);
+
+  Atomic<int64_t> top_;
+  Atomic<int64_t> bottom_;
+  Atomic<Buffer*> buffer_;
+  // All the buffers, including the outgrown ones thieves may still read from.
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingTaskDeque);
+};
+
+// A thread pool where each worker has its own deque of tasks. Tasks a worker adds go to its
+// deque, and idle workers steal from the deques of randomly chosen workers, so that workers
+// rarely need the task queue lock.
+class WorkStealingThreadPool : public ThreadPool {
+ public:
+  WorkStealingThreadPool(const char* name, size_t num_threads, bool create_peers = false);
+  virtual ~WorkStealingThreadPool();
+
+  // A task added by a worker goes to the worker's deque. Tasks added while the workers are
+  // stopped and idle are spread over the deques of the active workers. Other tasks go to the
+  // shared queue.
+  void AddTask(Thread* self, Task* task) OVERRIDE REQUIRES(!task_queue_lock_);
+
+  void RemoveAllTasks(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+
+  size_t GetTaskCount(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+
+  bool IsWorkStealing() const OVERRIDE {
+    return true;
+  }
+
+ protected:
+  Task* GetTask(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+
+  Task* TryGetTask(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+
+  bool HasOutstandingTasks() const OVERRIDE REQUIRES(task_queue_lock_);
+
+ private:
+  static constexpr size_t kNotAWorker = static_cast<size_t>(-1);
+
+  // Return the index of the worker running on `self`, or kNotAWorker.
+  size_t GetWorkerIndex(Thread* self) const;
+
+  // Whether the worker may take tasks. Does not take the lock, so the result may be stale; the
+  // caller rechecks with the lock held before waiting.
+  bool MayTakeTasks(size_t worker_index) const;
+
+  // Pop from the deque of the worker, then try to steal from the other deques.
+  Task* TryGetDequeTask(size_t worker_index, uint32_t* random_state);
+
+  Task* StealTask(size_t thief_index, uint32_t* random_state);
+
+  std::vector<std::unique_ptr<WorkStealingTaskDeque>> deques_;
+  // Random number generator state of each worker to pick the victims to steal from.
+  std::vector<uint32_t> random_states_;
+  // Number of workers waiting on task_queue_condition_. Read without the lock by workers adding
+  // tasks to their deques to decide whether to wake someone up.
+  Atomic<size_t> num_waiting_workers_;
+  // Deque the next task added while the workers are stopped goes to.
+  size_t next_deque_ GUARDED_BY(task_queue_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+};
+
+// A thread pool where workers take the task with the highest priority first. Tasks with the same
+// priority run in the order they were added. The priority of a PriorityTask is read when a worker
+// picks the next task, so a task may overtake tasks added before it while it waits.
+class PriorityThreadPool : public ThreadPool {
+ public:
+  PriorityThreadPool(const char* name, size_t num_threads, bool create_peers = false);
+  virtual ~PriorityThreadPool();
+
+  // Add a task with the lowest priority.
+  void AddTask(Thread* self, Task* task) OVERRIDE REQUIRES(!task_queue_lock_) {
+    AddTaskWithPriority(self, task, 0u);
+  }
+
+  // Add a task with a fixed priority.
+  void AddTaskWithPriority(Thread* self, Task* task, uint32_t priority)
+      REQUIRES(!task_queue_lock_);
+
+  // Add a task whose priority is given by PriorityTask::GetPriority().
+  void AddPriorityTask(Thread* self, PriorityTask* task) REQUIRES(!task_queue_lock_);
+
+  void RemoveAllTasks(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+
+  size_t GetTaskCount(Thread* self) OVERRIDE REQUIRES(!task_queue_lock_);
+
+ protected:
+  Task* TryGetTaskLocked() OVERRIDE REQUIRES(task_queue_lock_);
+
+  bool HasOutstandingTasks() const OVERRIDE REQUIRES(task_queue_lock_) {
+    return started_.LoadRelaxed() && !prioritized_tasks_.empty();
+  }
+
+ private:
+  struct PrioritizedTask {
+    // Only used if priority_task is null.
+    uint32_t priority;
+    // Breaks ties between tasks of the same priority, lower numbers were added first.
+    uint64_t sequence_number;
+    Task* task;
+    // Non-null if the priority is read from the task.
+    PriorityTask* priority_task;
+
+    uint32_t GetPriority() const {
+      return priority_task != nullptr ? priority_task->GetPriority() : priority;
+    }
+  };
+
+  void AddPrioritizedTask(Thread* self, const PrioritizedTask& task) REQUIRES(!task_queue_lock_);
+
+  // Not a heap since the priorities may change; the queue is scanned for the next task. The JIT,
+  // its user, rarely has more than a few hundred methods waiting.
+  std::vector<PrioritizedTask> prioritized_tasks_ GUARDED_BY(task_queue_lock_);
+  uint64_t next_sequence_number_ GUARDED_BY(task_queue_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(PriorityThreadPool);
+};
+
 }  // namespace art
 
 #endif  // ART_RUNTIME_THREAD_POOL_H_
@@ -17,6 +17,7 @@
 #include "thread_pool.h"
 
 #include <string>
+#include <vector>
 
 #include "base/atomic.h"
 #include "common_runtime_test.h"
@@ -211,4 +212,173 @@ TEST_F(ThreadPoolTest, PeerTest) {
   }
 }
 
+TEST_F(ThreadPoolTest, WorkStealingCheckRun) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  EXPECT_TRUE(thread_pool.IsWorkStealing());
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&count));
+  }
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+  EXPECT_EQ(0u, thread_pool.GetTaskCount(self));
+}
+
+TEST_F(ThreadPoolTest, WorkStealingStopStart) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTask(self, new CountTask(&count));
+  }
+  usleep(200);
+  // Check that no threads started prematurely.
+  EXPECT_EQ(0, count.LoadSequentiallyConsistent());
+  thread_pool.StartWorkers(self);
+  usleep(200);
+  thread_pool.StopWorkers(self);
+  AtomicInteger bad_count(0);
+  thread_pool.AddTask(self, new CountTask(&bad_count));
+  usleep(200);
+  // Ensure that the task added after the workers were stopped doesn't get run.
+  EXPECT_EQ(0, bad_count.LoadSequentiallyConsistent());
+  // Allow tasks to finish up and delete themselves.
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, false, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+  EXPECT_EQ(1, bad_count.LoadSequentiallyConsistent());
+}
+
+// Test that tasks added from within a task go through the worker deques and get stolen.
+TEST_F(ThreadPoolTest, WorkStealingRecursiveTest) {
+  Thread* self = Thread::Current();
+  WorkStealingThreadPool thread_pool("Work stealing thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int depth = 12;
+  thread_pool.AddTask(self, new TreeTask(&thread_pool, &count, depth));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ((1 << depth) - 1, count.LoadSequentiallyConsistent());
+}
+
+TEST_F(ThreadPoolTest, WorkStealingTaskDeque) {
+  WorkStealingTaskDeque deque;
+  std::vector<std::unique_ptr<AtomicInteger>> counts;
+  std::vector<Task*> tasks;
+  // Enough tasks to grow the deque.
+  for (size_t i = 0; i < 1000u; ++i) {
+    counts.emplace_back(new AtomicInteger(0));
+    tasks.push_back(new CountTask(counts.back().get()));
+    deque.Push(tasks.back());
+  }
+  EXPECT_EQ(1000u, deque.Size());
+  // The owner pops the most recent task, thieves steal the oldest.
+  EXPECT_EQ(tasks.back(), deque.Pop());
+  EXPECT_EQ(tasks.front(), deque.Steal());
+  EXPECT_EQ(998u, deque.Size());
+  while (!deque.IsEmpty()) {
+    EXPECT_NE(nullptr, deque.Pop());
+  }
+  EXPECT_EQ(nullptr, deque.Pop());
+  EXPECT_EQ(nullptr, deque.Steal());
+  for (Task* task : tasks) {
+    task->Finalize();
+  }
+}
+
+class RecordOrderTask : public Task {
+ public:
+  RecordOrderTask(std::vector<uint32_t>* order, uint32_t id) : order_(order), id_(id) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) {
+    order_->push_back(id_);
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+ private:
+  std::vector<uint32_t>* const order_;
+  const uint32_t id_;
+};
+
+TEST_F(ThreadPoolTest, PriorityOrder) {
+  Thread* self = Thread::Current();
+  // A single worker so that the tasks run one after the other.
+  PriorityThreadPool thread_pool("Thread pool test thread pool", 1);
+  std::vector<uint32_t> order;
+  thread_pool.AddTaskWithPriority(self, new RecordOrderTask(&order, 0u), 10u);
+  thread_pool.AddTask(self, new RecordOrderTask(&order, 1u));
+  thread_pool.AddTaskWithPriority(self, new RecordOrderTask(&order, 2u), 1000u);
+  thread_pool.AddTaskWithPriority(self, new RecordOrderTask(&order, 3u), 10u);
+  thread_pool.AddTaskWithPriority(self, new RecordOrderTask(&order, 4u), 500u);
+  EXPECT_EQ(5u, thread_pool.GetTaskCount(self));
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, false, false);
+  EXPECT_EQ(0u, thread_pool.GetTaskCount(self));
+  // Highest priority first, ties in the order the tasks were added.
+  const std::vector<uint32_t> expected = { 2u, 4u, 0u, 3u, 1u };
+  EXPECT_EQ(expected, order);
+}
+
+// Stands in for a JIT compile task, whose priority is the current hotness of its method.
+class HotnessOrderTask : public PriorityTask {
+ public:
+  HotnessOrderTask(std::vector<uint32_t>* order, uint32_t id, const uint16_t* hotness)
+      : order_(order), id_(id), hotness_(hotness) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) {
+    order_->push_back(id_);
+  }
+
+  void Finalize() {
+    delete this;
+  }
+
+  uint32_t GetPriority() OVERRIDE {
+    return *hotness_;
+  }
+
+ private:
+  std::vector<uint32_t>* const order_;
+  const uint32_t id_;
+  const uint16_t* const hotness_;
+};
+
+TEST_F(ThreadPoolTest, PriorityReadWhenTaskIsPicked) {
+  Thread* self = Thread::Current();
+  PriorityThreadPool thread_pool("Thread pool test thread pool", 1);
+  std::vector<uint32_t> order;
+  // All the methods are queued when they cross the same hotness threshold.
+  uint16_t hotness[3] = { 1000u, 1000u, 1000u };
+  for (uint32_t i = 0; i != 3u; ++i) {
+    thread_pool.AddPriorityTask(self, new HotnessOrderTask(&order, i, &hotness[i]));
+  }
+  thread_pool.AddTaskWithPriority(self, new RecordOrderTask(&order, 3u), 1500u);
+  // The last queued method keeps getting hotter while it waits.
+  hotness[2] = 2000u;
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, false, false);
+  const std::vector<uint32_t> expected = { 2u, 3u, 0u, 1u };
+  EXPECT_EQ(expected, order);
+}
+
+TEST_F(ThreadPoolTest, PriorityCheckRun) {
+  Thread* self = Thread::Current();
+  PriorityThreadPool thread_pool("Thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  static const int32_t num_tasks = num_threads * 4;
+  for (int32_t i = 0; i < num_tasks; ++i) {
+    thread_pool.AddTaskWithPriority(self, new CountTask(&count), static_cast<uint32_t>(i % 3));
+  }
+  thread_pool.StartWorkers(self);
+  thread_pool.Wait(self, true, false);
+  EXPECT_EQ(num_tasks, count.LoadSequentiallyConsistent());
+}
+
 }  // namespace art
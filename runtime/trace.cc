@@ -22,6 +22,7 @@
 #include "android-base/stringprintf.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "base/casts.h"
 #include "base/enums.h"
 #include "base/os.h"
@@ -95,12 +96,30 @@ static const uint16_t kTraceRecordSizeDualClock   = 14;  // using v3 with two ti
 TraceClockSource Trace::default_clock_source_ = kDefaultTraceClockSource;
 
 Trace* volatile Trace::the_trace_ = nullptr;
+Trace* Trace::stopping_trace_ = nullptr;
 pthread_t Trace::sampling_pthread_ = 0U;
 std::unique_ptr<std::vector<ArtMethod*>> Trace::temp_stack_trace_;
 
 // The key identifying the tracer to update instrumentation.
 static constexpr const char* kTracerInstrumentationKey = "Tracer";
 
+// Number of entries in the buffer of a thread. An event uses one entry for the method and the
+// trace action, plus one for each clock.
+static constexpr size_t kPerThreadBufSize = 1536U;
+
+static uintptr_t EncodeEvent(ArtMethod* method, TraceAction action) {
+  static_assert(alignof(ArtMethod) > kTraceMethodActionMask, "No room for the trace action");
+  return reinterpret_cast<uintptr_t>(method) | action;
+}
+
+static ArtMethod* DecodeEventMethod(uintptr_t event) {
+  return reinterpret_cast<ArtMethod*>(event & ~static_cast<uintptr_t>(kTraceMethodActionMask));
+}
+
+static TraceAction DecodeEventAction(uintptr_t event) {
+  return static_cast<TraceAction>(event & kTraceMethodActionMask);
+}
+
 static TraceAction DecodeTraceAction(uint32_t tmid) {
   return static_cast<TraceAction>(tmid & kTraceMethodActionMask);
 }
@@ -112,6 +131,10 @@ ArtMethod* Trace::DecodeTraceMethod(uint32_t tmid) {
 
 uint32_t Trace::EncodeTraceMethod(ArtMethod* method) {
   MutexLock mu(Thread::Current(), *unique_methods_lock_);
+  return EncodeTraceMethodLocked(method);
+}
+
+uint32_t Trace::EncodeTraceMethodLocked(ArtMethod* method) {
   uint32_t idx;
   auto it = art_method_id_map_.find(method);
   if (it != art_method_id_map_.end()) {
@@ -133,11 +156,18 @@ uint32_t Trace::EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action
 }
 
 std::vector<ArtMethod*>* Trace::AllocStackTrace() {
+  if (pthread_self() != sampling_pthread_) {
+    return new std::vector<ArtMethod*>();
+  }
   return (temp_stack_trace_.get() != nullptr)  ? temp_stack_trace_.release() :
       new std::vector<ArtMethod*>();
 }
 
 void Trace::FreeStackTrace(std::vector<ArtMethod*>* stack_trace) {
+  if (pthread_self() != sampling_pthread_) {
+    delete stack_trace;
+    return;
+  }
   stack_trace->clear();
   temp_stack_trace_.reset(stack_trace);
 }
@@ -235,6 +265,25 @@ static void GetSample(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_
   the_trace->CompareAndUpdateStackTrace(thread, stack_trace);
 }
 
+// Samples the stack of a thread at its next suspend check, or on behalf of the thread by the
+// sampling thread if it is already suspended. Unlike GetSample() under ScopedSuspendAll, a
+// thread sampling itself does not have to wait for any other thread.
+class SampleCheckpoint FINAL : public Closure {
+ public:
+  SampleCheckpoint(Trace* trace, Barrier* barrier) : trace_(trace), barrier_(barrier) {}
+
+  void Run(Thread* thread) OVERRIDE REQUIRES_SHARED(Locks::mutator_lock_) {
+    ScopedTrace trace(__PRETTY_FUNCTION__);
+    DCHECK(thread == Thread::Current() || thread->IsSuspended());
+    GetSample(thread, trace_);
+    barrier_->Pass(Thread::Current());
+  }
+
+ private:
+  Trace* const trace_;
+  Barrier* const barrier_;
+};
+
 static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUTE_UNUSED) {
   thread->SetTraceClockBase(0);
   std::vector<ArtMethod*>* stack_trace = thread->GetStackTraceSample();
@@ -242,9 +291,22 @@ static void ClearThreadStackTraceAndClockBase(Thread* thread, void* arg ATTRIBUT
   delete stack_trace;
 }
 
+// Writes the events buffered by the thread to the trace passed as argument, if any, and frees
+// the buffer.
+static void ReleaseThreadBuffer(Thread* thread, void* arg) REQUIRES_SHARED(Locks::mutator_lock_) {
+  Trace* the_trace = reinterpret_cast<Trace*>(arg);
+  if (the_trace != nullptr) {
+    the_trace->FlushThreadBuffer(thread);
+  }
+  delete[] thread->GetMethodTraceBuffer();
+  thread->SetMethodTraceBuffer(nullptr);
+  thread->SetMethodTraceBufferIndex(0);
+}
+
 void Trace::CompareAndUpdateStackTrace(Thread* thread,
                                        std::vector<ArtMethod*>* stack_trace) {
-  CHECK_EQ(pthread_self(), sampling_pthread_);
+  // With kTraceSampleWithCheckpoints, a thread may sample itself.
+  CHECK(pthread_self() == sampling_pthread_ || thread == Thread::Current());
   std::vector<ArtMethod*>* old_stack_trace = thread->GetStackTraceSample();
   // Update the thread's stack trace sample.
   thread->SetStackTraceSample(stack_trace);
@@ -281,6 +343,9 @@ void Trace::CompareAndUpdateStackTrace(Thread* thread,
     }
     FreeStackTrace(old_stack_trace);
   }
+  // Write the events of a sample at once. This keeps the buffer of a thread empty while it is
+  // not sampled, so that it can exit at any time.
+  FlushThreadBuffer(thread);
 }
 
 void* Trace::RunSamplingThread(void* arg) {
@@ -302,7 +367,20 @@ void* Trace::RunSamplingThread(void* arg) {
         break;
       }
     }
-    {
+    if ((the_trace->flags_ & kTraceSampleWithCheckpoints) != 0) {
+      // Runnable threads sample themselves at their next suspend check, so that there is no
+      // global suspension. Use our own barrier, the empty checkpoint one is reserved for the GC.
+      Barrier barrier(0);
+      SampleCheckpoint checkpoint(the_trace, &barrier);
+      ScopedObjectAccess soa(self);
+      size_t threads_running_checkpoint = runtime->GetThreadList()->RunCheckpoint(&checkpoint);
+      // Now that we have run our checkpoint, move to a suspended state and wait
+      // for other threads to run the checkpoint.
+      ScopedThreadSuspension sts(self, kSuspended);
+      if (threads_running_checkpoint != 0) {
+        barrier.Increment(self, threads_running_checkpoint);
+      }
+    } else {
       // Avoid a deadlock between a thread doing garbage collection
       // and the profile sampling thread, by blocking GC when sampling
       // thread stacks (see b/73624630).
@@ -371,7 +449,7 @@ void Trace::Start(const char* trace_filename, int trace_fd, size_t buffer_size,
     if (the_trace_ != nullptr) {
       LOG(ERROR) << "Trace already in progress, ignoring this request";
     } else {
-      enable_stats = (flags && kTraceCountAllocs) != 0;
+      enable_stats = (flags & kTraceCountAllocs) != 0;
       the_trace_ = new Trace(trace_file.release(), trace_filename, buffer_size, flags, output_mode,
                              trace_mode);
       if (trace_mode == TraceMode::kSampling) {
@@ -409,6 +487,9 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
     } else {
       the_trace = the_trace_;
       the_trace_ = nullptr;
+      if (finish_tracing) {
+        stopping_trace_ = the_trace;
+      }
       sampling_pthread = sampling_pthread_;
     }
   }
@@ -422,24 +503,37 @@ void Trace::StopTracing(bool finish_tracing, bool flush_file) {
 
   if (the_trace != nullptr) {
     stop_alloc_counting = (the_trace->flags_ & Trace::kTraceCountAllocs) != 0;
+    {
+      gc::ScopedGCCriticalSection gcs(self,
+                                      gc::kGcCauseInstrumentation,
+                                      gc::kCollectorTypeInstrumentation);
+      ScopedSuspendAll ssa(__FUNCTION__);
+
+      if (the_trace->trace_mode_ == TraceMode::kSampling) {
+        MutexLock mu(self, *Locks::thread_list_lock_);
+        runtime->GetThreadList()->ForEach(ClearThreadStackTraceAndClockBase, nullptr);
+      } else {
+        runtime->GetInstrumentation()->DisableMethodTracing(kTracerInstrumentationKey);
+        runtime->GetInstrumentation()->RemoveListener(
+            the_trace, instrumentation::Instrumentation::kMethodEntered |
+            instrumentation::Instrumentation::kMethodExited |
+            instrumentation::Instrumentation::kMethodUnwind);
+      }
+      // No more events can be recorded, collect the ones still buffered by threads. Threads that
+      // exited since the_trace_ was cleared have written theirs to stopping_trace_.
+      {
+        MutexLock mu(self, *Locks::thread_list_lock_);
+        runtime->GetThreadList()->ForEach(ReleaseThreadBuffer,
+                                          finish_tracing ? the_trace : nullptr);
+      }
+      {
+        MutexLock mu(self, *Locks::trace_lock_);
+        stopping_trace_ = nullptr;
+      }
+    }
     if (finish_tracing) {
       the_trace->FinishTracing();
     }
-    gc::ScopedGCCriticalSection gcs(self,
-                                    gc::kGcCauseInstrumentation,
-                                    gc::kCollectorTypeInstrumentation);
-    ScopedSuspendAll ssa(__FUNCTION__);
-
-    if (the_trace->trace_mode_ == TraceMode::kSampling) {
-      MutexLock mu(self, *Locks::thread_list_lock_);
-      runtime->GetThreadList()->ForEach(ClearThreadStackTraceAndClockBase, nullptr);
-    } else {
-      runtime->GetInstrumentation()->DisableMethodTracing(kTracerInstrumentationKey);
-      runtime->GetInstrumentation()->RemoveListener(
-          the_trace, instrumentation::Instrumentation::kMethodEntered |
-          instrumentation::Instrumentation::kMethodExited |
-          instrumentation::Instrumentation::kMethodUnwind);
-    }
     if (the_trace->trace_file_.get() != nullptr) {
       // Do not try to erase, so flush and close explicitly.
       if (flush_file) {
@@ -526,6 +620,10 @@ void Trace::Pause() {
           instrumentation::Instrumentation::kMethodExited |
           instrumentation::Instrumentation::kMethodUnwind);
     }
+    // Exiting threads flush their buffer while runnable, see FlushExitingThreadBuffer().
+    MutexLock mu(self, *Locks::trace_lock_);
+    MutexLock mu2(self, *Locks::thread_list_lock_);
+    runtime->GetThreadList()->ForEach(ReleaseThreadBuffer, the_trace);
   }
 
   if (stop_alloc_counting) {
@@ -549,7 +647,7 @@ void Trace::Resume() {
   Runtime* runtime = Runtime::Current();
 
   // Enable count of allocs if specified in the flags.
-  bool enable_stats = (the_trace->flags_ && kTraceCountAllocs) != 0;
+  bool enable_stats = (the_trace->flags_ & kTraceCountAllocs) != 0;
 
   {
     gc::ScopedGCCriticalSection gcs(self,
@@ -931,20 +1029,9 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
   // Ensure we always use the non-obsolete version of the method so that entry/exit events have the
   // same pointer value.
   method = method->GetNonObsoleteMethod();
-  // Advance cur_offset_ atomically.
-  int32_t new_offset;
-  int32_t old_offset = 0;
 
-  // We do a busy loop here trying to acquire the next offset.
-  if (trace_output_mode_ != TraceOutputMode::kStreaming) {
-    do {
-      old_offset = cur_offset_.LoadRelaxed();
-      new_offset = old_offset + GetRecordSize(clock_source_);
-      if (static_cast<size_t>(new_offset) > buffer_size_) {
-        overflow_ = true;
-        return;
-      }
-    } while (!cur_offset_.CompareAndSetWeakSequentiallyConsistent(old_offset, new_offset));
+  if (trace_output_mode_ != TraceOutputMode::kStreaming && overflow_) {
+    return;
   }
 
   TraceAction action = kTraceMethodEnter;
@@ -962,33 +1049,95 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
       UNIMPLEMENTED(FATAL) << "Unexpected event: " << event;
   }
 
-  uint32_t method_value = EncodeTraceMethodAndAction(method, action);
+  // Events are recorded in a buffer owned by the thread, which is only accessed by the thread
+  // itself or while it is suspended. Encoding the events into trace records, and writing these
+  // to the shared output, is done for a whole buffer at a time.
+  uintptr_t* events = thread->GetMethodTraceBuffer();
+  if (UNLIKELY(events == nullptr)) {
+    events = new uintptr_t[kPerThreadBufSize];
+    thread->SetMethodTraceBuffer(events);
+    thread->SetMethodTraceBufferIndex(0);
+    if (trace_output_mode_ == TraceOutputMode::kStreaming) {
+      MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
+      if (RegisterThread(thread)) {
+        // It might be better to postpone this. Threads might not have received names...
+        std::string thread_name;
+        thread->GetThreadName(thread_name);
+        uint8_t buf2[7];
+        Append2LE(buf2, 0);
+        buf2[2] = kOpNewThread;
+        Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
+        Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
+        WriteToBuf(buf2, sizeof(buf2));
+        WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
+      }
+    }
+  }
+  size_t index = thread->GetMethodTraceBufferIndex();
+  if (index + GetEventSize() > kPerThreadBufSize) {
+    FlushThreadBuffer(thread);
+    index = 0;
+  }
+  events[index++] = EncodeEvent(method, action);
+  if (UseThreadCpuClock()) {
+    events[index++] = thread_clock_diff;
+  }
+  if (UseWallClock()) {
+    events[index++] = wall_clock_diff;
+  }
+  thread->SetMethodTraceBufferIndex(index);
+}
+
+size_t Trace::GetEventSize() {
+  return 1U + (UseThreadCpuClock() ? 1U : 0U) + (UseWallClock() ? 1U : 0U);
+}
 
-  // Write data
-  uint8_t* ptr;
-  static constexpr size_t kPacketSize = 14U;  // The maximum size of data in a packet.
-  uint8_t stack_buf[kPacketSize];             // Space to store a packet when in streaming mode.
+void Trace::FlushThreadBuffer(Thread* thread) {
+  size_t num_entries = thread->GetMethodTraceBufferIndex();
+  if (num_entries == 0) {
+    return;
+  }
+  thread->SetMethodTraceBufferIndex(0);
+  uint16_t tid = static_cast<uint16_t>(thread->GetTid());
   if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    ptr = stack_buf;
+    StreamEvents(tid, thread->GetMethodTraceBuffer(), num_entries);
   } else {
-    ptr = buf_.get() + old_offset;
+    WriteEventsToBuf(tid, thread->GetMethodTraceBuffer(), num_entries);
   }
+}
 
-  Append2LE(ptr, thread->GetTid());
-  Append4LE(ptr + 2, method_value);
-  ptr += 6;
-
-  if (UseThreadCpuClock()) {
-    Append4LE(ptr, thread_clock_diff);
-    ptr += 4;
+void Trace::WriteEventsToBuf(uint16_t tid, const uintptr_t* events, size_t num_entries) {
+  const size_t event_size = GetEventSize();
+  const size_t record_size = GetRecordSize(clock_source_);
+  // Reserve room for as many records as fit with a single update of cur_offset_.
+  size_t num_records;
+  int32_t old_offset;
+  int32_t new_offset;
+  do {
+    old_offset = cur_offset_.LoadRelaxed();
+    size_t available = (buffer_size_ - static_cast<size_t>(old_offset)) / record_size;
+    num_records = std::min(num_entries / event_size, available);
+    new_offset = old_offset + static_cast<int32_t>(num_records * record_size);
+  } while (!cur_offset_.CompareAndSetWeakSequentiallyConsistent(old_offset, new_offset));
+  if (num_records * event_size != num_entries) {
+    overflow_ = true;
   }
-  if (UseWallClock()) {
-    Append4LE(ptr, wall_clock_diff);
+
+  MutexLock mu(Thread::Current(), *unique_methods_lock_);
+  uint8_t* ptr = buf_.get() + old_offset;
+  for (size_t i = 0; i != num_records * event_size; i += event_size) {
+    uint32_t method_value = (EncodeTraceMethodLocked(DecodeEventMethod(events[i])) <<
+                             TraceActionBits) | DecodeEventAction(events[i]);
+    WriteRecord(ptr, tid, method_value, &events[i + 1]);
+    ptr += record_size;
   }
-  static_assert(kPacketSize == 2 + 4 + 4 + 4, "Packet size incorrect.");
+}
 
-  if (trace_output_mode_ == TraceOutputMode::kStreaming) {
-    MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
+void Trace::StreamEvents(uint16_t tid, const uintptr_t* events, size_t num_entries) {
+  const size_t event_size = GetEventSize();
+  MutexLock mu(Thread::Current(), *streaming_lock_);  // To serialize writing.
+  for (size_t i = 0; i != num_entries; i += event_size) {
+    ArtMethod* method = DecodeEventMethod(events[i]);
     if (RegisterMethod(method)) {
       // Write a special block with the name.
       std::string method_line(GetMethodLine(method));
@@ -999,19 +1148,42 @@ void Trace::LogMethodTraceEvent(Thread* thread, ArtMethod* method,
       WriteToBuf(buf2, sizeof(buf2));
       WriteToBuf(reinterpret_cast<const uint8_t*>(method_line.c_str()), method_line.length());
     }
-    if (RegisterThread(thread)) {
-      // It might be better to postpone this. Threads might not have received names...
-      std::string thread_name;
-      thread->GetThreadName(thread_name);
-      uint8_t buf2[7];
-      Append2LE(buf2, 0);
-      buf2[2] = kOpNewThread;
-      Append2LE(buf2 + 3, static_cast<uint16_t>(thread->GetTid()));
-      Append2LE(buf2 + 5, static_cast<uint16_t>(thread_name.length()));
-      WriteToBuf(buf2, sizeof(buf2));
-      WriteToBuf(reinterpret_cast<const uint8_t*>(thread_name.c_str()), thread_name.length());
-    }
-    WriteToBuf(stack_buf, sizeof(stack_buf));
+    uint8_t record[kTraceRecordSizeDualClock] = {};
+    WriteRecord(record, tid, EncodeTraceMethodAndAction(method, DecodeEventAction(events[i])),
+                &events[i + 1]);
+    WriteToBuf(record, sizeof(record));
+  }
+}
+
+void Trace::WriteRecord(uint8_t* ptr, uint16_t tid, uint32_t method_value,
+                        const uintptr_t* clocks) {
+  Append2LE(ptr, tid);
+  Append4LE(ptr + 2, method_value);
+  ptr += 6;
+
+  if (UseThreadCpuClock()) {
+    Append4LE(ptr, static_cast<uint32_t>(*clocks++));
+    ptr += 4;
+  }
+  if (UseWallClock()) {
+    Append4LE(ptr, static_cast<uint32_t>(*clocks));
+  }
+  static_assert(kTraceRecordSizeDualClock == 2 + 4 + 4 + 4, "Packet size incorrect.");
+}
+
+void Trace::ReleaseExitingThreadBuffer(Thread* thread) {
+  std::unique_ptr<uintptr_t[]> events(thread->GetMethodTraceBuffer());
+  size_t num_entries = thread->GetMethodTraceBufferIndex();
+  thread->SetMethodTraceBuffer(nullptr);
+  thread->SetMethodTraceBufferIndex(0);
+  if (num_entries == 0) {
+    return;
+  }
+  uint16_t tid = static_cast<uint16_t>(thread->GetTid());
+  if (trace_output_mode_ == TraceOutputMode::kStreaming) {
+    StreamEvents(tid, events.get(), num_entries);
+  } else {
+    WriteEventsToBuf(tid, events.get(), num_entries);
   }
 }
 
@@ -1051,14 +1223,37 @@ void Trace::DumpThreadList(std::ostream& os) {
   Runtime::Current()->GetThreadList()->ForEach(DumpThread, &os);
 }
 
+Trace* Trace::GetTraceOfExitingThreads() {
+  return (the_trace_ != nullptr) ? the_trace_ : stopping_trace_;
+}
+
+void Trace::FlushExitingThreadBuffer(Thread* thread) {
+  // Only threads that recorded events under a trace have a buffer.
+  if (thread->GetMethodTraceBuffer() == nullptr) {
+    return;
+  }
+  Trace* the_trace;
+  {
+    MutexLock mu(thread, *Locks::trace_lock_);
+    the_trace = GetTraceOfExitingThreads();
+  }
+  // The trace is deleted only after suspending all threads, so it stays alive while this thread
+  // holds the mutator lock. When sampling, the events of a thread are written with each sample
+  // instead, and the sampling thread may still be recording a sample of this thread.
+  if (the_trace != nullptr && the_trace->trace_mode_ == TraceMode::kMethodTracing) {
+    the_trace->ReleaseExitingThreadBuffer(thread);
+  }
+}
+
 void Trace::StoreExitingThreadInfo(Thread* thread) {
   MutexLock mu(thread, *Locks::trace_lock_);
-  if (the_trace_ != nullptr) {
+  Trace* the_trace = GetTraceOfExitingThreads();
+  if (the_trace != nullptr) {
     std::string name;
     thread->GetThreadName(name);
     // The same thread/tid may be used multiple times. As SafeMap::Put does not allow to override
     // a previous mapping, use SafeMap::Overwrite.
-    the_trace_->exited_threads_.Overwrite(thread->GetTid(), name);
+    the_trace->exited_threads_.Overwrite(thread->GetTid(), name);
   }
 }
 
@@ -98,6 +98,9 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
  public:
   enum TraceFlag {
     kTraceCountAllocs = 1,
+    // In sampling mode, have each thread record its own sample at its next suspend check
+    // instead of suspending all threads for every sample.
+    kTraceSampleWithCheckpoints = 2,
   };
 
   enum class TraceOutputMode {
@@ -140,6 +143,10 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
   void CompareAndUpdateStackTrace(Thread* thread, std::vector<ArtMethod*>* stack_trace)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_, !*streaming_lock_);
 
+  // Write the events buffered by the thread to the trace output and empty its buffer.
+  void FlushThreadBuffer(Thread* thread)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_, !*streaming_lock_);
+
   // InstrumentationListener implementation.
   void MethodEntered(Thread* thread,
                      Handle<mirror::Object> this_object,
@@ -197,12 +204,20 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_) OVERRIDE;
   void WatchedFramePop(Thread* thread, const ShadowFrame& frame)
       REQUIRES_SHARED(Locks::mutator_lock_) OVERRIDE;
-  // Reuse an old stack trace if it exists, otherwise allocate a new one.
+  // Reuse an old stack trace if it exists, otherwise allocate a new one. Only the sampling
+  // thread reuses stack traces, other threads sampling themselves always allocate.
   static std::vector<ArtMethod*>* AllocStackTrace();
-  // Clear and store an old stack trace for later use.
+  // Clear and store an old stack trace for later use, or delete it if not on the sampling thread.
   static void FreeStackTrace(std::vector<ArtMethod*>* stack_trace);
+  // Write the buffered events of an exiting thread and free its buffer. Called from
+  // Thread::Destroy() while the thread may still be runnable, as writing the events may need to
+  // read the declaring classes of the methods.
+  static void FlushExitingThreadBuffer(Thread* thread)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      // See StopTracing() about lock annotations of static functions calling into the trace.
+      NO_THREAD_SAFETY_ANALYSIS;
   // Save id and name of a thread before it exits.
-  static void StoreExitingThreadInfo(Thread* thread);
+  static void StoreExitingThreadInfo(Thread* thread) REQUIRES(!Locks::trace_lock_);
 
   static TraceOutputMode GetOutputMode() REQUIRES(!Locks::trace_lock_);
   static TraceMode GetMode() REQUIRES(!Locks::trace_lock_);
@@ -235,6 +250,22 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
                            uint32_t thread_clock_diff, uint32_t wall_clock_diff)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_, !*streaming_lock_);
 
+  // Number of per-thread buffer entries used by one event.
+  size_t GetEventSize();
+
+  // Methods to write buffered events to the trace output. When not streaming, records that do
+  // not fit in buf_ are dropped. When streaming, each new method is announced before its first
+  // record.
+  void WriteEventsToBuf(uint16_t tid, const uintptr_t* events, size_t num_entries)
+      REQUIRES(!*unique_methods_lock_);
+  void StreamEvents(uint16_t tid, const uintptr_t* events, size_t num_entries)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_, !*streaming_lock_);
+  void WriteRecord(uint8_t* ptr, uint16_t tid, uint32_t method_value, const uintptr_t* clocks);
+
+  // Write the buffered events of an exiting thread and free its buffer.
+  void ReleaseExitingThreadBuffer(Thread* thread)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!*unique_methods_lock_, !*streaming_lock_);
+
   // Methods to output traced methods and threads.
   void GetVisitedMethods(size_t end_offset, std::set<ArtMethod*>* visited_methods)
       REQUIRES(!*unique_methods_lock_);
@@ -258,6 +289,7 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
       REQUIRES(streaming_lock_);
 
   uint32_t EncodeTraceMethod(ArtMethod* method) REQUIRES(!*unique_methods_lock_);
+  uint32_t EncodeTraceMethodLocked(ArtMethod* method) REQUIRES(*unique_methods_lock_);
   uint32_t EncodeTraceMethodAndAction(ArtMethod* method, TraceAction action)
       REQUIRES(!*unique_methods_lock_);
   ArtMethod* DecodeTraceMethod(uint32_t tmid) REQUIRES(!*unique_methods_lock_);
@@ -270,13 +302,20 @@ class Trace FINAL : public instrumentation::InstrumentationListener {
   // Singleton instance of the Trace or null when no method tracing is active.
   static Trace* volatile the_trace_ GUARDED_BY(Locks::trace_lock_);
 
+  // Trace being stopped and finished, until the buffers of all threads are collected. Threads
+  // exiting in the meantime still write their events and names to it.
+  static Trace* stopping_trace_ GUARDED_BY(Locks::trace_lock_);
+
+  // The trace exiting threads write to, if any.
+  static Trace* GetTraceOfExitingThreads() REQUIRES(Locks::trace_lock_);
+
   // The default profiler clock source.
   static TraceClockSource default_clock_source_;
 
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
+  // Used by the sampling thread to remember an unused stack trace to avoid re-allocation.
   static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
 
   // File to write trace data out to, null if direct to ddms.
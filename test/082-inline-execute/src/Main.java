@@ -70,6 +70,7 @@ public class Main {
     test_String_charAt();
     test_String_compareTo();
     test_String_indexOf();
+    test_String_indexOfString();
     test_String_isEmpty();
     test_String_length();
     test_Thread_currentThread();
@@ -391,6 +392,129 @@ public class Main {
     return strNull.indexOf(c, startIndex);
   }
 
+  public static void test_String_indexOfString() {
+    String str0 = "";
+    String str3 = "abc";
+    String str10 = "abcdefghij";
+    String str40 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabc";
+
+    // The empty string is found at the start index, clamped to the length.
+    Assert.assertEquals(str0.indexOf(""), 0);
+    Assert.assertEquals(str3.indexOf(""), 0);
+    Assert.assertEquals(str3.indexOf("", 2), 2);
+    Assert.assertEquals(str3.indexOf("", 3), 3);
+    Assert.assertEquals(str3.indexOf("", 4), 3);
+    Assert.assertEquals(str3.indexOf("", -1), 0);
+    Assert.assertEquals(str0.indexOf("", 1234), 0);
+
+    // Start index out of range.
+    Assert.assertEquals(str10.indexOf("abc", -1), 0);
+    Assert.assertEquals(str10.indexOf("abc", negIndex[0]), 0);
+    Assert.assertEquals(str10.indexOf("hij", -5), 7);
+    Assert.assertEquals(str10.indexOf("j", 10), -1);
+    Assert.assertEquals(str10.indexOf("j", 1234), -1);
+    Assert.assertEquals(str10.indexOf("hij", 8), -1);
+
+    // Argument longer than the string.
+    Assert.assertEquals(str0.indexOf("a"), -1);
+    Assert.assertEquals(str3.indexOf("abcd"), -1);
+    Assert.assertEquals(str3.indexOf("abcd", 0), -1);
+
+    // Matches and partial matches, at the start, inside and at the end.
+    Assert.assertEquals(str3.indexOf("abc"), 0);
+    Assert.assertEquals(str3.indexOf("bc"), 1);
+    Assert.assertEquals(str3.indexOf("c"), 2);
+    Assert.assertEquals(str3.indexOf("bd"), -1);
+    Assert.assertEquals(str3.indexOf("cd"), -1);
+    Assert.assertEquals(str10.indexOf("def"), 3);
+    Assert.assertEquals(str10.indexOf("def", 3), 3);
+    Assert.assertEquals(str10.indexOf("def", 4), -1);
+    Assert.assertEquals(str10.indexOf("ijk"), -1);
+    Assert.assertEquals(str40.indexOf("aab"), 36);
+    Assert.assertEquals(str40.indexOf("abc"), 37);
+    Assert.assertEquals(str40.indexOf("abd"), -1);
+    Assert.assertEquals(str40.indexOf("bcd"), -1);
+    Assert.assertEquals(str40.indexOf("aaaa", 20), 20);
+
+    // Uncompressed strings.
+    String utf16 = "\u0100abc\u0100ab\u0100abd";
+    Assert.assertEquals(utf16.indexOf("\u0100"), 0);
+    Assert.assertEquals(utf16.indexOf("\u0100ab", 1), 4);
+    Assert.assertEquals(utf16.indexOf("\u0100abd"), 7);
+    Assert.assertEquals(utf16.indexOf("\u0100abe"), -1);
+    Assert.assertEquals(utf16.indexOf("d\u0100"), -1);
+    Assert.assertEquals(utf16.indexOf("", 5), 5);
+
+    // Strings of different encodings, when string compression is enabled.
+    Assert.assertEquals(utf16.indexOf("abd"), 8);
+    Assert.assertEquals(utf16.indexOf("abe"), -1);
+    Assert.assertEquals(str10.indexOf("\u0100"), -1);
+    Assert.assertEquals(str10.indexOf("c\u0100"), -1);
+
+    testIndexOfStringNull();
+
+    // Move the match over all positions of strings longer than one SIMD block.
+    for (int length = 1; length <= 70; ++length) {
+      testIndexOfStringPositions(length, 'x', 'y');
+      testIndexOfStringPositions(length, '\u0100', '\u0101');
+    }
+  }
+
+  private static void testIndexOfStringPositions(int length, char filler, char mark) {
+    for (int position = 0; position < length; ++position) {
+      char[] chars = new char[length];
+      java.util.Arrays.fill(chars, filler);
+      chars[position] = mark;
+      String str = new String(chars);
+      String mark1 = String.valueOf(mark);
+      String mark2 = String.valueOf(new char[] { mark, filler });
+      String filler2 = String.valueOf(new char[] { filler, filler });
+      Assert.assertEquals(str.indexOf(mark1), position);
+      Assert.assertEquals(str.indexOf(mark1, position), position);
+      Assert.assertEquals(str.indexOf(mark1, position + 1), -1);
+      Assert.assertEquals(str.indexOf(mark2), (position + 1 < length) ? position : -1);
+      Assert.assertEquals(str.indexOf(filler2, position), naiveIndexOf(str, filler2, position));
+      Assert.assertEquals(str.indexOf(str), 0);
+      Assert.assertEquals(str.indexOf(str, 1), -1);
+    }
+  }
+
+  private static int naiveIndexOf(String str, String arg, int start) {
+    for (int i = Math.max(start, 0); i + arg.length() <= str.length(); ++i) {
+      if (str.regionMatches(i, arg, 0, arg.length())) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  private static void testIndexOfStringNull() {
+    String strNull = null;
+    try {
+      testNullIndexOfString("abc", strNull);
+      Assert.fail();
+    } catch (NullPointerException expected) {
+    }
+    try {
+      testNullIndexOfString("abc", strNull, 0);
+      Assert.fail();
+    } catch (NullPointerException expected) {
+    }
+    try {
+      testNullIndexOfString(strNull, "abc");
+      Assert.fail();
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  private static int testNullIndexOfString(String str, String arg) {
+    return str.indexOf(arg);
+  }
+
+  private static int testNullIndexOfString(String str, String arg, int startIndex) {
+    return str.indexOf(arg, startIndex);
+  }
+
   public static void test_String_compareTo() {
     String test = "0123456789";
     String test1 = new String("0123456789");    // different object
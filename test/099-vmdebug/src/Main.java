@@ -90,6 +90,17 @@ public class Main {
             System.out.println("ERROR: sample tracing output file is empty");
         }
 
+        System.out.println("Confirm sampling with checkpoints");
+        // Flag 2 samples each thread at its next suspend check (kTraceSampleWithCheckpoints).
+        VMDebug.startMethodTracing(tempFileName, 0, 2, true, 1000);
+        System.out.println("status=" + VMDebug.getMethodTracingMode());
+        Thread.sleep(10);
+        VMDebug.stopMethodTracing();
+        System.out.println("status=" + VMDebug.getMethodTracingMode());
+        if (tempFile.length() == 0) {
+            System.out.println("ERROR: checkpoint sample tracing output file is empty");
+        }
+
         System.out.println("Test starting when already started");
         VMDebug.startMethodTracing(tempFileName, 0, 0, false, 0);
         System.out.println("status=" + VMDebug.getMethodTracingMode());
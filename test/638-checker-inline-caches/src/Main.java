@@ -30,6 +30,35 @@ class SubE extends Super {
   int getValue() { return -4; }
 }
 
+interface Itf {
+  int getValue();
+}
+
+class ItfA implements Itf {
+  // The try block of the synchronized statement prevents inlining.
+  public int getValue() {
+    synchronized (this) {
+      return 42;
+    }
+  }
+}
+
+class ItfB implements Itf {
+  public int getValue() { return 38; }
+}
+
+class ItfC implements Itf {
+  public int getValue() { return 24; }
+}
+
+class ItfD implements Itf {
+  public int getValue() { return 10; }
+}
+
+class ItfE implements Itf {
+  public int getValue() { return -4; }
+}
+
 public class Main {
 
   /// CHECK-START: int Main.inlineMonomorphicSubA(Super) inliner (before)
@@ -116,6 +145,56 @@ public class Main {
     return a.getValue();
   }
 
+  /// CHECK-START: int Main.inlineMegamorphicDominantSubA(Super) inliner (before)
+  /// CHECK:       InvokeVirtual method_name:Super.getValue
+
+  // Only the dominant type of the megamorphic receiver is guarded, and the original
+  // invoke is kept for the other types.
+
+  /// CHECK-START: int Main.inlineMegamorphicDominantSubA(Super) inliner (after)
+  /// CHECK-DAG:  <<SubARet:i\d+>>         IntConstant 42
+  /// CHECK-DAG:  <<Obj:l\d+>>             NullCheck
+  /// CHECK-DAG:  <<ObjClass:l\d+>>        InstanceFieldGet [<<Obj>>] field_name:java.lang.Object.shadow$_klass_
+  /// CHECK-DAG:  <<InlineClass:l\d+>>     LoadClass class_name:SubA
+  /// CHECK-DAG:  <<Test:z\d+>>            NotEqual [<<InlineClass>>,<<ObjClass>>]
+  /// CHECK-DAG:                           If [<<Test>>]
+  /// CHECK-DAG:  <<DefaultRet:i\d+>>      InvokeVirtual [<<Obj>>] method_name:Super.getValue
+  /// CHECK-DAG:  <<Ret:i\d+>>             Phi [<<SubARet>>,<<DefaultRet>>]
+  /// CHECK-DAG:                           Return [<<Ret>>]
+
+  /// CHECK-START: int Main.inlineMegamorphicDominantSubA(Super) inliner (after)
+  /// CHECK:                               LoadClass class_name:SubA
+  /// CHECK-NOT:                           LoadClass
+
+  /// CHECK-START: int Main.inlineMegamorphicDominantSubA(Super) inliner (after)
+  /// CHECK-NOT:                           Deoptimize
+  public static int inlineMegamorphicDominantSubA(Super a) {
+    return a.getValue();
+  }
+
+  /// CHECK-START: int Main.devirtualizeMegamorphicDominantItfA(Itf) inliner (before)
+  /// CHECK:       InvokeInterface method_name:Itf.getValue
+
+  // The dominant target cannot be inlined, but is called through an invoke-virtual
+  // behind the type guard.
+
+  /// CHECK-START: int Main.devirtualizeMegamorphicDominantItfA(Itf) inliner (after)
+  /// CHECK-DAG:  <<Obj:l\d+>>             NullCheck
+  /// CHECK-DAG:  <<ObjClass:l\d+>>        InstanceFieldGet [<<Obj>>] field_name:java.lang.Object.shadow$_klass_
+  /// CHECK-DAG:  <<InlineClass:l\d+>>     LoadClass class_name:ItfA
+  /// CHECK-DAG:  <<Test:z\d+>>            NotEqual [<<InlineClass>>,<<ObjClass>>]
+  /// CHECK-DAG:                           If [<<Test>>]
+  /// CHECK-DAG:  <<ItfARet:i\d+>>         InvokeVirtual [<<Obj>>] method_name:ItfA.getValue
+  /// CHECK-DAG:  <<DefaultRet:i\d+>>      InvokeInterface [<<Obj>>] method_name:Itf.getValue
+  /// CHECK-DAG:  <<Ret:i\d+>>             Phi [<<ItfARet>>,<<DefaultRet>>]
+  /// CHECK-DAG:                           Return [<<Ret>>]
+
+  /// CHECK-START: int Main.devirtualizeMegamorphicDominantItfA(Itf) inliner (after)
+  /// CHECK-NOT:                           Deoptimize
+  public static int devirtualizeMegamorphicDominantItfA(Itf a) {
+    return a.getValue();
+  }
+
   /// CHECK-START: int Main.inlineMissingTypes(Super) inliner (before)
   /// CHECK:       InvokeVirtual method_name:Super.getValue
 
@@ -177,6 +256,23 @@ public class Main {
     if (inlineMegamorphic(new SubA()) != 42) {
       throw new Error("Expected 42");
     }
+
+    if (inlineMegamorphicDominantSubA(new SubA()) != 42) {
+      throw new Error("Expected 42");
+    }
+
+    // Call with a type that is not guarded.
+    if (inlineMegamorphicDominantSubA(new SubE()) != -4) {
+      throw new Error("Expected -4");
+    }
+
+    if (devirtualizeMegamorphicDominantItfA(new ItfA()) != 42) {
+      throw new Error("Expected 42");
+    }
+
+    if (devirtualizeMegamorphicDominantItfA(new ItfB()) != 38) {
+      throw new Error("Expected 38");
+    }
   }
 
 
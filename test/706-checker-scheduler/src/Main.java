@@ -585,11 +585,33 @@ public class Main {
     }
   }
 
+  // Check that the multiplication of the loop body is speculatively moved to the loop
+  // exit test, while the updates of the loop phis stay in the body. (On ARM64 the
+  // multiplication is merged into a MultiplyAccumulate.)
+
+  /// CHECK-START-X86_64: int Main.speculateToLoopExit(int) scheduler (before)
+  /// CHECK:                     If                          loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK:     <<Mul:i\d+>>    Mul                         loop:<<Loop>>      outer_loop:none
+  /// CHECK:                     Add [{{i\d+}},<<Mul>>]      loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START-X86_64: int Main.speculateToLoopExit(int) scheduler (after)
+  /// CHECK:     <<Mul:i\d+>>    Mul                         loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK:                     If                          loop:<<Loop>>      outer_loop:none
+  /// CHECK:                     Add [{{i\d+}},<<Mul>>]      loop:<<Loop>>      outer_loop:none
+  public static int speculateToLoopExit(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += i * i;
+    }
+    return sum;
+  }
+
   public static void main(String[] args) {
     testVecSetScalars();
     testVecReplicateScalar();
     if ((arrayAccess() + intDiv(10)) != -35) {
       System.out.println("FAIL");
     }
+    expectEquals(285, speculateToLoopExit(10));
   }
 }
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+import java.lang.invoke.MethodHandles;
 import java.lang.invoke.VarHandle;
 
 /**
@@ -88,6 +89,177 @@ public class Main {
       VarHandle.storeStoreFence();
   }
 
+  //
+  // Accessors (invoke-polymorphic).
+  //
+
+  static final VarHandle intField;
+  static final VarHandle intArray = MethodHandles.arrayElementVarHandle(int[].class);
+  static final VarHandle objectField;
+  static final VarHandle objectArray = MethodHandles.arrayElementVarHandle(Object[].class);
+
+  static {
+    try {
+      intField = MethodHandles.lookup().findVarHandle(Main.class, "field", int.class);
+      objectField = MethodHandles.lookup().findVarHandle(Main.class, "objectValue", Object.class);
+    } catch (ReflectiveOperationException e) {
+      throw new ExceptionInInitializerError(e);
+    }
+  }
+
+  int field;
+  Object objectValue;
+
+  /// CHECK-START: int Main.getVolatile(Main) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleGetVolatile
+  private static int getVolatile(Main m) {
+    return (int) intField.getVolatile(m);
+  }
+
+  /// CHECK-START: void Main.setRelease(Main, int) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleSetRelease
+  private static void setRelease(Main m, int value) {
+    intField.setRelease(m, value);
+  }
+
+  /// CHECK-START: boolean Main.compareAndSet(int[], int, int, int) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleCompareAndSet
+  private static boolean compareAndSet(int[] a, int i, int expected, int value) {
+    return intArray.compareAndSet(a, i, expected, value);
+  }
+
+  /// CHECK-START: int Main.getAndAdd(int[], int, int) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleGetAndAdd
+  private static int getAndAdd(int[] a, int i, int delta) {
+    return (int) intArray.getAndAdd(a, i, delta);
+  }
+
+  /// CHECK-START: java.lang.Object Main.getObject(Main) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleGet
+  private static Object getObject(Main m) {
+    return objectField.get(m);
+  }
+
+  /// CHECK-START: void Main.setObject(Main, java.lang.Object) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleSet
+  private static void setObject(Main m, Object value) {
+    objectField.set(m, value);
+  }
+
+  /// CHECK-START: boolean Main.compareAndSetObject(Main, java.lang.Object, java.lang.Object) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleCompareAndSet
+  private static boolean compareAndSetObject(Main m, Object expected, Object value) {
+    return objectField.compareAndSet(m, expected, value);
+  }
+
+  /// CHECK-START: java.lang.Object Main.getObjectElement(java.lang.Object[], int) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleGet
+  private static Object getObjectElement(Object[] a, int i) {
+    return objectArray.get(a, i);
+  }
+
+  /// CHECK-START: void Main.setObjectElement(java.lang.Object[], int, java.lang.Object) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleSet
+  private static void setObjectElement(Object[] a, int i, Object value) {
+    objectArray.set(a, i, value);
+  }
+
+  /// CHECK-START: boolean Main.compareAndSetObjectElement(java.lang.Object[], int, java.lang.Object, java.lang.Object) builder (after)
+  /// CHECK-DAG: InvokePolymorphic intrinsic:VarHandleCompareAndSet
+  private static boolean compareAndSetObjectElement(Object[] a, int i, Object expected, Object value) {
+    return objectArray.compareAndSet(a, i, expected, value);
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(boolean expected, boolean result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectSame(Object expected, Object result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void accessors() {
+    Main m = new Main();
+    setRelease(m, 42);
+    expectEquals(42, getVolatile(m));
+    expectEquals(42, m.field);
+
+    int[] a = new int[4];
+    expectEquals(true, compareAndSet(a, 3, 0, 7));
+    expectEquals(false, compareAndSet(a, 3, 0, 8));
+    expectEquals(7, getAndAdd(a, 3, 5));
+    expectEquals(12, a[3]);
+    try {
+      getAndAdd(a, 4, 1);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    try {
+      getVolatile(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  private static void referenceAccessors() {
+    // Values of exactly the variable type take the compiled fast path, the strings take the
+    // slow path.
+    Main m = new Main();
+    Object first = new Object();
+    Object second = new Object();
+    setObject(m, first);
+    expectSame(first, getObject(m));
+    expectSame(first, m.objectValue);
+    expectEquals(true, compareAndSetObject(m, first, second));
+    expectEquals(false, compareAndSetObject(m, first, null));
+    expectSame(second, getObject(m));
+    expectEquals(true, compareAndSetObject(m, second, null));
+    expectSame(null, m.objectValue);
+    setObject(m, "string");
+    expectSame("string", getObject(m));
+
+    Object[] a = new Object[4];
+    setObjectElement(a, 3, first);
+    expectSame(first, getObjectElement(a, 3));
+    expectSame(first, a[3]);
+    expectEquals(true, compareAndSetObjectElement(a, 3, first, second));
+    expectEquals(false, compareAndSetObjectElement(a, 3, first, null));
+    expectSame(second, getObjectElement(a, 3));
+    expectEquals(true, compareAndSetObjectElement(a, 3, second, "string"));
+    expectSame("string", a[3]);
+    try {
+      setObjectElement(a, 4, first);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+
+    // Store new objects into the old holders, so that the GC sees them through the card table
+    // or the read barriers only.
+    Runtime.getRuntime().gc();
+    for (int i = 0; i < 100; ++i) {
+      setObject(m, new Object());
+      compareAndSetObjectElement(a, 0, getObjectElement(a, 0), new Object());
+      setObjectElement(a, 1, new int[i + 1]);
+      if (i % 10 == 0) {
+        Runtime.getRuntime().gc();
+      }
+    }
+    Runtime.getRuntime().gc();
+    expectSame(Object.class, getObject(m).getClass());
+    expectSame(Object.class, getObjectElement(a, 0).getClass());
+    expectEquals(100, ((int[]) getObjectElement(a, 1)).length);
+  }
+
   //
   // Driver.
   //
@@ -99,6 +271,8 @@ public class Main {
     loadLoadFence();
     storeStoreFence();
     fullFence();
+    accessors();
+    referenceAccessors();
     System.out.println("passed");
   }
 }
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Arrays;
+
+public class Main {
+
+  static class Point {
+    int x;
+    int y;
+  }
+
+  public static void main(String[] args) {
+    assertIntEquals(testThrowPath(1, 2), 3);
+    try {
+      testThrowPath(-1, 2);
+      throw new Error("Unreachable");
+    } catch (IllegalStateException e) {
+      System.out.println(e.getMessage());
+    }
+
+    assertIntEquals(testArrayThrowPath(3, 4), 7);
+    try {
+      testArrayThrowPath(-3, 4);
+      throw new Error("Unreachable");
+    } catch (IllegalStateException e) {
+      System.out.println(e.getMessage());
+    }
+
+    assertIntEquals(testEscapeAndMerge(5, 6), 11);
+    assertIntEquals(testEscapeAndMerge(-5, 6), 1);
+  }
+
+  /// CHECK-START: int Main.testThrowPath(int, int) partial_escape_analysis (before)
+  /// CHECK: <<New:l\d+>>         NewInstance
+  /// CHECK:                      If
+  /// CHECK:                      InvokeStaticOrDirect [<<New>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$newError
+  /// CHECK:                      Throw
+
+  /// CHECK-START: int Main.testThrowPath(int, int) partial_escape_analysis (after)
+  /// CHECK-DAG: <<A:i\d+>>       ParameterValue
+  /// CHECK-DAG: <<B:i\d+>>       ParameterValue
+  /// CHECK:                      NewInstance
+  /// CHECK:                      If
+  /// CHECK: <<Copy:l\d+>>        NewInstance
+  /// CHECK-DAG:                  InstanceFieldSet [<<Copy>>,<<A>>]
+  /// CHECK-DAG:                  InstanceFieldSet [<<Copy>>,<<B>>]
+  /// CHECK:                      ConstructorFence [<<Copy>>]
+  /// CHECK:                      InvokeStaticOrDirect [<<Copy>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$newError
+  /// CHECK:                      Throw
+
+  /// CHECK-START: int Main.testThrowPath(int, int) load_store_elimination (after)
+  /// CHECK-NOT:                  NewInstance
+  /// CHECK:                      If
+  /// CHECK:                      NewInstance
+  /// CHECK-NOT:                  NewInstance
+  /// CHECK:                      Throw
+
+  /// CHECK-START: int Main.testThrowPath(int, int) load_store_elimination (after)
+  /// CHECK-NOT:                  InstanceFieldGet
+  public static int testThrowPath(int a, int b) {
+    Point p = new Point();
+    p.x = a;
+    p.y = b;
+    if (a < 0) {
+      throw $noinline$newError(p);
+    }
+    return p.x + p.y;
+  }
+
+  /// CHECK-START: int Main.testArrayThrowPath(int, int) partial_escape_analysis (after)
+  /// CHECK-DAG: <<A:i\d+>>       ParameterValue
+  /// CHECK-DAG: <<B:i\d+>>       ParameterValue
+  /// CHECK-DAG: <<Const0:i\d+>>  IntConstant 0
+  /// CHECK-DAG: <<Const1:i\d+>>  IntConstant 1
+  /// CHECK:                      NewArray
+  /// CHECK:                      If
+  /// CHECK: <<Copy:l\d+>>        NewArray
+  /// CHECK-DAG:                  ArraySet [<<Copy>>,<<Const0>>,<<A>>]
+  /// CHECK-DAG:                  ArraySet [<<Copy>>,<<Const1>>,<<B>>]
+  /// CHECK:                      InvokeStaticOrDirect [<<Copy>>{{(,[ij]\d+)?}}] method_name:Main.$noinline$newArrayError
+  /// CHECK:                      Throw
+
+  /// CHECK-START: int Main.testArrayThrowPath(int, int) load_store_elimination (after)
+  /// CHECK-NOT:                  NewArray
+  /// CHECK:                      If
+  /// CHECK:                      NewArray
+  /// CHECK-NOT:                  NewArray
+  /// CHECK:                      Throw
+  public static int testArrayThrowPath(int a, int b) {
+    int[] array = new int[2];
+    array[0] = a;
+    array[1] = b;
+    if (a < 0) {
+      throw $noinline$newArrayError(array);
+    }
+    return array[0] + array[1];
+  }
+
+  // The logging call can modify the object seen after the merge, so the
+  // allocation cannot be moved to the escape point.
+
+  /// CHECK-START: int Main.testEscapeAndMerge(int, int) partial_escape_analysis (after)
+  /// CHECK:                      NewInstance
+  /// CHECK-NOT:                  NewInstance
+  public static int testEscapeAndMerge(int a, int b) {
+    Point p = new Point();
+    p.x = a;
+    p.y = b;
+    if (a < 0) {
+      $noinline$log(p);
+    }
+    return p.x + p.y;
+  }
+
+  public static RuntimeException $noinline$newError(Point p) {
+    return new IllegalStateException("x=" + p.x + " y=" + p.y);
+  }
+
+  public static RuntimeException $noinline$newArrayError(int[] array) {
+    return new IllegalStateException(Arrays.toString(array));
+  }
+
+  public static void $noinline$log(Point p) {
+    System.out.println("logged x=" + p.x + " y=" + p.y);
+  }
+
+  static void assertIntEquals(int result, int expected) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
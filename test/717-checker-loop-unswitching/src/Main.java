@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Functional tests for loop unswitching and loop versioning.
+ */
+public class Main {
+
+  static int[] a;
+
+  //
+  // Unswitching on a loop-invariant condition.
+  //
+
+  /// CHECK-START: void Main.unswitch(int) loop_optimization (before)
+  /// CHECK-DAG: <<Cond:z\d+>> {{GreaterThan|LessThanOrEqual}} loop:none
+  /// CHECK-DAG:               If [<<Cond>>] loop:{{B\d+}}
+  //
+  /// CHECK-START: void Main.unswitch(int) loop_optimization (after)
+  /// CHECK-DAG: <<Cond:z\d+>> {{GreaterThan|LessThanOrEqual}} loop:none
+  /// CHECK-DAG:               If [<<Cond>>] loop:none
+  //
+  /// CHECK-START-{ARM,ARM64,MIPS64}: void Main.unswitch(int) loop_optimization (after)
+  /// CHECK-DAG: VecAdd loop:<<Loop1:B\d+>> outer_loop:none
+  /// CHECK-DAG: VecSub loop:<<Loop2:B\d+>> outer_loop:none
+  /// CHECK-EVAL: "<<Loop1>>" != "<<Loop2>>"
+  static void unswitch(int x) {
+    for (int i = 0; i < 128; i++) {
+      if (x > 0) {
+        a[i] += x;
+      } else {
+        a[i] -= x;
+      }
+    }
+  }
+
+  // The sum is used after the loop, and must be merged from both loop versions.
+  static int unswitchWithLastValue(int x) {
+    int sum = 0;
+    for (int i = 0; i < 128; i++) {
+      if (x > 0) {
+        sum += a[i];
+      } else {
+        sum -= a[i];
+      }
+    }
+    return sum;
+  }
+
+  //
+  // Versioning on several potentially aliased arrays.
+  //
+
+  static void version(int[] x, int[] y, int[] z) {
+    for (int i = 0; i < 100; i++) {
+      x[i] = y[i + 1] + z[i + 1];
+    }
+  }
+
+  public static void main(String[] args) {
+    a = new int[128];
+    for (int i = 0; i < 128; i++) {
+      a[i] = i;
+    }
+    unswitch(2);
+    for (int i = 0; i < 128; i++) {
+      expectEquals(i + 2, a[i]);
+    }
+    unswitch(-3);
+    for (int i = 0; i < 128; i++) {
+      expectEquals(i + 5, a[i]);
+    }
+    expectEquals(8768, unswitchWithLastValue(1));
+    expectEquals(-8768, unswitchWithLastValue(0));
+
+    // Disjoint arrays.
+    int[] x = new int[101];
+    int[] y = new int[101];
+    int[] z = new int[101];
+    for (int i = 0; i < 101; i++) {
+      y[i] = i;
+      z[i] = 2 * i;
+    }
+    version(x, y, z);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(3 * (i + 1), x[i]);
+    }
+    // Aliased arrays: each iteration reads the value stored by the next one.
+    for (int i = 0; i < 101; i++) {
+      x[i] = 1;
+    }
+    version(x, x, z);
+    for (int i = 0; i < 100; i++) {
+      expectEquals(1 + 2 * (i + 1), x[i]);
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
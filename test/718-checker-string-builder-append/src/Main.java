@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  public static void main(String[] args) {
+    assertEquals("ab", $noinline$appendStrings("a", "b"));
+    assertEquals("anull", $noinline$appendStrings("a", null));
+    assertEquals("nullnull", $noinline$appendStrings(null, null));
+    assertEquals("a\u0100", $noinline$appendStrings("a", "\u0100"));
+
+    assertEquals("x=0 y=0", $noinline$appendInts(0, 0));
+    assertEquals("x=-1 y=42", $noinline$appendInts(-1, 42));
+    assertEquals("x=-2147483648 y=2147483647",
+                 $noinline$appendInts(Integer.MIN_VALUE, Integer.MAX_VALUE));
+
+    assertEquals("-9223372036854775808", $noinline$appendLong(Long.MIN_VALUE));
+    assertEquals("9223372036854775807", $noinline$appendLong(Long.MAX_VALUE));
+    assertEquals("1000000000000", $noinline$appendLong(1000000000000L));
+
+    assertEquals("true:a", $noinline$appendBooleanChar(true, 'a'));
+    assertEquals("false:\u0000", $noinline$appendBooleanChar(false, '\u0000'));
+    assertEquals("false:\u20ac", $noinline$appendBooleanChar(false, '\u20ac'));
+
+    assertEquals("s1234truec", $noinline$appendMixed("s", 1, 2L, 3, 4L, true, 'c'));
+    assertEquals("12345678", $noinline$appendMaxArgs());
+    assertEquals("123456789", $noinline$appendTooManyArgs());
+
+    System.out.println("passed");
+  }
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendStrings(java.lang.String, java.lang.String) instruction_simplifier (before)
+  /// CHECK:                      NewInstance
+  /// CHECK:                      InvokeVirtual intrinsic:StringBuilderAppend
+  /// CHECK:                      InvokeVirtual intrinsic:StringBuilderAppend
+  /// CHECK:                      InvokeVirtual intrinsic:StringBuilderToString
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendStrings(java.lang.String, java.lang.String) instruction_simplifier (after)
+  /// CHECK-DAG: <<A:l\d+>>       ParameterValue
+  /// CHECK-DAG: <<B:l\d+>>       ParameterValue
+  /// CHECK-DAG: <<Append:l\d+>>  StringBuilderAppend [<<A>>,<<B>>,{{i\d+}}]
+  /// CHECK-DAG:                  Return [<<Append>>]
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendStrings(java.lang.String, java.lang.String) instruction_simplifier (after)
+  /// CHECK-NOT:                  NewInstance
+  /// CHECK-NOT:                  InvokeVirtual
+  public static String $noinline$appendStrings(String a, String b) {
+    return new StringBuilder().append(a).append(b).toString();
+  }
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendInts(int, int) instruction_simplifier (after)
+  /// CHECK-DAG: <<X:i\d+>>       ParameterValue
+  /// CHECK-DAG: <<Y:i\d+>>       ParameterValue
+  /// CHECK-DAG:                  StringBuilderAppend [{{l\d+}},<<X>>,{{l\d+}},<<Y>>,{{i\d+}}]
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendInts(int, int) instruction_simplifier (after)
+  /// CHECK-NOT:                  NewInstance
+  public static String $noinline$appendInts(int x, int y) {
+    return "x=" + x + " y=" + y;
+  }
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendLong(long) instruction_simplifier (after)
+  /// CHECK-DAG: <<L:j\d+>>       ParameterValue
+  /// CHECK-DAG:                  StringBuilderAppend [<<L>>,{{i\d+}}]
+  public static String $noinline$appendLong(long l) {
+    return new StringBuilder().append(l).toString();
+  }
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendBooleanChar(boolean, char) instruction_simplifier (after)
+  /// CHECK-DAG: <<Z:z\d+>>       ParameterValue
+  /// CHECK-DAG: <<C:c\d+>>       ParameterValue
+  /// CHECK-DAG:                  StringBuilderAppend [<<Z>>,{{l\d+}},<<C>>,{{i\d+}}]
+  public static String $noinline$appendBooleanChar(boolean z, char c) {
+    return new StringBuilder().append(z).append(":").append(c).toString();
+  }
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendMixed(java.lang.String, int, long, int, long, boolean, char) instruction_simplifier (after)
+  /// CHECK:                      StringBuilderAppend
+  /// CHECK-NOT:                  NewInstance
+  public static String $noinline$appendMixed(String s, int i1, long l1, int i2, long l2,
+                                             boolean z, char c) {
+    return s + i1 + l1 + i2 + l2 + z + c;
+  }
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendMaxArgs() instruction_simplifier (after)
+  /// CHECK:                      StringBuilderAppend
+  /// CHECK-NOT:                  NewInstance
+  public static String $noinline$appendMaxArgs() {
+    return new StringBuilder()
+        .append(1).append(2).append(3).append(4).append(5).append(6).append(7).append(8)
+        .toString();
+  }
+
+  // The format of the fused call can describe at most eight arguments.
+
+  /// CHECK-START: java.lang.String Main.$noinline$appendTooManyArgs() instruction_simplifier (after)
+  /// CHECK-NOT:                  StringBuilderAppend
+  public static String $noinline$appendTooManyArgs() {
+    return new StringBuilder()
+        .append(1).append(2).append(3).append(4).append(5).append(6).append(7).append(8)
+        .append(9)
+        .toString();
+  }
+
+  static void assertEquals(String expected, String result) {
+    if (!expected.equals(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
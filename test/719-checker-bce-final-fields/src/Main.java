@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class IntList {
+  final int[] elements;
+  final int size;
+
+  IntList(int[] elements, int size) {
+    this.elements = elements;
+    this.size = size;
+  }
+
+  /// CHECK-START: int IntList.$noinline$sum() BCE (before)
+  /// CHECK-DAG: BoundsCheck loop:<<Loop:B\d+>>
+  /// CHECK-DAG: InvokeStaticOrDirect loop:<<Loop>>
+
+  /// CHECK-START: int IntList.$noinline$sum() BCE (after)
+  /// CHECK-DAG: Deoptimize loop:none
+  /// CHECK-DAG: InvokeStaticOrDirect loop:{{B\d+}}
+
+  /// CHECK-START: int IntList.$noinline$sum() BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  int $noinline$sum() {
+    int result = 0;
+    // The call keeps global value numbering and loop invariant code motion
+    // from moving the field loads out of the loop.
+    for (int i = 0; i < size; i++) {
+      result += elements[i];
+      Main.$noinline$opaque();
+    }
+    return result;
+  }
+}
+
+public class Main {
+  static int calls;
+
+  public static void main(String[] args) {
+    int[] array = { 1, 2, 3, 4 };
+
+    assertEquals(3, $noinline$sumAcrossCall(new IntList(array, 4)));
+    assertEquals(0, $noinline$sumAcrossCall(new IntList(new int[1], 1)));
+
+    assertEquals(10, new IntList(array, 4).$noinline$sum());
+    assertEquals(6, new IntList(array, 3).$noinline$sum());
+    assertEquals(0, new IntList(array, 0).$noinline$sum());
+    assertEquals(0, new IntList(null, 0).$noinline$sum());
+    try {
+      new IntList(array, 5).$noinline$sum();
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    try {
+      new IntList(null, 1).$noinline$sum();
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+
+    System.out.println("passed");
+  }
+
+  /// CHECK-START: int Main.$noinline$sumAcrossCall(IntList) BCE (before)
+  /// CHECK: BoundsCheck
+  /// CHECK: InvokeStaticOrDirect
+  /// CHECK: BoundsCheck
+
+  /// CHECK-START: int Main.$noinline$sumAcrossCall(IntList) BCE (after)
+  /// CHECK-NOT: BoundsCheck
+  static int $noinline$sumAcrossCall(IntList list) {
+    if (list.elements.length < 2) {
+      return 0;
+    }
+    int result = list.elements[0];
+    // Reloads the final field after the call, which does not clobber it.
+    $noinline$opaque();
+    return result + list.elements[1];
+  }
+
+  static void $noinline$opaque() {
+    calls++;
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected: " + expected + ", found: " + actual);
+    }
+  }
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.File;
+import java.io.FileDescriptor;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.lang.reflect.Method;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+
+public class Main {
+    private static final int NUM_ROUNDS = 50;
+    private static final int NUM_THREADS_PER_ROUND = 20;
+    private static final int NUM_CALLS_PER_THREAD = 100;
+
+    // See runtime/trace.cc.
+    private static final int TRACE_HEADER_LENGTH = 32;
+    private static final int STREAMED_RECORD_SIZE = 14;
+    private static final int OP_NEW_METHOD = 1;
+    private static final int OP_NEW_THREAD = 2;
+    private static final int OP_TRACE_SUMMARY = 3;
+    private static final int TRACE_METHOD_ACTION_MASK = 0x03;
+
+    static class ThreadRunnable implements Runnable {
+        public void run() {
+            // Leave the trace buffer of the thread partially filled when it exits.
+            for (int i = 0; i < NUM_CALLS_PER_THREAD; ++i) {
+                doNothing();
+            }
+        }
+
+        private void doNothing() {}
+    }
+
+    public static void main(String[] args) throws Exception {
+        File file = createTempFile();
+        try {
+            FileOutputStream out = new FileOutputStream(file);
+            try {
+                VMDebug.startStreamingMethodTracing(file.getPath(), out.getFD());
+                runThreads();
+                VMDebug.stopMethodTracing();
+            } finally {
+                out.close();
+            }
+            // The buffered events of an exiting thread are streamed when it exits, so none of
+            // them are missing once tracing stops.
+            int expected = 2 * NUM_CALLS_PER_THREAD * NUM_THREADS_PER_ROUND * NUM_ROUNDS;
+            int found = countEvents(file, "Main$ThreadRunnable", "doNothing");
+            if (found != expected) {
+                System.out.println("Expected " + expected + " doNothing events, found " + found);
+            }
+        } finally {
+            file.delete();
+        }
+        System.out.println("Done");
+    }
+
+    private static void runThreads() {
+        for (int round = 0; round < NUM_ROUNDS; ++round) {
+            ArrayList<Thread> threads = new ArrayList<Thread>();
+            for (int i = 0; i < NUM_THREADS_PER_ROUND; ++i) {
+                threads.add(new Thread(new ThreadRunnable(), "TestThread-" + round + "-" + i));
+            }
+
+            for (Thread t : threads) {
+                t.start();
+            }
+
+            for (Thread t : threads) {
+                try {
+                    t.join();
+                } catch (InterruptedException e) {
+                    System.out.println("Thread " + t.getName() + " has been interrupted");
+                }
+            }
+        }
+    }
+
+    // Count the entry and exit events of the method in a streamed trace.
+    private static int countEvents(File file, String className, String methodName)
+            throws IOException {
+        ByteBuffer buf;
+        try (RandomAccessFile raf = new RandomAccessFile(file, "r")) {
+            byte[] data = new byte[(int) raf.length()];
+            raf.readFully(data);
+            buf = ByteBuffer.wrap(data).order(ByteOrder.LITTLE_ENDIAN);
+        }
+        buf.position(TRACE_HEADER_LENGTH);
+        int methodId = -1;
+        int count = 0;
+        while (buf.remaining() >= 2) {
+            int tid = buf.getShort(buf.position()) & 0xffff;
+            if (tid != 0) {
+                // Streamed records always have room for two clocks.
+                int methodValue = buf.getInt(buf.position() + 2);
+                if ((methodValue & ~TRACE_METHOD_ACTION_MASK) == methodId) {
+                    ++count;
+                }
+                buf.position(buf.position() + STREAMED_RECORD_SIZE);
+                continue;
+            }
+            buf.getShort();
+            int op = buf.get();
+            if (op == OP_NEW_METHOD) {
+                // "<id>\t<class>\t<name>\t<signature>\t<file>\n"
+                String[] fields = readString(buf, buf.getShort() & 0xffff).split("\t");
+                if (fields[1].equals(className) && fields[2].equals(methodName)) {
+                    methodId = Integer.decode(fields[0]);
+                }
+            } else if (op == OP_NEW_THREAD) {
+                buf.getShort();
+                readString(buf, buf.getShort() & 0xffff);
+            } else if (op == OP_TRACE_SUMMARY) {
+                break;
+            } else {
+                throw new Error("Unexpected trace op " + op);
+            }
+        }
+        return count;
+    }
+
+    private static String readString(ByteBuffer buf, int length) {
+        byte[] bytes = new byte[length];
+        buf.get(bytes);
+        return new String(bytes, StandardCharsets.UTF_8);
+    }
+
+    private static File createTempFile() throws Exception {
+        try {
+            return File.createTempFile("test", ".trace");
+        } catch (IOException e) {
+            System.setProperty("java.io.tmpdir", "/data/local/tmp");
+            try {
+                return File.createTempFile("test", ".trace");
+            } catch (IOException e2) {
+                System.setProperty("java.io.tmpdir", "/sdcard");
+                return File.createTempFile("test", ".trace");
+            }
+        }
+    }
+
+    private static class VMDebug {
+        private static final Method startMethodTracingMethod;
+        private static final Method stopMethodTracingMethod;
+        static {
+            try {
+                Class<?> c = Class.forName("dalvik.system.VMDebug");
+                startMethodTracingMethod = c.getDeclaredMethod("startMethodTracing", String.class,
+                        FileDescriptor.class, Integer.TYPE, Integer.TYPE, Boolean.TYPE,
+                        Integer.TYPE, Boolean.TYPE);
+                stopMethodTracingMethod = c.getDeclaredMethod("stopMethodTracing");
+            } catch (Exception e) {
+                throw new RuntimeException(e);
+            }
+        }
+
+        public static void startStreamingMethodTracing(String filename, FileDescriptor fd)
+                throws Exception {
+            startMethodTracingMethod.invoke(null, filename, fd, /* bufferSize */ 8 * 1024 * 1024,
+                    /* flags */ 0, /* samplingEnabled */ false, /* intervalUs */ 0,
+                    /* streamingOutput */ true);
+        }
+        public static void stopMethodTracing() throws Exception {
+            stopMethodTracingMethod.invoke(null);
+        }
+    }
+}
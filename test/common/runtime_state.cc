@@ -227,7 +227,13 @@ extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitCompiled(JNIEnv* env,
   code_cache->SetGarbageCollectCode(false);
   while (true) {
     const void* pc = method->GetEntryPointFromQuickCompiledCode();
+    bool is_baseline = false;
     if (code_cache->ContainsPc(pc)) {
+      // Tests expect optimized code, baseline code still has to be replaced.
+      ScopedObjectAccess soa(self);
+      is_baseline = code_cache->IsBaselineCompiled(method);
+    }
+    if (code_cache->ContainsPc(pc) && !is_baseline) {
       break;
     } else {
       // Sleep to yield to the compiler thread.
@@ -236,7 +242,7 @@ extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitCompiled(JNIEnv* env,
       // Make sure there is a profiling info, required by the compiler.
       ProfilingInfo::Create(self, method, /* retry_allocation */ true);
       // Will either ensure it's compiled or do the compilation itself.
-      jit->CompileMethod(method, self, /* osr */ false);
+      jit->CompileMethod(method, self, /* baseline */ false, /* osr */ false);
     }
   }
 }